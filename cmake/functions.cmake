@@ -57,6 +57,11 @@ function(setup_implementation)
   # link core module
   target_link_libraries(${LIB_NAME} PUBLIC core_module_lib)
 
+  # std::execution policies need the parallel backend on top of core
+  if(SETUP_NAME STREQUAL "pstl")
+    ppc_link_pstl(${LIB_NAME})
+  endif()
+
   # and link into each enabled test executable
   foreach(test_exec ${SETUP_TESTS})
     target_link_libraries(${test_exec} PUBLIC ${LIB_NAME})
@@ -78,9 +83,11 @@ function(ppc_configure_subproject SUBDIR)
   set(TEST_DIR "${CMAKE_CURRENT_SOURCE_DIR}/${SUBDIR}/tests")
   set(TEST_EXECUTABLES "")
 
-  # Register functional and performance test runners
+  # Register functional and performance test runners and the benchmark drivers
   add_tests(USE_FUNC_TESTS ${FUNC_TEST_EXEC} functional)
   add_tests(USE_PERF_TESTS ${PERF_TEST_EXEC} performance)
+  add_tests(USE_PERF_TESTS ${BENCH_EXEC} bench)
+  add_tests(USE_PERF_TESTS ${COMM_BENCH_EXEC} comm_bench)
 
   message(STATUS "${SUBDIR}")
 
@@ -0,0 +1,23 @@
+# Records the commit of the source tree in a header, executed with cmake -P by
+# the ppc_git_sha target (see modules/CMakeLists.txt) on every build, so perf
+# records name the commit the binaries were built from rather than the one the
+# tree was configured at. The header is only rewritten when the commit changes.
+#
+# Inputs: GIT_EXECUTABLE (may be empty), SOURCE_DIR, OUTPUT.
+
+cmake_minimum_required(VERSION 3.25)
+
+set(sha "")
+if(GIT_EXECUTABLE)
+  execute_process(
+    COMMAND "${GIT_EXECUTABLE}" rev-parse HEAD
+    WORKING_DIRECTORY "${SOURCE_DIR}"
+    OUTPUT_VARIABLE sha
+    OUTPUT_STRIP_TRAILING_WHITESPACE ERROR_QUIET)
+endif()
+
+file(
+  CONFIGURE
+  OUTPUT "${OUTPUT}"
+  CONTENT "#pragma once\n\n#define PPC_GIT_SHA \"@sha@\"\n"
+  @ONLY)
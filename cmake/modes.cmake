@@ -27,3 +27,8 @@ if(USE_PERF_TESTS)
   message(STATUS "Enable performance tests")
   add_compile_definitions(USE_PERF_TESTS)
 endif(USE_PERF_TESTS)
+
+option(USE_MPI_PROFILER "Link the PMPI communication profiler into the test executables" OFF)
+if(USE_MPI_PROFILER)
+  message(STATUS "Enable MPI communication profiler")
+endif(USE_MPI_PROFILER)
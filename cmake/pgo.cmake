@@ -0,0 +1,179 @@
+include_guard()
+
+# Profile-guided optimization in two phases. The top-level build configures an
+# instrumented copy of the project under <build>/pgo/instrumented, builds its
+# ppc_perf_tests, runs a subset of them (cmake/pgo_train.cmake) and then
+# compiles every target of this build with the collected profile.
+option(PPC_PGO "Build with profile-guided optimization trained on ppc_perf_tests" OFF)
+option(PPC_PGO_LTO "Link the profile-optimized build with ThinLTO (LTO on GCC)" OFF)
+set(PPC_PGO_TRAINING_FILTER
+    "*Trapezoid*:*ConnectedComponents*:*RadixSort*:*ExampleRunPerfTestThreads*"
+    CACHE STRING "GoogleTest filter of the perf tests that produce the profile")
+set(PPC_PGO_TRAINING_PROCESSES
+    "2"
+    CACHE STRING "MPI processes of the training run")
+set(PPC_PGO_TRAINING_THREADS
+    "2"
+    CACHE STRING "PPC_NUM_THREADS of the training run")
+# Set by the top-level build on the instrumented copy only
+set(PPC_PGO_PHASE
+    "use"
+    CACHE STRING "PGO phase of this build tree: generate or use")
+set(PPC_PGO_DIR
+    "${CMAKE_BINARY_DIR}/pgo"
+    CACHE PATH "Directory of the instrumented build and the collected profile")
+mark_as_advanced(PPC_PGO_PHASE PPC_PGO_DIR)
+
+# Builds and trains the instrumented copy, and makes every target defined so
+# far wait for the profile and recompile when it changes. Called after all
+# subdirectories are added.
+function(ppc_pgo_setup_training)
+  if(NOT PPC_PGO OR NOT PPC_PGO_PHASE STREQUAL "use")
+    return()
+  endif()
+
+  if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    string(REGEX MATCH "^[0-9]+" ppc_clang_major "${CMAKE_CXX_COMPILER_VERSION}")
+    get_filename_component(ppc_compiler_dir "${CMAKE_CXX_COMPILER}" DIRECTORY)
+    find_program(
+      PPC_LLVM_PROFDATA
+      NAMES llvm-profdata-${ppc_clang_major} llvm-profdata
+      HINTS "${ppc_compiler_dir}")
+    if(NOT PPC_LLVM_PROFDATA)
+      message(FATAL_ERROR "PPC_PGO with Clang needs llvm-profdata")
+    endif()
+  endif()
+
+  # Lists would be split into separate arguments of the training command
+  string(REPLACE ";" " " ppc_mpiexec_preflags "${MPIEXEC_PREFLAGS}")
+
+  include(ExternalProject)
+  ExternalProject_Add(
+    ppc_pgo_training
+    SOURCE_DIR "${CMAKE_SOURCE_DIR}"
+    PREFIX "${PPC_PGO_DIR}"
+    BINARY_DIR "${PPC_PGO_DIR}/instrumented"
+    CMAKE_ARGS -DCMAKE_C_COMPILER=${CMAKE_C_COMPILER}
+               -DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}
+               -DCMAKE_C_COMPILER_LAUNCHER=${CMAKE_C_COMPILER_LAUNCHER}
+               -DCMAKE_CXX_COMPILER_LAUNCHER=${CMAKE_CXX_COMPILER_LAUNCHER}
+               -DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE}
+               -DUSE_FUNC_TESTS=OFF
+               -DUSE_PERF_TESTS=ON
+               -DUSE_MPI_PROFILER=OFF
+               -DPPC_PGO=ON
+               -DPPC_PGO_PHASE=generate
+               -DPPC_PGO_DIR=${PPC_PGO_DIR}
+    CMAKE_CACHE_ARGS "-DPPC_IMPLEMENTATIONS:STRING=${PPC_IMPLEMENTATIONS}"
+    BUILD_COMMAND "${CMAKE_COMMAND}" --build "${PPC_PGO_DIR}/instrumented"
+                  --config $<CONFIG> --target ppc_perf_tests --parallel
+    INSTALL_COMMAND "")
+
+  ExternalProject_Add_Step(
+    ppc_pgo_training train
+    COMMAND
+      "${CMAKE_COMMAND}" -DPERF_TESTS=${PPC_PGO_DIR}/instrumented/bin/ppc_perf_tests
+      "-DFILTER=${PPC_PGO_TRAINING_FILTER}" -DPROCESSES=${PPC_PGO_TRAINING_PROCESSES}
+      -DTHREADS=${PPC_PGO_TRAINING_THREADS} "-DMPIEXEC=${MPIEXEC_EXECUTABLE}"
+      "-DMPIEXEC_NUMPROC_FLAG=${MPIEXEC_NUMPROC_FLAG}"
+      "-DMPIEXEC_PREFLAGS=${ppc_mpiexec_preflags}" -DRAW_DIR=${PPC_PGO_RAW_DIR}
+      -DPROFDATA=${PPC_LLVM_PROFDATA} -DPROFILE=${PPC_PGO_PROFILE}
+      -DSTAMP=${PPC_PGO_STAMP} -P "${CMAKE_SOURCE_DIR}/cmake/pgo_train.cmake"
+    COMMENT "Collecting the PGO profile from ppc_perf_tests"
+    DEPENDEES build
+    DEPENDERS install
+    BYPRODUCTS "${PPC_PGO_STAMP}"
+    USES_TERMINAL TRUE)
+
+  ppc_pgo_depend_on_profile("${CMAKE_SOURCE_DIR}")
+endfunction()
+
+function(ppc_pgo_depend_on_profile dir)
+  get_property(
+    targets
+    DIRECTORY "${dir}"
+    PROPERTY BUILDSYSTEM_TARGETS)
+  foreach(target ${targets})
+    get_target_property(type ${target} TYPE)
+    if(type MATCHES "^(STATIC_LIBRARY|SHARED_LIBRARY|OBJECT_LIBRARY|EXECUTABLE)$")
+      add_dependencies(${target} ppc_pgo_training)
+      get_target_property(sources ${target} SOURCES)
+      list(TRANSFORM sources PREPEND "${dir}/" REGEX "^[^/$]")
+      set_property(
+        SOURCE ${sources}
+        DIRECTORY "${dir}"
+        APPEND
+        PROPERTY OBJECT_DEPENDS "${PPC_PGO_STAMP}")
+    endif()
+  endforeach()
+
+  get_property(
+    subdirs
+    DIRECTORY "${dir}"
+    PROPERTY SUBDIRECTORIES)
+  foreach(subdir ${subdirs})
+    ppc_pgo_depend_on_profile("${subdir}")
+  endforeach()
+endfunction()
+
+if(NOT PPC_PGO)
+  return()
+endif()
+
+if(NOT (CMAKE_CXX_COMPILER_ID MATCHES "Clang" OR CMAKE_CXX_COMPILER_ID MATCHES
+                                                 "GNU"))
+  message(WARNING "PGO is supported on gcc and clang compilers only!")
+  set(PPC_PGO OFF)
+  return()
+endif()
+
+set(PPC_PGO_RAW_DIR "${PPC_PGO_DIR}/raw")
+set(PPC_PGO_STAMP "${PPC_PGO_DIR}/profile.stamp")
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+  set(PPC_PGO_PROFILE "${PPC_PGO_DIR}/ppc.profdata")
+else()
+  # GCC keeps one .gcda file per object; the prefix path makes their names
+  # relative to the build tree, so both trees find the same files
+  set(PPC_PGO_PROFILE "${PPC_PGO_RAW_DIR}")
+endif()
+
+if(PPC_PGO_PHASE STREQUAL "generate")
+  message(STATUS "PGO: instrumented build, profiles in ${PPC_PGO_RAW_DIR}")
+  if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    add_compile_options(-fprofile-generate=${PPC_PGO_RAW_DIR}
+                        -fprofile-update=atomic)
+  else()
+    add_compile_options(
+      -fprofile-generate=${PPC_PGO_RAW_DIR} -fprofile-update=atomic
+      -fprofile-prefix-path=${CMAKE_BINARY_DIR})
+  endif()
+  add_link_options(-fprofile-generate=${PPC_PGO_RAW_DIR})
+  return()
+endif()
+
+message(STATUS "PGO: optimized build with profile ${PPC_PGO_PROFILE}")
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+  # Code the training did not reach and sources changed since then are not
+  # errors under CMAKE_COMPILE_WARNING_AS_ERROR
+  add_compile_options(
+    -fprofile-use=${PPC_PGO_PROFILE} -Wno-profile-instr-unprofiled
+    -Wno-profile-instr-out-of-date -Wno-backend-plugin)
+else()
+  # Partial training keeps functions the subset never ran optimized for speed
+  add_compile_options(
+    -fprofile-use=${PPC_PGO_PROFILE} -fprofile-partial-training
+    -fprofile-prefix-path=${CMAKE_BINARY_DIR} -Wno-missing-profile
+    -Wno-coverage-mismatch)
+endif()
+
+if(PPC_PGO_LTO)
+  include(CheckIPOSupported)
+  check_ipo_supported(RESULT ppc_ipo_supported OUTPUT ppc_ipo_output)
+  if(ppc_ipo_supported)
+    # CMake passes -flto=thin to Clang and -flto=auto to GCC
+    set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+    message(STATUS "PGO: link-time optimization enabled")
+  else()
+    message(WARNING "LTO is not supported: ${ppc_ipo_output}")
+  endif()
+endif()
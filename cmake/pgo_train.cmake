@@ -0,0 +1,47 @@
+# Training run of the PGO build, executed with cmake -P by the
+# ppc_pgo_training target (see pgo.cmake): runs the instrumented perf tests
+# and turns their raw profiles into the profile of the optimized build.
+#
+# Inputs: PERF_TESTS, FILTER, PROCESSES, THREADS, MPIEXEC,
+# MPIEXEC_NUMPROC_FLAG, MPIEXEC_PREFLAGS, RAW_DIR, PROFDATA (Clang only),
+# PROFILE, STAMP.
+
+# Profiles of an earlier training would be merged into the new ones
+file(REMOVE_RECURSE "${RAW_DIR}")
+file(MAKE_DIRECTORY "${RAW_DIR}")
+
+set(command "${PERF_TESTS}" "--gtest_filter=${FILTER}")
+if(MPIEXEC)
+  separate_arguments(preflags UNIX_COMMAND "${MPIEXEC_PREFLAGS}")
+  set(command "${MPIEXEC}" ${MPIEXEC_NUMPROC_FLAG} ${PROCESSES} ${preflags}
+              ${command})
+endif()
+
+set(ENV{PPC_NUM_PROC} "${PROCESSES}")
+set(ENV{PPC_NUM_THREADS} "${THREADS}")
+set(ENV{OMP_NUM_THREADS} "${THREADS}")
+string(JOIN " " printed_command ${command})
+message(STATUS "PGO training: ${printed_command}")
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "PGO training run failed: ${result}")
+endif()
+
+if(PROFDATA)
+  file(GLOB raw_profiles "${RAW_DIR}/*.profraw")
+  if(NOT raw_profiles)
+    message(FATAL_ERROR "PGO training wrote no profiles to ${RAW_DIR}")
+  endif()
+  execute_process(COMMAND "${PROFDATA}" merge "-output=${PROFILE}"
+                          ${raw_profiles} RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "llvm-profdata merge failed: ${result}")
+  endif()
+else()
+  file(GLOB_RECURSE raw_profiles "${RAW_DIR}/*.gcda")
+  if(NOT raw_profiles)
+    message(FATAL_ERROR "PGO training wrote no profiles to ${RAW_DIR}")
+  endif()
+endif()
+
+file(TOUCH "${STAMP}")
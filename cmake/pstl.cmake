@@ -0,0 +1,11 @@
+include_guard()
+
+# C++17 parallel algorithms (std::execution). libstdc++ dispatches the parallel
+# policies to oneTBB, so pstl implementations link the same TBB as tbb ones.
+function(ppc_link_pstl exec_func_lib)
+  ppc_link_tbb(${exec_func_lib})
+  if(APPLE AND CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    # libc++ keeps the execution policies behind the experimental library flag
+    target_compile_options(${exec_func_lib} PUBLIC -fexperimental-library)
+  endif()
+endfunction()
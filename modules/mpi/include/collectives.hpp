@@ -0,0 +1,249 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mpi/include/distribution.hpp"
+
+namespace ppc::mpi {
+
+/// @brief MPI datatype of the C++ type @p T; specialized for the arithmetic types and std::byte.
+template <typename T>
+struct DatatypeTraits;
+
+/// @cond
+#define PPC_MPI_DATATYPE(type, mpi_type) \
+  template <>                            \
+  struct DatatypeTraits<type> {          \
+    static MPI_Datatype Get() {          \
+      return mpi_type;                   \
+    }                                    \
+  }
+
+PPC_MPI_DATATYPE(char, MPI_CHAR);
+PPC_MPI_DATATYPE(signed char, MPI_SIGNED_CHAR);
+PPC_MPI_DATATYPE(unsigned char, MPI_UNSIGNED_CHAR);
+PPC_MPI_DATATYPE(short, MPI_SHORT);
+PPC_MPI_DATATYPE(unsigned short, MPI_UNSIGNED_SHORT);
+PPC_MPI_DATATYPE(int, MPI_INT);
+PPC_MPI_DATATYPE(unsigned int, MPI_UNSIGNED);
+PPC_MPI_DATATYPE(long, MPI_LONG);
+PPC_MPI_DATATYPE(unsigned long, MPI_UNSIGNED_LONG);
+PPC_MPI_DATATYPE(long long, MPI_LONG_LONG);
+PPC_MPI_DATATYPE(unsigned long long, MPI_UNSIGNED_LONG_LONG);
+PPC_MPI_DATATYPE(float, MPI_FLOAT);
+PPC_MPI_DATATYPE(double, MPI_DOUBLE);
+PPC_MPI_DATATYPE(long double, MPI_LONG_DOUBLE);
+PPC_MPI_DATATYPE(bool, MPI_CXX_BOOL);
+PPC_MPI_DATATYPE(std::byte, MPI_BYTE);
+
+#undef PPC_MPI_DATATYPE
+/// @endcond
+
+/// @brief Types the typed wrappers accept: those with a DatatypeTraits specialization.
+template <typename T>
+concept MpiType = requires {
+  { DatatypeTraits<std::remove_cv_t<T>>::Get() } -> std::same_as<MPI_Datatype>;
+};
+
+template <MpiType T>
+MPI_Datatype GetDatatype() {
+  return DatatypeTraits<std::remove_cv_t<T>>::Get();
+}
+
+/// @cond
+namespace detail {
+
+inline int CommRank(MPI_Comm comm) {
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  return rank;
+}
+
+/// Rank of the caller in @p comm, after checking that @p plan was made for that many ranks.
+inline int CheckPlan(const DistributionPlan &plan, MPI_Comm comm) {
+  int size = 0;
+  MPI_Comm_size(comm, &size);
+  if (plan.Spec().ranks != size) {
+    throw std::runtime_error("The distribution plan is for " + std::to_string(plan.Spec().ranks) +
+                             " ranks, the communicator has " + std::to_string(size));
+  }
+  return CommRank(comm);
+}
+
+inline void CheckSize(std::size_t actual, std::size_t expected, const char *what) {
+  if (actual != expected) {
+    throw std::runtime_error(std::string(what) + " has " + std::to_string(actual) + " elements instead of " +
+                             std::to_string(expected));
+  }
+}
+
+/// Whether @p local is @p rank's part of the global buffer @p global of a contiguous plan, i.e. MPI_IN_PLACE applies.
+template <typename T>
+bool IsOwnSlot(const DistributionPlan &plan, std::span<const T> global, std::span<const T> local, int rank) {
+  return plan.Contiguous() && !global.empty() && local.data() == global.data() + plan.Displacements()[rank];
+}
+
+// Untyped transfers of collectives.cpp. Buffers hold rank-ordered elements of @p type_size bytes; every count above
+// GetMpiMaxCount() goes to the MPI-4 large-count call or, before MPI-4, to chunks of at most that many elements.
+void Scatterv(const DistributionPlan &plan, const void *send, void *recv, MPI_Datatype type, std::size_t type_size,
+              int root, MPI_Comm comm);
+void Gatherv(const DistributionPlan &plan, const void *send, void *recv, MPI_Datatype type, std::size_t type_size,
+             int root, MPI_Comm comm);
+void Allgatherv(const DistributionPlan &plan, const void *send, void *recv, MPI_Datatype type, std::size_t type_size,
+                MPI_Comm comm);
+void Reduce(const void *send, void *recv, std::size_t count, MPI_Datatype type, std::size_t type_size, MPI_Op op,
+            int root, MPI_Comm comm);
+void Allreduce(const void *send, void *recv, std::size_t count, MPI_Datatype type, std::size_t type_size, MPI_Op op,
+               MPI_Comm comm);
+void Bcast(void *data, std::size_t count, MPI_Datatype type, std::size_t type_size, int root, MPI_Comm comm);
+void Send(const void *data, std::size_t count, MPI_Datatype type, std::size_t type_size, int dest, int tag,
+          MPI_Comm comm);
+void Recv(void *data, std::size_t count, MPI_Datatype type, std::size_t type_size, int source, int tag, MPI_Comm comm);
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Tag of the point-to-point messages that carry the chunks of a Scatter() or Gather() too large for one
+/// int-count call when MPI-4 is not available; keep it free on communicators that use these collectives.
+inline constexpr int kChunkTag = 32767;
+
+/// @brief Makes the next collective read PPC_MPI_MAX_COUNT again (for tests that change it).
+void ResetMaxCount();
+
+/// @brief Deals @p global on @p root out to every rank's @p local according to @p plan (MPI_Scatterv).
+/// @details @p global is only read on @p root and may be empty elsewhere; @p local must hold LocalSize(rank)
+/// elements. With a contiguous plan, a root @p local that is its own part of @p global is left in place.
+/// Other plans are packed into a temporary buffer on @p root first.
+/// @throws std::runtime_error If the plan or a buffer does not match the communicator and the plan.
+template <MpiType T>
+void Scatter(const DistributionPlan &plan, std::span<const T> global, std::span<T> local, int root, MPI_Comm comm) {
+  const int rank = detail::CheckPlan(plan, comm);
+  detail::CheckSize(local.size(), plan.LocalSize(rank), "The local buffer of Scatter");
+  if (rank != root) {
+    detail::Scatterv(plan, nullptr, local.data(), GetDatatype<T>(), sizeof(T), root, comm);
+    return;
+  }
+  detail::CheckSize(global.size(), plan.TotalSize(), "The global buffer of Scatter");
+  if (plan.Contiguous()) {
+    void *recv = detail::IsOwnSlot<T>(plan, global, local, rank) ? MPI_IN_PLACE : local.data();
+    detail::Scatterv(plan, global.data(), recv, GetDatatype<T>(), sizeof(T), root, comm);
+    return;
+  }
+  std::vector<T> packed(global.size());
+  plan.Pack(global, std::span(packed));
+  detail::Scatterv(plan, packed.data(), local.data(), GetDatatype<T>(), sizeof(T), root, comm);
+}
+
+/// @brief Collects every rank's @p local into @p global on @p root according to @p plan (MPI_Gatherv).
+/// @details @p global must hold TotalSize() elements on @p root and may be empty elsewhere. A root @p local that is
+/// its own part of @p global of a contiguous plan is used in place.
+/// @throws std::runtime_error If the plan or a buffer does not match the communicator and the plan.
+template <MpiType T>
+void Gather(const DistributionPlan &plan, std::span<const T> local, std::span<T> global, int root, MPI_Comm comm) {
+  const int rank = detail::CheckPlan(plan, comm);
+  detail::CheckSize(local.size(), plan.LocalSize(rank), "The local buffer of Gather");
+  if (rank != root) {
+    detail::Gatherv(plan, local.data(), nullptr, GetDatatype<T>(), sizeof(T), root, comm);
+    return;
+  }
+  detail::CheckSize(global.size(), plan.TotalSize(), "The global buffer of Gather");
+  if (plan.Contiguous()) {
+    const void *send = detail::IsOwnSlot<T>(plan, global, local, rank) ? MPI_IN_PLACE : local.data();
+    detail::Gatherv(plan, send, global.data(), GetDatatype<T>(), sizeof(T), root, comm);
+    return;
+  }
+  std::vector<T> packed(global.size());
+  detail::Gatherv(plan, local.data(), packed.data(), GetDatatype<T>(), sizeof(T), root, comm);
+  plan.Unpack(std::span<const T>(packed), global);
+}
+
+/// @brief Gather() onto every rank (MPI_Allgatherv); @p global must hold TotalSize() elements everywhere.
+template <MpiType T>
+void Allgather(const DistributionPlan &plan, std::span<const T> local, std::span<T> global, MPI_Comm comm) {
+  const int rank = detail::CheckPlan(plan, comm);
+  detail::CheckSize(local.size(), plan.LocalSize(rank), "The local buffer of Allgather");
+  detail::CheckSize(global.size(), plan.TotalSize(), "The global buffer of Allgather");
+  if (plan.Contiguous()) {
+    const void *send = detail::IsOwnSlot<T>(plan, global, local, rank) ? MPI_IN_PLACE : local.data();
+    detail::Allgatherv(plan, send, global.data(), GetDatatype<T>(), sizeof(T), comm);
+    return;
+  }
+  std::vector<T> packed(global.size());
+  detail::Allgatherv(plan, local.data(), packed.data(), GetDatatype<T>(), sizeof(T), comm);
+  plan.Unpack(std::span<const T>(packed), global);
+}
+
+/// @brief Element-wise reduction of every rank's @p send with @p op into @p recv on @p root (MPI_Reduce).
+/// @details @p recv is only written on @p root and may be empty elsewhere. If @p send and @p recv are the same
+/// buffer on @p root, the reduction runs in place.
+template <MpiType T>
+void Reduce(std::span<const T> send, std::span<T> recv, MPI_Op op, int root, MPI_Comm comm) {
+  if (detail::CommRank(comm) != root) {
+    detail::Reduce(send.data(), nullptr, send.size(), GetDatatype<T>(), sizeof(T), op, root, comm);
+    return;
+  }
+  detail::CheckSize(recv.size(), send.size(), "The receive buffer of Reduce");
+  const void *send_buffer = send.data() == recv.data() ? MPI_IN_PLACE : send.data();
+  detail::Reduce(send_buffer, recv.data(), send.size(), GetDatatype<T>(), sizeof(T), op, root, comm);
+}
+
+/// @brief Reduce() with the result on every rank (MPI_Allreduce); in place where @p send and @p recv are the same.
+template <MpiType T>
+void Allreduce(std::span<const T> send, std::span<T> recv, MPI_Op op, MPI_Comm comm) {
+  detail::CheckSize(recv.size(), send.size(), "The receive buffer of Allreduce");
+  const void *send_buffer = send.data() == recv.data() ? MPI_IN_PLACE : send.data();
+  detail::Allreduce(send_buffer, recv.data(), send.size(), GetDatatype<T>(), sizeof(T), op, comm);
+}
+
+/// @brief @p value reduced with @p op over every rank of @p comm.
+template <MpiType T>
+T Allreduce(const T &value, MPI_Op op, MPI_Comm comm) {
+  T result = value;
+  Allreduce<T>(std::span<const T>(&result, 1), std::span<T>(&result, 1), op, comm);
+  return result;
+}
+
+/// @brief @p value reduced with @p op over every rank of @p comm on @p root; @p value unchanged elsewhere.
+template <MpiType T>
+T Reduce(const T &value, MPI_Op op, int root, MPI_Comm comm) {
+  T result = value;
+  Reduce<T>(std::span<const T>(&result, 1), std::span<T>(&result, 1), op, root, comm);
+  return result;
+}
+
+/// @brief Copies @p data of @p root to every rank (MPI_Bcast); @p data must have the same size everywhere.
+template <MpiType T>
+void Bcast(std::span<T> data, int root, MPI_Comm comm) {
+  detail::Bcast(data.data(), data.size(), GetDatatype<T>(), sizeof(T), root, comm);
+}
+
+/// @brief @p value of @p root on every rank of @p comm.
+template <MpiType T>
+T Bcast(const T &value, int root, MPI_Comm comm) {
+  T result = value;
+  Bcast<T>(std::span<T>(&result, 1), root, comm);
+  return result;
+}
+
+/// @brief Blocking send of @p data to @p dest (MPI_Send); the matching Recv() must expect data.size() elements.
+template <MpiType T>
+void Send(std::span<const T> data, int dest, int tag, MPI_Comm comm) {
+  detail::Send(data.data(), data.size(), GetDatatype<T>(), sizeof(T), dest, tag, comm);
+}
+
+/// @brief Blocking receive of exactly data.size() elements from @p source (MPI_Recv).
+/// @details @p source must name the rank: a transfer above GetMpiMaxCount() may arrive in chunks before MPI-4.
+template <MpiType T>
+void Recv(std::span<T> data, int source, int tag, MPI_Comm comm) {
+  detail::Recv(data.data(), data.size(), GetDatatype<T>(), sizeof(T), source, tag, comm);
+}
+
+}  // namespace ppc::mpi
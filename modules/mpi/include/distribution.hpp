@@ -0,0 +1,147 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace ppc::mpi {
+
+/// @brief How the items of a range are dealt out to the ranks.
+enum class DistributionKind : uint8_t {
+  /// One contiguous run per rank; the first `items % ranks` ranks get one item more.
+  kBlock,
+  /// Item i to rank i % ranks.
+  kCyclic,
+  /// Runs of @ref DistributionSpec::block items dealt out round-robin.
+  kBlockCyclic,
+};
+
+/// @brief Parameters of a distribution plan; also the key of the plan cache.
+struct DistributionSpec {
+  DistributionKind kind = DistributionKind::kBlock;
+  std::size_t items = 0;
+  int ranks = 1;
+  /// @brief Items per run of kBlockCyclic; ignored by the other kinds.
+  std::size_t block = 1;
+  /// @brief Consecutive elements per item, e.g. the row length when the items are matrix rows.
+  std::size_t item_size = 1;
+
+  auto operator<=>(const DistributionSpec &) const = default;
+};
+
+/// @brief Element counts and displacements of every rank for one distribution, as the *v collectives take them.
+/// @details Displacements index the rank-ordered buffer: rank 0's elements, then rank 1's, and so on. For kBlock
+/// that is the global range itself; the other kinds go through Pack() and Unpack(). Plans are immutable, so one
+/// plan serves every Run() of a task with the same input size (see GetDistributionPlan()). Counts are 64-bit; the
+/// collectives of collectives.hpp pick the int-count MPI calls, the MPI-4 large-count calls or chunked transfers by
+/// MaxExtent().
+class DistributionPlan {
+ public:
+  /// @throws std::runtime_error If ranks, block or item_size is not positive.
+  explicit DistributionPlan(const DistributionSpec &spec);
+
+  [[nodiscard]] const DistributionSpec &Spec() const {
+    return spec_;
+  }
+  /// @brief Elements of the whole range: items * item_size.
+  [[nodiscard]] std::size_t TotalSize() const {
+    return spec_.items * spec_.item_size;
+  }
+  [[nodiscard]] const std::vector<std::size_t> &Counts() const {
+    return counts_;
+  }
+  [[nodiscard]] const std::vector<std::size_t> &Displacements() const {
+    return displacements_;
+  }
+  /// @brief Counts() as the int array of the classic *v collectives; empty if MaxExtent() exceeds INT_MAX.
+  [[nodiscard]] const std::vector<int> &IntCounts() const {
+    return int_counts_;
+  }
+  /// @brief Displacements() as ints; empty if MaxExtent() exceeds INT_MAX.
+  [[nodiscard]] const std::vector<int> &IntDisplacements() const {
+    return int_displacements_;
+  }
+  /// @brief Largest count or displacement of any rank, i.e. the count limit a single *v call has to accept.
+  [[nodiscard]] std::size_t MaxExtent() const {
+    return max_extent_;
+  }
+  /// @brief Elements held by @p rank.
+  [[nodiscard]] std::size_t LocalSize(int rank) const {
+    return counts_.at(rank);
+  }
+  /// @brief Whether the rank-ordered buffer is the global range, so Pack() and Unpack() are not needed.
+  [[nodiscard]] bool Contiguous() const {
+    return spec_.kind == DistributionKind::kBlock || spec_.ranks == 1;
+  }
+
+  /// @brief Rank that holds @p item.
+  [[nodiscard]] int Owner(std::size_t item) const;
+  /// @brief Global index of item @p local_item of @p rank.
+  [[nodiscard]] std::size_t GlobalItem(int rank, std::size_t local_item) const;
+
+  /// @brief Reorders the global range @p global into the rank-ordered buffer @p packed.
+  /// @throws std::runtime_error If a span is not TotalSize() long.
+  template <typename T>
+  void Pack(std::span<const T> global, std::span<T> packed) const {
+    CheckSizes(global.size(), packed.size());
+    ForEachRun([&](std::size_t global_offset, std::size_t packed_offset, std::size_t size) {
+      std::copy_n(global.begin() + static_cast<std::ptrdiff_t>(global_offset), size,
+                  packed.begin() + static_cast<std::ptrdiff_t>(packed_offset));
+    });
+  }
+
+  /// @brief Inverse of Pack().
+  template <typename T>
+  void Unpack(std::span<const T> packed, std::span<T> global) const {
+    CheckSizes(global.size(), packed.size());
+    ForEachRun([&](std::size_t global_offset, std::size_t packed_offset, std::size_t size) {
+      std::copy_n(packed.begin() + static_cast<std::ptrdiff_t>(packed_offset), size,
+                  global.begin() + static_cast<std::ptrdiff_t>(global_offset));
+    });
+  }
+
+ private:
+  /// @brief Items per round-robin run: 1 for kCyclic, block for kBlockCyclic.
+  [[nodiscard]] std::size_t RunItems() const;
+  void CheckSizes(std::size_t global_size, std::size_t packed_size) const;
+
+  /// @brief Calls @p copy(global_offset, packed_offset, size) in elements for every run of consecutive items.
+  template <typename Copy>
+  void ForEachRun(Copy copy) const {
+    if (Contiguous()) {
+      copy(0, 0, TotalSize());
+      return;
+    }
+    const std::size_t run_items = RunItems();
+    const auto ranks = static_cast<std::size_t>(spec_.ranks);
+    for (std::size_t run = 0; run * run_items < spec_.items; run++) {
+      const std::size_t first = run * run_items;
+      const std::size_t items = std::min(run_items, spec_.items - first);
+      const std::size_t local_first = (run / ranks) * run_items;
+      copy(first * spec_.item_size, displacements_[run % ranks] + (local_first * spec_.item_size),
+           items * spec_.item_size);
+    }
+  }
+
+  DistributionSpec spec_;
+  std::vector<std::size_t> counts_;
+  std::vector<std::size_t> displacements_;
+  std::vector<int> int_counts_;
+  std::vector<int> int_displacements_;
+  std::size_t max_extent_ = 0;
+};
+
+/// @brief Plan for @p spec, built on the first request and shared by later ones in this process.
+/// @details Thread-safe; the reference stays valid until the process ends.
+const DistributionPlan &GetDistributionPlan(const DistributionSpec &spec);
+
+/// @brief Cached kBlock plan of @p items items of @p item_size elements over the ranks of @p comm.
+const DistributionPlan &GetBlockPlan(std::size_t items, MPI_Comm comm, std::size_t item_size = 1);
+
+}  // namespace ppc::mpi
@@ -0,0 +1,250 @@
+#include "mpi/include/collectives.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "mpi/include/distribution.hpp"
+#include "util/include/util.hpp"
+
+namespace ppc::mpi::detail {
+
+namespace {
+
+/// MaxCount() as read from PPC_MPI_MAX_COUNT, or 0 until the first call and after ResetMaxCount().
+std::atomic<std::size_t> &CachedMaxCount() {
+  static std::atomic<std::size_t> cached{0};
+  return cached;
+}
+
+/// Largest count or displacement handed to an int-count MPI call.
+std::size_t MaxCount() {
+  auto &cached = CachedMaxCount();
+  if (const std::size_t max_count = cached.load(std::memory_order_relaxed); max_count != 0) {
+    return max_count;
+  }
+  const auto max_count = static_cast<std::size_t>(ppc::util::GetMpiMaxCount());
+  cached.store(max_count, std::memory_order_relaxed);
+  return max_count;
+}
+
+/// @p buffer advanced by @p elements elements; null and MPI_IN_PLACE stay what they are.
+const void *Offset(const void *buffer, std::size_t elements, std::size_t type_size) {
+  if (buffer == nullptr || buffer == MPI_IN_PLACE) {
+    return buffer;
+  }
+  return static_cast<const char *>(buffer) + (elements * type_size);
+}
+
+void *Offset(void *buffer, std::size_t elements, std::size_t type_size) {
+  if (buffer == nullptr || buffer == MPI_IN_PLACE) {
+    return buffer;
+  }
+  return static_cast<char *>(buffer) + (elements * type_size);
+}
+
+#if MPI_VERSION >= 4
+
+std::vector<MPI_Count> LargeCounts(const DistributionPlan &plan) {
+  return {plan.Counts().begin(), plan.Counts().end()};
+}
+
+std::vector<MPI_Aint> LargeDisplacements(const DistributionPlan &plan) {
+  return {plan.Displacements().begin(), plan.Displacements().end()};
+}
+
+#else
+
+/// Calls @p transfer(first_element, chunk_size) for consecutive chunks of at most MaxCount() elements.
+template <typename Transfer>
+void ForEachChunk(std::size_t count, Transfer transfer) {
+  const std::size_t max_count = MaxCount();
+  for (std::size_t first = 0; first < count; first += max_count) {
+    transfer(first, static_cast<int>(std::min(max_count, count - first)));
+  }
+}
+
+void CopyOwnPart(const void *from, void *to, std::size_t count, std::size_t type_size) {
+  if (count != 0 && from != MPI_IN_PLACE && to != MPI_IN_PLACE) {
+    std::memcpy(to, from, count * type_size);
+  }
+}
+
+#endif
+
+}  // namespace
+
+void Scatterv(const DistributionPlan &plan, const void *send, void *recv, MPI_Datatype type,
+              [[maybe_unused]] std::size_t type_size, int root, MPI_Comm comm) {
+  const int rank = CommRank(comm);
+  const std::size_t count = plan.Counts()[rank];
+  if (plan.MaxExtent() <= MaxCount()) {
+    MPI_Scatterv(send, plan.IntCounts().data(), plan.IntDisplacements().data(), type, recv, static_cast<int>(count),
+                 type, root, comm);
+    return;
+  }
+#if MPI_VERSION >= 4
+  const auto counts = LargeCounts(plan);
+  const auto displacements = LargeDisplacements(plan);
+  MPI_Scatterv_c(send, counts.data(), displacements.data(), type, recv, static_cast<MPI_Count>(count), type, root,
+                 comm);
+#else
+  if (rank != root) {
+    ForEachChunk(count, [&](std::size_t first, int size) {
+      MPI_Recv(Offset(recv, first, type_size), size, type, root, kChunkTag, comm, MPI_STATUS_IGNORE);
+    });
+    return;
+  }
+  for (int other = 0; other < plan.Spec().ranks; other++) {
+    const void *part = Offset(send, plan.Displacements()[other], type_size);
+    if (other == root) {
+      CopyOwnPart(part, recv, count, type_size);
+      continue;
+    }
+    ForEachChunk(plan.Counts()[other], [&](std::size_t first, int size) {
+      MPI_Send(Offset(part, first, type_size), size, type, other, kChunkTag, comm);
+    });
+  }
+#endif
+}
+
+void Gatherv(const DistributionPlan &plan, const void *send, void *recv, MPI_Datatype type,
+             [[maybe_unused]] std::size_t type_size, int root, MPI_Comm comm) {
+  const int rank = CommRank(comm);
+  const std::size_t count = plan.Counts()[rank];
+  if (plan.MaxExtent() <= MaxCount()) {
+    MPI_Gatherv(send, static_cast<int>(count), type, recv, plan.IntCounts().data(), plan.IntDisplacements().data(),
+                type, root, comm);
+    return;
+  }
+#if MPI_VERSION >= 4
+  const auto counts = LargeCounts(plan);
+  const auto displacements = LargeDisplacements(plan);
+  MPI_Gatherv_c(send, static_cast<MPI_Count>(count), type, recv, counts.data(), displacements.data(), type, root,
+                comm);
+#else
+  if (rank != root) {
+    ForEachChunk(count, [&](std::size_t first, int size) {
+      MPI_Send(Offset(send, first, type_size), size, type, root, kChunkTag, comm);
+    });
+    return;
+  }
+  for (int other = 0; other < plan.Spec().ranks; other++) {
+    void *part = Offset(recv, plan.Displacements()[other], type_size);
+    if (other == root) {
+      CopyOwnPart(send, part, count, type_size);
+      continue;
+    }
+    ForEachChunk(plan.Counts()[other], [&](std::size_t first, int size) {
+      MPI_Recv(Offset(part, first, type_size), size, type, other, kChunkTag, comm, MPI_STATUS_IGNORE);
+    });
+  }
+#endif
+}
+
+void Allgatherv(const DistributionPlan &plan, const void *send, void *recv, MPI_Datatype type,
+                [[maybe_unused]] std::size_t type_size, MPI_Comm comm) {
+  const int rank = CommRank(comm);
+  const std::size_t count = plan.Counts()[rank];
+  if (plan.MaxExtent() <= MaxCount()) {
+    MPI_Allgatherv(send, static_cast<int>(count), type, recv, plan.IntCounts().data(), plan.IntDisplacements().data(),
+                   type, comm);
+    return;
+  }
+#if MPI_VERSION >= 4
+  const auto counts = LargeCounts(plan);
+  const auto displacements = LargeDisplacements(plan);
+  MPI_Allgatherv_c(send, static_cast<MPI_Count>(count), type, recv, counts.data(), displacements.data(), type, comm);
+#else
+  // In place means the part already sits in recv, which Gatherv() only accepts on its root
+  const void *own = (send == MPI_IN_PLACE && rank != 0) ? Offset(recv, plan.Displacements()[rank], type_size) : send;
+  Gatherv(plan, own, recv, type, type_size, 0, comm);
+  Bcast(recv, plan.TotalSize(), type, type_size, 0, comm);
+#endif
+}
+
+void Reduce(const void *send, void *recv, std::size_t count, MPI_Datatype type, [[maybe_unused]] std::size_t type_size,
+            MPI_Op op, int root, MPI_Comm comm) {
+  if (count <= MaxCount()) {
+    MPI_Reduce(send, recv, static_cast<int>(count), type, op, root, comm);
+    return;
+  }
+#if MPI_VERSION >= 4
+  MPI_Reduce_c(send, recv, static_cast<MPI_Count>(count), type, op, root, comm);
+#else
+  ForEachChunk(count, [&](std::size_t first, int size) {
+    MPI_Reduce(Offset(send, first, type_size), Offset(recv, first, type_size), size, type, op, root, comm);
+  });
+#endif
+}
+
+void Allreduce(const void *send, void *recv, std::size_t count, MPI_Datatype type,
+               [[maybe_unused]] std::size_t type_size, MPI_Op op, MPI_Comm comm) {
+  if (count <= MaxCount()) {
+    MPI_Allreduce(send, recv, static_cast<int>(count), type, op, comm);
+    return;
+  }
+#if MPI_VERSION >= 4
+  MPI_Allreduce_c(send, recv, static_cast<MPI_Count>(count), type, op, comm);
+#else
+  ForEachChunk(count, [&](std::size_t first, int size) {
+    MPI_Allreduce(Offset(send, first, type_size), Offset(recv, first, type_size), size, type, op, comm);
+  });
+#endif
+}
+
+void Bcast(void *data, std::size_t count, MPI_Datatype type, [[maybe_unused]] std::size_t type_size, int root,
+           MPI_Comm comm) {
+  if (count <= MaxCount()) {
+    MPI_Bcast(data, static_cast<int>(count), type, root, comm);
+    return;
+  }
+#if MPI_VERSION >= 4
+  MPI_Bcast_c(data, static_cast<MPI_Count>(count), type, root, comm);
+#else
+  ForEachChunk(count, [&](std::size_t first, int size) {
+    MPI_Bcast(Offset(data, first, type_size), size, type, root, comm);
+  });
+#endif
+}
+
+void Send(const void *data, std::size_t count, MPI_Datatype type, [[maybe_unused]] std::size_t type_size, int dest,
+          int tag, MPI_Comm comm) {
+  if (count <= MaxCount()) {
+    MPI_Send(data, static_cast<int>(count), type, dest, tag, comm);
+    return;
+  }
+#if MPI_VERSION >= 4
+  MPI_Send_c(data, static_cast<MPI_Count>(count), type, dest, tag, comm);
+#else
+  // Messages between two ranks with one tag are not overtaken, so the chunks arrive in order
+  ForEachChunk(count, [&](std::size_t first, int size) {
+    MPI_Send(Offset(data, first, type_size), size, type, dest, tag, comm);
+  });
+#endif
+}
+
+void Recv(void *data, std::size_t count, MPI_Datatype type, [[maybe_unused]] std::size_t type_size, int source,
+          int tag, MPI_Comm comm) {
+  if (count <= MaxCount()) {
+    MPI_Recv(data, static_cast<int>(count), type, source, tag, comm, MPI_STATUS_IGNORE);
+    return;
+  }
+#if MPI_VERSION >= 4
+  MPI_Recv_c(data, static_cast<MPI_Count>(count), type, source, tag, comm, MPI_STATUS_IGNORE);
+#else
+  ForEachChunk(count, [&](std::size_t first, int size) {
+    MPI_Recv(Offset(data, first, type_size), size, type, source, tag, comm, MPI_STATUS_IGNORE);
+  });
+#endif
+}
+
+}  // namespace ppc::mpi::detail
+
+void ppc::mpi::ResetMaxCount() {
+  detail::CachedMaxCount().store(0, std::memory_order_relaxed);
+}
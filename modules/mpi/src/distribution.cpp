@@ -0,0 +1,108 @@
+#include "mpi/include/distribution.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ppc::mpi {
+
+DistributionPlan::DistributionPlan(const DistributionSpec &spec) : spec_(spec) {
+  if (spec_.ranks < 1 || spec_.block < 1 || spec_.item_size < 1) {
+    throw std::runtime_error("A distribution needs a positive rank count, block and item size");
+  }
+  const auto ranks = static_cast<std::size_t>(spec_.ranks);
+  std::vector<std::size_t> items(ranks, 0);
+  if (spec_.kind == DistributionKind::kBlock) {
+    for (std::size_t rank = 0; rank < ranks; rank++) {
+      items[rank] = (spec_.items / ranks) + (rank < spec_.items % ranks ? 1 : 0);
+    }
+  } else {
+    // Whole rounds of runs, then the partial round: full runs, one shorter run and nothing for the rest
+    const std::size_t run_items = RunItems();
+    const std::size_t round_items = run_items * ranks;
+    const std::size_t rest = spec_.items % round_items;
+    for (std::size_t rank = 0; rank < ranks; rank++) {
+      items[rank] = ((spec_.items / round_items) * run_items) +
+                    std::min(run_items, rest > rank * run_items ? rest - (rank * run_items) : 0);
+    }
+  }
+
+  counts_.resize(ranks);
+  displacements_.resize(ranks);
+  std::size_t offset = 0;
+  for (std::size_t rank = 0; rank < ranks; rank++) {
+    counts_[rank] = items[rank] * spec_.item_size;
+    displacements_[rank] = offset;
+    max_extent_ = std::max({max_extent_, counts_[rank], offset});
+    offset += counts_[rank];
+  }
+  if (max_extent_ <= static_cast<std::size_t>(INT_MAX)) {
+    int_counts_.assign(counts_.begin(), counts_.end());
+    int_displacements_.assign(displacements_.begin(), displacements_.end());
+  }
+}
+
+std::size_t DistributionPlan::RunItems() const {
+  return spec_.kind == DistributionKind::kBlockCyclic ? spec_.block : 1;
+}
+
+int DistributionPlan::Owner(std::size_t item) const {
+  if (item >= spec_.items) {
+    throw std::runtime_error("Item " + std::to_string(item) + " is outside the distributed range");
+  }
+  const auto ranks = static_cast<std::size_t>(spec_.ranks);
+  if (spec_.kind != DistributionKind::kBlock) {
+    return static_cast<int>((item / RunItems()) % ranks);
+  }
+  // The first `extra` ranks hold base + 1 items
+  const std::size_t base = spec_.items / ranks;
+  const std::size_t extra = spec_.items % ranks;
+  if (item < extra * (base + 1)) {
+    return static_cast<int>(item / (base + 1));
+  }
+  return static_cast<int>(extra + ((item - (extra * (base + 1))) / base));
+}
+
+std::size_t DistributionPlan::GlobalItem(int rank, std::size_t local_item) const {
+  if (spec_.kind == DistributionKind::kBlock) {
+    return (displacements_.at(rank) / spec_.item_size) + local_item;
+  }
+  const std::size_t run_items = RunItems();
+  const std::size_t run = ((local_item / run_items) * static_cast<std::size_t>(spec_.ranks)) +
+                          static_cast<std::size_t>(rank);
+  return (run * run_items) + (local_item % run_items);
+}
+
+void DistributionPlan::CheckSizes(std::size_t global_size, std::size_t packed_size) const {
+  if (global_size != TotalSize() || packed_size != TotalSize()) {
+    throw std::runtime_error("Pack and Unpack need buffers of " + std::to_string(TotalSize()) + " elements");
+  }
+}
+
+const DistributionPlan &GetDistributionPlan(const DistributionSpec &spec) {
+  static std::mutex mutex;
+  static std::map<DistributionSpec, std::unique_ptr<const DistributionPlan>> plans;
+  const std::scoped_lock lock(mutex);
+  auto &plan = plans[spec];
+  if (!plan) {
+    plan = std::make_unique<const DistributionPlan>(spec);
+  }
+  return *plan;
+}
+
+const DistributionPlan &GetBlockPlan(std::size_t items, MPI_Comm comm, std::size_t item_size) {
+  int ranks = 1;
+  MPI_Comm_size(comm, &ranks);
+  return GetDistributionPlan(
+      {.kind = DistributionKind::kBlock, .items = items, .ranks = ranks, .block = 1, .item_size = item_size});
+}
+
+}  // namespace ppc::mpi
@@ -0,0 +1,144 @@
+#include "mpi/include/distribution.hpp"
+
+#include <gtest/gtest.h>
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mpi/include/collectives.hpp"
+
+namespace {
+
+using ppc::mpi::DistributionKind;
+using ppc::mpi::DistributionPlan;
+using ppc::mpi::DistributionSpec;
+
+/// Items of every rank in rank order, computed one item at a time from Owner().
+std::vector<std::vector<std::size_t>> ItemsByOwner(const DistributionPlan &plan) {
+  std::vector<std::vector<std::size_t>> items(plan.Spec().ranks);
+  for (std::size_t item = 0; item < plan.Spec().items; item++) {
+    items[plan.Owner(item)].push_back(item);
+  }
+  return items;
+}
+
+}  // namespace
+
+TEST(DistributionPlan, BlockSpreadsTheRemainderOverTheFirstRanks) {
+  const DistributionPlan plan({.kind = DistributionKind::kBlock, .items = 10, .ranks = 4, .block = 1, .item_size = 3});
+  EXPECT_EQ(plan.Counts(), (std::vector<std::size_t>{9, 9, 6, 6}));
+  EXPECT_EQ(plan.Displacements(), (std::vector<std::size_t>{0, 9, 18, 24}));
+  EXPECT_EQ(plan.IntCounts(), (std::vector<int>{9, 9, 6, 6}));
+  EXPECT_EQ(plan.MaxExtent(), 24U);
+  EXPECT_TRUE(plan.Contiguous());
+  EXPECT_EQ(plan.Owner(5), 1);
+  EXPECT_EQ(plan.Owner(6), 2);
+  EXPECT_EQ(plan.GlobalItem(3, 1), 9U);
+
+  const DistributionPlan few({.kind = DistributionKind::kBlock, .items = 2, .ranks = 5, .block = 1, .item_size = 1});
+  EXPECT_EQ(few.Counts(), (std::vector<std::size_t>{1, 1, 0, 0, 0}));
+  EXPECT_EQ(few.Owner(1), 1);
+}
+
+TEST(DistributionPlan, CyclicAndBlockCyclicDealRunsRoundRobin) {
+  const DistributionPlan cyclic(
+      {.kind = DistributionKind::kCyclic, .items = 7, .ranks = 3, .block = 1, .item_size = 1});
+  EXPECT_EQ(cyclic.Counts(), (std::vector<std::size_t>{3, 2, 2}));
+  EXPECT_EQ(ItemsByOwner(cyclic)[0], (std::vector<std::size_t>{0, 3, 6}));
+  EXPECT_FALSE(cyclic.Contiguous());
+
+  const DistributionPlan block_cyclic(
+      {.kind = DistributionKind::kBlockCyclic, .items = 11, .ranks = 3, .block = 2, .item_size = 1});
+  // Runs {0,1} {2,3} {4,5} | {6,7} {8,9} {10}
+  EXPECT_EQ(block_cyclic.Counts(), (std::vector<std::size_t>{4, 4, 3}));
+  EXPECT_EQ(ItemsByOwner(block_cyclic)[2], (std::vector<std::size_t>{4, 5, 10}));
+}
+
+TEST(DistributionPlan, GlobalItemAndOwnerAgreeForEveryKind) {
+  for (const auto kind : {DistributionKind::kBlock, DistributionKind::kCyclic, DistributionKind::kBlockCyclic}) {
+    for (const std::size_t items : std::vector<std::size_t>{0, 1, 5, 16, 37}) {
+      for (const int ranks : {1, 2, 3, 8}) {
+        const DistributionPlan plan({.kind = kind, .items = items, .ranks = ranks, .block = 3, .item_size = 1});
+        SCOPED_TRACE("kind " + std::to_string(static_cast<int>(kind)) + " items " + std::to_string(items) +
+                     " ranks " + std::to_string(ranks));
+        const auto by_owner = ItemsByOwner(plan);
+        for (int rank = 0; rank < ranks; rank++) {
+          ASSERT_EQ(by_owner[rank].size(), plan.LocalSize(rank));
+          for (std::size_t local = 0; local < by_owner[rank].size(); local++) {
+            EXPECT_EQ(plan.GlobalItem(rank, local), by_owner[rank][local]);
+          }
+        }
+        EXPECT_EQ(std::accumulate(plan.Counts().begin(), plan.Counts().end(), std::size_t{0}), items);
+      }
+    }
+  }
+}
+
+TEST(DistributionPlan, PackOrdersElementsByRankAndUnpackRestoresThem) {
+  const DistributionPlan plan(
+      {.kind = DistributionKind::kBlockCyclic, .items = 5, .ranks = 2, .block = 2, .item_size = 2});
+  std::vector<int> global(plan.TotalSize());
+  std::iota(global.begin(), global.end(), 0);
+  std::vector<int> packed(plan.TotalSize());
+  plan.Pack(std::span<const int>(global), std::span<int>(packed));
+  // Rank 0 holds items 0, 1 and 4, rank 1 items 2 and 3; two elements per item
+  EXPECT_EQ(packed, (std::vector<int>{0, 1, 2, 3, 8, 9, 4, 5, 6, 7}));
+
+  std::vector<int> restored(plan.TotalSize());
+  plan.Unpack(std::span<const int>(packed), std::span<int>(restored));
+  EXPECT_EQ(restored, global);
+  EXPECT_THROW(plan.Pack(std::span<const int>(global), std::span<int>(packed).first(3)), std::runtime_error);
+}
+
+TEST(DistributionPlan, RejectsInvalidSpecs) {
+  const DistributionSpec no_ranks{.kind = DistributionKind::kBlock, .items = 4, .ranks = 0, .block = 1, .item_size = 1};
+  EXPECT_THROW(DistributionPlan{no_ranks}, std::runtime_error);
+  const DistributionSpec empty_blocks{
+      .kind = DistributionKind::kBlockCyclic, .items = 4, .ranks = 2, .block = 0, .item_size = 1};
+  EXPECT_THROW(DistributionPlan{empty_blocks}, std::runtime_error);
+}
+
+TEST(DistributionPlan, CountsBeyondIntMaxStayExact) {
+  // 2^33 + 3 rows of 2 elements over 3 ranks: every count and the later displacements exceed INT_MAX
+  const std::size_t items = (std::size_t{1} << 33U) + 3;
+  const DistributionPlan plan(
+      {.kind = DistributionKind::kBlock, .items = items, .ranks = 3, .block = 1, .item_size = 2});
+  const std::size_t base = items / 3;
+  EXPECT_EQ(plan.Counts(), (std::vector<std::size_t>{2 * (base + 1), 2 * (base + 1), 2 * base}));
+  EXPECT_EQ(plan.Displacements().back(), 4 * (base + 1));
+  EXPECT_EQ(plan.MaxExtent(), plan.Displacements().back());
+  EXPECT_EQ(plan.TotalSize(), 2 * items);
+  EXPECT_TRUE(plan.IntCounts().empty());
+  EXPECT_EQ(plan.Owner(items - 1), 2);
+  EXPECT_EQ(plan.GlobalItem(2, base - 1), items - 1);
+
+  const DistributionPlan cyclic(
+      {.kind = DistributionKind::kCyclic, .items = items, .ranks = 2, .block = 1, .item_size = 1});
+  EXPECT_EQ(cyclic.LocalSize(0), (items / 2) + 1);
+  EXPECT_EQ(cyclic.GlobalItem(1, (items / 2) - 1), items - 2);
+}
+
+TEST(DistributionPlan, CachesPlansPerSpec) {
+  const DistributionSpec spec{.kind = DistributionKind::kCyclic, .items = 100, .ranks = 4, .block = 1, .item_size = 1};
+  const auto &plan = ppc::mpi::GetDistributionPlan(spec);
+  EXPECT_EQ(&ppc::mpi::GetDistributionPlan(spec), &plan);
+  auto other = spec;
+  other.items = 101;
+  EXPECT_NE(&ppc::mpi::GetDistributionPlan(other), &plan);
+}
+
+TEST(MpiDatatype, MapsArithmeticTypesAtCompileTime) {
+  static_assert(ppc::mpi::MpiType<double>);
+  static_assert(ppc::mpi::MpiType<const uint8_t>);
+  static_assert(!ppc::mpi::MpiType<std::string>);
+  EXPECT_EQ(ppc::mpi::GetDatatype<int>(), MPI_INT);
+  EXPECT_EQ(ppc::mpi::GetDatatype<double>(), MPI_DOUBLE);
+  EXPECT_EQ(ppc::mpi::GetDatatype<unsigned long long>(), MPI_UNSIGNED_LONG_LONG);
+  EXPECT_EQ(ppc::mpi::GetDatatype<char>(), MPI_CHAR);
+}
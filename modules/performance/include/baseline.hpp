@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json_fwd.hpp"
+
+namespace ppc::performance {
+
+/// @brief Significance level below which a slowdown against the baseline is considered real.
+inline constexpr double kRegressionAlpha = 0.01;
+
+/// @brief Samples per run needed on both sides before the test can reach kRegressionAlpha at all.
+inline constexpr uint64_t kMinBaselineSamples = 8;
+
+/// @brief One-sided Mann-Whitney U test outcome.
+struct MannWhitneyResult {
+  /// @brief U statistic of the first sample.
+  double u = 0.0;
+  /// @brief Standard score of U under the null hypothesis (tie and continuity corrected).
+  double z = 0.0;
+  /// @brief Probability of a U at least this large when both samples come from one distribution.
+  double p_value = 1.0;
+};
+
+/// @brief Tests whether values of @p current tend to be larger than values of @p baseline.
+/// @details Uses average ranks for ties and the normal approximation of U.
+MannWhitneyResult MannWhitneyGreater(const std::vector<double> &current, const std::vector<double> &baseline);
+
+/// @brief Comparison of current perf samples against stored baseline samples.
+struct RegressionCheck {
+  double baseline_median = 0.0;
+  double current_median = 0.0;
+  /// @brief Relative change of the median time, e.g. 0.1 for 10% slower.
+  double slowdown = 0.0;
+  double p_value = 1.0;
+  /// @brief True when the slowdown exceeds the threshold and is statistically significant.
+  bool regressed = false;
+};
+
+/// @brief Flags a regression when the median slows down by more than @p threshold with p < @p alpha.
+RegressionCheck CheckRegression(const std::vector<double> &current, const std::vector<double> &baseline,
+                                double threshold, double alpha = kRegressionAlpha);
+
+/// @brief Identity of a baseline: one file per task, implementation, mode and parallel configuration.
+struct BaselineKey {
+  std::string task;
+  std::string implementation;
+  std::string mode;
+  int threads = 1;
+  int processes = 1;
+  /// @brief Input scale of the run (PPC_PERF_SCALE / PPC_PERF_SCALES).
+  double scale = 1.0;
+  /// @brief Cache state of the timed iterations (PPC_PERF_CACHE), "warm" or "cold".
+  std::string cache = "warm";
+  /// @brief Distribution of the input values (PPC_PERF_DISTRIBUTION); empty when the suite does not use one.
+  std::string distribution = {};
+};
+
+/// @brief Returns a name-safe tag of an input scale: empty for 1, otherwise e.g. "x10" or "x0p5".
+std::string GetScaleTag(double scale);
+
+/// @brief Returns the baseline file of @p key:
+/// `<dir>/<task>/<implementation>_<mode>_t<threads>_p<processes>[_<scale tag>][_<distribution>][_cold].json`.
+std::filesystem::path GetBaselinePath(const std::filesystem::path &dir, const BaselineKey &key);
+
+/// @brief Reads the samples of a stored perf record; nullopt if the file is missing or has no samples.
+std::optional<std::vector<double>> LoadBaselineSamples(const std::filesystem::path &path);
+
+/// @brief Stores a perf record as the new baseline, creating parent directories as needed.
+void SaveBaseline(const std::filesystem::path &path, const nlohmann::json &record);
+
+}  // namespace ppc::performance
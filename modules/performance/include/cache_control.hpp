@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ppc::performance {
+
+/// @brief Cache state every timed perf iteration starts from.
+enum class CacheState : uint8_t {
+  /// Iterations follow each other, so the working set stays cached after the first one.
+  kWarm,
+  /// The caches are flushed before every iteration, as for a request that arrives after unrelated work.
+  kCold,
+};
+
+/// @brief Returns "warm" or "cold".
+std::string GetCacheStateName(CacheState state);
+
+/// @brief Size of the largest CPU cache reported by Linux sysfs; 0 when it cannot be determined.
+std::size_t DetectLastLevelCacheBytes();
+
+/// @brief Evicts the task's data from the caches by streaming over a buffer larger than the last-level cache.
+/// @details Writes every cache line of the buffer, which also pushes dirty lines of the task out to memory. Only the
+/// caches of the calling core and the shared last-level cache are affected; on CPUs whose last-level cache is not
+/// inclusive, private caches of other cores may keep some of their lines.
+class CacheFlusher {
+ public:
+  /// @param bytes Buffer size; 0 picks twice the detected last-level cache size, or 64 MiB if it is unknown.
+  explicit CacheFlusher(std::size_t bytes = 0);
+
+  void Flush();
+
+  [[nodiscard]] std::size_t GetBytes() const {
+    return buffer_.size();
+  }
+
+ private:
+  std::vector<uint8_t> buffer_;
+};
+
+}  // namespace ppc::performance
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "nlohmann/json_fwd.hpp"
+
+namespace ppc::performance {
+
+/// @brief Sustained memory bandwidth of the four STREAM kernels, in bytes per second.
+struct StreamBandwidth {
+  /// @brief c[i] = a[i]
+  double copy = 0.0;
+  /// @brief b[i] = q * c[i]
+  double scale = 0.0;
+  /// @brief c[i] = a[i] + b[i]
+  double add = 0.0;
+  /// @brief a[i] = b[i] + q * c[i]; the bandwidth roofline positions are measured against.
+  double triad = 0.0;
+};
+
+/// @brief Memory, compute and interconnect limits of one host at one degree of parallelism.
+struct MachineCalibration {
+  std::string hostname;
+  std::string cpu_model;
+  /// @brief Concurrent workers (threads, or processes times threads) the limits were measured with.
+  int workers = 1;
+  StreamBandwidth stream;
+  /// @brief Double-precision operations per second of independent multiply-add chains.
+  double peak_flops = 0.0;
+  /// @brief Half round trip of an 8-byte MPI message between ranks 0 and 1; NaN if measured on a single process.
+  double mpi_latency_sec = 0.0;
+  /// @brief Bandwidth of 4 MiB MPI messages between ranks 0 and 1; NaN if measured on a single process.
+  double mpi_bandwidth = 0.0;
+  /// @brief Seconds since the epoch when the limits were measured.
+  int64_t timestamp = 0;
+};
+
+/// @brief Runs the STREAM kernels on @p workers OpenMP threads, keeping the best of several repetitions.
+/// @param elements Length of each of the three arrays; 0 picks four times the last-level cache per array.
+StreamBandwidth MeasureStreamBandwidth(int workers, std::size_t elements = 0);
+
+/// @brief Measures double-precision multiply-add throughput on @p workers OpenMP threads.
+/// @details Uses independent dependency chains the compiler can keep in registers and vectorize, so the result is
+/// the peak reachable by portable code built with the project's flags rather than the data sheet peak.
+double MeasurePeakFlops(int workers);
+
+/// @brief Latency and bandwidth of MPI messages between ranks 0 and 1 of MPI_COMM_WORLD.
+struct PingPong {
+  double latency_sec = 0.0;
+  double bandwidth = 0.0;
+};
+
+/// @brief Measures ping-pong between ranks 0 and 1; collective over MPI_COMM_WORLD, NaN on a single process.
+PingPong MeasureMpiPingPong();
+
+nlohmann::json CalibrationToJson(const MachineCalibration &calibration);
+/// @brief Parses a stored calibration; nullopt if required fields are missing.
+std::optional<MachineCalibration> CalibrationFromJson(const nlohmann::json &json);
+
+/// @brief Returns `<dir>/<hostname>_w<workers>.json`.
+std::filesystem::path GetCalibrationPath(const std::filesystem::path &dir, const std::string &hostname, int workers);
+
+/// @brief Limits of this host at @p workers, measured once and stored under @p dir (not stored if @p dir is empty).
+/// @details Collective over MPI_COMM_WORLD; rank 0's @p workers is used. Rank 0 loads the stored calibration or runs
+/// the STREAM and FLOP kernels while the other ranks wait without spinning, then the ping-pong is added if the run
+/// has several processes and the stored calibration had none. Results are kept for the rest of the process.
+const MachineCalibration &GetMachineCalibration(const std::filesystem::path &dir, int workers);
+
+/// @brief Position of a measured run relative to the calibrated limits.
+struct RooflinePoint {
+  /// @brief Input bytes over the median time: a lower bound of the memory traffic.
+  double bytes_per_sec = 0.0;
+  /// @brief bytes_per_sec over STREAM triad bandwidth.
+  double stream_fraction = 0.0;
+  /// @brief Operations per input byte; NaN when the operation count is unknown.
+  double intensity = 0.0;
+  double flops_per_sec = 0.0;
+  /// @brief min(peak_flops, intensity * STREAM triad): the roofline at this intensity.
+  double attainable_flops = 0.0;
+  /// @brief flops_per_sec over attainable_flops.
+  double roofline_fraction = 0.0;
+  /// @brief "memory" left of the ridge point, "compute" right of it, empty when the intensity is unknown.
+  std::string bound;
+};
+
+/// @brief Places a run that moved @p bytes (and performed @p flops, if known) in @p seconds on the roofline.
+RooflinePoint ComputeRoofline(double bytes, std::optional<double> flops, double seconds,
+                              const MachineCalibration &calibration);
+
+/// @brief Serializes a roofline point together with the limits it is relative to.
+nlohmann::json RooflineToJson(const RooflinePoint &point, const MachineCalibration &calibration);
+
+/// @brief Formats a roofline point as space-separated key=value pairs.
+std::string FormatRoofline(const RooflinePoint &point);
+
+}  // namespace ppc::performance
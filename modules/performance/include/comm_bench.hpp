@@ -0,0 +1,92 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json_fwd.hpp"
+#include "performance/include/performance.hpp"
+
+namespace ppc::performance {
+
+/// @brief Communication patterns the tasks implement by hand, each with a native MPI equivalent.
+enum class CommPattern : uint8_t {
+  /// Binomial tree broadcast (morozova_s_broadcast) vs MPI_Bcast.
+  kBcast,
+  /// Dimension-exchange sum towards rank 0 (likhanov_m_hypercube) vs MPI_Reduce.
+  kReduce,
+  /// Binary tree collection of variable-size blocks (sabutay_a_radix_sort_double_with_merge) vs MPI_Gatherv.
+  kGather,
+};
+
+std::string GetCommPatternName(CommPattern pattern);
+/// @throws std::runtime_error For names other than bcast, reduce and gather.
+CommPattern ParseCommPattern(const std::string &name);
+
+/// @brief Hand-written implementation of a pattern, registered by the task it comes from, so that the benchmark
+/// runs the task's own code.
+/// @details Only the member of the registered pattern is set.
+struct CustomCollective {
+  /// @brief Task directory, e.g. "morozova_s_broadcast".
+  std::string task;
+  /// @cond
+  /// Broadcast of @p block from rank 0.
+  std::function<void(std::vector<char> &block, MPI_Comm comm)> bcast = {};
+  /// Element-wise sum of every rank's @p values into rank 0's @p values.
+  std::function<void(std::vector<uint64_t> &values, MPI_Comm comm)> reduce = {};
+  /// Every rank's @p part in rank order, returned on rank 0.
+  std::function<std::vector<double>(std::vector<double> part, MPI_Comm comm)> gather = {};
+  /// @endcond
+};
+
+/// @brief Custom implementations by pattern, registered by the tests/comm_bench sources of the tasks.
+std::map<CommPattern, CustomCollective> &CustomCollectiveRegistry();
+
+/// @brief Registers @p collective as the custom implementation of @p pattern.
+/// @return true, so that the registration can initialize a namespace-scope constant.
+/// @throws std::runtime_error If the pattern is already registered.
+bool RegisterCustomCollective(CommPattern pattern, CustomCollective collective);
+
+/// @brief Latency and bandwidth of one implementation of a pattern at one message size and rank count.
+struct CommBenchPoint {
+  CommPattern pattern = CommPattern::kBcast;
+  /// @brief "custom" or "native".
+  std::string implementation;
+  /// @brief Task the custom implementation comes from; empty for the native one.
+  std::string task;
+  int ranks = 1;
+  /// @brief Bytes broadcast, reduced per rank, or gathered in total on rank 0 (whole doubles, like the radix sort).
+  std::size_t bytes = 0;
+  /// @brief Slowest rank's time of each iteration, in seconds.
+  std::vector<double> samples;
+  PerfStatistics stats;
+  /// @brief @ref bytes over the median time.
+  double bandwidth = 0.0;
+  /// @brief Whether the result equals that of the native implementation; empty when not checked.
+  std::optional<bool> matches;
+};
+
+/// @brief Timed iterations for a message of @p bytes: enough to move about 64 MiB, within [min, max].
+std::size_t GetCommBenchIterations(std::size_t bytes, std::size_t min_iterations = 5,
+                                   std::size_t max_iterations = 1000);
+
+/// @brief Times @p iterations runs (after one warmup) of the custom or native implementation of @p pattern.
+/// @details Collective over @p comm. Every iteration starts after a barrier and lasts until the slowest rank
+/// finishes. With @p check, the custom result is compared once with the native one.
+/// @throws std::runtime_error For a custom run of a pattern no task registered.
+CommBenchPoint MeasureCommPattern(CommPattern pattern, bool custom, std::size_t bytes, std::size_t iterations,
+                                  MPI_Comm comm, bool check = true);
+
+/// @brief Serializes a point as a ppc.comm_bench.v1 record.
+nlohmann::json CommBenchPointToJson(const CommBenchPoint &point);
+
+/// @brief Median time of the native implementation over that of the custom one: above 1 when the custom one wins.
+double CommBenchSpeedup(const CommBenchPoint &custom, const CommBenchPoint &native);
+
+}  // namespace ppc::performance
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ppc::performance {
+
+/// @brief One RAPL energy counter of the node.
+struct EnergyZone {
+  /// @brief Zone name from sysfs, e.g. "package-0" or "dram".
+  std::string name;
+  std::filesystem::path energy_file;
+  /// @brief Value at which the counter wraps around to zero, in microjoules.
+  uint64_t max_range_uj = 0;
+};
+
+/// @brief Energy consumed between two readings of a counter that wraps at @p max_range_uj.
+/// @details A counter that went backwards is assumed to have wrapped exactly once; RAPL counters wrap after
+/// minutes at full load, far longer than one perf iteration.
+uint64_t EnergyDeltaMicrojoules(uint64_t begin, uint64_t end, uint64_t max_range_uj);
+
+/// @brief Energy of the timed iterations.
+struct EnergyStats {
+  /// @brief True if every node the run used reported energy.
+  bool available = false;
+  /// @brief Mean energy per iteration in joules, summed over nodes.
+  double joules = 0.0;
+  /// @brief Energy over the summed iteration time.
+  double avg_watts = 0.0;
+  /// @brief Energy-delay product per iteration (joules times mean iteration seconds); lower is better.
+  double edp = 0.0;
+  /// @brief Comma-separated zone names that were summed.
+  std::string zones;
+};
+
+/// @brief Derives per-iteration energy, average power and EDP from the energy of all @p samples.
+/// @details A non-finite @p total_joules marks the energy as unavailable.
+EnergyStats ComputeEnergyStats(double total_joules, const std::vector<double> &samples, const std::string &zones);
+
+/// @brief Reads the node's energy counters through the Linux powercap interface (/sys/class/powercap).
+/// @details Uses the package zones of the RAPL driver, which also serves AMD processors since Linux 5.8, plus their
+/// DRAM subzones, which packages do not include. Core and uncore subzones are part of the package and skipped, as are
+/// the duplicate MMIO zones. Without packages the platform (psys) zone is used. RAPL counts the whole socket, so
+/// readings include every process on the node. The counters are root-only readable since Linux 5.10; when no zone can
+/// be read the meter reports itself unavailable and Read() returns empty readings instead of failing.
+class EnergyMeter {
+ public:
+  explicit EnergyMeter(const std::filesystem::path &powercap_root = "/sys/class/powercap");
+
+  [[nodiscard]] bool IsAvailable() const {
+    return !zones_.empty();
+  }
+  /// @brief Explains why no zone can be read; empty when available.
+  [[nodiscard]] const std::string &GetUnavailableReason() const {
+    return unavailable_reason_;
+  }
+  [[nodiscard]] const std::vector<EnergyZone> &GetZones() const {
+    return zones_;
+  }
+  /// @brief Comma-separated names of the zones.
+  [[nodiscard]] std::string GetZoneNames() const;
+
+  /// @brief Current counter of every zone in microjoules.
+  [[nodiscard]] std::vector<uint64_t> Read() const;
+  /// @brief Joules consumed by all zones between two readings, accounting for wraparound.
+  [[nodiscard]] double JoulesBetween(const std::vector<uint64_t> &begin, const std::vector<uint64_t> &end) const;
+
+ private:
+  std::vector<EnergyZone> zones_;
+  std::string unavailable_reason_;
+};
+
+}  // namespace ppc::performance
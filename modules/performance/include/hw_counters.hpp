@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ppc::performance {
+
+/// @brief Hardware events sampled by HwCounterGroup.
+enum class HwCounter : uint8_t {
+  kCycles,
+  kInstructions,
+  kLlcMisses,
+  kBranchMisses,
+  kDtlbMisses,
+};
+
+inline constexpr std::size_t kHwCounterCount = 5;
+
+/// @brief Returns a short lowercase name of the hardware counter.
+inline std::string GetHwCounterName(HwCounter counter) {
+  switch (counter) {
+    case HwCounter::kCycles:
+      return "cycles";
+    case HwCounter::kInstructions:
+      return "instructions";
+    case HwCounter::kLlcMisses:
+      return "llc_misses";
+    case HwCounter::kBranchMisses:
+      return "branch_misses";
+    case HwCounter::kDtlbMisses:
+      return "dtlb_misses";
+  }
+  return "unknown";
+}
+
+/// @brief Counter readings for one measured region.
+struct HwCounterValues {
+  /// @brief Event counts, scaled when the kernel multiplexed the counters.
+  std::array<double, kHwCounterCount> values{};
+  /// @brief Whether the corresponding event could be opened and read.
+  std::array<bool, kHwCounterCount> valid{};
+  /// @brief Threads whose counters were read; 0 when unknown.
+  std::size_t threads = 0;
+
+  [[nodiscard]] double Get(HwCounter counter) const {
+    return values[static_cast<std::size_t>(counter)];
+  }
+  [[nodiscard]] bool IsValid(HwCounter counter) const {
+    return valid[static_cast<std::size_t>(counter)];
+  }
+};
+
+/// @brief Per-iteration means and derived metrics over hardware counter samples.
+struct HwCounterStats {
+  /// @brief True if at least one counter produced data.
+  bool available = false;
+  /// @brief Mean event counts per iteration.
+  HwCounterValues mean;
+  /// @brief Instructions per cycle.
+  double ipc = 0.0;
+  /// @brief Last-level cache misses per 1000 instructions.
+  double llc_mpki = 0.0;
+  /// @brief Branch mispredictions per 1000 instructions.
+  double branch_mpki = 0.0;
+  /// @brief Data TLB misses per 1000 instructions.
+  double dtlb_mpki = 0.0;
+  /// @brief Most threads covered by one sample; 0 when unknown.
+  std::size_t threads = 0;
+};
+
+/// @brief Averages counter samples and derives IPC and per-kilo-instruction miss rates.
+HwCounterStats ComputeHwCounterStats(const std::vector<HwCounterValues> &samples);
+
+/// @brief Group of per-process hardware counters backed by Linux perf_event_open.
+/// @details Every event is opened for each thread of the process (user space only), and Stop() sums the threads.
+/// The thread list is taken from /proc/self/task when the group is built and again at every Start(), which also
+/// closes the events of exited threads, so worker pools started by earlier runs are covered. Events are not
+/// inherited: a thread created during a sample is counted from the next sample on, so a pool that starts during
+/// the first sample is missed until then. Each event is opened independently, so a missing event does not disable
+/// the others. On non-Linux systems, or when perf_event_paranoid, seccomp or a hypervisor blocks the syscall, the
+/// group reports itself unavailable and Start()/Stop() return empty readings instead of failing.
+class HwCounterGroup {
+ public:
+  HwCounterGroup();
+  ~HwCounterGroup();
+  HwCounterGroup(const HwCounterGroup &) = delete;
+  HwCounterGroup &operator=(const HwCounterGroup &) = delete;
+
+  /// @brief True if at least one event was opened.
+  [[nodiscard]] bool IsAvailable() const;
+  /// @brief Explains why no event could be opened; empty when available.
+  [[nodiscard]] const std::string &GetUnavailableReason() const;
+  /// @brief Follows the threads started or exited since the last call, then resets and enables all events.
+  void Start();
+  /// @brief Disables all opened events and returns their values since Start(), summed over the threads.
+  HwCounterValues Stop();
+
+ private:
+  /// @brief Event descriptors of one thread (-1 where an event could not be opened).
+  struct ThreadEvents {
+    int tid = 0;
+    /// @brief Start time from /proc, which tells a recycled thread id from the thread that had it before.
+    uint64_t start_time = 0;
+    std::array<int, kHwCounterCount> fds{};
+  };
+
+  /// @brief Opens the events of every thread of the process that has none yet and closes those of exited threads;
+  /// returns the last errno on failure.
+  int SyncThreads();
+
+  std::vector<ThreadEvents> threads_;
+  std::string unavailable_reason_;
+};
+
+}  // namespace ppc::performance
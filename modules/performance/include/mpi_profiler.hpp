@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json_fwd.hpp"
+
+namespace ppc::performance {
+
+/// @brief MPI functions intercepted by the PMPI wrappers (USE_MPI_PROFILER); MPI-4 _c variants count as these.
+enum class MpiCall : uint8_t {
+  kSend,
+  kRecv,
+  kSendrecv,
+  kBcast,
+  kScatter,
+  kScatterv,
+  kGather,
+  kGatherv,
+  kAllgather,
+  kAllgatherv,
+  kReduce,
+  kAllreduce,
+  kCommSplit,
+  kBarrier,
+};
+
+inline constexpr std::size_t kMpiCallCount = 14;
+
+/// @brief Returns the MPI name of the call, e.g. "MPI_Bcast".
+std::string GetMpiCallName(MpiCall call);
+
+/// @brief Accumulated cost of one MPI function.
+struct MpiCallStats {
+  uint64_t calls = 0;
+  /// @brief Bytes of the user buffers the calls read and wrote on this process.
+  uint64_t bytes = 0;
+  double time_sec = 0.0;
+};
+
+/// @brief Per-process record of MPI calls by task and pipeline stage, plus the bytes sent to every peer.
+/// @details Filled by the PMPI wrappers; without them linked in the profile stays empty. Peers are ranks in
+/// MPI_COMM_WORLD. Traffic is logical: point-to-point sends and the data rooted and gather collectives move
+/// between ranks. Reductions only count towards bytes, since their routing depends on the MPI library.
+class MpiProfile {
+ public:
+  /// @brief Adds one call made by @p task during @p stage.
+  void Record(const std::string &task, std::string_view stage, MpiCall call, uint64_t bytes, double time_sec);
+  /// @brief Adds @p bytes sent by this process to world rank @p peer on behalf of @p task.
+  void RecordTraffic(const std::string &task, int peer, uint64_t bytes);
+
+  [[nodiscard]] bool Empty() const;
+  void Clear();
+
+  /// @brief Serializes this process's data as {"rank", "calls": [...], "traffic": {task: [bytes per peer]}}.
+  [[nodiscard]] nlohmann::json ToJson(int rank) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::pair<std::string, std::string>, std::array<MpiCallStats, kMpiCallCount>> calls_;
+  std::map<std::string, std::vector<uint64_t>> traffic_;
+};
+
+/// @brief Returns the process-wide profile the PMPI wrappers record into.
+MpiProfile &GetMpiProfile();
+
+/// @brief Combines the ToJson() output of every rank into one report.
+/// @details Calls and bytes are summed over ranks; time is reported as the sum and as the slowest rank.
+/// Traffic becomes a rank x rank matrix (row = sender, column = receiver) per task and in total.
+nlohmann::json MergeMpiProfiles(const std::vector<nlohmann::json> &ranks);
+
+/// @brief Renders a merged report as text: one line per task, stage and call, then the traffic matrices.
+std::string FormatMpiProfile(const nlohmann::json &report);
+
+/// @brief Collects the profiles of all ranks on rank 0, prints the report and writes PPC_MPI_PROFILE_JSON if set.
+/// @details Collective over MPI_COMM_WORLD; does nothing when no rank recorded a call. Communication of the report
+/// itself bypasses the wrappers.
+void ReportMpiProfile();
+
+}  // namespace ppc::performance
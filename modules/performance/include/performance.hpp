@@ -1,14 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "performance/include/cache_control.hpp"
+#include "performance/include/energy_meter.hpp"
+#include "performance/include/hw_counters.hpp"
+#include "performance/include/threading_profiler.hpp"
 #include "task/include/task.hpp"
 #include "util/include/util.hpp"
 
@@ -21,15 +32,269 @@ inline double DefaultTimer() {
 struct PerfAttr {
   /// @brief Number of times the task is run for performance evaluation.
   uint64_t num_running = 5;
+  /// @brief Number of untimed runs executed before sampling starts.
+  uint64_t num_warmup = 1;
+  /// @brief Choose the iteration count automatically instead of using @ref num_running.
+  /// @details Sampling stops once the relative 95% confidence interval of the median drops below
+  /// @ref target_rel_ci, the wall-time budget is spent, or @ref max_running samples are taken.
+  bool adaptive_running = false;
+  /// @brief Lower bound on the number of samples in adaptive mode.
+  uint64_t min_running = 3;
+  /// @brief Upper bound on the number of samples in adaptive mode.
+  uint64_t max_running = 100;
+  /// @brief Wall-time budget in seconds for the sampling loop in adaptive mode.
+  double time_budget_sec = 5.0;
+  /// @brief Target relative half-width of the median's confidence interval in adaptive mode.
+  double target_rel_ci = 0.02;
+  /// @brief Sample hardware counters (cycles, instructions, cache/branch/TLB misses) around every iteration.
+  bool hw_counters = false;
+  /// @brief Cache state every timed iteration starts from.
+  /// @details kCold flushes the caches before each iteration (not timed), so the input is read from memory again.
+  CacheState cache_state = CacheState::kWarm;
+  /// @brief Size of the buffer streamed to flush the caches in kCold; 0 picks twice the last-level cache size.
+  std::size_t cache_flush_bytes = 0;
+  /// @brief Read the node's RAPL energy counters around every iteration.
+  bool energy = false;
+  /// @brief Record per-thread activity of OpenMP and TBB during the timed iterations.
+  bool threading = false;
+  /// @brief Combines the local "need more samples" decision across cooperating processes.
+  /// @details Every process must take the same number of samples, so MPI runs replace it with a reduction.
+  /// @cond
+  std::function<bool(bool)> sync_continue = [](bool local) { return local; };
+  /// @endcond
+  /// @brief Called before every timed iteration so that cooperating processes start it together; not timed itself.
+  /// @cond
+  std::function<void()> sync_start = [] {};
+  /// @endcond
+  /// @brief Turns this process's per-iteration times into times of the whole run.
+  /// @details MPI runs take the element-wise maximum over processes: an iteration ends with its slowest process.
+  /// @cond
+  std::function<std::vector<double>(const std::vector<double> &)> combine_samples =
+      [](const std::vector<double> &local) { return local; };
+  /// @endcond
+  /// @brief Turns this process's joules (NaN if it could not measure them) into joules of the whole run.
+  /// @details RAPL counts whole nodes, so MPI runs sum one reading per node instead of one per process.
+  /// @cond
+  std::function<double(double)> combine_energy = [](double local) { return local; };
+  /// @endcond
   /// @brief Timer function returning current time in seconds.
   /// @cond
   std::function<double()> current_timer = DefaultTimer;
   /// @endcond
 };
 
+/// @brief Summary statistics over per-iteration time samples (seconds).
+struct PerfStatistics {
+  double min = 0.0;
+  double max = 0.0;
+  double mean = 0.0;
+  double median = 0.0;
+  double p90 = 0.0;
+  double p99 = 0.0;
+  /// @brief Sample standard deviation.
+  double stddev = 0.0;
+  /// @brief Median absolute deviation from the median.
+  double mad = 0.0;
+};
+
+/// @brief Returns the q-th quantile (0 <= q <= 1) of sorted samples using linear interpolation.
+inline double SortedQuantile(const std::vector<double> &sorted, double q) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const double pos = q * static_cast<double>(sorted.size() - 1);
+  const auto lo = static_cast<std::size_t>(std::floor(pos));
+  const auto hi = std::min(lo + 1, sorted.size() - 1);
+  const double frac = pos - static_cast<double>(lo);
+  return sorted[lo] + ((sorted[hi] - sorted[lo]) * frac);
+}
+
+/// @brief Computes robust statistics for a set of time samples.
+inline PerfStatistics ComputeStatistics(const std::vector<double> &samples) {
+  PerfStatistics stats;
+  if (samples.empty()) {
+    return stats;
+  }
+  std::vector<double> sorted = samples;
+  std::ranges::sort(sorted);
+
+  double sum = 0.0;
+  for (double v : sorted) {
+    sum += v;
+  }
+  const auto n = static_cast<double>(sorted.size());
+  stats.min = sorted.front();
+  stats.max = sorted.back();
+  stats.mean = sum / n;
+  stats.median = SortedQuantile(sorted, 0.5);
+  stats.p90 = SortedQuantile(sorted, 0.9);
+  stats.p99 = SortedQuantile(sorted, 0.99);
+
+  double sq_sum = 0.0;
+  std::vector<double> abs_dev;
+  abs_dev.reserve(sorted.size());
+  for (double v : sorted) {
+    sq_sum += (v - stats.mean) * (v - stats.mean);
+    abs_dev.push_back(std::abs(v - stats.median));
+  }
+  stats.stddev = sorted.size() > 1 ? std::sqrt(sq_sum / (n - 1.0)) : 0.0;
+  std::ranges::sort(abs_dev);
+  stats.mad = SortedQuantile(abs_dev, 0.5);
+  return stats;
+}
+
+/// @brief Relative half-width of the distribution-free 95% confidence interval of the median.
+/// @details Uses the order statistics around n/2 +- 0.98 * sqrt(n); returns infinity for fewer than two samples.
+inline double MedianRelativeCI(const std::vector<double> &samples) {
+  if (samples.size() < 2) {
+    return std::numeric_limits<double>::infinity();
+  }
+  std::vector<double> sorted = samples;
+  std::ranges::sort(sorted);
+  const auto n = static_cast<double>(sorted.size());
+  const double half_width = 0.98 * std::sqrt(n);
+  const auto lo = static_cast<std::size_t>(std::max(0.0, std::floor((n / 2.0) - half_width) - 1.0));
+  const auto hi = std::min(static_cast<std::size_t>(std::ceil(1.0 + (n / 2.0) + half_width) - 1.0), sorted.size() - 1);
+  const double spread = sorted[hi] - sorted[lo];
+  const double median = SortedQuantile(sorted, 0.5);
+  if (median <= 0.0) {
+    return spread > 0.0 ? std::numeric_limits<double>::infinity() : 0.0;
+  }
+  return spread / (2.0 * median);
+}
+
+/// @brief Spread of per-process times of one run.
+struct RankBreakdown {
+  double max = 0.0;
+  double min = 0.0;
+  double mean = 0.0;
+  /// @brief Load-imbalance factor max / mean; 1 means perfectly balanced.
+  double imbalance = 1.0;
+  /// @brief Process with the largest time.
+  std::size_t slowest_rank = 0;
+};
+
+/// @brief Summarizes per-process times indexed by rank.
+inline RankBreakdown ComputeRankBreakdown(const std::vector<double> &rank_times) {
+  RankBreakdown breakdown;
+  if (rank_times.empty()) {
+    return breakdown;
+  }
+  const auto max_it = std::ranges::max_element(rank_times);
+  breakdown.max = *max_it;
+  breakdown.min = *std::ranges::min_element(rank_times);
+  double sum = 0.0;
+  for (double time : rank_times) {
+    sum += time;
+  }
+  breakdown.mean = sum / static_cast<double>(rank_times.size());
+  breakdown.imbalance = breakdown.mean > 0.0 ? breakdown.max / breakdown.mean : 1.0;
+  breakdown.slowest_rank = static_cast<std::size_t>(std::distance(rank_times.begin(), max_it));
+  return breakdown;
+}
+
+/// @brief Least-squares fit of time = c * size^exponent on a log-log scale.
+struct PowerLawFit {
+  /// @brief Empirical complexity exponent (slope of log time over log size).
+  double exponent = 0.0;
+  /// @brief Coefficient of determination of the log-log fit.
+  double r2 = 0.0;
+};
+
+/// @brief Fits a power law to (size, time) points; points with non-positive values are ignored.
+/// @details Returns a zero fit when fewer than two distinct sizes remain.
+inline PowerLawFit FitPowerLaw(const std::vector<std::pair<double, double>> &points) {
+  std::vector<std::pair<double, double>> logs;
+  for (const auto &[size, time] : points) {
+    if (size > 0.0 && time > 0.0) {
+      logs.emplace_back(std::log(size), std::log(time));
+    }
+  }
+  PowerLawFit fit;
+  if (logs.size() < 2) {
+    return fit;
+  }
+  const auto n = static_cast<double>(logs.size());
+  double mean_x = 0.0;
+  double mean_y = 0.0;
+  for (const auto &[x, y] : logs) {
+    mean_x += x / n;
+    mean_y += y / n;
+  }
+  double sxx = 0.0;
+  double sxy = 0.0;
+  double syy = 0.0;
+  for (const auto &[x, y] : logs) {
+    sxx += (x - mean_x) * (x - mean_x);
+    sxy += (x - mean_x) * (y - mean_y);
+    syy += (y - mean_y) * (y - mean_y);
+  }
+  if (sxx <= 0.0) {
+    return fit;
+  }
+  fit.exponent = sxy / sxx;
+  fit.r2 = syy > 0.0 ? (sxy * sxy) / (sxx * syy) : 1.0;
+  return fit;
+}
+
+/// @brief Formats hardware counter means and derived metrics as space-separated key=value pairs.
+inline std::string FormatHwCounterStats(const HwCounterStats &hw_stats) {
+  std::stringstream hw_str;
+  for (std::size_t i = 0; i < kHwCounterCount; i++) {
+    const auto counter = static_cast<HwCounter>(i);
+    if (hw_stats.mean.IsValid(counter)) {
+      hw_str << GetHwCounterName(counter) << "=" << std::fixed << std::setprecision(0) << hw_stats.mean.Get(counter)
+             << " ";
+    }
+  }
+  hw_str << std::fixed << std::setprecision(4) << "ipc=" << hw_stats.ipc << " llc_mpki=" << hw_stats.llc_mpki
+         << " branch_mpki=" << hw_stats.branch_mpki << " dtlb_mpki=" << hw_stats.dtlb_mpki;
+  // Counts are totals over this many threads of the process
+  if (hw_stats.threads > 0) {
+    hw_str << " threads=" << hw_stats.threads;
+  }
+  return hw_str.str();
+}
+
+/// @brief Formats the utilization of one threading runtime as space-separated key=value pairs.
+inline std::string FormatThreadingStats(const ThreadingStats &stats) {
+  std::stringstream str;
+  str << std::fixed << std::setprecision(4) << "runtime=" << stats.runtime << " threads=" << stats.threads.size()
+      << " regions=" << stats.regions << " utilization=" << stats.utilization
+      << " barrier_wait_share=" << stats.barrier_wait_share << " imbalance=" << stats.imbalance << " busy_sec=";
+  for (std::size_t i = 0; i < stats.threads.size(); i++) {
+    str << (i == 0 ? "" : ",") << stats.threads[i].busy_sec;
+  }
+  return str.str();
+}
+
 struct PerfResults {
-  /// @brief Measured execution time in seconds.
+  /// @brief Measured execution time in seconds (mean over samples).
   double time_sec = 0.0;
+  /// @brief Per-iteration execution times in seconds, warm-up runs excluded.
+  std::vector<double> samples;
+  /// @brief This process's own per-iteration times; equal to @ref samples unless processes are combined.
+  std::vector<double> local_samples;
+  /// @brief Statistics computed over @ref samples.
+  PerfStatistics stats;
+  /// @brief Achieved relative half-width of the median's 95% confidence interval.
+  double median_rel_ci = 0.0;
+  /// @brief Per-iteration hardware counter readings of this process (empty unless requested and available).
+  std::vector<HwCounterValues> hw_samples;
+  /// @brief Per-iteration counter means with derived IPC and miss rates.
+  HwCounterStats hw_stats;
+  /// @brief Why counters were requested but could not be collected; empty otherwise.
+  std::string hw_unavailable_reason;
+  /// @brief Cache state the timed iterations started from.
+  CacheState cache_state = CacheState::kWarm;
+  /// @brief Energy of the timed iterations (unavailable unless requested and readable).
+  EnergyStats energy;
+  /// @brief Why energy was requested but could not be measured; empty otherwise.
+  std::string energy_unavailable_reason;
+  /// @brief Per-thread activity of each threading runtime used by this process.
+  std::vector<ThreadingStats> threading;
+  /// @brief Why threading activity was requested but none was recorded; empty otherwise.
+  std::string threading_unavailable_reason;
   enum class TypeOfRunning : uint8_t {
     kPipeline,
     kTaskRun,
@@ -39,6 +304,39 @@ struct PerfResults {
   constexpr static double kMaxTime = 10.0;
 };
 
+/// @brief Prints the sample statistics and the profiler results of a run, one `test_id:mode:kind:` line per kind.
+inline void PrintPerfResultsStatistic(const PerfResults &perf_results, const std::string &test_id,
+                                      const std::string &type_test_name) {
+  const auto &stats = perf_results.stats;
+  std::stringstream stats_str;
+  stats_str << std::fixed << std::setprecision(10) << "n=" << perf_results.samples.size() << " min=" << stats.min
+            << " median=" << stats.median << " p90=" << stats.p90 << " p99=" << stats.p99
+            << " max=" << stats.max << " stddev=" << stats.stddev << " mad=" << stats.mad
+            << " median_rel_ci=" << perf_results.median_rel_ci;
+  std::cout << test_id << ":" << type_test_name << ":stats:" << stats_str.str() << '\n';
+  if (perf_results.hw_stats.available) {
+    std::cout << test_id << ":" << type_test_name << ":hw:" << FormatHwCounterStats(perf_results.hw_stats) << '\n';
+  } else if (!perf_results.hw_unavailable_reason.empty()) {
+    std::cout << test_id << ":" << type_test_name << ":hw:unavailable " << perf_results.hw_unavailable_reason << '\n';
+  }
+  for (const auto &runtime : perf_results.threading) {
+    std::cout << test_id << ":" << type_test_name << ":threads:" << FormatThreadingStats(runtime) << '\n';
+  }
+  if (!perf_results.threading_unavailable_reason.empty()) {
+    std::cout << test_id << ":" << type_test_name << ":threads:unavailable "
+              << perf_results.threading_unavailable_reason << '\n';
+  }
+  const auto &energy = perf_results.energy;
+  if (energy.available) {
+    std::cout << test_id << ":" << type_test_name << ":energy:" << std::fixed << std::setprecision(6)
+              << "joules=" << energy.joules << " avg_watts=" << energy.avg_watts << " edp=" << energy.edp
+              << " zones=" << energy.zones << '\n';
+  } else if (!perf_results.energy_unavailable_reason.empty()) {
+    std::cout << test_id << ":" << type_test_name << ":energy:unavailable " << perf_results.energy_unavailable_reason
+              << '\n';
+  }
+}
+
 template <typename InType, typename OutType>
 class Perf {
  public:
@@ -91,6 +389,7 @@ class Perf {
     if (time_secs < max_time) {
       perf_res_str << std::fixed << std::setprecision(10) << time_secs;
       std::cout << test_id << ":" << type_test_name << ":" << perf_res_str.str() << '\n';
+      PrintSampleStatistic(test_id, type_test_name);
     } else {
       std::stringstream err_msg;
       err_msg << '\n' << "Task execute time need to be: ";
@@ -111,12 +410,117 @@ class Perf {
   PerfResults perf_results_;
   std::shared_ptr<ppc::task::Task<InType, OutType>> task_;
   static void CommonRun(const PerfAttr &perf_attr, const std::function<void()> &pipeline, PerfResults &perf_results) {
-    auto begin = perf_attr.current_timer();
-    for (uint64_t i = 0; i < perf_attr.num_running; i++) {
+    for (uint64_t i = 0; i < perf_attr.num_warmup; i++) {
+      pipeline();
+    }
+    const bool adaptive = perf_attr.adaptive_running;
+    const uint64_t min_running = adaptive ? std::max<uint64_t>(perf_attr.min_running, 1) : perf_attr.num_running;
+    const uint64_t max_running = adaptive ? std::max(perf_attr.max_running, min_running) : perf_attr.num_running;
+
+    std::unique_ptr<HwCounterGroup> counters;
+    perf_results.hw_samples.clear();
+    perf_results.hw_unavailable_reason.clear();
+    if (perf_attr.hw_counters) {
+      counters = std::make_unique<HwCounterGroup>();
+      if (!counters->IsAvailable()) {
+        perf_results.hw_unavailable_reason = counters->GetUnavailableReason();
+        counters.reset();
+      }
+    }
+
+    std::unique_ptr<CacheFlusher> flusher;
+    perf_results.cache_state = perf_attr.cache_state;
+    if (perf_attr.cache_state == CacheState::kCold) {
+      flusher = std::make_unique<CacheFlusher>(perf_attr.cache_flush_bytes);
+    }
+
+    std::unique_ptr<EnergyMeter> energy_meter;
+    double local_joules = 0.0;
+    perf_results.energy = {};
+    perf_results.energy_unavailable_reason.clear();
+    if (perf_attr.energy) {
+      energy_meter = std::make_unique<EnergyMeter>();
+      if (!energy_meter->IsAvailable()) {
+        perf_results.energy_unavailable_reason = energy_meter->GetUnavailableReason();
+        energy_meter.reset();
+      }
+    }
+
+    auto &threading = ThreadingProfiler::Instance();
+    perf_results.threading.clear();
+    perf_results.threading_unavailable_reason.clear();
+    if (perf_attr.threading) {
+      threading.Start();
+    }
+
+    perf_results.samples.clear();
+    perf_results.samples.reserve(adaptive ? min_running : max_running);
+    const double sampling_begin = adaptive ? perf_attr.current_timer() : 0.0;
+    while (perf_results.samples.size() < max_running) {
+      if (flusher) {
+        flusher->Flush();
+      }
+      perf_attr.sync_start();
+      std::vector<uint64_t> energy_begin;
+      if (energy_meter) {
+        energy_begin = energy_meter->Read();
+      }
+      if (counters) {
+        counters->Start();
+      }
+      if (perf_attr.threading) {
+        threading.Resume();
+      }
+      auto begin = perf_attr.current_timer();
       pipeline();
+      auto end = perf_attr.current_timer();
+      if (perf_attr.threading) {
+        threading.Pause();
+      }
+      if (counters) {
+        perf_results.hw_samples.push_back(counters->Stop());
+      }
+      if (energy_meter) {
+        local_joules += energy_meter->JoulesBetween(energy_begin, energy_meter->Read());
+      }
+      perf_results.samples.push_back(end - begin);
+
+      if (adaptive && perf_results.samples.size() >= min_running) {
+        const bool within_budget = (end - sampling_begin) < perf_attr.time_budget_sec;
+        const bool need_more = within_budget && MedianRelativeCI(perf_results.samples) > perf_attr.target_rel_ci;
+        if (!perf_attr.sync_continue(need_more)) {
+          break;
+        }
+      }
+    }
+    perf_results.local_samples = perf_results.samples;
+    if (perf_attr.threading) {
+      double local_sec = 0.0;
+      for (double sample : perf_results.local_samples) {
+        local_sec += sample;
+      }
+      perf_results.threading = threading.Stop(local_sec);
+      if (perf_results.threading.empty()) {
+        perf_results.threading_unavailable_reason = threading.GetUnavailableReason();
+      }
+    }
+    perf_results.samples = perf_attr.combine_samples(perf_results.local_samples);
+    perf_results.stats = ComputeStatistics(perf_results.samples);
+    perf_results.median_rel_ci = MedianRelativeCI(perf_results.samples);
+    perf_results.hw_stats = ComputeHwCounterStats(perf_results.hw_samples);
+    perf_results.time_sec = perf_results.stats.mean;
+    if (perf_attr.energy) {
+      const double joules =
+          perf_attr.combine_energy(energy_meter ? local_joules : std::numeric_limits<double>::quiet_NaN());
+      perf_results.energy =
+          ComputeEnergyStats(joules, perf_results.samples, energy_meter ? energy_meter->GetZoneNames() : "");
+      if (!perf_results.energy.available && perf_results.energy_unavailable_reason.empty()) {
+        perf_results.energy_unavailable_reason = "RAPL energy is not readable on every node";
+      }
     }
-    auto end = perf_attr.current_timer();
-    perf_results.time_sec = (end - begin) / static_cast<double>(perf_attr.num_running);
+  }
+  void PrintSampleStatistic(const std::string &test_id, const std::string &type_test_name) const {
+    PrintPerfResultsStatistic(perf_results_, test_id, type_test_name);
   }
 };
 
@@ -130,4 +534,67 @@ inline std::string GetStringParamName(PerfResults::TypeOfRunning type_of_running
   return "none";
 }
 
+/// @brief Serializes samples, statistics and hardware counters of a perf run.
+inline nlohmann::json PerfResultsToJson(const PerfResults &results) {
+  auto finite_or_null = [](double value) -> nlohmann::json {
+    return std::isfinite(value) ? nlohmann::json(value) : nlohmann::json(nullptr);
+  };
+  const auto &stats = results.stats;
+  nlohmann::json json;
+  json["mode"] = GetStringParamName(results.type_of_running);
+  json["cache"] = GetCacheStateName(results.cache_state);
+  json["time_sec"] = results.time_sec;
+  json["samples"] = results.samples;
+  json["stats"] = {{"min", stats.min},       {"max", stats.max}, {"mean", stats.mean},
+                   {"median", stats.median}, {"p90", stats.p90}, {"p99", stats.p99},
+                   {"stddev", stats.stddev}, {"mad", stats.mad}};
+  json["median_rel_ci"] = finite_or_null(results.median_rel_ci);
+  if (results.hw_stats.available) {
+    nlohmann::json hw;
+    for (std::size_t i = 0; i < kHwCounterCount; i++) {
+      const auto counter = static_cast<HwCounter>(i);
+      hw[GetHwCounterName(counter)] =
+          results.hw_stats.mean.IsValid(counter) ? nlohmann::json(results.hw_stats.mean.Get(counter)) : nullptr;
+    }
+    hw["ipc"] = results.hw_stats.ipc;
+    hw["llc_mpki"] = results.hw_stats.llc_mpki;
+    hw["branch_mpki"] = results.hw_stats.branch_mpki;
+    hw["dtlb_mpki"] = results.hw_stats.dtlb_mpki;
+    hw["threads"] = results.hw_stats.threads;
+    json["hw"] = hw;
+  } else if (!results.hw_unavailable_reason.empty()) {
+    json["hw"] = {{"unavailable", results.hw_unavailable_reason}};
+  }
+  if (!results.threading.empty()) {
+    json["threading"] = nlohmann::json::array();
+    for (const auto &runtime : results.threading) {
+      auto threads = nlohmann::json::array();
+      for (const auto &thread : runtime.threads) {
+        threads.push_back({{"thread", thread.thread},
+                           {"busy_sec", thread.busy_sec},
+                           {"wait_sec", thread.wait_sec},
+                           {"entries", thread.entries}});
+      }
+      json["threading"].push_back({{"runtime", runtime.runtime},
+                                   {"regions", runtime.regions},
+                                   {"wall_sec", runtime.wall_sec},
+                                   {"utilization", runtime.utilization},
+                                   {"barrier_wait_share", runtime.barrier_wait_share},
+                                   {"imbalance", runtime.imbalance},
+                                   {"threads", threads}});
+    }
+  } else if (!results.threading_unavailable_reason.empty()) {
+    json["threading"] = {{"unavailable", results.threading_unavailable_reason}};
+  }
+  if (results.energy.available) {
+    json["energy"] = {{"joules", results.energy.joules},
+                      {"avg_watts", results.energy.avg_watts},
+                      {"edp", results.energy.edp},
+                      {"zones", results.energy.zones}};
+  } else if (!results.energy_unavailable_reason.empty()) {
+    json["energy"] = {{"unavailable", results.energy_unavailable_reason}};
+  }
+  return json;
+}
+
 }  // namespace ppc::performance
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+namespace ppc::performance {
+
+/// @brief Host, toolchain and source revision describing where a perf record was produced.
+struct RunMetadata {
+  std::string hostname;
+  std::string cpu_model;
+  std::string compiler;
+  std::string compile_flags;
+  std::string build_type;
+  /// @brief Commit the binary was built from; overridden at runtime by PPC_GIT_SHA.
+  std::string git_sha;
+};
+
+/// @brief Returns metadata of the running binary and host (computed once per process).
+const RunMetadata &GetRunMetadata();
+
+}  // namespace ppc::performance
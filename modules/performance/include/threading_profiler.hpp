@@ -0,0 +1,98 @@
+#pragma once
+
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ppc::performance {
+
+/// @brief Time one thread of a threading runtime spent in parallel work during the timed iterations.
+struct ThreadActivity {
+  /// @brief OpenMP thread number or TBB arena slot.
+  int thread = 0;
+  /// @brief Seconds in OpenMP implicit tasks or in the TBB arena, barrier waits excluded.
+  double busy_sec = 0.0;
+  /// @brief Seconds spent waiting in OpenMP barriers; always 0 for TBB.
+  double wait_sec = 0.0;
+  /// @brief Implicit tasks executed (OpenMP) or arena entries (TBB).
+  uint64_t entries = 0;
+};
+
+/// @brief Utilization of one runtime (OpenMP, or one TBB arena) over the timed iterations.
+struct ThreadingStats {
+  /// @brief "omp" or "tbb:<arena>".
+  std::string runtime;
+  /// @brief Threads that took part, ordered by thread number.
+  std::vector<ThreadActivity> threads;
+  /// @brief OpenMP parallel regions started; 0 for TBB.
+  uint64_t regions = 0;
+  /// @brief Timed seconds the activity is compared with.
+  double wall_sec = 0.0;
+  /// @brief Mean busy time of the threads over @ref wall_sec; low values point at serial parts or idle workers.
+  double utilization = 0.0;
+  /// @brief Share of the threads' parallel time spent waiting in barriers; high values point at load imbalance.
+  double barrier_wait_share = 0.0;
+  /// @brief Largest over mean busy time of the threads; 1 means the work was evenly split.
+  double imbalance = 1.0;
+};
+
+/// @brief Derives utilization, barrier wait share and imbalance from per-thread activity.
+ThreadingStats ComputeThreadingStats(const std::string &runtime, std::vector<ThreadActivity> threads,
+                                     uint64_t regions, double wall_sec);
+
+/// @brief Records the time a TBB arena's threads spend in it while the ThreadingProfiler records.
+/// @details Time in the arena includes stealing and the short spin before an idle worker leaves, so TBB utilization
+/// is an upper bound of the busy time. The profiler observes the default arena by itself, counting its worker threads
+/// only: the main thread belongs to the default arena for its whole life. Tasks running in their own tbb::task_arena
+/// can keep an observer of it alive for the duration of Run(); there the threads calling execute() count as well.
+class TbbArenaObserver : public tbb::task_scheduler_observer {
+ public:
+  /// @brief Observes the worker threads of the arena of the calling thread (the default arena unless called inside
+  /// another one).
+  explicit TbbArenaObserver(const std::string &arena_name);
+  TbbArenaObserver(tbb::task_arena &arena, const std::string &arena_name);
+  ~TbbArenaObserver() override;
+  TbbArenaObserver(const TbbArenaObserver &) = delete;
+  TbbArenaObserver &operator=(const TbbArenaObserver &) = delete;
+  TbbArenaObserver(TbbArenaObserver &&) = delete;
+  TbbArenaObserver &operator=(TbbArenaObserver &&) = delete;
+
+  void on_scheduler_entry(bool is_worker) override;
+  void on_scheduler_exit(bool is_worker) override;
+
+ private:
+  std::string runtime_;
+  bool count_external_threads_;
+};
+
+/// @brief Collects per-thread activity of OpenMP (through an OMPT tool) and TBB (through arena observers).
+/// @details The OMPT tool registers when the OpenMP runtime starts, so PPC_PERF_THREADING must be set before the
+/// process starts and the runtime must support OMPT (LLVM libomp and Intel's runtime do, GCC's libgomp does not).
+/// Activity is only recorded between Resume() and Pause(), so untimed work between iterations is left out.
+class ThreadingProfiler {
+ public:
+  static ThreadingProfiler &Instance();
+
+  /// @brief True if the OpenMP runtime accepted the OMPT tool.
+  [[nodiscard]] bool IsOmptActive() const;
+
+  /// @brief Clears earlier activity and starts observing the default TBB arena; recording starts paused.
+  void Start();
+  void Resume();
+  void Pause();
+  /// @brief Stops observing and returns the stats of every runtime with activity, compared with @p wall_sec.
+  std::vector<ThreadingStats> Stop(double wall_sec);
+  /// @brief Explains an empty Stop() result.
+  [[nodiscard]] std::string GetUnavailableReason() const;
+
+ private:
+  ThreadingProfiler() = default;
+
+  std::unique_ptr<TbbArenaObserver> default_arena_observer_;
+};
+
+}  // namespace ppc::performance
@@ -0,0 +1,365 @@
+// PMPI interposition layer of the MPI communication profiler.
+//
+// Built only with -DUSE_MPI_PROFILER=ON and linked as object files into ppc_func_tests and ppc_perf_tests, so these
+// definitions take precedence over the MPI library's. Every wrapper forwards to its PMPI_ counterpart and records
+// the call, its buffer bytes and wall time under the task and pipeline stage of ppc::util::CurrentProfileContext().
+// With MPI-4, the large-count (_c) functions that ppc::mpi uses above GetMpiMaxCount() count as their int versions.
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "performance/include/mpi_profiler.hpp"
+#include "util/include/util.hpp"
+
+namespace {
+
+using ppc::performance::MpiCall;
+
+uint64_t Bytes(MPI_Datatype type, int64_t count) {
+  int size = 0;
+  PMPI_Type_size(type, &size);
+  return count > 0 ? static_cast<uint64_t>(count) * static_cast<uint64_t>(size) : 0;
+}
+
+/// Sum of the int or MPI_Count @p counts of @p size ranks.
+template <typename Count>
+int64_t Sum(const Count *counts, int size) {
+  return std::accumulate(counts, counts + size, int64_t{0});
+}
+
+uint64_t ReceivedBytes(const MPI_Status *status, MPI_Datatype type) {
+#if MPI_VERSION >= 4
+  MPI_Count count = 0;
+  PMPI_Get_count_c(status, type, &count);
+#else
+  int count = 0;
+  PMPI_Get_count(status, type, &count);
+#endif
+  return count == MPI_UNDEFINED ? 0 : Bytes(type, count);
+}
+
+int CommRank(MPI_Comm comm) {
+  int rank = 0;
+  PMPI_Comm_rank(comm, &rank);
+  return rank;
+}
+
+int CommSize(MPI_Comm comm) {
+  int size = 0;
+  PMPI_Comm_size(comm, &size);
+  return size;
+}
+
+/// World ranks of all members of @p comm, indexed by their rank in @p comm.
+std::vector<int> WorldRanks(MPI_Comm comm) {
+  std::vector<int> ranks(static_cast<std::size_t>(CommSize(comm)));
+  std::iota(ranks.begin(), ranks.end(), 0);
+  if (comm == MPI_COMM_WORLD) {
+    return ranks;
+  }
+  MPI_Group group = MPI_GROUP_NULL;
+  MPI_Group world_group = MPI_GROUP_NULL;
+  PMPI_Comm_group(comm, &group);
+  PMPI_Comm_group(MPI_COMM_WORLD, &world_group);
+  std::vector<int> world(ranks.size());
+  PMPI_Group_translate_ranks(group, static_cast<int>(ranks.size()), ranks.data(), world_group, world.data());
+  PMPI_Group_free(&group);
+  PMPI_Group_free(&world_group);
+  return world;
+}
+
+void RecordCall(MpiCall call, uint64_t bytes, double start) {
+  const double elapsed = PMPI_Wtime() - start;
+  const auto &context = ppc::util::CurrentProfileContext();
+  ppc::performance::GetMpiProfile().Record(context.task, context.stage, call, bytes, elapsed);
+}
+
+/// Logical traffic from this process to rank @p dest of @p comm.
+void RecordSend(MPI_Comm comm, int dest, uint64_t bytes) {
+  if (dest == MPI_PROC_NULL || bytes == 0) {
+    return;
+  }
+  const int peer = comm == MPI_COMM_WORLD ? dest : WorldRanks(comm)[static_cast<std::size_t>(dest)];
+  ppc::performance::GetMpiProfile().RecordTraffic(ppc::util::CurrentProfileContext().task, peer, bytes);
+}
+
+/// Logical traffic from this process to every other member of @p comm; @p bytes_to gives the bytes per member.
+template <typename BytesTo>
+void RecordSendToOthers(MPI_Comm comm, BytesTo bytes_to) {
+  const auto world = WorldRanks(comm);
+  const int self = CommRank(comm);
+  auto &profile = ppc::performance::GetMpiProfile();
+  const auto &task = ppc::util::CurrentProfileContext().task;
+  for (int rank = 0; rank < static_cast<int>(world.size()); rank++) {
+    const uint64_t bytes = bytes_to(rank);
+    if (rank != self && bytes > 0) {
+      profile.RecordTraffic(task, world[static_cast<std::size_t>(rank)], bytes);
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTBEGIN(readability-identifier-naming,readability-inconsistent-declaration-parameter-name)
+extern "C" {
+
+int MPI_Send(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Send(buf, count, datatype, dest, tag, comm);
+  const uint64_t bytes = Bytes(datatype, count);
+  RecordCall(MpiCall::kSend, bytes, start);
+  RecordSend(comm, dest, bytes);
+  return result;
+}
+
+int MPI_Recv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status *status) {
+  MPI_Status local_status;
+  MPI_Status *used_status = status == MPI_STATUS_IGNORE ? &local_status : status;
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Recv(buf, count, datatype, source, tag, comm, used_status);
+  RecordCall(MpiCall::kRecv, source == MPI_PROC_NULL ? 0 : ReceivedBytes(used_status, datatype), start);
+  return result;
+}
+
+int MPI_Sendrecv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, int dest, int sendtag, void *recvbuf,
+                 int recvcount, MPI_Datatype recvtype, int source, int recvtag, MPI_Comm comm, MPI_Status *status) {
+  MPI_Status local_status;
+  MPI_Status *used_status = status == MPI_STATUS_IGNORE ? &local_status : status;
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Sendrecv(sendbuf, sendcount, sendtype, dest, sendtag, recvbuf, recvcount, recvtype, source,
+                                   recvtag, comm, used_status);
+  const uint64_t sent = dest == MPI_PROC_NULL ? 0 : Bytes(sendtype, sendcount);
+  const uint64_t received = source == MPI_PROC_NULL ? 0 : ReceivedBytes(used_status, recvtype);
+  RecordCall(MpiCall::kSendrecv, sent + received, start);
+  RecordSend(comm, dest, sent);
+  return result;
+}
+
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Bcast(buffer, count, datatype, root, comm);
+  const uint64_t bytes = Bytes(datatype, count);
+  RecordCall(MpiCall::kBcast, bytes, start);
+  if (CommRank(comm) == root) {
+    RecordSendToOthers(comm, [bytes](int /*rank*/) { return bytes; });
+  }
+  return result;
+}
+
+int MPI_Scatter(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Scatter(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+  const bool is_root = CommRank(comm) == root;
+  const uint64_t block = Bytes(sendtype, sendcount);
+  uint64_t bytes = recvbuf == MPI_IN_PLACE ? 0 : Bytes(recvtype, recvcount);
+  if (is_root) {
+    bytes += block * static_cast<uint64_t>(CommSize(comm));
+  }
+  RecordCall(MpiCall::kScatter, bytes, start);
+  if (is_root) {
+    RecordSendToOthers(comm, [block](int /*rank*/) { return block; });
+  }
+  return result;
+}
+
+int MPI_Scatterv(const void *sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype,
+                 void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Scatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm);
+  const bool is_root = CommRank(comm) == root;
+  uint64_t bytes = recvbuf == MPI_IN_PLACE ? 0 : Bytes(recvtype, recvcount);
+  if (is_root) {
+    bytes += Bytes(sendtype, Sum(sendcounts, CommSize(comm)));
+  }
+  RecordCall(MpiCall::kScatterv, bytes, start);
+  if (is_root) {
+    RecordSendToOthers(comm, [&](int rank) { return Bytes(sendtype, sendcounts[rank]); });
+  }
+  return result;
+}
+
+int MPI_Gather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+               MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+  const bool is_root = CommRank(comm) == root;
+  const uint64_t sent = sendbuf == MPI_IN_PLACE ? 0 : Bytes(sendtype, sendcount);
+  RecordCall(MpiCall::kGather, sent + (is_root ? Bytes(recvtype, int64_t{recvcount} * CommSize(comm)) : 0), start);
+  if (!is_root) {
+    RecordSend(comm, root, sent);
+  }
+  return result;
+}
+
+int MPI_Gatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                const int displs[], MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Gatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm);
+  const bool is_root = CommRank(comm) == root;
+  const uint64_t sent = sendbuf == MPI_IN_PLACE ? 0 : Bytes(sendtype, sendcount);
+  RecordCall(MpiCall::kGatherv, sent + (is_root ? Bytes(recvtype, Sum(recvcounts, CommSize(comm))) : 0), start);
+  if (!is_root) {
+    RecordSend(comm, root, sent);
+  }
+  return result;
+}
+
+int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                  MPI_Datatype recvtype, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+  const uint64_t block = Bytes(recvtype, recvcount);
+  const uint64_t sent = sendbuf == MPI_IN_PLACE ? 0 : Bytes(sendtype, sendcount);
+  RecordCall(MpiCall::kAllgather, sent + (block * static_cast<uint64_t>(CommSize(comm))), start);
+  RecordSendToOthers(comm, [block](int /*rank*/) { return block; });
+  return result;
+}
+
+int MPI_Allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                   const int displs[], MPI_Datatype recvtype, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Allgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, comm);
+  const uint64_t block = Bytes(recvtype, recvcounts[CommRank(comm)]);
+  const uint64_t sent = sendbuf == MPI_IN_PLACE ? 0 : Bytes(sendtype, sendcount);
+  RecordCall(MpiCall::kAllgatherv, sent + Bytes(recvtype, Sum(recvcounts, CommSize(comm))), start);
+  RecordSendToOthers(comm, [block](int /*rank*/) { return block; });
+  return result;
+}
+
+int MPI_Reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root,
+               MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+  const bool is_root = CommRank(comm) == root;
+  const uint64_t bytes = Bytes(datatype, count);
+  RecordCall(MpiCall::kReduce, is_root ? 2 * bytes : bytes, start);
+  if (!is_root) {
+    RecordSend(comm, root, bytes);
+  }
+  return result;
+}
+
+int MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+  RecordCall(MpiCall::kAllreduce, 2 * Bytes(datatype, count), start);
+  return result;
+}
+
+int MPI_Comm_split(MPI_Comm comm, int color, int key, MPI_Comm *newcomm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Comm_split(comm, color, key, newcomm);
+  RecordCall(MpiCall::kCommSplit, 0, start);
+  return result;
+}
+
+int MPI_Barrier(MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Barrier(comm);
+  RecordCall(MpiCall::kBarrier, 0, start);
+  return result;
+}
+
+#if MPI_VERSION >= 4
+
+int MPI_Send_c(const void *buf, MPI_Count count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Send_c(buf, count, datatype, dest, tag, comm);
+  const uint64_t bytes = Bytes(datatype, count);
+  RecordCall(MpiCall::kSend, bytes, start);
+  RecordSend(comm, dest, bytes);
+  return result;
+}
+
+int MPI_Recv_c(void *buf, MPI_Count count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm,
+               MPI_Status *status) {
+  MPI_Status local_status;
+  MPI_Status *used_status = status == MPI_STATUS_IGNORE ? &local_status : status;
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Recv_c(buf, count, datatype, source, tag, comm, used_status);
+  RecordCall(MpiCall::kRecv, source == MPI_PROC_NULL ? 0 : ReceivedBytes(used_status, datatype), start);
+  return result;
+}
+
+int MPI_Bcast_c(void *buffer, MPI_Count count, MPI_Datatype datatype, int root, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Bcast_c(buffer, count, datatype, root, comm);
+  const uint64_t bytes = Bytes(datatype, count);
+  RecordCall(MpiCall::kBcast, bytes, start);
+  if (CommRank(comm) == root) {
+    RecordSendToOthers(comm, [bytes](int /*rank*/) { return bytes; });
+  }
+  return result;
+}
+
+int MPI_Scatterv_c(const void *sendbuf, const MPI_Count sendcounts[], const MPI_Aint displs[], MPI_Datatype sendtype,
+                   void *recvbuf, MPI_Count recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Scatterv_c(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm);
+  const bool is_root = CommRank(comm) == root;
+  uint64_t bytes = recvbuf == MPI_IN_PLACE ? 0 : Bytes(recvtype, recvcount);
+  if (is_root) {
+    bytes += Bytes(sendtype, Sum(sendcounts, CommSize(comm)));
+  }
+  RecordCall(MpiCall::kScatterv, bytes, start);
+  if (is_root) {
+    RecordSendToOthers(comm, [&](int rank) { return Bytes(sendtype, sendcounts[rank]); });
+  }
+  return result;
+}
+
+int MPI_Gatherv_c(const void *sendbuf, MPI_Count sendcount, MPI_Datatype sendtype, void *recvbuf,
+                  const MPI_Count recvcounts[], const MPI_Aint displs[], MPI_Datatype recvtype, int root,
+                  MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Gatherv_c(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm);
+  const bool is_root = CommRank(comm) == root;
+  const uint64_t sent = sendbuf == MPI_IN_PLACE ? 0 : Bytes(sendtype, sendcount);
+  RecordCall(MpiCall::kGatherv, sent + (is_root ? Bytes(recvtype, Sum(recvcounts, CommSize(comm))) : 0), start);
+  if (!is_root) {
+    RecordSend(comm, root, sent);
+  }
+  return result;
+}
+
+int MPI_Allgatherv_c(const void *sendbuf, MPI_Count sendcount, MPI_Datatype sendtype, void *recvbuf,
+                     const MPI_Count recvcounts[], const MPI_Aint displs[], MPI_Datatype recvtype, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Allgatherv_c(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, comm);
+  const uint64_t block = Bytes(recvtype, recvcounts[CommRank(comm)]);
+  const uint64_t sent = sendbuf == MPI_IN_PLACE ? 0 : Bytes(sendtype, sendcount);
+  RecordCall(MpiCall::kAllgatherv, sent + Bytes(recvtype, Sum(recvcounts, CommSize(comm))), start);
+  RecordSendToOthers(comm, [block](int /*rank*/) { return block; });
+  return result;
+}
+
+int MPI_Reduce_c(const void *sendbuf, void *recvbuf, MPI_Count count, MPI_Datatype datatype, MPI_Op op, int root,
+                 MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Reduce_c(sendbuf, recvbuf, count, datatype, op, root, comm);
+  const bool is_root = CommRank(comm) == root;
+  const uint64_t bytes = Bytes(datatype, count);
+  RecordCall(MpiCall::kReduce, is_root ? 2 * bytes : bytes, start);
+  if (!is_root) {
+    RecordSend(comm, root, bytes);
+  }
+  return result;
+}
+
+int MPI_Allreduce_c(const void *sendbuf, void *recvbuf, MPI_Count count, MPI_Datatype datatype, MPI_Op op,
+                    MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int result = PMPI_Allreduce_c(sendbuf, recvbuf, count, datatype, op, comm);
+  RecordCall(MpiCall::kAllreduce, 2 * Bytes(datatype, count), start);
+  return result;
+}
+
+#endif
+
+}  // extern "C"
+// NOLINTEND(readability-identifier-naming,readability-inconsistent-declaration-parameter-name)
@@ -0,0 +1,142 @@
+#include "performance/include/baseline.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ppc::performance {
+
+namespace {
+
+double Median(std::vector<double> values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::ranges::sort(values);
+  const std::size_t mid = values.size() / 2;
+  return values.size() % 2 == 0 ? (values[mid - 1] + values[mid]) / 2.0 : values[mid];
+}
+
+}  // namespace
+
+MannWhitneyResult MannWhitneyGreater(const std::vector<double> &current, const std::vector<double> &baseline) {
+  MannWhitneyResult result;
+  const auto n1 = static_cast<double>(current.size());
+  const auto n2 = static_cast<double>(baseline.size());
+  if (current.empty() || baseline.empty()) {
+    return result;
+  }
+
+  // Pool both samples (second = true for current) and rank them, averaging ranks over ties
+  std::vector<std::pair<double, bool>> pooled;
+  pooled.reserve(current.size() + baseline.size());
+  for (double value : current) {
+    pooled.emplace_back(value, true);
+  }
+  for (double value : baseline) {
+    pooled.emplace_back(value, false);
+  }
+  std::ranges::sort(pooled, {}, &std::pair<double, bool>::first);
+
+  double rank_sum = 0.0;
+  double tie_term = 0.0;
+  for (std::size_t i = 0; i < pooled.size();) {
+    std::size_t j = i;
+    while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+      j++;
+    }
+    const double avg_rank = (static_cast<double>(i + j) + 1.0) / 2.0;
+    for (std::size_t k = i; k < j; k++) {
+      if (pooled[k].second) {
+        rank_sum += avg_rank;
+      }
+    }
+    const auto ties = static_cast<double>(j - i);
+    tie_term += (ties * ties * ties) - ties;
+    i = j;
+  }
+
+  const double n = n1 + n2;
+  result.u = rank_sum - (n1 * (n1 + 1.0) / 2.0);
+  const double mean_u = n1 * n2 / 2.0;
+  const double var_u = n1 * n2 / 12.0 * ((n + 1.0) - (tie_term / (n * (n - 1.0))));
+  if (var_u <= 0.0) {
+    return result;
+  }
+  result.z = (result.u - mean_u - 0.5) / std::sqrt(var_u);
+  result.p_value = 0.5 * std::erfc(result.z / std::sqrt(2.0));
+  return result;
+}
+
+RegressionCheck CheckRegression(const std::vector<double> &current, const std::vector<double> &baseline,
+                                double threshold, double alpha) {
+  RegressionCheck check;
+  check.baseline_median = Median(baseline);
+  check.current_median = Median(current);
+  if (check.baseline_median > 0.0) {
+    check.slowdown = (check.current_median / check.baseline_median) - 1.0;
+  }
+  check.p_value = MannWhitneyGreater(current, baseline).p_value;
+  check.regressed = check.slowdown > threshold && check.p_value < alpha;
+  return check;
+}
+
+std::string GetScaleTag(double scale) {
+  if (scale == 1.0) {
+    return {};
+  }
+  std::string value;
+  if (scale == std::floor(scale) && scale < 1e15) {
+    value = std::to_string(static_cast<int64_t>(scale));
+  } else {
+    value = std::to_string(scale);
+    value.erase(value.find_last_not_of('0') + 1);
+    std::ranges::replace(value, '.', 'p');
+  }
+  return "x" + value;
+}
+
+std::filesystem::path GetBaselinePath(const std::filesystem::path &dir, const BaselineKey &key) {
+  const auto scale_tag = GetScaleTag(key.scale);
+  return dir / key.task /
+         (key.implementation + "_" + key.mode + "_t" + std::to_string(key.threads) + "_p" +
+          std::to_string(key.processes) + (scale_tag.empty() ? "" : "_" + scale_tag) +
+          (key.distribution.empty() || key.distribution == "uniform" ? "" : "_" + key.distribution) +
+          (key.cache == "cold" ? "_cold" : "") + ".json");
+}
+
+std::optional<std::vector<double>> LoadBaselineSamples(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  const auto record = nlohmann::json::parse(file, nullptr, false);
+  if (record.is_discarded() || !record.contains("samples") || !record["samples"].is_array()) {
+    return std::nullopt;
+  }
+  auto samples = record["samples"].get<std::vector<double>>();
+  if (samples.empty()) {
+    return std::nullopt;
+  }
+  return samples;
+}
+
+void SaveBaseline(const std::filesystem::path &path, const nlohmann::json &record) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to write perf baseline: " + path.string());
+  }
+  file << record.dump(2) << '\n';
+}
+
+}  // namespace ppc::performance
@@ -0,0 +1,79 @@
+#include "performance/include/cache_control.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+namespace ppc::performance {
+
+namespace {
+
+constexpr std::size_t kCacheLineBytes = 64;
+constexpr std::size_t kFallbackFlushBytes = std::size_t{64} << 20;
+
+/// Parses sysfs cache sizes such as "48K" or "105M".
+std::size_t ParseCacheSize(const std::string &text) {
+  std::size_t pos = 0;
+  std::size_t value = 0;
+  try {
+    value = std::stoull(text, &pos);
+  } catch (...) {
+    return 0;
+  }
+  if (pos < text.size()) {
+    switch (text[pos]) {
+      case 'K':
+        return value << 10;
+      case 'M':
+        return value << 20;
+      case 'G':
+        return value << 30;
+      default:
+        break;
+    }
+  }
+  return value;
+}
+
+}  // namespace
+
+std::string GetCacheStateName(CacheState state) {
+  return state == CacheState::kCold ? "cold" : "warm";
+}
+
+std::size_t DetectLastLevelCacheBytes() {
+  const std::filesystem::path cache_dir("/sys/devices/system/cpu/cpu0/cache");
+  std::error_code ec;
+  std::size_t largest = 0;
+  for (const auto &entry : std::filesystem::directory_iterator(cache_dir, ec)) {
+    if (!entry.path().filename().string().starts_with("index")) {
+      continue;
+    }
+    std::ifstream size_file(entry.path() / "size");
+    std::string size;
+    if (size_file >> size) {
+      largest = std::max(largest, ParseCacheSize(size));
+    }
+  }
+  return largest;
+}
+
+CacheFlusher::CacheFlusher(std::size_t bytes) {
+  if (bytes == 0) {
+    const std::size_t llc = DetectLastLevelCacheBytes();
+    bytes = llc > 0 ? 2 * llc : kFallbackFlushBytes;
+  }
+  buffer_.assign(bytes, 0);
+}
+
+void CacheFlusher::Flush() {
+  for (std::size_t i = 0; i < buffer_.size(); i += kCacheLineBytes) {
+    buffer_[i]++;
+  }
+}
+
+}  // namespace ppc::performance
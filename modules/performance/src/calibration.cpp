@@ -0,0 +1,373 @@
+#include "performance/include/calibration.hpp"
+
+#include <mpi.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "performance/include/cache_control.hpp"
+#include "performance/include/run_metadata.hpp"
+
+namespace ppc::performance {
+
+namespace {
+
+constexpr int kStreamRepeats = 10;
+constexpr std::size_t kMinStreamElements = std::size_t{1} << 21;
+constexpr std::size_t kFallbackCacheBytes = std::size_t{32} << 20;
+constexpr double kStreamScalar = 3.0;
+
+constexpr int kFlopChains = 16;
+constexpr int64_t kFlopIterations = int64_t{1} << 22;
+constexpr int kFlopRepeats = 3;
+
+constexpr int kPingPongLatencyReps = 1000;
+constexpr int kPingPongBandwidthReps = 20;
+constexpr int kPingPongBandwidthBytes = 4 << 20;
+constexpr int kPingPongWarmup = 10;
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+/// Best of kStreamRepeats timings of @p kernel, which must be an OpenMP parallel loop.
+template <typename Kernel>
+double BestTime(const Kernel &kernel) {
+  double best = std::numeric_limits<double>::infinity();
+  for (int repeat = 0; repeat < kStreamRepeats; repeat++) {
+    const double begin = omp_get_wtime();
+    kernel();
+    best = std::min(best, omp_get_wtime() - begin);
+  }
+  return best;
+}
+
+/// Round trips of @p bytes between ranks 0 and 1; returns the elapsed time on rank 0.
+double PingPongSeconds(int rank, std::vector<char> &buffer, int bytes, int reps) {
+  const double begin = MPI_Wtime();
+  for (int i = 0; i < reps; i++) {
+    if (rank == 0) {
+      MPI_Send(buffer.data(), bytes, MPI_CHAR, 1, 0, MPI_COMM_WORLD);
+      MPI_Recv(buffer.data(), bytes, MPI_CHAR, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    } else if (rank == 1) {
+      MPI_Recv(buffer.data(), bytes, MPI_CHAR, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      MPI_Send(buffer.data(), bytes, MPI_CHAR, 0, 0, MPI_COMM_WORLD);
+    }
+  }
+  return MPI_Wtime() - begin;
+}
+
+/// Waits for rank 0 without the busy polling of MPI_Barrier, so the waiting ranks leave the cores to its kernels.
+void WaitForRoot(int rank) {
+  MPI_Request request = MPI_REQUEST_NULL;
+  MPI_Ibarrier(MPI_COMM_WORLD, &request);
+  if (rank == 0) {
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    return;
+  }
+  int done = 0;
+  MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+  while (done == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+  }
+}
+
+double FiniteOr(const nlohmann::json &json, const char *key, double fallback) {
+  return json.contains(key) && json[key].is_number() ? json[key].get<double>() : fallback;
+}
+
+nlohmann::json FiniteOrNull(double value) {
+  return std::isfinite(value) ? nlohmann::json(value) : nlohmann::json(nullptr);
+}
+
+std::optional<MachineCalibration> LoadCalibration(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  const auto json = nlohmann::json::parse(file, nullptr, false);
+  return json.is_discarded() ? std::nullopt : CalibrationFromJson(json);
+}
+
+void StoreCalibration(const std::filesystem::path &path, const MachineCalibration &calibration) {
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  // A failed write only costs the next run another measurement
+  std::ofstream(path) << CalibrationToJson(calibration).dump(2) << '\n';
+}
+
+}  // namespace
+
+StreamBandwidth MeasureStreamBandwidth(int workers, std::size_t elements) {
+  if (elements == 0) {
+    const auto cache_bytes = DetectLastLevelCacheBytes();
+    elements = std::max(4 * (cache_bytes == 0 ? kFallbackCacheBytes : cache_bytes) / sizeof(double),
+                        kMinStreamElements);
+  }
+  const auto n = static_cast<int64_t>(elements);
+  std::vector<double> a(elements);
+  std::vector<double> b(elements);
+  std::vector<double> c(elements);
+  // First touch with the kernels' schedule places the pages near the threads that stream them
+#pragma omp parallel for num_threads(workers) schedule(static) default(none) shared(a, b, c, n)
+  for (int64_t i = 0; i < n; i++) {
+    a[i] = 1.0;
+    b[i] = 2.0;
+    c[i] = 0.0;
+  }
+
+  const double q = kStreamScalar;
+  const double copy = BestTime([&] {
+#pragma omp parallel for num_threads(workers) schedule(static) default(none) shared(a, c, n)
+    for (int64_t i = 0; i < n; i++) {
+      c[i] = a[i];
+    }
+  });
+  const double scale = BestTime([&] {
+#pragma omp parallel for num_threads(workers) schedule(static) default(none) shared(b, c, n, q)
+    for (int64_t i = 0; i < n; i++) {
+      b[i] = q * c[i];
+    }
+  });
+  const double add = BestTime([&] {
+#pragma omp parallel for num_threads(workers) schedule(static) default(none) shared(a, b, c, n)
+    for (int64_t i = 0; i < n; i++) {
+      c[i] = a[i] + b[i];
+    }
+  });
+  const double triad = BestTime([&] {
+#pragma omp parallel for num_threads(workers) schedule(static) default(none) shared(a, b, c, n, q)
+    for (int64_t i = 0; i < n; i++) {
+      a[i] = b[i] + (q * c[i]);
+    }
+  });
+
+  const auto array_bytes = static_cast<double>(elements * sizeof(double));
+  return {.copy = 2.0 * array_bytes / copy,
+          .scale = 2.0 * array_bytes / scale,
+          .add = 3.0 * array_bytes / add,
+          .triad = 3.0 * array_bytes / triad};
+}
+
+double MeasurePeakFlops(int workers) {
+  double best = std::numeric_limits<double>::infinity();
+  double checksum = 0.0;
+  for (int repeat = 0; repeat < kFlopRepeats; repeat++) {
+    double sum = 0.0;
+    const double begin = omp_get_wtime();
+#pragma omp parallel num_threads(workers) default(none) reduction(+ : sum)
+    {
+      std::array<double, kFlopChains> acc{};
+      for (int chain = 0; chain < kFlopChains; chain++) {
+        acc.at(chain) = 1.0 + (1e-3 * chain) + (1e-6 * omp_get_thread_num());
+      }
+      // Factors close to one keep the chains finite; their sum keeps the loop from being optimized away
+      const double mul = 0.999999;
+      const double add = 1e-7;
+      for (int64_t i = 0; i < kFlopIterations; i++) {
+        for (auto &value : acc) {
+          value = (value * mul) + add;
+        }
+      }
+      for (double value : acc) {
+        sum += value;
+      }
+    }
+    best = std::min(best, omp_get_wtime() - begin);
+    checksum += sum;
+  }
+  const double flops = 2.0 * kFlopChains * static_cast<double>(kFlopIterations) * workers;
+  return std::isfinite(checksum) ? flops / best : kNaN;
+}
+
+PingPong MeasureMpiPingPong() {
+  int rank = 0;
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (size < 2) {
+    return {.latency_sec = kNaN, .bandwidth = kNaN};
+  }
+  std::vector<char> buffer(kPingPongBandwidthBytes);
+  PingPongSeconds(rank, buffer, 8, kPingPongWarmup);
+  const double latency_sec = PingPongSeconds(rank, buffer, 8, kPingPongLatencyReps) / (2.0 * kPingPongLatencyReps);
+  PingPongSeconds(rank, buffer, kPingPongBandwidthBytes, 1);
+  const double bandwidth_sec = PingPongSeconds(rank, buffer, kPingPongBandwidthBytes, kPingPongBandwidthReps);
+  std::array<double, 2> result = {latency_sec,
+                                  2.0 * kPingPongBandwidthBytes * kPingPongBandwidthReps / bandwidth_sec};
+  MPI_Bcast(result.data(), static_cast<int>(result.size()), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  return {.latency_sec = result[0], .bandwidth = result[1]};
+}
+
+nlohmann::json CalibrationToJson(const MachineCalibration &calibration) {
+  return {{"schema", "ppc.calibration.v1"},
+          {"hostname", calibration.hostname},
+          {"cpu_model", calibration.cpu_model},
+          {"workers", calibration.workers},
+          {"stream",
+           {{"copy", calibration.stream.copy},
+            {"scale", calibration.stream.scale},
+            {"add", calibration.stream.add},
+            {"triad", calibration.stream.triad}}},
+          {"peak_flops", FiniteOrNull(calibration.peak_flops)},
+          {"mpi_latency_sec", FiniteOrNull(calibration.mpi_latency_sec)},
+          {"mpi_bandwidth", FiniteOrNull(calibration.mpi_bandwidth)},
+          {"timestamp", calibration.timestamp}};
+}
+
+std::optional<MachineCalibration> CalibrationFromJson(const nlohmann::json &json) {
+  if (!json.is_object() || !json.contains("stream") || !json["stream"].is_object() || !json.contains("workers")) {
+    return std::nullopt;
+  }
+  const auto &stream = json["stream"];
+  MachineCalibration calibration;
+  calibration.hostname = json.value("hostname", "");
+  calibration.cpu_model = json.value("cpu_model", "");
+  calibration.workers = json["workers"].get<int>();
+  calibration.stream = {.copy = FiniteOr(stream, "copy", kNaN),
+                        .scale = FiniteOr(stream, "scale", kNaN),
+                        .add = FiniteOr(stream, "add", kNaN),
+                        .triad = FiniteOr(stream, "triad", kNaN)};
+  calibration.peak_flops = FiniteOr(json, "peak_flops", kNaN);
+  calibration.mpi_latency_sec = FiniteOr(json, "mpi_latency_sec", kNaN);
+  calibration.mpi_bandwidth = FiniteOr(json, "mpi_bandwidth", kNaN);
+  calibration.timestamp = json.value("timestamp", int64_t{0});
+  if (!std::isfinite(calibration.stream.triad)) {
+    return std::nullopt;
+  }
+  return calibration;
+}
+
+std::filesystem::path GetCalibrationPath(const std::filesystem::path &dir, const std::string &hostname, int workers) {
+  std::string name = hostname.empty() ? "unknown" : hostname;
+  std::ranges::replace_if(name, [](char c) { return c == '/' || c == '\\' || c == ':'; }, '_');
+  return dir / (name + "_w" + std::to_string(workers) + ".json");
+}
+
+const MachineCalibration &GetMachineCalibration(const std::filesystem::path &dir, int workers) {
+  static std::map<int, MachineCalibration> measured;
+  int rank = 0;
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Bcast(&workers, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  workers = std::max(workers, 1);
+  if (auto it = measured.find(workers); it != measured.end()) {
+    return it->second;
+  }
+
+  const auto &metadata = GetRunMetadata();
+  const auto path = GetCalibrationPath(dir, metadata.hostname, workers);
+  std::optional<MachineCalibration> stored;
+  std::array<int, 2> need = {0, 0};
+  if (rank == 0) {
+    stored = dir.empty() ? std::nullopt : LoadCalibration(path);
+    need[0] = stored.has_value() ? 0 : 1;
+    need[1] = size > 1 && (!stored.has_value() || !std::isfinite(stored->mpi_latency_sec)) ? 1 : 0;
+  }
+  MPI_Bcast(need.data(), static_cast<int>(need.size()), MPI_INT, 0, MPI_COMM_WORLD);
+
+  MachineCalibration calibration = stored.value_or(MachineCalibration{});
+  if (need[0] != 0) {
+    if (rank == 0) {
+      calibration.hostname = metadata.hostname;
+      calibration.cpu_model = metadata.cpu_model;
+      calibration.workers = workers;
+      calibration.stream = MeasureStreamBandwidth(workers);
+      calibration.peak_flops = MeasurePeakFlops(workers);
+      calibration.mpi_latency_sec = kNaN;
+      calibration.mpi_bandwidth = kNaN;
+    }
+    WaitForRoot(rank);
+  }
+  if (need[1] != 0) {
+    const auto ping_pong = MeasureMpiPingPong();
+    calibration.mpi_latency_sec = ping_pong.latency_sec;
+    calibration.mpi_bandwidth = ping_pong.bandwidth;
+  }
+  if (rank == 0 && (need[0] != 0 || need[1] != 0)) {
+    calibration.timestamp =
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    if (!dir.empty()) {
+      StoreCalibration(path, calibration);
+    }
+  }
+
+  // Every rank reports against the same limits
+  std::string text = rank == 0 ? CalibrationToJson(calibration).dump() : std::string{};
+  int length = static_cast<int>(text.size());
+  MPI_Bcast(&length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  text.resize(static_cast<std::size_t>(length));
+  MPI_Bcast(text.data(), length, MPI_CHAR, 0, MPI_COMM_WORLD);
+  calibration = CalibrationFromJson(nlohmann::json::parse(text)).value_or(calibration);
+  return measured.insert_or_assign(workers, calibration).first->second;
+}
+
+RooflinePoint ComputeRoofline(double bytes, std::optional<double> flops, double seconds,
+                              const MachineCalibration &calibration) {
+  RooflinePoint point;
+  const double triad = calibration.stream.triad;
+  point.bytes_per_sec = seconds > 0.0 ? bytes / seconds : 0.0;
+  point.stream_fraction = triad > 0.0 ? point.bytes_per_sec / triad : kNaN;
+  if (!flops.has_value() || bytes <= 0.0) {
+    point.intensity = kNaN;
+    point.flops_per_sec = kNaN;
+    point.attainable_flops = kNaN;
+    point.roofline_fraction = kNaN;
+    return point;
+  }
+  point.intensity = flops.value() / bytes;
+  point.flops_per_sec = seconds > 0.0 ? flops.value() / seconds : 0.0;
+  const double memory_roof = point.intensity * triad;
+  const double peak = std::isfinite(calibration.peak_flops) ? calibration.peak_flops : memory_roof;
+  point.attainable_flops = std::min(peak, memory_roof);
+  point.roofline_fraction = point.attainable_flops > 0.0 ? point.flops_per_sec / point.attainable_flops : kNaN;
+  point.bound = memory_roof < peak ? "memory" : "compute";
+  return point;
+}
+
+nlohmann::json RooflineToJson(const RooflinePoint &point, const MachineCalibration &calibration) {
+  nlohmann::json json = {{"workers", calibration.workers},
+                         {"stream_triad", calibration.stream.triad},
+                         {"peak_flops", FiniteOrNull(calibration.peak_flops)},
+                         {"bytes_per_sec", point.bytes_per_sec},
+                         {"stream_fraction", FiniteOrNull(point.stream_fraction)}};
+  if (!point.bound.empty()) {
+    json["intensity"] = point.intensity;
+    json["flops_per_sec"] = point.flops_per_sec;
+    json["attainable_flops"] = point.attainable_flops;
+    json["roofline_fraction"] = FiniteOrNull(point.roofline_fraction);
+    json["bound"] = point.bound;
+  }
+  return json;
+}
+
+std::string FormatRoofline(const RooflinePoint &point) {
+  std::ostringstream out;
+  out << std::setprecision(6) << "bytes_per_sec=" << point.bytes_per_sec << " stream_pct=" << std::fixed
+      << std::setprecision(2) << point.stream_fraction * 100.0;
+  if (!point.bound.empty()) {
+    out << std::defaultfloat << std::setprecision(6) << " intensity=" << point.intensity
+        << " flops_per_sec=" << point.flops_per_sec << " roofline_pct=" << std::fixed << std::setprecision(2)
+        << point.roofline_fraction * 100.0 << " bound=" << point.bound;
+  }
+  return out.str();
+}
+
+}  // namespace ppc::performance
@@ -0,0 +1,260 @@
+#include "performance/include/comm_bench.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "performance/include/performance.hpp"
+
+namespace ppc::performance {
+
+namespace {
+
+constexpr std::size_t kIterationTargetBytes = std::size_t{64} << 20;
+
+/// Inputs and outputs of one pattern, refilled before every iteration so that each one does the same work.
+struct PatternBuffers {
+  std::vector<char> block;
+  std::vector<uint64_t> values;
+  std::vector<uint64_t> reduced;
+  std::vector<double> part;
+  std::vector<double> gathered;
+  std::vector<int> counts;
+  std::vector<int> displs;
+};
+
+int CommRank(MPI_Comm comm) {
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  return rank;
+}
+
+int CommSize(MPI_Comm comm) {
+  int size = 1;
+  MPI_Comm_size(comm, &size);
+  return size;
+}
+
+PatternBuffers MakeBuffers(CommPattern pattern, std::size_t bytes, MPI_Comm comm) {
+  const int rank = CommRank(comm);
+  const int size = CommSize(comm);
+  PatternBuffers buffers;
+  if (pattern == CommPattern::kBcast) {
+    buffers.block.resize(std::max<std::size_t>(bytes, 1));
+  } else if (pattern == CommPattern::kReduce) {
+    buffers.values.resize(std::max<std::size_t>(bytes / sizeof(uint64_t), 1));
+    buffers.reduced.resize(buffers.values.size());
+  } else {
+    // The total is split as evenly as the task's Scatterv splits its input
+    const std::size_t elements = bytes / sizeof(double);
+    const auto usize = static_cast<std::size_t>(size);
+    buffers.counts.resize(usize);
+    buffers.displs.resize(usize);
+    for (std::size_t i = 0; i < usize; i++) {
+      buffers.counts[i] = static_cast<int>((elements / usize) + (i < elements % usize ? 1 : 0));
+      buffers.displs[i] = i == 0 ? 0 : buffers.displs[i - 1] + buffers.counts[i - 1];
+    }
+    buffers.part.resize(static_cast<std::size_t>(buffers.counts[static_cast<std::size_t>(rank)]));
+    buffers.gathered.resize(rank == 0 ? elements : 0);
+  }
+  return buffers;
+}
+
+void FillBuffers(CommPattern pattern, PatternBuffers &buffers, MPI_Comm comm) {
+  const int rank = CommRank(comm);
+  if (pattern == CommPattern::kBcast) {
+    for (std::size_t i = 0; i < buffers.block.size(); i++) {
+      buffers.block[i] = static_cast<char>(rank == 0 ? (i * 31) % 127 : 0);
+    }
+  } else if (pattern == CommPattern::kReduce) {
+    for (std::size_t i = 0; i < buffers.values.size(); i++) {
+      buffers.values[i] = static_cast<uint64_t>(rank) + i;
+    }
+  } else {
+    for (std::size_t i = 0; i < buffers.part.size(); i++) {
+      buffers.part[i] = static_cast<double>(rank) + (static_cast<double>(i) * 0.5);
+    }
+  }
+}
+
+const CustomCollective &FindCustomCollective(CommPattern pattern) {
+  const auto &registry = CustomCollectiveRegistry();
+  const auto it = registry.find(pattern);
+  if (it == registry.end()) {
+    throw std::runtime_error("No task registered a custom " + GetCommPatternName(pattern) + " implementation");
+  }
+  return it->second;
+}
+
+void RunPattern(CommPattern pattern, const CustomCollective *custom, PatternBuffers &buffers, MPI_Comm comm) {
+  if (pattern == CommPattern::kBcast) {
+    if (custom != nullptr) {
+      custom->bcast(buffers.block, comm);
+    } else {
+      MPI_Bcast(buffers.block.data(), static_cast<int>(buffers.block.size()), MPI_CHAR, 0, comm);
+    }
+  } else if (pattern == CommPattern::kReduce) {
+    if (custom != nullptr) {
+      custom->reduce(buffers.values, comm);
+    } else {
+      MPI_Reduce(buffers.values.data(), buffers.reduced.data(), static_cast<int>(buffers.values.size()),
+                 MPI_UINT64_T, MPI_SUM, 0, comm);
+    }
+  } else if (custom != nullptr) {
+    buffers.gathered = custom->gather(buffers.part, comm);
+  } else {
+    // Like the tree, rank 0 learns the block sizes from the other ranks rather than assuming them
+    const int count = static_cast<int>(buffers.part.size());
+    MPI_Gather(&count, 1, MPI_INT, buffers.counts.data(), 1, MPI_INT, 0, comm);
+    if (CommRank(comm) == 0) {
+      for (std::size_t i = 1; i < buffers.counts.size(); i++) {
+        buffers.displs[i] = buffers.displs[i - 1] + buffers.counts[i - 1];
+      }
+    }
+    MPI_Gatherv(buffers.part.data(), count, MPI_DOUBLE, buffers.gathered.data(), buffers.counts.data(),
+                buffers.displs.data(), MPI_DOUBLE, 0, comm);
+  }
+}
+
+/// The part of the result that both implementations define: the broadcast buffer everywhere, rank 0's result else.
+std::vector<char> ResultBytes(CommPattern pattern, bool custom, const PatternBuffers &buffers, MPI_Comm comm) {
+  if (pattern == CommPattern::kBcast) {
+    return buffers.block;
+  }
+  if (CommRank(comm) != 0) {
+    return {};
+  }
+  if (pattern == CommPattern::kReduce) {
+    const auto &sum = custom ? buffers.values : buffers.reduced;
+    const auto *begin = reinterpret_cast<const char *>(sum.data());
+    return {begin, begin + (sum.size() * sizeof(uint64_t))};
+  }
+  const auto *begin = reinterpret_cast<const char *>(buffers.gathered.data());
+  return {begin, begin + (buffers.gathered.size() * sizeof(double))};
+}
+
+bool CustomMatchesNative(CommPattern pattern, const CustomCollective &collective, std::size_t bytes,
+                         MPI_Comm comm) {
+  std::array<std::vector<char>, 2> results;
+  for (const bool custom : {false, true}) {
+    auto buffers = MakeBuffers(pattern, bytes, comm);
+    FillBuffers(pattern, buffers, comm);
+    RunPattern(pattern, custom ? &collective : nullptr, buffers, comm);
+    results.at(custom ? 1 : 0) = ResultBytes(pattern, custom, buffers, comm);
+  }
+  int local = results[0] == results[1] ? 1 : 0;
+  int global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_LAND, comm);
+  return global != 0;
+}
+
+nlohmann::json StatsToJson(const PerfStatistics &stats) {
+  return {{"min", stats.min},       {"max", stats.max}, {"mean", stats.mean},     {"median", stats.median},
+          {"p90", stats.p90},       {"p99", stats.p99}, {"stddev", stats.stddev}, {"mad", stats.mad}};
+}
+
+}  // namespace
+
+std::string GetCommPatternName(CommPattern pattern) {
+  switch (pattern) {
+    case CommPattern::kBcast:
+      return "bcast";
+    case CommPattern::kReduce:
+      return "reduce";
+    case CommPattern::kGather:
+      return "gather";
+  }
+  return "unknown";
+}
+
+CommPattern ParseCommPattern(const std::string &name) {
+  for (const auto pattern : {CommPattern::kBcast, CommPattern::kReduce, CommPattern::kGather}) {
+    if (GetCommPatternName(pattern) == name) {
+      return pattern;
+    }
+  }
+  throw std::runtime_error("Unknown pattern '" + name + "' (expected bcast, reduce or gather)");
+}
+
+std::map<CommPattern, CustomCollective> &CustomCollectiveRegistry() {
+  static std::map<CommPattern, CustomCollective> registry;
+  return registry;
+}
+
+bool RegisterCustomCollective(CommPattern pattern, CustomCollective collective) {
+  auto &registry = CustomCollectiveRegistry();
+  if (const auto it = registry.find(pattern); it != registry.end()) {
+    throw std::runtime_error("Custom " + GetCommPatternName(pattern) + " implementation registered by both " +
+                             it->second.task + " and " + collective.task);
+  }
+  registry.emplace(pattern, std::move(collective));
+  return true;
+}
+
+std::size_t GetCommBenchIterations(std::size_t bytes, std::size_t min_iterations, std::size_t max_iterations) {
+  return std::clamp(kIterationTargetBytes / std::max<std::size_t>(bytes, 1), min_iterations, max_iterations);
+}
+
+CommBenchPoint MeasureCommPattern(CommPattern pattern, bool custom, std::size_t bytes, std::size_t iterations,
+                                  MPI_Comm comm, bool check) {
+  CommBenchPoint point;
+  point.pattern = pattern;
+  point.implementation = custom ? "custom" : "native";
+  point.ranks = CommSize(comm);
+  point.bytes = bytes;
+  const CustomCollective *collective = custom ? &FindCustomCollective(pattern) : nullptr;
+  if (collective != nullptr) {
+    point.task = collective->task;
+  }
+
+  auto buffers = MakeBuffers(pattern, bytes, comm);
+  for (std::size_t i = 0; i <= iterations; i++) {
+    FillBuffers(pattern, buffers, comm);
+    MPI_Barrier(comm);
+    const double begin = MPI_Wtime();
+    RunPattern(pattern, collective, buffers, comm);
+    const double local = MPI_Wtime() - begin;
+    double slowest = 0.0;
+    MPI_Allreduce(&local, &slowest, 1, MPI_DOUBLE, MPI_MAX, comm);
+    // The first iteration warms up connections and buffers
+    if (i > 0) {
+      point.samples.push_back(slowest);
+    }
+  }
+  point.stats = ComputeStatistics(point.samples);
+  point.bandwidth = point.stats.median > 0.0 ? static_cast<double>(bytes) / point.stats.median : 0.0;
+  if (check && collective != nullptr) {
+    point.matches = CustomMatchesNative(pattern, *collective, bytes, comm);
+  }
+  return point;
+}
+
+nlohmann::json CommBenchPointToJson(const CommBenchPoint &point) {
+  return {{"schema", "ppc.comm_bench.v1"},
+          {"pattern", GetCommPatternName(point.pattern)},
+          {"implementation", point.implementation},
+          {"task", point.task.empty() ? nlohmann::json(nullptr) : nlohmann::json(point.task)},
+          {"ranks", point.ranks},
+          {"bytes", point.bytes},
+          {"iterations", point.samples.size()},
+          {"samples", point.samples},
+          {"stats", StatsToJson(point.stats)},
+          {"latency_sec", point.stats.median},
+          {"bandwidth", point.bandwidth},
+          {"matches", point.matches.has_value() ? nlohmann::json(point.matches.value()) : nlohmann::json(nullptr)}};
+}
+
+double CommBenchSpeedup(const CommBenchPoint &custom, const CommBenchPoint &native) {
+  return custom.stats.median > 0.0 ? native.stats.median / custom.stats.median : 0.0;
+}
+
+}  // namespace ppc::performance
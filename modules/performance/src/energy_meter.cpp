@@ -0,0 +1,130 @@
+#include "performance/include/energy_meter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace ppc::performance {
+
+namespace {
+
+constexpr double kJoulesPerMicrojoule = 1e-6;
+
+std::optional<uint64_t> ReadCounter(const std::filesystem::path &file) {
+  std::ifstream in(file);
+  uint64_t value = 0;
+  if (in >> value) {
+    return value;
+  }
+  return std::nullopt;
+}
+
+std::string ReadZoneName(const std::filesystem::path &zone_dir) {
+  std::ifstream in(zone_dir / "name");
+  std::string name;
+  in >> name;
+  return name;
+}
+
+}  // namespace
+
+uint64_t EnergyDeltaMicrojoules(uint64_t begin, uint64_t end, uint64_t max_range_uj) {
+  if (end >= begin) {
+    return end - begin;
+  }
+  return max_range_uj > begin ? (max_range_uj - begin) + end : end;
+}
+
+EnergyStats ComputeEnergyStats(double total_joules, const std::vector<double> &samples, const std::string &zones) {
+  EnergyStats stats;
+  if (!std::isfinite(total_joules) || samples.empty()) {
+    return stats;
+  }
+  double total_sec = 0.0;
+  for (double sample : samples) {
+    total_sec += sample;
+  }
+  const auto n = static_cast<double>(samples.size());
+  stats.available = true;
+  stats.joules = total_joules / n;
+  stats.avg_watts = total_sec > 0.0 ? total_joules / total_sec : 0.0;
+  stats.edp = stats.joules * (total_sec / n);
+  stats.zones = zones;
+  return stats;
+}
+
+EnergyMeter::EnergyMeter(const std::filesystem::path &powercap_root) {
+  std::vector<EnergyZone> packages;
+  std::vector<EnergyZone> platform;
+  std::size_t unreadable = 0;
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(powercap_root, ec)) {
+    // Zones are "intel-rapl:<package>" with subzones "intel-rapl:<package>:<domain>"
+    const auto dir_name = entry.path().filename().string();
+    if (!dir_name.starts_with("intel-rapl:")) {
+      continue;
+    }
+    const auto depth = std::ranges::count(dir_name, ':');
+    const auto name = ReadZoneName(entry.path());
+    const bool is_package = depth == 1 && name.starts_with("package");
+    const bool is_dram = depth == 2 && name == "dram";
+    const bool is_platform = depth == 1 && name == "psys";
+    if (!is_package && !is_dram && !is_platform) {
+      continue;
+    }
+    EnergyZone zone{.name = name,
+                    .energy_file = entry.path() / "energy_uj",
+                    .max_range_uj = ReadCounter(entry.path() / "max_energy_range_uj").value_or(0)};
+    if (!ReadCounter(zone.energy_file).has_value()) {
+      unreadable++;
+      continue;
+    }
+    (is_platform ? platform : packages).push_back(std::move(zone));
+  }
+  zones_ = packages.empty() ? platform : packages;
+  std::ranges::sort(zones_, {}, &EnergyZone::energy_file);
+  if (!zones_.empty()) {
+    return;
+  }
+  if (unreadable > 0) {
+    unavailable_reason_ = "RAPL energy_uj under " + powercap_root.string() +
+                          " is not readable (root only since Linux 5.10; grant read access to measure energy)";
+  } else {
+    unavailable_reason_ = "no RAPL package zones under " + powercap_root.string();
+  }
+}
+
+std::string EnergyMeter::GetZoneNames() const {
+  std::string names;
+  for (const auto &zone : zones_) {
+    names += (names.empty() ? "" : ",") + zone.name;
+  }
+  return names;
+}
+
+std::vector<uint64_t> EnergyMeter::Read() const {
+  std::vector<uint64_t> reading;
+  reading.reserve(zones_.size());
+  for (const auto &zone : zones_) {
+    reading.push_back(ReadCounter(zone.energy_file).value_or(0));
+  }
+  return reading;
+}
+
+double EnergyMeter::JoulesBetween(const std::vector<uint64_t> &begin, const std::vector<uint64_t> &end) const {
+  uint64_t microjoules = 0;
+  for (std::size_t i = 0; i < zones_.size() && i < begin.size() && i < end.size(); i++) {
+    microjoules += EnergyDeltaMicrojoules(begin[i], end[i], zones_[i].max_range_uj);
+  }
+  return static_cast<double>(microjoules) * kJoulesPerMicrojoule;
+}
+
+}  // namespace ppc::performance
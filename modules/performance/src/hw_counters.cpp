@@ -0,0 +1,277 @@
+#include "performance/include/hw_counters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+#  include <cerrno>
+#  include <charconv>
+#  include <cstring>
+#  include <filesystem>
+#  include <fstream>
+#  include <optional>
+#  include <sstream>
+#  include <system_error>
+#endif
+
+namespace ppc::performance {
+
+namespace {
+
+double PerKiloInstruction(const HwCounterValues &mean, HwCounter counter) {
+  const double instructions = mean.Get(HwCounter::kInstructions);
+  if (!mean.IsValid(counter) || !mean.IsValid(HwCounter::kInstructions) || instructions <= 0.0) {
+    return 0.0;
+  }
+  return mean.Get(counter) * 1000.0 / instructions;
+}
+
+#ifdef __linux__
+
+struct EventConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr std::array<EventConfig, kHwCounterCount> kEventConfigs = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U)},
+}};
+
+int OpenEvent(const EventConfig &event, int tid) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+/// Start time of thread @p tid in clock ticks since boot (field 22 of its stat file); empty if it has exited.
+std::optional<uint64_t> ReadThreadStartTime(int tid) {
+  std::ifstream file("/proc/self/task/" + std::to_string(tid) + "/stat");
+  std::string line;
+  if (!std::getline(file, line)) {
+    return std::nullopt;
+  }
+  // The command name in parentheses may contain spaces; field 3 follows its closing parenthesis
+  const auto name_end = line.rfind(')');
+  if (name_end == std::string::npos) {
+    return std::nullopt;
+  }
+  std::istringstream fields(line.substr(name_end + 1));
+  std::string field;
+  for (int i = 3; i < 22; i++) {
+    fields >> field;
+  }
+  uint64_t start_time = 0;
+  if (fields >> start_time) {
+    return start_time;
+  }
+  return std::nullopt;
+}
+
+void CloseEvents(const std::array<int, kHwCounterCount> &fds) {
+  for (int fd : fds) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+std::string ReadParanoidLevel() {
+  std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+  std::string level;
+  if (file >> level) {
+    return level;
+  }
+  return "?";
+}
+
+#endif
+
+}  // namespace
+
+HwCounterStats ComputeHwCounterStats(const std::vector<HwCounterValues> &samples) {
+  HwCounterStats stats;
+  if (samples.empty()) {
+    return stats;
+  }
+  for (std::size_t i = 0; i < kHwCounterCount; i++) {
+    bool valid = true;
+    double sum = 0.0;
+    for (const auto &sample : samples) {
+      valid = valid && sample.valid[i];
+      sum += sample.values[i];
+    }
+    stats.mean.valid[i] = valid;
+    stats.mean.values[i] = valid ? sum / static_cast<double>(samples.size()) : 0.0;
+    stats.available = stats.available || valid;
+  }
+  for (const auto &sample : samples) {
+    stats.threads = std::max(stats.threads, sample.threads);
+  }
+  const auto &mean = stats.mean;
+  if (mean.IsValid(HwCounter::kCycles) && mean.IsValid(HwCounter::kInstructions) &&
+      mean.Get(HwCounter::kCycles) > 0.0) {
+    stats.ipc = mean.Get(HwCounter::kInstructions) / mean.Get(HwCounter::kCycles);
+  }
+  stats.llc_mpki = PerKiloInstruction(mean, HwCounter::kLlcMisses);
+  stats.branch_mpki = PerKiloInstruction(mean, HwCounter::kBranchMisses);
+  stats.dtlb_mpki = PerKiloInstruction(mean, HwCounter::kDtlbMisses);
+  return stats;
+}
+
+#ifdef __linux__
+
+HwCounterGroup::HwCounterGroup() {
+  const int last_errno = SyncThreads();
+  if (!IsAvailable()) {
+    unavailable_reason_ = std::string("perf_event_open failed: ") + std::strerror(last_errno) +
+                          " (perf_event_paranoid=" + ReadParanoidLevel() + ")";
+  }
+}
+
+HwCounterGroup::~HwCounterGroup() {
+  for (const auto &thread : threads_) {
+    CloseEvents(thread.fds);
+  }
+}
+
+int HwCounterGroup::SyncThreads() {
+  std::vector<ThreadEvents> alive;
+  int last_errno = 0;
+  std::error_code error;
+  for (const auto &entry : std::filesystem::directory_iterator("/proc/self/task", error)) {
+    int tid = 0;
+    const auto name = entry.path().filename().string();
+    if (std::from_chars(name.data(), name.data() + name.size(), tid).ec != std::errc()) {
+      continue;
+    }
+    const auto start_time = ReadThreadStartTime(tid);
+    if (!start_time.has_value()) {
+      continue;
+    }
+    // A recycled thread id has a later start time, so it gets events of its own
+    auto known = std::ranges::find_if(threads_, [&](const ThreadEvents &thread) {
+      return thread.tid == tid && thread.start_time == start_time.value();
+    });
+    if (known != threads_.end()) {
+      alive.push_back(*known);
+      known->fds.fill(-1);
+      continue;
+    }
+    ThreadEvents thread{.tid = tid, .start_time = start_time.value()};
+    for (std::size_t i = 0; i < kHwCounterCount; i++) {
+      thread.fds[i] = OpenEvent(kEventConfigs[i], tid);
+      if (thread.fds[i] < 0) {
+        last_errno = errno;
+      }
+    }
+    alive.push_back(thread);
+  }
+  // Whatever was not moved over belongs to exited threads
+  for (const auto &thread : threads_) {
+    CloseEvents(thread.fds);
+  }
+  threads_ = std::move(alive);
+  return last_errno;
+}
+
+bool HwCounterGroup::IsAvailable() const {
+  return std::ranges::any_of(threads_, [](const ThreadEvents &thread) {
+    return std::ranges::any_of(thread.fds, [](int fd) { return fd >= 0; });
+  });
+}
+
+void HwCounterGroup::Start() {
+  SyncThreads();
+  for (const auto &thread : threads_) {
+    for (int fd : thread.fds) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+  }
+}
+
+HwCounterValues HwCounterGroup::Stop() {
+  HwCounterValues result;
+  for (const auto &thread : threads_) {
+    for (int fd : thread.fds) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      }
+    }
+  }
+  for (const auto &thread : threads_) {
+    bool thread_read = false;
+    for (std::size_t i = 0; i < kHwCounterCount; i++) {
+      if (thread.fds[i] < 0) {
+        continue;
+      }
+      // value, time_enabled, time_running
+      std::array<uint64_t, 3> data{};
+      if (read(thread.fds[i], data.data(), sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+        continue;
+      }
+      thread_read = true;
+      // A thread that did not run during the sample contributes nothing
+      if (data[2] != 0) {
+        const double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        result.values[i] += static_cast<double>(data[0]) * scale;
+        result.valid[i] = true;
+      }
+    }
+    if (thread_read) {
+      result.threads++;
+    }
+  }
+  return result;
+}
+
+#else
+
+HwCounterGroup::HwCounterGroup() : unavailable_reason_("hardware counters require Linux perf_event_open") {}
+
+int HwCounterGroup::SyncThreads() {
+  return 0;
+}
+
+HwCounterGroup::~HwCounterGroup() = default;
+
+bool HwCounterGroup::IsAvailable() const {
+  return false;
+}
+
+void HwCounterGroup::Start() {}
+
+HwCounterValues HwCounterGroup::Stop() {
+  return {};
+}
+
+#endif
+
+const std::string &HwCounterGroup::GetUnavailableReason() const {
+  return unavailable_reason_;
+}
+
+}  // namespace ppc::performance
@@ -0,0 +1,271 @@
+#include "performance/include/mpi_profiler.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "util/include/util.hpp"
+
+namespace ppc::performance {
+
+namespace {
+
+/// Pipeline order of the stages, so the report reads top to bottom like the task runs.
+int StageOrder(std::string_view stage) {
+  constexpr std::array<std::string_view, 4> kStages = {"validation", "pre_processing", "run", "post_processing"};
+  const auto *it = std::ranges::find(kStages, stage);
+  return static_cast<int>(it - kStages.begin());
+}
+
+std::size_t CallOrder(const std::string &name) {
+  for (std::size_t i = 0; i < kMpiCallCount; i++) {
+    if (GetMpiCallName(static_cast<MpiCall>(i)) == name) {
+      return i;
+    }
+  }
+  return kMpiCallCount;
+}
+
+std::string FormatRow(const std::vector<uint64_t> &row) {
+  std::string out;
+  for (std::size_t i = 0; i < row.size(); i++) {
+    out += (i == 0 ? "" : ",") + std::to_string(row[i]);
+  }
+  return out;
+}
+
+}  // namespace
+
+std::string GetMpiCallName(MpiCall call) {
+  switch (call) {
+    case MpiCall::kSend:
+      return "MPI_Send";
+    case MpiCall::kRecv:
+      return "MPI_Recv";
+    case MpiCall::kSendrecv:
+      return "MPI_Sendrecv";
+    case MpiCall::kBcast:
+      return "MPI_Bcast";
+    case MpiCall::kScatter:
+      return "MPI_Scatter";
+    case MpiCall::kScatterv:
+      return "MPI_Scatterv";
+    case MpiCall::kGather:
+      return "MPI_Gather";
+    case MpiCall::kGatherv:
+      return "MPI_Gatherv";
+    case MpiCall::kAllgather:
+      return "MPI_Allgather";
+    case MpiCall::kAllgatherv:
+      return "MPI_Allgatherv";
+    case MpiCall::kReduce:
+      return "MPI_Reduce";
+    case MpiCall::kAllreduce:
+      return "MPI_Allreduce";
+    case MpiCall::kCommSplit:
+      return "MPI_Comm_split";
+    case MpiCall::kBarrier:
+      return "MPI_Barrier";
+  }
+  return "unknown";
+}
+
+void MpiProfile::Record(const std::string &task, std::string_view stage, MpiCall call, uint64_t bytes,
+                        double time_sec) {
+  const std::scoped_lock lock(mutex_);
+  auto &stats = calls_[{task.empty() ? "untracked" : task, std::string(stage)}][static_cast<std::size_t>(call)];
+  stats.calls++;
+  stats.bytes += bytes;
+  stats.time_sec += time_sec;
+}
+
+void MpiProfile::RecordTraffic(const std::string &task, int peer, uint64_t bytes) {
+  if (peer < 0) {
+    return;
+  }
+  const std::scoped_lock lock(mutex_);
+  auto &row = traffic_[task.empty() ? "untracked" : task];
+  if (row.size() <= static_cast<std::size_t>(peer)) {
+    row.resize(static_cast<std::size_t>(peer) + 1, 0);
+  }
+  row[static_cast<std::size_t>(peer)] += bytes;
+}
+
+bool MpiProfile::Empty() const {
+  const std::scoped_lock lock(mutex_);
+  return calls_.empty() && traffic_.empty();
+}
+
+void MpiProfile::Clear() {
+  const std::scoped_lock lock(mutex_);
+  calls_.clear();
+  traffic_.clear();
+}
+
+nlohmann::json MpiProfile::ToJson(int rank) const {
+  const std::scoped_lock lock(mutex_);
+  auto calls = nlohmann::json::array();
+  for (const auto &[key, per_call] : calls_) {
+    for (std::size_t i = 0; i < kMpiCallCount; i++) {
+      if (per_call[i].calls == 0) {
+        continue;
+      }
+      calls.push_back({{"task", key.first},
+                       {"stage", key.second},
+                       {"call", GetMpiCallName(static_cast<MpiCall>(i))},
+                       {"calls", per_call[i].calls},
+                       {"bytes", per_call[i].bytes},
+                       {"time_sec", per_call[i].time_sec}});
+    }
+  }
+  auto traffic = nlohmann::json::object();
+  for (const auto &[task, row] : traffic_) {
+    traffic[task] = row;
+  }
+  return {{"rank", rank}, {"calls", calls}, {"traffic", traffic}};
+}
+
+MpiProfile &GetMpiProfile() {
+  static MpiProfile profile;
+  return profile;
+}
+
+nlohmann::json MergeMpiProfiles(const std::vector<nlohmann::json> &ranks) {
+  struct Totals {
+    uint64_t calls = 0;
+    uint64_t bytes = 0;
+    double time_sec = 0.0;
+    double max_rank_time_sec = 0.0;
+  };
+  using Key = std::tuple<std::string, int, std::string, std::size_t, std::string>;
+  std::map<Key, Totals> calls;
+  using Matrix = std::vector<std::vector<uint64_t>>;
+  std::map<std::string, Matrix> traffic;
+  const std::size_t size = ranks.size();
+  Matrix total(size, std::vector<uint64_t>(size, 0));
+
+  for (const auto &profile : ranks) {
+    for (const auto &entry : profile["calls"]) {
+      const auto stage = entry["stage"].get<std::string>();
+      const auto call = entry["call"].get<std::string>();
+      auto &totals = calls[{entry["task"].get<std::string>(), StageOrder(stage), stage, CallOrder(call), call}];
+      const auto time_sec = entry["time_sec"].get<double>();
+      totals.calls += entry["calls"].get<uint64_t>();
+      totals.bytes += entry["bytes"].get<uint64_t>();
+      totals.time_sec += time_sec;
+      totals.max_rank_time_sec = std::max(totals.max_rank_time_sec, time_sec);
+    }
+    const auto rank = profile["rank"].get<std::size_t>();
+    if (rank >= size) {
+      continue;
+    }
+    for (const auto &[task, row] : profile["traffic"].items()) {
+      auto &matrix = traffic[task];
+      if (matrix.empty()) {
+        matrix.assign(size, std::vector<uint64_t>(size, 0));
+      }
+      const auto bytes = row.get<std::vector<uint64_t>>();
+      for (std::size_t peer = 0; peer < std::min(bytes.size(), size); peer++) {
+        matrix[rank][peer] += bytes[peer];
+        total[rank][peer] += bytes[peer];
+      }
+    }
+  }
+
+  auto report_calls = nlohmann::json::array();
+  for (const auto &[key, totals] : calls) {
+    report_calls.push_back({{"task", std::get<0>(key)},
+                            {"stage", std::get<2>(key)},
+                            {"call", std::get<4>(key)},
+                            {"calls", totals.calls},
+                            {"bytes", totals.bytes},
+                            {"time_sec", totals.time_sec},
+                            {"max_rank_time_sec", totals.max_rank_time_sec}});
+  }
+  auto report_traffic = nlohmann::json::object();
+  for (const auto &[task, matrix] : traffic) {
+    report_traffic[task] = matrix;
+  }
+  return {{"schema", "ppc.mpi_profile.v1"},
+          {"processes", size},
+          {"calls", report_calls},
+          {"traffic", report_traffic},
+          {"total_traffic", total}};
+}
+
+std::string FormatMpiProfile(const nlohmann::json &report) {
+  std::ostringstream out;
+  for (const auto &entry : report["calls"]) {
+    out << entry["task"].get<std::string>() << ":" << entry["stage"].get<std::string>() << ":mpi:"
+        << entry["call"].get<std::string>() << " calls=" << entry["calls"].get<uint64_t>()
+        << " bytes=" << entry["bytes"].get<uint64_t>() << " time_sec=" << entry["time_sec"].get<double>()
+        << " max_rank_time_sec=" << entry["max_rank_time_sec"].get<double>() << '\n';
+  }
+  auto print_matrix = [&out](const std::string &label, const nlohmann::json &matrix) {
+    const auto rows = matrix.get<std::vector<std::vector<uint64_t>>>();
+    for (std::size_t sender = 0; sender < rows.size(); sender++) {
+      out << label << ":traffic:from=" << sender << " bytes_to=" << FormatRow(rows[sender]) << '\n';
+    }
+  };
+  for (const auto &[task, matrix] : report["traffic"].items()) {
+    print_matrix(task, matrix);
+  }
+  print_matrix("total", report["total_traffic"]);
+  return out.str();
+}
+
+void ReportMpiProfile() {
+  int rank = 0;
+  int size = 1;
+  PMPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  PMPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  const int local_has_data = GetMpiProfile().Empty() ? 0 : 1;
+  int has_data = 0;
+  PMPI_Allreduce(&local_has_data, &has_data, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+  if (has_data == 0) {
+    return;
+  }
+
+  const auto local = GetMpiProfile().ToJson(rank).dump();
+  const int length = static_cast<int>(local.size());
+  std::vector<int> lengths(rank == 0 ? static_cast<std::size_t>(size) : 0);
+  PMPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  std::vector<int> displs(lengths.size(), 0);
+  for (std::size_t i = 1; i < lengths.size(); i++) {
+    displs[i] = displs[i - 1] + lengths[i - 1];
+  }
+  std::string gathered(rank == 0 ? static_cast<std::size_t>(displs.back() + lengths.back()) : 0, '\0');
+  PMPI_Gatherv(local.data(), length, MPI_CHAR, gathered.data(), lengths.data(), displs.data(), MPI_CHAR, 0,
+               MPI_COMM_WORLD);
+  if (rank != 0) {
+    return;
+  }
+
+  std::vector<nlohmann::json> profiles;
+  profiles.reserve(lengths.size());
+  for (std::size_t i = 0; i < lengths.size(); i++) {
+    profiles.push_back(nlohmann::json::parse(gathered.substr(displs[i], lengths[i])));
+  }
+  const auto report = MergeMpiProfiles(profiles);
+  std::cout << FormatMpiProfile(report);
+  if (const auto path = ppc::util::GetMpiProfileJsonPath(); !path.empty()) {
+    std::ofstream(path) << report.dump(2) << '\n';
+  }
+}
+
+}  // namespace ppc::performance
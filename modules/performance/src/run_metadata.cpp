@@ -0,0 +1,115 @@
+#include "performance/include/run_metadata.hpp"
+
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <libenvpp/detail/get.hpp>
+#include <string>
+
+#if defined(__linux__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+#ifdef __APPLE__
+#  include <sys/sysctl.h>
+#endif
+
+// Regenerated on every build by the ppc_git_sha target
+#if __has_include("ppc_git_sha.hpp")
+#  include "ppc_git_sha.hpp"
+#endif
+#ifndef PPC_GIT_SHA
+#  define PPC_GIT_SHA "unknown"
+#endif
+#ifndef PPC_BUILD_TYPE
+#  define PPC_BUILD_TYPE "unknown"
+#endif
+#ifndef PPC_CXX_FLAGS
+#  define PPC_CXX_FLAGS ""
+#endif
+
+namespace ppc::performance {
+
+namespace {
+
+std::string Trim(const std::string &value) {
+  const auto begin = value.find_first_not_of(" \t");
+  if (begin == std::string::npos) {
+    return {};
+  }
+  const auto end = value.find_last_not_of(" \t\r\n");
+  return value.substr(begin, end - begin + 1);
+}
+
+std::string DetectHostname() {
+#if defined(__linux__) || defined(__APPLE__)
+  std::array<char, 256> buffer{};
+  if (gethostname(buffer.data(), buffer.size() - 1) == 0) {
+    return {buffer.data()};
+  }
+#endif
+  if (auto name = env::get<std::string>("COMPUTERNAME"); name.has_value()) {
+    return name.value();
+  }
+  return "unknown";
+}
+
+std::string DetectCpuModel() {
+#if defined(__linux__)
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.starts_with("model name")) {
+      const auto colon = line.find(':');
+      if (colon != std::string::npos) {
+        return Trim(line.substr(colon + 1));
+      }
+    }
+  }
+#elif defined(__APPLE__)
+  std::array<char, 256> buffer{};
+  std::size_t size = buffer.size();
+  if (sysctlbyname("machdep.cpu.brand_string", buffer.data(), &size, nullptr, 0) == 0) {
+    return {buffer.data()};
+  }
+#endif
+  if (auto name = env::get<std::string>("PROCESSOR_IDENTIFIER"); name.has_value()) {
+    return name.value();
+  }
+  return "unknown";
+}
+
+std::string DetectCompiler() {
+#if defined(__clang__)
+  return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+  return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+  return "unknown";
+#endif
+}
+
+std::string DetectGitSha() {
+  if (auto sha = env::get<std::string>("PPC_GIT_SHA"); sha.has_value() && !sha->empty()) {
+    return sha.value();
+  }
+  const std::string built = PPC_GIT_SHA;
+  return built.empty() ? "unknown" : built;
+}
+
+}  // namespace
+
+const RunMetadata &GetRunMetadata() {
+  static const RunMetadata kMetadata{
+      .hostname = DetectHostname(),
+      .cpu_model = DetectCpuModel(),
+      .compiler = DetectCompiler(),
+      .compile_flags = Trim(PPC_CXX_FLAGS),
+      .build_type = PPC_BUILD_TYPE,
+      .git_sha = DetectGitSha(),
+  };
+  return kMetadata;
+}
+
+}  // namespace ppc::performance
@@ -0,0 +1,354 @@
+#include "performance/include/threading_profiler.hpp"
+
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "util/include/util.hpp"
+
+#if __has_include(<omp-tools.h>)
+#include <omp-tools.h>
+#define PPC_HAS_OMPT 1
+#endif
+
+namespace ppc::performance {
+
+namespace {
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct ActivitySlot {
+  std::string runtime;
+  int thread = 0;
+  std::atomic<int64_t> busy_ns{0};
+  std::atomic<int64_t> wait_ns{0};
+  std::atomic<uint64_t> entries{0};
+  /// TBB only: when the thread entered the arena, -1 outside of it. Guarded by the state mutex.
+  int64_t entered_ns = -1;
+  /// OpenMP only: start of the running work segment and of the running barrier wait, -1 if none.
+  std::atomic<int64_t> segment_begin_ns{-1};
+  std::atomic<int64_t> wait_begin_ns{-1};
+  /// OpenMP only: parallel region the running barrier wait belongs to.
+  std::atomic<uint64_t> wait_region{0};
+};
+
+/// Slots are never freed, so OpenMP threads can keep a pointer to theirs.
+struct ProfilerState {
+  std::mutex mutex;
+  std::deque<std::unique_ptr<ActivitySlot>> slots;
+  std::atomic<bool> recording{false};
+  /// Start of the current recording window; guarded by the mutex.
+  int64_t window_begin_ns = 0;
+  std::atomic<uint64_t> omp_regions{0};
+  std::atomic<bool> ompt_active{false};
+  /// Parallel regions started and the last one that ended, with its end time.
+  std::atomic<uint64_t> region{0};
+  std::atomic<uint64_t> ended_region{0};
+  std::atomic<int64_t> ended_ns{0};
+};
+
+ProfilerState &State() {
+  static ProfilerState state;
+  return state;
+}
+
+/// Caller holds the state mutex.
+ActivitySlot &FindOrAddSlot(const std::string &runtime, int thread) {
+  auto &state = State();
+  for (auto &slot : state.slots) {
+    if (slot->runtime == runtime && slot->thread == thread) {
+      return *slot;
+    }
+  }
+  auto &slot = state.slots.emplace_back(std::make_unique<ActivitySlot>());
+  slot->runtime = runtime;
+  slot->thread = thread;
+  return *slot;
+}
+
+/// Arena time of a thread inside the current window; caller holds the state mutex.
+int64_t ArenaTimeInWindow(const ActivitySlot &slot, int64_t now) {
+  return now - std::max(slot.entered_ns, State().window_begin_ns);
+}
+
+#ifdef PPC_HAS_OMPT
+
+// Runtimes such as libomp report the end of a worker's closing barrier only when the next region starts. Waits of a
+// region that already ended are therefore cut at its end, and Pause() settles the waits still open.
+
+/// Ends the thread's running barrier wait at @p now, or at the end of its region if that ended before.
+void SettleWait(ActivitySlot &slot, int64_t now) {
+  const int64_t begin = slot.wait_begin_ns.exchange(-1);
+  if (begin < 0) {
+    return;
+  }
+  auto &state = State();
+  const bool region_ended = state.ended_region.load() == slot.wait_region.load();
+  const int64_t end = region_ended ? std::min(now, state.ended_ns.load()) : now;
+  slot.wait_ns.fetch_add(std::max<int64_t>(end - begin, 0), std::memory_order_relaxed);
+}
+
+ActivitySlot &LocalOmpSlot(unsigned int index) {
+  thread_local ActivitySlot *slot = nullptr;
+  if (slot == nullptr) {
+    const std::scoped_lock lock(State().mutex);
+    slot = &FindOrAddSlot("omp", static_cast<int>(index));
+  }
+  return *slot;
+}
+
+int64_t NowIfRecording() {
+  return State().recording.load(std::memory_order_relaxed) ? NowNs() : -1;
+}
+
+void OnParallelBegin(ompt_data_t * /*encountering_task_data*/, const ompt_frame_t * /*encountering_task_frame*/,
+                     ompt_data_t * /*parallel_data*/, unsigned int /*requested_parallelism*/, int /*flags*/,
+                     const void * /*codeptr_ra*/) {
+  auto &state = State();
+  state.region.fetch_add(1);
+  if (state.recording.load(std::memory_order_relaxed)) {
+    state.omp_regions.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void OnParallelEnd(ompt_data_t * /*parallel_data*/, ompt_data_t * /*encountering_task_data*/, int /*flags*/,
+                   const void * /*codeptr_ra*/) {
+  auto &state = State();
+  state.ended_ns = NowNs();
+  state.ended_region = state.region.load();
+}
+
+void OnImplicitTask(ompt_scope_endpoint_t endpoint, ompt_data_t * /*parallel_data*/, ompt_data_t * /*task_data*/,
+                    unsigned int /*actual_parallelism*/, unsigned int index, int flags) {
+  if ((flags & ompt_task_initial) != 0) {
+    return;
+  }
+  auto &slot = LocalOmpSlot(index);
+  if (endpoint == ompt_scope_begin) {
+    const int64_t now = NowIfRecording();
+    slot.segment_begin_ns = now;
+    if (now >= 0) {
+      slot.entries.fetch_add(1, std::memory_order_relaxed);
+    }
+  } else if (const int64_t begin = slot.segment_begin_ns.exchange(-1); begin >= 0) {
+    slot.busy_ns.fetch_add(NowNs() - begin, std::memory_order_relaxed);
+  }
+}
+
+void OnSyncRegionWait(ompt_sync_region_t kind, ompt_scope_endpoint_t endpoint, ompt_data_t * /*parallel_data*/,
+                      ompt_data_t * /*task_data*/, const void * /*codeptr_ra*/) {
+  if (kind == ompt_sync_region_taskwait || kind == ompt_sync_region_taskgroup || kind == ompt_sync_region_reduction) {
+    return;
+  }
+  auto &slot = LocalOmpSlot(0);
+  const int64_t now = NowNs();
+  if (endpoint == ompt_scope_begin) {
+    if (const int64_t begin = slot.segment_begin_ns.exchange(-1); begin >= 0) {
+      slot.busy_ns.fetch_add(now - begin, std::memory_order_relaxed);
+      slot.wait_region = State().region.load();
+      slot.wait_begin_ns = now;
+    }
+    return;
+  }
+  // Work continues after a barrier inside the region; after the closing one the thread is idle
+  const bool region_ended = State().ended_region.load() == slot.wait_region.load();
+  const bool was_waiting = slot.wait_begin_ns.load() >= 0;
+  SettleWait(slot, now);
+  if (was_waiting && !region_ended) {
+    slot.segment_begin_ns = now;
+  }
+}
+
+int InitializeTool(ompt_function_lookup_t lookup, int /*initial_device_num*/, ompt_data_t * /*tool_data*/) {
+  auto set_callback = reinterpret_cast<ompt_set_callback_t>(lookup("ompt_set_callback"));
+  if (set_callback == nullptr) {
+    return 0;
+  }
+  set_callback(ompt_callback_parallel_begin, reinterpret_cast<ompt_callback_t>(&OnParallelBegin));
+  set_callback(ompt_callback_parallel_end, reinterpret_cast<ompt_callback_t>(&OnParallelEnd));
+  set_callback(ompt_callback_implicit_task, reinterpret_cast<ompt_callback_t>(&OnImplicitTask));
+  set_callback(ompt_callback_sync_region_wait, reinterpret_cast<ompt_callback_t>(&OnSyncRegionWait));
+  State().ompt_active = true;
+  return 1;
+}
+
+void FinalizeTool(ompt_data_t * /*tool_data*/) {
+  State().ompt_active = false;
+}
+
+#endif  // PPC_HAS_OMPT
+
+}  // namespace
+
+ThreadingStats ComputeThreadingStats(const std::string &runtime, std::vector<ThreadActivity> threads,
+                                     uint64_t regions, double wall_sec) {
+  ThreadingStats stats;
+  stats.runtime = runtime;
+  stats.regions = regions;
+  stats.wall_sec = wall_sec;
+  std::ranges::sort(threads, {}, &ThreadActivity::thread);
+  stats.threads = std::move(threads);
+  if (stats.threads.empty()) {
+    return stats;
+  }
+  double busy = 0.0;
+  double wait = 0.0;
+  double max_busy = 0.0;
+  for (const auto &thread : stats.threads) {
+    busy += thread.busy_sec;
+    wait += thread.wait_sec;
+    max_busy = std::max(max_busy, thread.busy_sec);
+  }
+  const double mean_busy = busy / static_cast<double>(stats.threads.size());
+  stats.utilization = wall_sec > 0.0 ? mean_busy / wall_sec : 0.0;
+  stats.barrier_wait_share = busy + wait > 0.0 ? wait / (busy + wait) : 0.0;
+  stats.imbalance = mean_busy > 0.0 ? max_busy / mean_busy : 1.0;
+  return stats;
+}
+
+TbbArenaObserver::TbbArenaObserver(const std::string &arena_name)
+    : runtime_("tbb:" + arena_name), count_external_threads_(false) {
+  observe(true);
+}
+
+TbbArenaObserver::TbbArenaObserver(tbb::task_arena &arena, const std::string &arena_name)
+    : tbb::task_scheduler_observer(arena), runtime_("tbb:" + arena_name), count_external_threads_(true) {
+  observe(true);
+}
+
+TbbArenaObserver::~TbbArenaObserver() {
+  observe(false);
+}
+
+void TbbArenaObserver::on_scheduler_entry(bool is_worker) {
+  if (!is_worker && !count_external_threads_) {
+    return;
+  }
+  auto &state = State();
+  const std::scoped_lock lock(state.mutex);
+  auto &slot = FindOrAddSlot(runtime_, tbb::this_task_arena::current_thread_index());
+  slot.entered_ns = NowNs();
+  if (state.recording.load(std::memory_order_relaxed)) {
+    slot.entries.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void TbbArenaObserver::on_scheduler_exit(bool is_worker) {
+  if (!is_worker && !count_external_threads_) {
+    return;
+  }
+  auto &state = State();
+  const std::scoped_lock lock(state.mutex);
+  auto &slot = FindOrAddSlot(runtime_, tbb::this_task_arena::current_thread_index());
+  // Time before a Pause() was already added by it
+  if (slot.entered_ns >= 0 && state.recording.load(std::memory_order_relaxed)) {
+    slot.busy_ns.fetch_add(ArenaTimeInWindow(slot, NowNs()), std::memory_order_relaxed);
+  }
+  slot.entered_ns = -1;
+}
+
+ThreadingProfiler &ThreadingProfiler::Instance() {
+  static ThreadingProfiler profiler;
+  return profiler;
+}
+
+bool ThreadingProfiler::IsOmptActive() const {
+  return State().ompt_active.load();
+}
+
+void ThreadingProfiler::Start() {
+  auto &state = State();
+  {
+    const std::scoped_lock lock(state.mutex);
+    state.recording = false;
+    state.omp_regions = 0;
+    for (auto &slot : state.slots) {
+      slot->busy_ns = 0;
+      slot->wait_ns = 0;
+      slot->entries = 0;
+    }
+  }
+  default_arena_observer_ = std::make_unique<TbbArenaObserver>("default");
+}
+
+void ThreadingProfiler::Resume() {
+  auto &state = State();
+  const std::scoped_lock lock(state.mutex);
+  state.window_begin_ns = NowNs();
+  state.recording = true;
+}
+
+void ThreadingProfiler::Pause() {
+  auto &state = State();
+  const std::scoped_lock lock(state.mutex);
+  state.recording = false;
+  const int64_t now = NowNs();
+  for (auto &slot : state.slots) {
+    if (slot->entered_ns >= 0) {
+      slot->busy_ns.fetch_add(ArenaTimeInWindow(*slot, now), std::memory_order_relaxed);
+    }
+#ifdef PPC_HAS_OMPT
+    SettleWait(*slot, now);
+#endif
+  }
+}
+
+std::vector<ThreadingStats> ThreadingProfiler::Stop(double wall_sec) {
+  default_arena_observer_.reset();
+  auto &state = State();
+  const std::scoped_lock lock(state.mutex);
+  state.recording = false;
+  std::map<std::string, std::vector<ThreadActivity>> by_runtime;
+  for (const auto &slot : state.slots) {
+    if (slot->entries == 0 && slot->busy_ns == 0) {
+      continue;
+    }
+    by_runtime[slot->runtime].push_back({.thread = slot->thread,
+                                         .busy_sec = static_cast<double>(slot->busy_ns) * 1e-9,
+                                         .wait_sec = static_cast<double>(slot->wait_ns) * 1e-9,
+                                         .entries = slot->entries});
+  }
+  std::vector<ThreadingStats> stats;
+  for (auto &[runtime, threads] : by_runtime) {
+    const uint64_t regions = runtime == "omp" ? state.omp_regions.load() : 0;
+    stats.push_back(ComputeThreadingStats(runtime, std::move(threads), regions, wall_sec));
+  }
+  return stats;
+}
+
+std::string ThreadingProfiler::GetUnavailableReason() const {
+  if (IsOmptActive()) {
+    return "no OpenMP or TBB parallel work recorded";
+  }
+  return "no OpenMP or TBB parallel work recorded (OpenMP is only observed with an OMPT-capable runtime such as "
+         "LLVM libomp and PPC_PERF_THREADING set at startup)";
+}
+
+}  // namespace ppc::performance
+
+#ifdef PPC_HAS_OMPT
+/// Entry point the OpenMP runtime looks up at startup; returning nullptr leaves OpenMP uninstrumented.
+extern "C" ompt_start_tool_result_t *ompt_start_tool(unsigned int /*omp_version*/, const char * /*runtime_version*/) {
+  if (!ppc::util::IsPerfThreadingEnabled()) {
+    return nullptr;
+  }
+  static ompt_start_tool_result_t result{.initialize = &ppc::performance::InitializeTool,
+                                         .finalize = &ppc::performance::FinalizeTool,
+                                         .tool_data = {.value = 0}};
+  return &result;
+}
+#endif
@@ -1,18 +1,38 @@
 #include <gtest/gtest.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <libenvpp/detail/environment.hpp>
+#include <limits>
 #include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
 #include <ostream>
+#include <random>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <system_error>
 #include <thread>
 #include <vector>
 
+#include "performance/include/baseline.hpp"
+#include "performance/include/cache_control.hpp"
+#include "performance/include/calibration.hpp"
+#include "performance/include/energy_meter.hpp"
+#include "performance/include/hw_counters.hpp"
+#include "performance/include/mpi_profiler.hpp"
 #include "performance/include/performance.hpp"
+#include "performance/include/threading_profiler.hpp"
 #include "task/include/task.hpp"
 #include "util/include/util.hpp"
 
@@ -104,6 +124,7 @@ TEST(PerfTests, CheckPerfPipelineUint8tSlowTest) {
 
   PerfAttr perf_attr;
   perf_attr.num_running = 1;
+  perf_attr.num_warmup = 0;
 
   const auto t0 = std::chrono::high_resolution_clock::now();
   perf_attr.current_timer = [&] {
@@ -123,6 +144,7 @@ TEST(PerfTests, SlowPerfRespectsEnvOverride) {
   Perf<std::vector<uint8_t>, uint8_t> perf_analyzer(test_task);
   PerfAttr perf_attr;
   perf_attr.num_running = 1;
+  perf_attr.num_warmup = 0;
   const auto t0 = std::chrono::high_resolution_clock::now();
   perf_attr.current_timer = [&] {
     auto current_time_point = std::chrono::high_resolution_clock::now();
@@ -207,6 +229,7 @@ class GetStringTaskTypeTest : public ::testing::TestWithParam<TaskTypeTestCase>
     (*j)["tasks"]["mpi"] = "MPI";
     (*j)["tasks"]["tbb"] = "TBB";
     (*j)["tasks"]["seq"] = "SEQ";
+    (*j)["tasks"]["pstl"] = "PSTL";
 
     std::ofstream(temp_path) << j->dump();
   }
@@ -227,7 +250,8 @@ INSTANTIATE_TEST_SUITE_P(AllTypeCases, GetStringTaskTypeTest,
                                            TaskTypeTestCase{TypeOfTask::kOMP, "omp_OMP", "kOMP"},
                                            TaskTypeTestCase{TypeOfTask::kMPI, "mpi_MPI", "kMPI"},
                                            TaskTypeTestCase{TypeOfTask::kTBB, "tbb_TBB", "kTBB"},
-                                           TaskTypeTestCase{TypeOfTask::kSEQ, "seq_SEQ", "kSEQ"}));
+                                           TaskTypeTestCase{TypeOfTask::kSEQ, "seq_SEQ", "kSEQ"},
+                                           TaskTypeTestCase{TypeOfTask::kPSTL, "pstl_PSTL", "kPSTL"}));
 
 TEST(GetStringTaskTypeStandaloneTest, ThrowsIfFileMissing) {
   std::string missing_path = "non_existent_settings.json";
@@ -371,6 +395,594 @@ TEST(PerfTest, PipelineRunAndTaskRun) {
   EXPECT_GT(res_taskrun.time_sec, 0.0);
 }
 
+TEST(PerfTest, KeepsOneSamplePerIterationExcludingWarmup) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.num_running = 4;
+  attr.num_warmup = 3;
+  int timer_calls = 0;
+  attr.current_timer = [&timer_calls]() { return static_cast<double>(timer_calls++); };
+
+  perf.PipelineRun(attr);
+  const auto res = perf.GetPerfResults();
+  ASSERT_EQ(res.samples.size(), 4U);
+  EXPECT_EQ(timer_calls, 8);
+  for (double sample : res.samples) {
+    EXPECT_DOUBLE_EQ(sample, 1.0);
+  }
+  EXPECT_DOUBLE_EQ(res.time_sec, 1.0);
+  EXPECT_DOUBLE_EQ(res.stats.stddev, 0.0);
+}
+
+TEST(PerfTest, SyncsStartAndCombinesSamplesAcrossProcesses) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.num_running = 3;
+  attr.num_warmup = 2;
+  int timer_calls = 0;
+  int sync_calls = 0;
+  attr.current_timer = [&timer_calls]() { return static_cast<double>(timer_calls++); };
+  attr.sync_start = [&sync_calls] { sync_calls++; };
+  attr.combine_samples = [](const std::vector<double> &local) {
+    auto combined = local;
+    for (double &sample : combined) {
+      sample *= 2.0;
+    }
+    return combined;
+  };
+
+  perf.TaskRun(attr);
+  const auto res = perf.GetPerfResults();
+  EXPECT_EQ(sync_calls, 3);
+  EXPECT_EQ(res.local_samples, (std::vector<double>{1.0, 1.0, 1.0}));
+  EXPECT_EQ(res.samples, (std::vector<double>{2.0, 2.0, 2.0}));
+  EXPECT_DOUBLE_EQ(res.stats.median, 2.0);
+}
+
+TEST(PerfTest, ComputeRankBreakdownFindsSlowestRank) {
+  const auto breakdown = ComputeRankBreakdown({1.0, 4.0, 1.0, 2.0});
+  EXPECT_DOUBLE_EQ(breakdown.max, 4.0);
+  EXPECT_DOUBLE_EQ(breakdown.min, 1.0);
+  EXPECT_DOUBLE_EQ(breakdown.mean, 2.0);
+  EXPECT_DOUBLE_EQ(breakdown.imbalance, 2.0);
+  EXPECT_EQ(breakdown.slowest_rank, 1U);
+
+  EXPECT_DOUBLE_EQ(ComputeRankBreakdown({}).imbalance, 1.0);
+}
+
+TEST(PerfTest, AdaptiveRunningStopsAtMinimumForStableSamples) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.adaptive_running = true;
+  attr.num_warmup = 0;
+  attr.min_running = 7;
+  attr.max_running = 50;
+  double time = 0.0;
+  attr.current_timer = [&time]() { return time += 0.5; };
+
+  perf.PipelineRun(attr);
+  const auto res = perf.GetPerfResults();
+  EXPECT_EQ(res.samples.size(), 7U);
+  EXPECT_DOUBLE_EQ(res.median_rel_ci, 0.0);
+}
+
+TEST(PerfTest, AdaptiveRunningRespectsMaximumForNoisySamples) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.adaptive_running = true;
+  attr.num_warmup = 0;
+  attr.min_running = 2;
+  attr.max_running = 12;
+  attr.time_budget_sec = 1e9;
+  // Every third timer step is slow, so every third sample is ten times longer regardless of call phase
+  int calls = 0;
+  double time = 0.0;
+  attr.current_timer = [&]() { return time += ((++calls % 3) == 0 ? 10.0 : 1.0); };
+  int sync_calls = 0;
+  attr.sync_continue = [&sync_calls](bool local) {
+    sync_calls++;
+    return local;
+  };
+
+  perf.PipelineRun(attr);
+  const auto res = perf.GetPerfResults();
+  EXPECT_EQ(res.samples.size(), 12U);
+  EXPECT_EQ(sync_calls, 11);
+  EXPECT_GT(res.median_rel_ci, attr.target_rel_ci);
+}
+
+TEST(PerfTest, AdaptiveRunningStopsWhenBudgetIsSpent) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.adaptive_running = true;
+  attr.num_warmup = 0;
+  attr.min_running = 3;
+  attr.max_running = 1000;
+  attr.time_budget_sec = 20.0;
+  int calls = 0;
+  double time = 0.0;
+  attr.current_timer = [&]() { return time += ((++calls % 3) == 0 ? 10.0 : 1.0); };
+
+  perf.PipelineRun(attr);
+  EXPECT_LT(perf.GetPerfResults().samples.size(), 10U);
+}
+
+TEST(PerfTest, ComputeStatisticsOnKnownSamples) {
+  const std::vector<double> samples = {5.0, 1.0, 4.0, 2.0, 3.0, 100.0};
+  const auto stats = ComputeStatistics(samples);
+  EXPECT_DOUBLE_EQ(stats.min, 1.0);
+  EXPECT_DOUBLE_EQ(stats.max, 100.0);
+  EXPECT_DOUBLE_EQ(stats.mean, 115.0 / 6.0);
+  EXPECT_DOUBLE_EQ(stats.median, 3.5);
+  EXPECT_DOUBLE_EQ(stats.mad, 1.5);
+  EXPECT_DOUBLE_EQ(stats.p90, 52.5);
+  EXPECT_GT(stats.p99, stats.p90);
+  EXPECT_LE(stats.p99, stats.max);
+  EXPECT_GT(stats.stddev, 0.0);
+}
+
+TEST(PerfTest, ComputeStatisticsOnEmptySamplesIsZero) {
+  const auto stats = ComputeStatistics({});
+  EXPECT_DOUBLE_EQ(stats.mean, 0.0);
+  EXPECT_DOUBLE_EQ(stats.median, 0.0);
+  EXPECT_DOUBLE_EQ(stats.stddev, 0.0);
+}
+
+TEST(PerfTest, ComputeHwCounterStatsDerivesIpcAndMissRates) {
+  std::vector<HwCounterValues> samples(2);
+  samples[0].values = {1000.0, 2000.0, 10.0, 4.0, 2.0};
+  samples[1].values = {3000.0, 6000.0, 30.0, 12.0, 6.0};
+  for (auto &sample : samples) {
+    sample.valid.fill(true);
+  }
+  const auto stats = ComputeHwCounterStats(samples);
+  ASSERT_TRUE(stats.available);
+  EXPECT_DOUBLE_EQ(stats.mean.Get(HwCounter::kCycles), 2000.0);
+  EXPECT_DOUBLE_EQ(stats.ipc, 2.0);
+  EXPECT_DOUBLE_EQ(stats.llc_mpki, 5.0);
+  EXPECT_DOUBLE_EQ(stats.branch_mpki, 2.0);
+  EXPECT_DOUBLE_EQ(stats.dtlb_mpki, 1.0);
+}
+
+TEST(PerfTest, HwCountersCoverThreadsStartedBeforeTheSample) {
+  HwCounterGroup counters;
+  if (!counters.IsAvailable()) {
+    GTEST_SKIP() << counters.GetUnavailableReason();
+  }
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> spins{0};
+  // A worker that exists before Start() and outlives Stop(), like a pool thread
+  std::thread worker([&] {
+    while (!stop.load()) {
+      spins.fetch_add(1);
+    }
+  });
+  while (spins.load() == 0) {
+    std::this_thread::yield();
+  }
+  counters.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  const auto values = counters.Stop();
+  stop = true;
+  worker.join();
+  EXPECT_GE(values.threads, 2U);
+}
+
+namespace {
+
+/// Waits until /proc/self/task lists @p count threads: a joined thread stays listed until the kernel has reaped it.
+bool WaitForProcessThreads(std::size_t count) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline) {
+    std::error_code error;
+    std::size_t listed = 0;
+    for (auto it = std::filesystem::directory_iterator("/proc/self/task", error);
+         !error && it != std::filesystem::directory_iterator(); it.increment(error)) {
+      listed++;
+    }
+    if (listed == count) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(PerfTest, HwCountersFollowThreadsBetweenSamples) {
+  HwCounterGroup counters;
+  if (!counters.IsAvailable()) {
+    GTEST_SKIP() << counters.GetUnavailableReason();
+  }
+  counters.Start();
+  const std::size_t before = counters.Stop().threads;
+
+  std::promise<void> release;
+  counters.Start();
+  // Started during a sample: counted from the next sample on, and only once
+  std::thread worker([done = release.get_future()] { done.wait(); });
+  EXPECT_EQ(counters.Stop().threads, before);
+  counters.Start();
+  EXPECT_EQ(counters.Stop().threads, before + 1);
+
+  release.set_value();
+  worker.join();
+  ASSERT_TRUE(WaitForProcessThreads(before));
+  counters.Start();
+  EXPECT_EQ(counters.Stop().threads, before);
+}
+
+TEST(PerfTest, ComputeHwCounterStatsSkipsMissingCounters) {
+  std::vector<HwCounterValues> samples(1);
+  samples[0].values = {1000.0, 2000.0, 10.0, 4.0, 2.0};
+  samples[0].valid = {true, true, false, true, false};
+  const auto stats = ComputeHwCounterStats(samples);
+  EXPECT_TRUE(stats.available);
+  EXPECT_FALSE(stats.mean.IsValid(HwCounter::kLlcMisses));
+  EXPECT_DOUBLE_EQ(stats.llc_mpki, 0.0);
+  EXPECT_DOUBLE_EQ(stats.branch_mpki, 2.0);
+}
+
+TEST(PerfTest, HwCountersDegradeGracefully) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.hw_counters = true;
+  attr.num_running = 3;
+  EXPECT_NO_THROW(perf.PipelineRun(attr));
+  const auto res = perf.GetPerfResults();
+  if (res.hw_unavailable_reason.empty()) {
+    EXPECT_EQ(res.hw_samples.size(), 3U);
+  } else {
+    EXPECT_TRUE(res.hw_samples.empty());
+    EXPECT_FALSE(res.hw_stats.available);
+  }
+  EXPECT_NO_THROW(perf.PrintPerfStatistic("hw_counters_degrade_gracefully"));
+}
+
+TEST(PerfTest, ColdCacheRunFlushesBeforeEveryIteration) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.num_running = 3;
+  attr.cache_state = CacheState::kCold;
+  attr.cache_flush_bytes = std::size_t{1} << 20;
+  perf.PipelineRun(attr);
+  const auto res = perf.GetPerfResults();
+  EXPECT_EQ(res.samples.size(), 3U);
+  EXPECT_EQ(res.cache_state, CacheState::kCold);
+  EXPECT_EQ(PerfResultsToJson(res)["cache"], "cold");
+}
+
+TEST(PerfTest, CacheFlusherDefaultsToTwiceTheLastLevelCache) {
+  const auto llc = DetectLastLevelCacheBytes();
+  const CacheFlusher flusher;
+  EXPECT_EQ(flusher.GetBytes(), llc > 0 ? 2 * llc : std::size_t{64} << 20);
+  EXPECT_EQ(CacheFlusher(4096).GetBytes(), 4096U);
+  EXPECT_EQ(GetCacheStateName(CacheState::kWarm), "warm");
+}
+
+namespace {
+
+void WriteRaplZone(const std::filesystem::path &root, const std::string &dir, const std::string &name, uint64_t energy,
+                   uint64_t max_range) {
+  std::filesystem::create_directories(root / dir);
+  std::ofstream(root / dir / "name") << name << '\n';
+  std::ofstream(root / dir / "energy_uj") << energy << '\n';
+  std::ofstream(root / dir / "max_energy_range_uj") << max_range << '\n';
+}
+
+}  // namespace
+
+TEST(PerfTest, EnergyMeterSumsPackagesAndDramAcrossWraparound) {
+  const auto root = std::filesystem::temp_directory_path() / ("ppc_powercap_" + std::to_string(std::random_device{}()));
+  WriteRaplZone(root, "intel-rapl:0", "package-0", 1000, 10000000);
+  WriteRaplZone(root, "intel-rapl:0:0", "core", 500, 1000000);
+  WriteRaplZone(root, "intel-rapl:0:1", "dram", 999000, 1000000);
+  WriteRaplZone(root, "intel-rapl:1", "psys", 0, 1000000);
+  WriteRaplZone(root, "intel-rapl-mmio:0", "package-0", 0, 1000000);
+
+  const EnergyMeter meter(root);
+  ASSERT_TRUE(meter.IsAvailable());
+  EXPECT_EQ(meter.GetZoneNames(), "package-0,dram");
+  const auto begin = meter.Read();
+  WriteRaplZone(root, "intel-rapl:0", "package-0", 3001000, 10000000);
+  WriteRaplZone(root, "intel-rapl:0:1", "dram", 1000, 1000000);
+  // 3 J on the package, 2000 uJ on the DRAM counter that wrapped
+  EXPECT_DOUBLE_EQ(meter.JoulesBetween(begin, meter.Read()), 3.002);
+  std::filesystem::remove_all(root);
+
+  EXPECT_EQ(EnergyDeltaMicrojoules(10, 25, 100), 15U);
+  EXPECT_EQ(EnergyDeltaMicrojoules(90, 5, 100), 15U);
+  const EnergyMeter missing(root);
+  EXPECT_FALSE(missing.IsAvailable());
+  EXPECT_FALSE(missing.GetUnavailableReason().empty());
+}
+
+TEST(PerfTest, ComputeEnergyStatsDerivesPowerAndEnergyDelayProduct) {
+  const auto stats = ComputeEnergyStats(12.0, {1.0, 2.0, 3.0}, "package-0");
+  EXPECT_TRUE(stats.available);
+  EXPECT_DOUBLE_EQ(stats.joules, 4.0);
+  EXPECT_DOUBLE_EQ(stats.avg_watts, 2.0);
+  EXPECT_DOUBLE_EQ(stats.edp, 8.0);
+  EXPECT_FALSE(ComputeEnergyStats(std::numeric_limits<double>::quiet_NaN(), {1.0}, "").available);
+}
+
+TEST(PerfTest, EnergyDegradesGracefully) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.energy = true;
+  attr.num_running = 3;
+  double combined = 0.0;
+  attr.combine_energy = [&combined](double local) {
+    combined = local;
+    return local;
+  };
+  EXPECT_NO_THROW(perf.PipelineRun(attr));
+  const auto res = perf.GetPerfResults();
+  const auto json = PerfResultsToJson(res);
+  if (res.energy_unavailable_reason.empty()) {
+    EXPECT_TRUE(res.energy.available);
+    EXPECT_GE(res.energy.joules, 0.0);
+    EXPECT_TRUE(json["energy"].contains("joules"));
+  } else {
+    EXPECT_FALSE(res.energy.available);
+    EXPECT_TRUE(std::isnan(combined));
+    EXPECT_EQ(json["energy"]["unavailable"], res.energy_unavailable_reason);
+  }
+  EXPECT_NO_THROW(perf.PrintPerfStatistic("energy_degrades_gracefully"));
+}
+
+TEST(PerfTest, ComputeThreadingStatsDerivesUtilizationAndImbalance) {
+  const std::vector<ThreadActivity> threads = {{.thread = 1, .busy_sec = 1.0, .wait_sec = 1.0},
+                                               {.thread = 0, .busy_sec = 3.0, .wait_sec = 0.0}};
+  const auto stats = ComputeThreadingStats("omp", threads, 5, 4.0);
+  ASSERT_EQ(stats.threads.size(), 2U);
+  EXPECT_EQ(stats.threads[0].thread, 0);
+  EXPECT_DOUBLE_EQ(stats.utilization, 0.5);
+  EXPECT_DOUBLE_EQ(stats.barrier_wait_share, 0.2);
+  EXPECT_DOUBLE_EQ(stats.imbalance, 1.5);
+  EXPECT_NE(FormatThreadingStats(stats).find("runtime=omp threads=2 regions=5"), std::string::npos);
+}
+
+TEST(PerfTest, ThreadingProfilerRecordsTbbArenaTimeOnlyWhileResumed) {
+  auto &profiler = ThreadingProfiler::Instance();
+  tbb::task_arena arena(2);
+  const TbbArenaObserver observer(arena, "test");
+  const auto run = [&arena] {
+    arena.execute([] {
+      tbb::parallel_for(0, 4, [](int) { std::this_thread::sleep_for(std::chrono::milliseconds(5)); });
+    });
+  };
+
+  profiler.Start();
+  run();
+  profiler.Resume();
+  run();
+  profiler.Pause();
+  run();
+  const auto stats = profiler.Stop(0.01);
+  const auto it = std::ranges::find(stats, std::string("tbb:test"), &ThreadingStats::runtime);
+  ASSERT_NE(it, stats.end());
+  ASSERT_FALSE(it->threads.empty());
+  double busy = 0.0;
+  for (const auto &thread : it->threads) {
+    busy += thread.busy_sec;
+    EXPECT_DOUBLE_EQ(thread.wait_sec, 0.0);
+  }
+  // Two threads sleep 4 x 5 ms in total per run; the runs outside the window are not counted
+  EXPECT_GE(busy, 0.015);
+  EXPECT_LT(busy, 0.5);
+}
+
+TEST(PerfTest, ThreadingDegradesGracefully) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.threading = true;
+  attr.num_running = 3;
+  EXPECT_NO_THROW(perf.PipelineRun(attr));
+  const auto res = perf.GetPerfResults();
+  EXPECT_EQ(res.threading.empty(), !res.threading_unavailable_reason.empty());
+  EXPECT_TRUE(PerfResultsToJson(res).contains("threading"));
+  EXPECT_NO_THROW(perf.PrintPerfStatistic("threading_degrades_gracefully"));
+}
+
+TEST(PerfTest, MannWhitneyDetectsShiftedSamples) {
+  const std::vector<double> baseline = {1.00, 1.01, 0.99, 1.02, 0.98, 1.00, 1.01, 0.99, 1.00, 1.02};
+  const std::vector<double> slower = {1.20, 1.21, 1.19, 1.22, 1.18, 1.20, 1.21, 1.19, 1.20, 1.22};
+
+  const auto slowdown = MannWhitneyGreater(slower, baseline);
+  EXPECT_DOUBLE_EQ(slowdown.u, 100.0);
+  EXPECT_LT(slowdown.p_value, 0.001);
+
+  const auto speedup = MannWhitneyGreater(baseline, slower);
+  EXPECT_DOUBLE_EQ(speedup.u, 0.0);
+  EXPECT_GT(speedup.p_value, 0.999);
+}
+
+TEST(PerfTest, MannWhitneyOnIdenticalSamplesIsNotSignificant) {
+  const std::vector<double> samples(8, 1.0);
+  const auto result = MannWhitneyGreater(samples, samples);
+  EXPECT_DOUBLE_EQ(result.p_value, 1.0);
+  EXPECT_DOUBLE_EQ(MannWhitneyGreater({}, samples).p_value, 1.0);
+}
+
+TEST(PerfTest, CheckRegressionRequiresThresholdAndSignificance) {
+  const std::vector<double> baseline = {1.00, 1.01, 0.99, 1.02, 0.98, 1.00, 1.01, 0.99, 1.00, 1.02};
+  const std::vector<double> slightly_slower = {1.02, 1.03, 1.01, 1.04, 1.00, 1.02, 1.03, 1.01, 1.02, 1.04};
+  const std::vector<double> slower = {1.20, 1.21, 1.19, 1.22, 1.18, 1.20, 1.21, 1.19, 1.20, 1.22};
+
+  const auto regressed = CheckRegression(slower, baseline, 0.05);
+  EXPECT_TRUE(regressed.regressed);
+  EXPECT_NEAR(regressed.slowdown, 0.2, 1e-9);
+
+  EXPECT_FALSE(CheckRegression(slightly_slower, baseline, 0.05).regressed);
+  EXPECT_FALSE(CheckRegression(slower, {1.0}, 0.05).regressed);
+}
+
+TEST(PerfTest, BaselineRoundTripsSamples) {
+  const auto dir = std::filesystem::temp_directory_path() / "ppc_perf_baseline_test";
+  std::filesystem::remove_all(dir);
+  const BaselineKey key{.task = "example", .implementation = "omp", .mode = "task_run", .threads = 4, .processes = 1};
+  const auto path = GetBaselinePath(dir, key);
+  EXPECT_EQ(path, dir / "example" / "omp_task_run_t4_p1.json");
+  EXPECT_FALSE(LoadBaselineSamples(path).has_value());
+
+  SaveBaseline(path, {{"samples", {0.5, 0.25}}});
+  const auto samples = LoadBaselineSamples(path);
+  ASSERT_TRUE(samples.has_value());
+  EXPECT_EQ(samples.value(), (std::vector<double>{0.5, 0.25}));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(PerfTest, FitPowerLawRecoversExponent) {
+  const auto linear = FitPowerLaw({{1e3, 2e-3}, {1e4, 2e-2}, {1e5, 2e-1}});
+  EXPECT_NEAR(linear.exponent, 1.0, 1e-9);
+  EXPECT_NEAR(linear.r2, 1.0, 1e-9);
+
+  const auto quadratic = FitPowerLaw({{10.0, 1.0}, {20.0, 4.0}, {40.0, 16.0}, {0.0, 5.0}});
+  EXPECT_NEAR(quadratic.exponent, 2.0, 1e-9);
+
+  EXPECT_DOUBLE_EQ(FitPowerLaw({{10.0, 1.0}}).exponent, 0.0);
+}
+
+TEST(PerfTest, GetScaleTagIsNameSafe) {
+  EXPECT_EQ(GetScaleTag(1.0), "");
+  EXPECT_EQ(GetScaleTag(10.0), "x10");
+  EXPECT_EQ(GetScaleTag(0.5), "x0p5");
+  const BaselineKey key{.task = "t", .implementation = "seq", .mode = "pipeline", .scale = 100.0};
+  EXPECT_EQ(GetBaselinePath("b", key).filename(), "seq_pipeline_t1_p1_x100.json");
+  const BaselineKey cold_key{.task = "t", .implementation = "seq", .mode = "pipeline", .cache = "cold"};
+  EXPECT_EQ(GetBaselinePath("b", cold_key).filename(), "seq_pipeline_t1_p1_cold.json");
+  const BaselineKey zipf_key{.task = "t", .implementation = "seq", .mode = "pipeline", .distribution = "zipf"};
+  EXPECT_EQ(GetBaselinePath("b", zipf_key).filename(), "seq_pipeline_t1_p1_zipf.json");
+}
+
+TEST(PerfTest, StreamKernelsReportPositiveBandwidth) {
+  const auto stream = MeasureStreamBandwidth(1, std::size_t{1} << 16);
+  EXPECT_GT(stream.copy, 0.0);
+  EXPECT_GT(stream.scale, 0.0);
+  EXPECT_GT(stream.add, 0.0);
+  EXPECT_GT(stream.triad, 0.0);
+}
+
+TEST(PerfTest, ComputeRooflineSplitsAtRidgePoint) {
+  MachineCalibration calibration;
+  calibration.stream.triad = 1e10;
+  calibration.peak_flops = 1e11;
+
+  const auto unknown = ComputeRoofline(1e9, std::nullopt, 0.5, calibration);
+  EXPECT_DOUBLE_EQ(unknown.bytes_per_sec, 2e9);
+  EXPECT_DOUBLE_EQ(unknown.stream_fraction, 0.2);
+  EXPECT_TRUE(unknown.bound.empty());
+  EXPECT_FALSE(RooflineToJson(unknown, calibration).contains("bound"));
+
+  // Ridge point at 10 flops per byte
+  const auto memory = ComputeRoofline(1e9, 2e9, 0.5, calibration);
+  EXPECT_DOUBLE_EQ(memory.intensity, 2.0);
+  EXPECT_DOUBLE_EQ(memory.attainable_flops, 2e10);
+  EXPECT_DOUBLE_EQ(memory.roofline_fraction, 0.2);
+  EXPECT_EQ(memory.bound, "memory");
+
+  const auto compute = ComputeRoofline(1e9, 1e11, 2.0, calibration);
+  EXPECT_DOUBLE_EQ(compute.attainable_flops, 1e11);
+  EXPECT_DOUBLE_EQ(compute.roofline_fraction, 0.5);
+  EXPECT_EQ(compute.bound, "compute");
+  EXPECT_EQ(RooflineToJson(compute, calibration)["bound"], "compute");
+}
+
+TEST(PerfTest, CalibrationRoundTripsThroughJson) {
+  MachineCalibration calibration;
+  calibration.hostname = "node1";
+  calibration.workers = 4;
+  calibration.stream = {.copy = 1.0, .scale = 2.0, .add = 3.0, .triad = 4.0};
+  calibration.peak_flops = 5.0;
+  calibration.mpi_latency_sec = std::numeric_limits<double>::quiet_NaN();
+  calibration.mpi_bandwidth = std::numeric_limits<double>::quiet_NaN();
+  calibration.timestamp = 42;
+
+  const auto parsed = CalibrationFromJson(nlohmann::json::parse(CalibrationToJson(calibration).dump()));
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(parsed->hostname, "node1");
+  EXPECT_EQ(parsed->workers, 4);
+  EXPECT_DOUBLE_EQ(parsed->stream.triad, 4.0);
+  EXPECT_DOUBLE_EQ(parsed->peak_flops, 5.0);
+  EXPECT_TRUE(std::isnan(parsed->mpi_latency_sec));
+  EXPECT_EQ(parsed->timestamp, 42);
+
+  EXPECT_FALSE(CalibrationFromJson({{"workers", 1}}).has_value());
+  EXPECT_EQ(GetCalibrationPath("c", "host/a", 8), std::filesystem::path("c") / "host_a_w8.json");
+}
+
+TEST(PerfTest, MpiProfileAccumulatesCallsPerTaskAndStage) {
+  MpiProfile profile;
+  EXPECT_TRUE(profile.Empty());
+  profile.Record("task", "run", MpiCall::kBcast, 8, 0.5);
+  profile.Record("task", "run", MpiCall::kBcast, 8, 0.25);
+  profile.Record("", "harness", MpiCall::kBarrier, 0, 0.125);
+  profile.RecordTraffic("task", 2, 16);
+
+  const auto json = profile.ToJson(1);
+  EXPECT_EQ(json["rank"], 1);
+  ASSERT_EQ(json["calls"].size(), 2U);
+  EXPECT_EQ(json["calls"][0]["task"], "task");
+  EXPECT_EQ(json["calls"][0]["call"], "MPI_Bcast");
+  EXPECT_EQ(json["calls"][0]["calls"], 2);
+  EXPECT_EQ(json["calls"][0]["bytes"], 16);
+  EXPECT_DOUBLE_EQ(json["calls"][0]["time_sec"].get<double>(), 0.75);
+  EXPECT_EQ(json["calls"][1]["task"], "untracked");
+  EXPECT_EQ(json["traffic"]["task"], nlohmann::json(std::vector<uint64_t>{0, 0, 16}));
+
+  profile.Clear();
+  EXPECT_TRUE(profile.Empty());
+}
+
+TEST(PerfTest, MergeMpiProfilesBuildsTrafficMatrix) {
+  MpiProfile root;
+  root.Record("task", "run", MpiCall::kSend, 40, 0.5);
+  root.Record("task", "pre_processing", MpiCall::kScatterv, 80, 0.25);
+  root.RecordTraffic("task", 1, 40);
+  MpiProfile worker;
+  worker.Record("task", "run", MpiCall::kSend, 8, 1.0);
+  worker.RecordTraffic("task", 0, 8);
+
+  const auto report = MergeMpiProfiles({root.ToJson(0), worker.ToJson(1)});
+  EXPECT_EQ(report["schema"], "ppc.mpi_profile.v1");
+  EXPECT_EQ(report["processes"], 2);
+  ASSERT_EQ(report["calls"].size(), 2U);
+  // Stages are listed in pipeline order
+  EXPECT_EQ(report["calls"][0]["stage"], "pre_processing");
+  EXPECT_EQ(report["calls"][1]["calls"], 2);
+  EXPECT_EQ(report["calls"][1]["bytes"], 48);
+  EXPECT_DOUBLE_EQ(report["calls"][1]["time_sec"].get<double>(), 1.5);
+  EXPECT_DOUBLE_EQ(report["calls"][1]["max_rank_time_sec"].get<double>(), 1.0);
+  const std::vector<std::vector<uint64_t>> matrix{{0, 40}, {8, 0}};
+  EXPECT_EQ(report["traffic"]["task"], nlohmann::json(matrix));
+  EXPECT_EQ(report["total_traffic"], nlohmann::json(matrix));
+
+  const auto text = FormatMpiProfile(report);
+  EXPECT_NE(text.find("task:run:mpi:MPI_Send calls=2 bytes=48"), std::string::npos);
+  EXPECT_NE(text.find("task:traffic:from=0 bytes_to=0,40\n"), std::string::npos);
+  EXPECT_NE(text.find("total:traffic:from=1 bytes_to=8,0\n"), std::string::npos);
+}
+
 TEST(PerfTest, PrintPerfStatisticThrowsOnNone) {
   {
     auto task_ptr = std::make_shared<DummyTask>();
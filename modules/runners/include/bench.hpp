@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "performance/include/performance.hpp"
+#include "util/include/bench_registry.hpp"
+
+namespace ppc::runners {
+
+/// @brief Command line of ppc_bench.
+struct BenchOptions {
+  bool help = false;
+  /// @brief Print the registered tasks instead of running one.
+  bool list = false;
+  std::string task;
+  /// @brief Implementation to run; empty runs every registered implementation of the task.
+  std::string implementation;
+  /// @brief Problem size; 0 uses the task's default.
+  std::size_t size = 0;
+  std::string generator;
+  uint64_t seed = 1;
+  std::vector<ppc::performance::PerfResults::TypeOfRunning> modes = {
+      ppc::performance::PerfResults::TypeOfRunning::kPipeline, ppc::performance::PerfResults::TypeOfRunning::kTaskRun};
+  /// @brief Fixed number of timed iterations; empty keeps the adaptive count of the perf tests.
+  std::optional<uint64_t> iterations;
+  std::optional<uint64_t> warmup;
+  std::optional<uint64_t> max_iterations;
+  std::optional<double> time_budget_sec;
+  std::optional<double> target_rel_ci;
+  ppc::performance::CacheState cache_state = ppc::performance::CacheState::kWarm;
+  /// @brief Threads per process; 0 keeps PPC_NUM_THREADS.
+  int threads = 0;
+  /// @brief Expected number of MPI processes; 0 accepts however many the run was launched with.
+  int processes = 0;
+  /// @brief Launcher used to start @ref processes ranks when ppc_bench is not started by one.
+  std::string mpiexec = "mpiexec";
+  /// @brief "text" for the perf test lines, "json" for one ppc.perf.v1 record per mode.
+  std::string format = "text";
+  bool check = true;
+  /// @brief Search the task's tunable parameters instead of reporting one run; saved to PPC_TUNING_DIR if set.
+  bool tune = false;
+};
+
+/// @brief Parses the arguments of ppc_bench (without the program name).
+/// @throws std::runtime_error On unknown options and malformed values.
+BenchOptions ParseBenchOptions(const std::vector<std::string> &args);
+
+/// @brief Help text of ppc_bench.
+std::string GetBenchUsage();
+
+/// @brief Registered implementations selected by @p options, in registration order.
+/// @throws std::runtime_error If the task or implementation is not registered.
+std::vector<const ppc::util::BenchCase *> SelectBenchCases(const std::vector<ppc::util::BenchCase> &registry,
+                                                           const BenchOptions &options);
+
+/// @brief Entry point of ppc_bench: runs the pipeline of one registered task without GoogleTest.
+/// @details Starts itself under @ref BenchOptions::mpiexec when more processes are requested than it was launched
+/// with, so the same command line works from a shell and from the dispatcher.
+/// @return EXIT_SUCCESS, or EXIT_FAILURE on bad arguments, failed output checks and errors.
+int BenchMain(int argc, char **argv);
+
+}  // namespace ppc::runners
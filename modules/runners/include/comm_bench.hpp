@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "performance/include/comm_bench.hpp"
+
+namespace ppc::runners {
+
+/// @brief Command line of ppc_comm_bench.
+struct CommBenchOptions {
+  bool help = false;
+  std::vector<ppc::performance::CommPattern> patterns = {ppc::performance::CommPattern::kBcast,
+                                                         ppc::performance::CommPattern::kReduce,
+                                                         ppc::performance::CommPattern::kGather};
+  std::size_t min_bytes = 8;
+  std::size_t max_bytes = std::size_t{256} << 20;
+  /// @brief Ratio between consecutive message sizes.
+  std::size_t factor = 2;
+  /// @brief Rank counts to run on; empty selects powers of two up to the launched count, plus the count itself.
+  std::vector<int> ranks;
+  /// @brief Fixed number of timed iterations; empty scales them with the message size.
+  std::optional<std::size_t> iterations;
+  /// @brief "text" for one line per measurement, "json" for one ppc.comm_bench.v1 record per measurement.
+  std::string format = "text";
+  /// @brief File the JSON records are also written to.
+  std::string output;
+  bool check = true;
+};
+
+/// @brief Parses the arguments of ppc_comm_bench (without the program name).
+/// @throws std::runtime_error On unknown options and malformed values.
+CommBenchOptions ParseCommBenchOptions(const std::vector<std::string> &args);
+
+/// @brief Help text of ppc_comm_bench.
+std::string GetCommBenchUsage();
+
+/// @brief Message sizes from @p min_bytes multiplied by @p factor while they stay below @p max_bytes, then
+/// @p max_bytes itself.
+std::vector<std::size_t> GetCommBenchSizes(std::size_t min_bytes, std::size_t max_bytes, std::size_t factor);
+
+/// @brief Rank counts of @p options that fit into @p world_size, in increasing order.
+std::vector<int> GetCommBenchRankCounts(const CommBenchOptions &options, int world_size);
+
+/// @brief Entry point of ppc_comm_bench: compares the tasks' hand-written collectives with native MPI.
+/// @return EXIT_SUCCESS, or EXIT_FAILURE on bad arguments and when a custom result differs from the native one.
+int CommBenchMain(int argc, char **argv);
+
+}  // namespace ppc::runners
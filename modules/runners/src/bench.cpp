@@ -0,0 +1,581 @@
+#include "runners/include/bench.hpp"
+
+#include <mpi.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
+
+#include "oneapi/tbb/global_control.h"
+#include "performance/include/calibration.hpp"
+#include "performance/include/mpi_profiler.hpp"
+#include "performance/include/performance.hpp"
+#include "performance/include/run_metadata.hpp"
+#include "task/include/task.hpp"
+#include "util/include/bench_registry.hpp"
+#include "util/include/perf_test_util.hpp"
+#include "util/include/trace.hpp"
+#include "util/include/tunables.hpp"
+#include "util/include/util.hpp"
+
+namespace ppc::runners {
+
+namespace {
+
+using TypeOfRunning = ppc::performance::PerfResults::TypeOfRunning;
+
+/// Set in the environment of ranks started by ppc_bench itself, so that they never start a launcher again.
+constexpr const char *kLaunchedEnvVar = "PPC_BENCH_LAUNCHED";
+
+constexpr std::array<std::string_view, 16> kValueOptions = {
+    "--task",   "--impl",           "--size",        "--generator", "--seed",  "--mode",    "--iterations",
+    "--warmup", "--max-iterations", "--time-budget", "--target-ci", "--cache", "--threads", "--processes",
+    "--mpiexec", "--format"};
+
+template <typename T>
+T ParseNumber(const std::string &option, const std::string &value) {
+  // Streams wrap negative input around for unsigned types, so the sign is rejected up front
+  std::istringstream in(value);
+  T number{};
+  if (value.starts_with('-') || !(in >> number) || !in.eof()) {
+    throw std::runtime_error("Invalid value '" + value + "' for " + option);
+  }
+  return number;
+}
+
+std::vector<TypeOfRunning> ParseModes(const std::string &value) {
+  if (value == "pipeline") {
+    return {TypeOfRunning::kPipeline};
+  }
+  if (value == "task_run") {
+    return {TypeOfRunning::kTaskRun};
+  }
+  if (value == "both") {
+    return {TypeOfRunning::kPipeline, TypeOfRunning::kTaskRun};
+  }
+  throw std::runtime_error("Unknown --mode '" + value + "' (expected pipeline, task_run or both)");
+}
+
+ppc::performance::CacheState ParseCacheState(const std::string &value) {
+  if (value == "warm") {
+    return ppc::performance::CacheState::kWarm;
+  }
+  if (value == "cold") {
+    return ppc::performance::CacheState::kCold;
+  }
+  throw std::runtime_error("Unknown --cache '" + value + "' (expected warm or cold)");
+}
+
+std::string ListBenchCases(const std::vector<ppc::util::BenchCase> &registry) {
+  std::ostringstream out;
+  for (const auto &bench_case : registry) {
+    out << bench_case.task << " " << bench_case.implementation << " size=" << bench_case.default_size
+        << " generators=";
+    for (std::size_t i = 0; i < bench_case.generators.size(); i++) {
+      out << (i == 0 ? "" : ",") << bench_case.generators[i];
+    }
+    out << '\n';
+  }
+  return out.str();
+}
+
+/// @brief Starts @p argv again under the MPI launcher with @p processes ranks; returns only if that fails.
+int RelaunchUnderMpiexec(const BenchOptions &options, char **argv) {
+#ifdef _WIN32
+  (void)argv;
+  std::cerr << "[  ERROR  ] Start ppc_bench with " << options.mpiexec << " -n " << options.processes
+            << " to run it on several processes" << '\n';
+  return EXIT_FAILURE;
+#else
+  std::vector<std::string> command;
+  std::istringstream launcher(options.mpiexec);
+  for (std::string part; launcher >> part;) {
+    command.push_back(part);
+  }
+  command.emplace_back("-np");
+  command.push_back(std::to_string(options.processes));
+  for (char **arg = argv; *arg != nullptr; ++arg) {
+    command.emplace_back(*arg);
+  }
+  std::vector<char *> exec_argv;
+  for (auto &part : command) {
+    exec_argv.push_back(part.data());
+  }
+  exec_argv.push_back(nullptr);
+  env::detail::set_environment_variable(kLaunchedEnvVar, "1");
+  execvp(exec_argv[0], exec_argv.data());
+  std::cerr << "[  ERROR  ] Failed to start " << command[0] << " for " << options.processes << " processes" << '\n';
+  return EXIT_FAILURE;
+#endif
+}
+
+/// @brief Builds a ppc.perf.v1 record compatible with the ones of the perf tests.
+nlohmann::json MakeBenchRecord(const ppc::util::BenchCase &bench_case, const std::string &test_id,
+                               const BenchOptions &options, const ppc::util::BenchResult &result, int processes) {
+  auto record = ppc::performance::PerfResultsToJson(result.results);
+  const auto &stats = result.results.stats;
+  record["schema"] = "ppc.perf.v1";
+  record["source"] = "ppc_bench";
+  record["test_id"] = test_id;
+  record["task"] = bench_case.task;
+  record["task_dir"] = bench_case.task;
+  record["implementation"] = bench_case.implementation;
+  record["status"] = test_id.ends_with("disabled") ? "disabled" : "enabled";
+  record["threads"] = ppc::util::GetNumThreads();
+  record["processes"] = processes;
+  record["scale"] = 1.0;
+  record["size"] = result.size;
+  record["generator"] = result.generator;
+  record["seed"] = options.seed;
+  record["input_size"] =
+      result.input_size.has_value() ? nlohmann::json(result.input_size.value()) : nlohmann::json(nullptr);
+  record["input_bytes"] =
+      result.input_bytes.has_value() ? nlohmann::json(result.input_bytes.value()) : nlohmann::json(nullptr);
+  record["bytes_per_sec"] = result.input_bytes.has_value() && stats.median > 0.0
+                                ? nlohmann::json(static_cast<double>(result.input_bytes.value()) / stats.median)
+                                : nlohmann::json(nullptr);
+  record["check"] = result.check_passed.has_value() ? nlohmann::json(result.check_passed.value() ? "passed" : "failed")
+                                                    : nlohmann::json("skipped");
+
+  std::ifstream settings_file(bench_case.settings_path);
+  const auto settings = nlohmann::json::parse(settings_file, nullptr, false);
+  if (!settings.is_discarded() && settings.contains("tasks_type")) {
+    record["tasks_type"] = settings["tasks_type"];
+  }
+
+  const auto &metadata = ppc::performance::GetRunMetadata();
+  record["host"] = {{"hostname", metadata.hostname}, {"cpu_model", metadata.cpu_model}};
+  record["build"] = {{"compiler", metadata.compiler},
+                     {"flags", metadata.compile_flags},
+                     {"build_type", metadata.build_type},
+                     {"git_sha", metadata.git_sha}};
+  record["timestamp"] =
+      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  return record;
+}
+
+void PrintBenchText(const std::string &test_id, const ppc::util::BenchResult &result,
+                    const std::optional<ppc::performance::RooflinePoint> &roofline) {
+  const auto mode = ppc::performance::GetStringParamName(result.results.type_of_running);
+  std::cout << test_id << ":" << mode << ":input:size=" << result.size << " generator=" << result.generator;
+  if (result.input_bytes.has_value()) {
+    std::cout << " bytes=" << result.input_bytes.value();
+  }
+  std::cout << '\n';
+  std::cout << test_id << ":" << mode << ":" << std::fixed << std::setprecision(10) << result.results.time_sec
+            << std::defaultfloat << std::setprecision(6) << '\n';
+  ppc::performance::PrintPerfResultsStatistic(result.results, test_id, mode);
+  if (result.input_bytes.has_value() && result.results.stats.median > 0.0) {
+    std::cout << test_id << ":" << mode << ":throughput:bytes=" << result.input_bytes.value()
+              << " bytes_per_sec=" << static_cast<double>(result.input_bytes.value()) / result.results.stats.median
+              << '\n';
+  }
+  if (roofline.has_value()) {
+    std::cout << test_id << ":" << mode << ":roofline:" << ppc::performance::FormatRoofline(roofline.value()) << '\n';
+  }
+  if (result.check_passed.has_value()) {
+    std::cout << test_id << ":" << mode << ":check:" << (result.check_passed.value() ? "passed" : "failed") << '\n';
+  }
+}
+
+/// @brief Request for one measurement of @p bench_case in @p mode with the sampling options of the command line.
+ppc::util::BenchRequest MakeBenchRequest(const ppc::util::BenchCase &bench_case, const BenchOptions &options,
+                                         TypeOfRunning mode) {
+  ppc::util::BenchRequest request{.size = options.size,
+                                  .generator = options.generator,
+                                  .seed = options.seed,
+                                  .mode = mode,
+                                  .perf_attr = {},
+                                  .check = options.check};
+  ppc::util::ConfigurePerfAttributes(request.perf_attr, bench_case.type);
+  auto &attr = request.perf_attr;
+  if (options.iterations.has_value()) {
+    attr.adaptive_running = false;
+    attr.num_running = options.iterations.value();
+  }
+  attr.num_warmup = options.warmup.value_or(attr.num_warmup);
+  attr.max_running = options.max_iterations.value_or(attr.max_running);
+  attr.time_budget_sec = options.time_budget_sec.value_or(attr.time_budget_sec);
+  attr.target_rel_ci = options.target_rel_ci.value_or(attr.target_rel_ci);
+  attr.cache_state = options.cache_state;
+  return request;
+}
+
+std::string GetBenchTestId(const ppc::util::BenchCase &bench_case) {
+  return bench_case.task + "_" + ppc::task::GetStringTaskType(bench_case.type, bench_case.settings_path);
+}
+
+/// @brief Runs every selected case in every requested mode; returns false if an output check failed.
+bool RunBenchCases(const std::vector<const ppc::util::BenchCase *> &cases, const BenchOptions &options) {
+  bool all_passed = true;
+  for (const auto *bench_case : cases) {
+    const auto test_id = GetBenchTestId(*bench_case);
+    const bool multi_process =
+        bench_case->type == ppc::task::TypeOfTask::kMPI || bench_case->type == ppc::task::TypeOfTask::kALL;
+    for (const auto mode : options.modes) {
+      const auto request = MakeBenchRequest(*bench_case, options, mode);
+      const ppc::util::ProfileTaskScope profile_task(test_id + ":" + ppc::performance::GetStringParamName(mode));
+      const auto result = bench_case->run(request);
+      const bool failed = ppc::util::AnyRankTrue(result.check_passed.has_value() && !result.check_passed.value());
+      all_passed = all_passed && !failed;
+      const ppc::performance::MachineCalibration *calibration = nullptr;
+      if (const auto calibration_dir = ppc::util::GetCalibrationDir(); !calibration_dir.empty()) {
+        calibration = &ppc::performance::GetMachineCalibration(calibration_dir,
+                                                               ppc::util::GetCalibrationWorkers(bench_case->type));
+      }
+
+      if (ppc::util::GetMPIRank() != 0) {
+        continue;
+      }
+      std::optional<ppc::performance::RooflinePoint> roofline;
+      if (calibration != nullptr && result.input_bytes.has_value()) {
+        roofline = ppc::performance::ComputeRoofline(static_cast<double>(result.input_bytes.value()), result.flops,
+                                                     result.results.stats.median, *calibration);
+      }
+      if (options.format == "json") {
+        auto record =
+            MakeBenchRecord(*bench_case, test_id, options, result, multi_process ? ppc::util::GetMPISize() : 1);
+        if (roofline.has_value()) {
+          record["roofline"] = ppc::performance::RooflineToJson(roofline.value(), *calibration);
+        }
+        const auto line = record.dump();
+        std::cout << line << '\n';
+        if (const auto path = ppc::util::GetPerfJsonPath(); !path.empty()) {
+          std::ofstream(path, std::ios::app) << line << '\n';
+        }
+      } else {
+        PrintBenchText(test_id, result, roofline);
+      }
+    }
+  }
+  return all_passed;
+}
+
+/// @brief A candidate replaces the best value so far only if it is faster by this fraction, which keeps noise from
+/// picking a different value on every run.
+constexpr double kMinTuningGain = 0.02;
+
+std::string FormatTuningTime(const std::optional<double> &median_sec) {
+  if (!median_sec.has_value()) {
+    return "check failed";
+  }
+  std::ostringstream out;
+  out << "median_sec=" << median_sec.value();
+  return out.str();
+}
+
+/// @brief Median time of one run; empty if the output check failed on any rank. Sets @p elements to the input size.
+std::optional<double> MeasureTuningRun(const ppc::util::BenchCase &bench_case, const ppc::util::BenchRequest &request,
+                                       std::size_t &elements) {
+  const auto result = bench_case.run(request);
+  elements = result.input_size.value_or(result.size);
+  if (ppc::util::AnyRankTrue(result.check_passed.has_value() && !result.check_passed.value())) {
+    return std::nullopt;
+  }
+  return result.results.stats.median;
+}
+
+/// @brief Searches the tunable parameters of every selected case one at a time, keeping the best value of each while
+/// the next one is searched, and saves the results to PPC_TUNING_DIR.
+/// @return False if a case declares no tunable parameters or fails its check with the default values.
+bool TuneBenchCases(const std::vector<const ppc::util::BenchCase *> &cases, const BenchOptions &options) {
+  const auto mode = options.modes.size() == 1 ? options.modes.front() : TypeOfRunning::kTaskRun;
+  const auto tuning_dir = ppc::util::GetTuningDir();
+  const bool root = ppc::util::GetMPIRank() == 0;
+  bool all_tuned = true;
+  for (const auto *bench_case : cases) {
+    const auto test_id = GetBenchTestId(*bench_case);
+    std::vector<const ppc::util::TunableSpec *> specs;
+    std::ranges::copy_if(ppc::util::TunableRegistry(), std::back_inserter(specs), [&](const auto *spec) {
+      return spec->task == bench_case->task && spec->implementation == bench_case->implementation;
+    });
+    if (specs.empty()) {
+      if (root) {
+        std::cout << test_id << ":tune:no tunable parameters" << '\n';
+      }
+      all_tuned = false;
+      continue;
+    }
+
+    for (const auto *spec : specs) {
+      ppc::util::SetTunableOverride(*spec, spec->default_value);
+    }
+    const auto request = MakeBenchRequest(*bench_case, options, mode);
+    const ppc::util::ProfileTaskScope profile_task(test_id + ":tune");
+    std::size_t elements = 0;
+    const auto default_time = MeasureTuningRun(*bench_case, request, elements);
+    if (root) {
+      std::cout << test_id << ":tune:default " << FormatTuningTime(default_time) << '\n';
+    }
+    std::vector<int64_t> best_values;
+    double best_time = default_time.value_or(0.0);
+    for (const auto *spec : specs) {
+      int64_t best = spec->default_value;
+      for (const int64_t candidate : spec->candidates) {
+        if (!default_time.has_value() || candidate == best) {
+          continue;
+        }
+        ppc::util::SetTunableOverride(*spec, candidate);
+        const auto time = MeasureTuningRun(*bench_case, request, elements);
+        if (root) {
+          std::cout << test_id << ":tune:" << spec->name << "=" << candidate << " " << FormatTuningTime(time) << '\n';
+        }
+        if (time.has_value() && time.value() < best_time * (1.0 - kMinTuningGain)) {
+          best_time = time.value();
+          best = candidate;
+        }
+      }
+      ppc::util::SetTunableOverride(*spec, best);
+      best_values.push_back(best);
+    }
+
+    for (std::size_t i = 0; i < specs.size(); i++) {
+      ppc::util::SetTunableOverride(*specs[i], std::nullopt);
+      if (!default_time.has_value() || !root) {
+        continue;
+      }
+      const ppc::util::TunedValue tuned{.task = specs[i]->task,
+                                        .implementation = specs[i]->implementation,
+                                        .name = specs[i]->name,
+                                        .context = ppc::util::GetTuningContext(*specs[i], elements),
+                                        .value = best_values[i],
+                                        .median_sec = best_time,
+                                        .default_median_sec = default_time.value()};
+      std::cout << test_id << ":tuned:" << tuned.name << "=" << tuned.value << " default=" << specs[i]->default_value
+                << " threads=" << tuned.context.threads << " processes=" << tuned.context.processes
+                << " size_bucket=" << tuned.context.size_bucket
+                << " speedup=" << (best_time > 0.0 ? default_time.value() / best_time : 1.0) << '\n';
+      if (!tuning_dir.empty()) {
+        ppc::util::SaveTunedValue(tuning_dir, tuned);
+      }
+    }
+    if (root && default_time.has_value() && !tuning_dir.empty()) {
+      std::cout << test_id << ":tune:saved "
+                << ppc::util::GetTuningPath(tuning_dir, ppc::performance::GetRunMetadata().hostname).string() << '\n';
+    }
+    all_tuned = all_tuned && default_time.has_value();
+  }
+  return all_tuned;
+}
+
+}  // namespace
+
+BenchOptions ParseBenchOptions(const std::vector<std::string> &args) {
+  BenchOptions options;
+  for (std::size_t i = 0; i < args.size(); i++) {
+    std::string option = args[i];
+    std::string value;
+    bool has_value = false;
+    if (const auto eq = option.find('='); option.starts_with("--") && eq != std::string::npos) {
+      value = option.substr(eq + 1);
+      option = option.substr(0, eq);
+      has_value = true;
+    }
+    if (option == "--help" || option == "-h") {
+      options.help = true;
+      continue;
+    }
+    if (option == "--list") {
+      options.list = true;
+      continue;
+    }
+    if (option == "--no-check") {
+      options.check = false;
+      continue;
+    }
+    if (option == "--tune") {
+      options.tune = true;
+      continue;
+    }
+    if (std::ranges::find(kValueOptions, option) == kValueOptions.end()) {
+      throw std::runtime_error("Unknown option " + option);
+    }
+    if (!has_value) {
+      if (i + 1 >= args.size()) {
+        throw std::runtime_error("Missing value for " + option);
+      }
+      value = args[++i];
+    }
+    if (option == "--task") {
+      options.task = value;
+    } else if (option == "--impl") {
+      options.implementation = value;
+    } else if (option == "--size") {
+      options.size = ParseNumber<std::size_t>(option, value);
+    } else if (option == "--generator") {
+      options.generator = value;
+    } else if (option == "--seed") {
+      options.seed = ParseNumber<uint64_t>(option, value);
+    } else if (option == "--mode") {
+      options.modes = ParseModes(value);
+    } else if (option == "--iterations") {
+      options.iterations = value == "auto" ? std::nullopt : std::optional(ParseNumber<uint64_t>(option, value));
+    } else if (option == "--warmup") {
+      options.warmup = ParseNumber<uint64_t>(option, value);
+    } else if (option == "--max-iterations") {
+      options.max_iterations = ParseNumber<uint64_t>(option, value);
+    } else if (option == "--time-budget") {
+      options.time_budget_sec = ParseNumber<double>(option, value);
+    } else if (option == "--target-ci") {
+      options.target_rel_ci = ParseNumber<double>(option, value);
+    } else if (option == "--cache") {
+      options.cache_state = ParseCacheState(value);
+    } else if (option == "--threads") {
+      options.threads = ParseNumber<int>(option, value);
+    } else if (option == "--processes") {
+      options.processes = ParseNumber<int>(option, value);
+    } else if (option == "--mpiexec") {
+      options.mpiexec = value;
+    } else if (option == "--format") {
+      if (value != "text" && value != "json") {
+        throw std::runtime_error("Unknown --format '" + value + "' (expected text or json)");
+      }
+      options.format = value;
+    }
+  }
+  if (options.iterations.has_value() && options.iterations.value() == 0) {
+    throw std::runtime_error("--iterations must be positive");
+  }
+  if (!options.help && !options.list && options.task.empty()) {
+    throw std::runtime_error("--task is required");
+  }
+  return options;
+}
+
+std::string GetBenchUsage() {
+  return "Usage: ppc_bench --task <id> [options]\n"
+         "Runs the pipeline of one registered task and prints its perf statistics.\n"
+         "\n"
+         "  --list                    print the registered tasks, implementations and generators\n"
+         "  --task <id>               task directory name\n"
+         "  --impl <name>             seq, omp, tbb, stl, pstl, mpi or all (default: every registered one)\n"
+         "  --size <n>                problem size passed to the generator (default: the task's)\n"
+         "  --generator <name>        input generator (default: the task's first)\n"
+         "  --seed <n>                generator seed, the same on every process (default: 1)\n"
+         "  --mode <m>                pipeline, task_run or both (default: both)\n"
+         "  --iterations <n|auto>     fixed number of timed iterations (default: auto)\n"
+         "  --warmup <n>              untimed iterations before sampling\n"
+         "  --max-iterations <n>      upper bound of the adaptive count\n"
+         "  --time-budget <sec>       sampling budget of the adaptive count\n"
+         "  --target-ci <x>           target relative CI of the median for the adaptive count\n"
+         "  --cache <warm|cold>       cache state every timed iteration starts from (default: warm)\n"
+         "  --threads <n>             threads per process (sets PPC_NUM_THREADS and OMP_NUM_THREADS)\n"
+         "  --processes <n>           MPI processes; starts itself under the launcher if needed\n"
+         "  --mpiexec <cmd>           launcher used by --processes (default: mpiexec)\n"
+         "  --format <text|json>      perf test lines or one ppc.perf.v1 JSON record per mode\n"
+         "  --no-check                skip the output check\n"
+         "  --tune                    search the task's tunable parameters (saved to PPC_TUNING_DIR if set)\n";
+}
+
+std::vector<const ppc::util::BenchCase *> SelectBenchCases(const std::vector<ppc::util::BenchCase> &registry,
+                                                           const BenchOptions &options) {
+  std::vector<const ppc::util::BenchCase *> cases;
+  bool task_found = false;
+  for (const auto &bench_case : registry) {
+    if (bench_case.task != options.task) {
+      continue;
+    }
+    task_found = true;
+    if (options.implementation.empty() || bench_case.implementation == options.implementation) {
+      cases.push_back(&bench_case);
+    }
+  }
+  if (!task_found) {
+    throw std::runtime_error("Task '" + options.task + "' is not registered with ppc_bench (see --list)");
+  }
+  if (cases.empty()) {
+    throw std::runtime_error("Task '" + options.task + "' has no registered implementation '" +
+                             options.implementation + "' (see --list)");
+  }
+  return cases;
+}
+
+int BenchMain(int argc, char **argv) {
+  BenchOptions options;
+  try {
+    options = ParseBenchOptions(std::vector<std::string>(argv + 1, argv + argc));
+  } catch (const std::exception &e) {
+    std::cerr << "[  ERROR  ] " << e.what() << '\n' << GetBenchUsage();
+    return EXIT_FAILURE;
+  }
+  if (options.help) {
+    std::cout << GetBenchUsage();
+    return EXIT_SUCCESS;
+  }
+  if (options.list) {
+    std::cout << ListBenchCases(ppc::util::BenchRegistry());
+    return EXIT_SUCCESS;
+  }
+  if (options.threads > 0) {
+    env::detail::set_environment_variable("PPC_NUM_THREADS", std::to_string(options.threads));
+    env::detail::set_environment_variable("OMP_NUM_THREADS", std::to_string(options.threads));
+    omp_set_num_threads(options.threads);
+  }
+  if (options.processes > 1 && !ppc::util::IsUnderMpirun() && std::getenv(kLaunchedEnvVar) == nullptr) {
+    return RelaunchUnderMpiexec(options, argv);
+  }
+
+  std::vector<const ppc::util::BenchCase *> cases;
+  try {
+    cases = SelectBenchCases(ppc::util::BenchRegistry(), options);
+  } catch (const std::exception &e) {
+    std::cerr << "[  ERROR  ] " << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  const int init_res = MPI_Init(&argc, &argv);
+  if (init_res != MPI_SUCCESS) {
+    std::cerr << "[  ERROR  ] MPI_Init failed with code " << init_res << '\n';
+    MPI_Abort(MPI_COMM_WORLD, init_res);
+    return init_res;
+  }
+
+  // Limit the number of threads in TBB
+  tbb::global_control control(tbb::global_control::max_allowed_parallelism, ppc::util::GetNumThreads());
+
+  bool passed = false;
+  if (options.processes > 0 && options.processes != ppc::util::GetMPISize()) {
+    if (ppc::util::GetMPIRank() == 0) {
+      std::cerr << "[  ERROR  ] Requested " << options.processes << " processes, but started with "
+                << ppc::util::GetMPISize() << '\n';
+    }
+  } else {
+    try {
+      passed = options.tune ? TuneBenchCases(cases, options) : RunBenchCases(cases, options);
+    } catch (const std::exception &e) {
+      std::cerr << "[  ERROR  ] " << e.what() << '\n';
+      MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+      return EXIT_FAILURE;
+    }
+  }
+  ppc::performance::ReportMpiProfile();
+  ppc::util::WriteTrace();
+
+  const int finalize_res = MPI_Finalize();
+  if (finalize_res != MPI_SUCCESS) {
+    std::cerr << "[  ERROR  ] MPI_Finalize failed with code " << finalize_res << '\n';
+    MPI_Abort(MPI_COMM_WORLD, finalize_res);
+    return finalize_res;
+  }
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace ppc::runners
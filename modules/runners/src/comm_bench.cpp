@@ -0,0 +1,282 @@
+#include "runners/include/comm_bench.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "performance/include/comm_bench.hpp"
+#include "performance/include/run_metadata.hpp"
+
+namespace ppc::runners {
+
+namespace {
+
+constexpr std::array<std::string_view, 8> kValueOptions = {
+    "--patterns", "--min-bytes", "--max-bytes", "--factor", "--ranks", "--iterations", "--format", "--output"};
+
+template <typename T>
+T ParseNumber(const std::string &option, const std::string &value) {
+  std::istringstream in(value);
+  T number{};
+  if (value.starts_with('-') || !(in >> number) || !in.eof()) {
+    throw std::runtime_error("Invalid value '" + value + "' for " + option);
+  }
+  return number;
+}
+
+std::vector<std::string> SplitList(const std::string &value) {
+  std::vector<std::string> items;
+  std::istringstream in(value);
+  for (std::string item; std::getline(in, item, ',');) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+/// @brief Runs every pattern and size on the first @p ranks processes; returns false if a custom result differed.
+bool RunOnRanks(const CommBenchOptions &options, int ranks, std::ofstream &output) {
+  int world_rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+  MPI_Comm comm = MPI_COMM_NULL;
+  MPI_Comm_split(MPI_COMM_WORLD, world_rank < ranks ? 0 : MPI_UNDEFINED, world_rank, &comm);
+  if (comm == MPI_COMM_NULL) {
+    return true;
+  }
+
+  bool all_match = true;
+  const auto &metadata = ppc::performance::GetRunMetadata();
+  for (const auto pattern : options.patterns) {
+    const auto name = ppc::performance::GetCommPatternName(pattern);
+    if (!ppc::performance::CustomCollectiveRegistry().contains(pattern)) {
+      if (world_rank == 0) {
+        std::cerr << "comm:" << name << ":skipped no task registered a custom implementation\n";
+      }
+      continue;
+    }
+    for (const auto bytes : GetCommBenchSizes(options.min_bytes, options.max_bytes, options.factor)) {
+      const auto iterations = options.iterations.value_or(ppc::performance::GetCommBenchIterations(bytes));
+      const auto native = ppc::performance::MeasureCommPattern(pattern, false, bytes, iterations, comm);
+      const auto custom = ppc::performance::MeasureCommPattern(pattern, true, bytes, iterations, comm, options.check);
+      all_match = all_match && custom.matches.value_or(true);
+      if (world_rank != 0) {
+        continue;
+      }
+      const double speedup = ppc::performance::CommBenchSpeedup(custom, native);
+      if (options.format == "json" || output.is_open()) {
+        for (const auto *point : {&native, &custom}) {
+          auto record = ppc::performance::CommBenchPointToJson(*point);
+          record["speedup_vs_native"] = point == &custom ? nlohmann::json(speedup) : nlohmann::json(nullptr);
+          record["host"] = {{"hostname", metadata.hostname}, {"cpu_model", metadata.cpu_model}};
+          const auto line = record.dump();
+          if (options.format == "json") {
+            std::cout << line << '\n';
+          }
+          if (output.is_open()) {
+            output << line << '\n';
+          }
+        }
+      }
+      if (options.format == "text") {
+        for (const auto *point : {&native, &custom}) {
+          std::cout << "comm:" << name << ":" << point->implementation << ":ranks=" << ranks << " bytes=" << bytes
+                    << " iterations=" << point->samples.size() << " latency_sec=" << point->stats.median
+                    << " bandwidth=" << point->bandwidth << '\n';
+        }
+        std::cout << "comm:" << name << ":speedup:ranks=" << ranks << " bytes=" << bytes
+                  << " custom_vs_native=" << speedup << (custom.matches.value_or(true) ? "" : " MISMATCH") << '\n';
+      }
+    }
+  }
+  MPI_Comm_free(&comm);
+  return all_match;
+}
+
+}  // namespace
+
+CommBenchOptions ParseCommBenchOptions(const std::vector<std::string> &args) {
+  CommBenchOptions options;
+  for (std::size_t i = 0; i < args.size(); i++) {
+    std::string option = args[i];
+    std::string value;
+    bool has_value = false;
+    if (const auto eq = option.find('='); option.starts_with("--") && eq != std::string::npos) {
+      value = option.substr(eq + 1);
+      option = option.substr(0, eq);
+      has_value = true;
+    }
+    if (option == "--help" || option == "-h") {
+      options.help = true;
+      continue;
+    }
+    if (option == "--no-check") {
+      options.check = false;
+      continue;
+    }
+    if (std::ranges::find(kValueOptions, option) == kValueOptions.end()) {
+      throw std::runtime_error("Unknown option " + option);
+    }
+    if (!has_value) {
+      if (i + 1 >= args.size()) {
+        throw std::runtime_error("Missing value for " + option);
+      }
+      value = args[++i];
+    }
+    if (option == "--patterns") {
+      options.patterns.clear();
+      for (const auto &name : SplitList(value)) {
+        options.patterns.push_back(ppc::performance::ParseCommPattern(name));
+      }
+    } else if (option == "--min-bytes") {
+      options.min_bytes = ParseNumber<std::size_t>(option, value);
+    } else if (option == "--max-bytes") {
+      options.max_bytes = ParseNumber<std::size_t>(option, value);
+    } else if (option == "--factor") {
+      options.factor = ParseNumber<std::size_t>(option, value);
+    } else if (option == "--ranks") {
+      options.ranks.clear();
+      for (const auto &count : SplitList(value)) {
+        options.ranks.push_back(ParseNumber<int>(option, count));
+      }
+    } else if (option == "--iterations") {
+      options.iterations = ParseNumber<std::size_t>(option, value);
+    } else if (option == "--format") {
+      if (value != "text" && value != "json") {
+        throw std::runtime_error("Unknown --format '" + value + "' (expected text or json)");
+      }
+      options.format = value;
+    } else if (option == "--output") {
+      options.output = value;
+    }
+  }
+  if (options.patterns.empty()) {
+    throw std::runtime_error("--patterns must name at least one pattern");
+  }
+  if (options.min_bytes == 0 || options.min_bytes > options.max_bytes) {
+    throw std::runtime_error("Message sizes must satisfy 0 < --min-bytes <= --max-bytes");
+  }
+  // MPI counts are int; larger messages need the chunked or large-count calls
+  if (options.max_bytes > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+    throw std::runtime_error("--max-bytes must fit into an MPI count (2 GiB - 1)");
+  }
+  if (options.factor < 2) {
+    throw std::runtime_error("--factor must be at least 2");
+  }
+  if (std::ranges::any_of(options.ranks, [](int count) { return count < 1; })) {
+    throw std::runtime_error("--ranks must be positive");
+  }
+  if (options.iterations.has_value() && options.iterations.value() == 0) {
+    throw std::runtime_error("--iterations must be positive");
+  }
+  return options;
+}
+
+std::string GetCommBenchUsage() {
+  return "Usage: mpiexec -n <p> ppc_comm_bench [options]\n"
+         "Compares the hand-written collectives of the tasks with native MPI over message sizes and rank counts.\n"
+         "\n"
+         "  --patterns <list>         comma-separated bcast, reduce, gather (default: all)\n"
+         "  --min-bytes <n>           smallest message (default: 8)\n"
+         "  --max-bytes <n>           largest message (default: 268435456)\n"
+         "  --factor <n>              ratio between consecutive sizes (default: 2)\n"
+         "  --ranks <list>            comma-separated rank counts (default: powers of two and the launched count)\n"
+         "  --iterations <n>          timed iterations per size (default: scaled with the size)\n"
+         "  --format <text|json>      one line or one ppc.comm_bench.v1 record per measurement\n"
+         "  --output <path>           also write the JSON records to this file\n"
+         "  --no-check                skip comparing the custom results with the native ones\n";
+}
+
+std::vector<std::size_t> GetCommBenchSizes(std::size_t min_bytes, std::size_t max_bytes, std::size_t factor) {
+  std::vector<std::size_t> sizes;
+  for (std::size_t bytes = min_bytes; bytes < max_bytes; bytes *= factor) {
+    sizes.push_back(bytes);
+    if (bytes > max_bytes / factor) {
+      break;
+    }
+  }
+  sizes.push_back(max_bytes);
+  return sizes;
+}
+
+std::vector<int> GetCommBenchRankCounts(const CommBenchOptions &options, int world_size) {
+  std::vector<int> counts;
+  if (options.ranks.empty()) {
+    for (int count = 2; count < world_size; count *= 2) {
+      counts.push_back(count);
+    }
+    counts.push_back(world_size);
+  } else {
+    std::ranges::copy_if(options.ranks, std::back_inserter(counts), [&](int count) { return count <= world_size; });
+  }
+  std::ranges::sort(counts);
+  const auto [first, last] = std::ranges::unique(counts);
+  counts.erase(first, last);
+  return counts;
+}
+
+int CommBenchMain(int argc, char **argv) {
+  CommBenchOptions options;
+  try {
+    options = ParseCommBenchOptions(std::vector<std::string>(argv + 1, argv + argc));
+  } catch (const std::exception &e) {
+    std::cerr << "[  ERROR  ] " << e.what() << '\n' << GetCommBenchUsage();
+    return EXIT_FAILURE;
+  }
+  if (options.help) {
+    std::cout << GetCommBenchUsage();
+    return EXIT_SUCCESS;
+  }
+
+  const int init_res = MPI_Init(&argc, &argv);
+  if (init_res != MPI_SUCCESS) {
+    std::cerr << "[  ERROR  ] MPI_Init failed with code " << init_res << '\n';
+    MPI_Abort(MPI_COMM_WORLD, init_res);
+    return init_res;
+  }
+  int world_rank = 0;
+  int world_size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+  std::ofstream output;
+  if (world_rank == 0 && !options.output.empty()) {
+    output.open(options.output);
+  }
+  const auto rank_counts = GetCommBenchRankCounts(options, world_size);
+  if (rank_counts.empty() && world_rank == 0) {
+    std::cerr << "[  ERROR  ] None of the requested rank counts fits into " << world_size << " processes" << '\n';
+  }
+  bool all_match = !rank_counts.empty();
+  for (const int ranks : rank_counts) {
+    all_match = RunOnRanks(options, ranks, output) && all_match;
+    MPI_Barrier(MPI_COMM_WORLD);
+  }
+  int local = all_match ? 1 : 0;
+  int global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+
+  const int finalize_res = MPI_Finalize();
+  if (finalize_res != MPI_SUCCESS) {
+    std::cerr << "[  ERROR  ] MPI_Finalize failed with code " << finalize_res << '\n';
+    return finalize_res;
+  }
+  return global != 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace ppc::runners
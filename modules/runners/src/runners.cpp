@@ -16,6 +16,8 @@
 #include <string_view>
 
 #include "oneapi/tbb/global_control.h"
+#include "performance/include/mpi_profiler.hpp"
+#include "util/include/trace.hpp"
 #include "util/include/util.hpp"
 
 namespace ppc::runners {
@@ -167,6 +169,8 @@ int Init(int argc, char **argv) {
   listeners.Append(new UnreadMessagesDetector());
 
   const int status = RunAllTestsSafely();
+  ppc::performance::ReportMpiProfile();
+  ppc::util::WriteTrace();
 
   const int finalize_res = MPI_Finalize();
   if (finalize_res != MPI_SUCCESS) {
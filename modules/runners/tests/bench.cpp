@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "performance/include/cache_control.hpp"
+#include "performance/include/performance.hpp"
+#include "runners/include/bench.hpp"
+#include "task/include/task.hpp"
+#include "util/include/bench_registry.hpp"
+#include "util/include/perf_test_util.hpp"
+
+namespace ppc::test {
+
+namespace {
+
+using TypeOfRunning = ppc::performance::PerfResults::TypeOfRunning;
+
+class BenchSumTask : public ppc::task::Task<std::vector<int>, int> {
+ public:
+  static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
+    return ppc::task::TypeOfTask::kSEQ;
+  }
+
+  explicit BenchSumTask(const std::vector<int> &in) {
+    SetTypeOfTask(GetStaticTypeOfTask());
+    GetInput() = in;
+  }
+
+  bool ValidationImpl() override {
+    return true;
+  }
+
+  bool PreProcessingImpl() override {
+    GetOutput() = 0;
+    return true;
+  }
+
+  bool RunImpl() override {
+    GetOutput() = std::accumulate(GetInput().begin(), GetInput().end(), 0);
+    return true;
+  }
+
+  bool PostProcessingImpl() override {
+    return true;
+  }
+};
+
+ppc::util::BenchInputs<std::vector<int>, int> MakeSumInputs() {
+  return {.default_size = 16,
+          .generators = {{"ones", [](std::size_t size, uint64_t /*seed*/) { return std::vector<int>(size, 1); }},
+                         {"seeded",
+                          [](std::size_t size, uint64_t seed) {
+                            return std::vector<int>(size, static_cast<int>(seed));
+                          }}},
+          .check = [](const std::vector<int> &input, const int &output) {
+            return std::accumulate(input.begin(), input.end(), 0) == output;
+          }};
+}
+
+ppc::util::BenchRequest MakeFixedRequest() {
+  ppc::util::BenchRequest request;
+  ppc::util::ConfigurePerfAttributes(request.perf_attr, ppc::task::TypeOfTask::kSEQ);
+  request.perf_attr.adaptive_running = false;
+  request.perf_attr.num_running = 3;
+  return request;
+}
+
+}  // namespace
+
+TEST(BenchTest, ParsesOptionsInBothSpellings) {
+  const auto options = ppc::runners::ParseBenchOptions({"--task", "example_threads", "--impl=omp", "--size", "1000",
+                                                        "--iterations=7", "--mode", "pipeline", "--threads", "4",
+                                                        "--cache=cold", "--format", "json", "--no-check"});
+  EXPECT_EQ(options.task, "example_threads");
+  EXPECT_EQ(options.implementation, "omp");
+  EXPECT_EQ(options.size, 1000U);
+  ASSERT_TRUE(options.iterations.has_value());
+  EXPECT_EQ(options.iterations.value(), 7U);
+  EXPECT_EQ(options.modes, std::vector<TypeOfRunning>{TypeOfRunning::kPipeline});
+  EXPECT_EQ(options.threads, 4);
+  EXPECT_EQ(options.cache_state, ppc::performance::CacheState::kCold);
+  EXPECT_EQ(options.format, "json");
+  EXPECT_FALSE(options.check);
+  EXPECT_FALSE(options.tune);
+  EXPECT_TRUE(ppc::runners::ParseBenchOptions({"--task", "t", "--tune"}).tune);
+}
+
+TEST(BenchTest, DefaultsToAdaptiveRunsOfBothModes) {
+  const auto options = ppc::runners::ParseBenchOptions({"--task", "t", "--iterations", "auto"});
+  EXPECT_FALSE(options.iterations.has_value());
+  EXPECT_EQ(options.modes.size(), 2U);
+  EXPECT_TRUE(options.implementation.empty());
+  EXPECT_EQ(options.processes, 0);
+}
+
+TEST(BenchTest, RejectsBadArguments) {
+  using ppc::runners::ParseBenchOptions;
+  EXPECT_THROW(ParseBenchOptions({}), std::runtime_error);
+  EXPECT_THROW(ParseBenchOptions({"--task", "t", "--unknown", "1"}), std::runtime_error);
+  EXPECT_THROW(ParseBenchOptions({"--task", "t", "--size", "-5"}), std::runtime_error);
+  EXPECT_THROW(ParseBenchOptions({"--task", "t", "--size", "12abc"}), std::runtime_error);
+  EXPECT_THROW(ParseBenchOptions({"--task", "t", "--iterations", "0"}), std::runtime_error);
+  EXPECT_THROW(ParseBenchOptions({"--task", "t", "--mode", "fast"}), std::runtime_error);
+  EXPECT_THROW(ParseBenchOptions({"--task", "t", "--format", "xml"}), std::runtime_error);
+  EXPECT_THROW(ParseBenchOptions({"--task"}), std::runtime_error);
+  EXPECT_NO_THROW(ParseBenchOptions({"--list"}));
+}
+
+TEST(BenchTest, SelectsRegisteredImplementations) {
+  std::vector<ppc::util::BenchCase> registry(3);
+  registry[0].task = "a";
+  registry[0].implementation = "seq";
+  registry[1].task = "b";
+  registry[1].implementation = "seq";
+  registry[2].task = "a";
+  registry[2].implementation = "omp";
+
+  ppc::runners::BenchOptions options;
+  options.task = "a";
+  const auto all = ppc::runners::SelectBenchCases(registry, options);
+  ASSERT_EQ(all.size(), 2U);
+  EXPECT_EQ(all[0], registry.data());
+  EXPECT_EQ(all[1], &registry[2]);
+
+  options.implementation = "omp";
+  const auto omp = ppc::runners::SelectBenchCases(registry, options);
+  ASSERT_EQ(omp.size(), 1U);
+  EXPECT_EQ(omp[0]->implementation, "omp");
+
+  options.implementation = "tbb";
+  EXPECT_THROW(ppc::runners::SelectBenchCases(registry, options), std::runtime_error);
+  options.task = "missing";
+  options.implementation.clear();
+  EXPECT_THROW(ppc::runners::SelectBenchCases(registry, options), std::runtime_error);
+}
+
+TEST(BenchTest, RunsTaskOnGeneratedInput) {
+  auto request = MakeFixedRequest();
+  request.size = 100;
+  request.generator = "seeded";
+  request.seed = 3;
+  request.mode = TypeOfRunning::kPipeline;
+  const auto result = ppc::util::RunBenchCase<BenchSumTask>(MakeSumInputs(), request);
+  EXPECT_EQ(result.size, 100U);
+  EXPECT_EQ(result.generator, "seeded");
+  EXPECT_EQ(result.results.samples.size(), 3U);
+  EXPECT_EQ(result.results.type_of_running, TypeOfRunning::kPipeline);
+  EXPECT_EQ(result.input_size, 100U);
+  EXPECT_EQ(result.input_bytes, 100U * sizeof(int));
+  ASSERT_TRUE(result.check_passed.has_value());
+  EXPECT_TRUE(result.check_passed.value());
+}
+
+TEST(BenchTest, UsesDefaultsAndSkipsCheckOnRequest) {
+  auto request = MakeFixedRequest();
+  request.check = false;
+  const auto result = ppc::util::RunBenchCase<BenchSumTask>(MakeSumInputs(), request);
+  EXPECT_EQ(result.size, 16U);
+  EXPECT_EQ(result.generator, "ones");
+  EXPECT_FALSE(result.check_passed.has_value());
+
+  request.generator = "missing";
+  EXPECT_THROW(ppc::util::RunBenchCase<BenchSumTask>(MakeSumInputs(), request), std::runtime_error);
+}
+
+TEST(BenchTest, RegistersEveryImplementation) {
+  auto &registry = ppc::util::BenchRegistry();
+  const auto before = registry.size();
+  EXPECT_TRUE(ppc::util::RegisterBenchTasks<BenchSumTask>("bench_sum", "settings.json", MakeSumInputs()));
+  ASSERT_EQ(registry.size(), before + 1);
+  const auto &bench_case = registry.back();
+  EXPECT_EQ(bench_case.task, "bench_sum");
+  EXPECT_EQ(bench_case.implementation, "seq");
+  EXPECT_EQ(bench_case.default_size, 16U);
+  EXPECT_EQ(bench_case.generators, (std::vector<std::string>{"ones", "seeded"}));
+  const auto result = bench_case.run(MakeFixedRequest());
+  EXPECT_EQ(result.check_passed, true);
+  registry.resize(before);
+}
+
+}  // namespace ppc::test
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "performance/include/comm_bench.hpp"
+#include "runners/include/comm_bench.hpp"
+
+namespace ppc::test {
+
+using ppc::performance::CommPattern;
+
+TEST(CommBenchTest, ParsesOptions) {
+  const auto options = ppc::runners::ParseCommBenchOptions({"--patterns", "gather,bcast", "--min-bytes=64",
+                                                            "--max-bytes", "4096", "--factor", "4", "--ranks=2,4",
+                                                            "--iterations", "10", "--format", "json", "--no-check"});
+  EXPECT_EQ(options.patterns, (std::vector<CommPattern>{CommPattern::kGather, CommPattern::kBcast}));
+  EXPECT_EQ(options.min_bytes, 64U);
+  EXPECT_EQ(options.max_bytes, 4096U);
+  EXPECT_EQ(options.factor, 4U);
+  EXPECT_EQ(options.ranks, (std::vector<int>{2, 4}));
+  EXPECT_EQ(options.iterations, 10U);
+  EXPECT_EQ(options.format, "json");
+  EXPECT_FALSE(options.check);
+
+  const auto defaults = ppc::runners::ParseCommBenchOptions({});
+  EXPECT_EQ(defaults.patterns.size(), 3U);
+  EXPECT_EQ(defaults.min_bytes, 8U);
+  EXPECT_EQ(defaults.max_bytes, std::size_t{256} << 20);
+  EXPECT_FALSE(defaults.iterations.has_value());
+}
+
+TEST(CommBenchTest, RejectsBadArguments) {
+  using ppc::runners::ParseCommBenchOptions;
+  EXPECT_THROW(ParseCommBenchOptions({"--patterns", "alltoall"}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--patterns", ","}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--min-bytes", "0"}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--min-bytes", "1024", "--max-bytes", "8"}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--max-bytes", "4294967296"}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--factor", "1"}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--ranks", "2,-1"}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--ranks", "0"}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--iterations", "0"}), std::runtime_error);
+  EXPECT_THROW(ParseCommBenchOptions({"--unknown"}), std::runtime_error);
+}
+
+TEST(CommBenchTest, SweepsSizesUpToTheMaximum) {
+  using ppc::runners::GetCommBenchSizes;
+  EXPECT_EQ(GetCommBenchSizes(8, 64, 2), (std::vector<std::size_t>{8, 16, 32, 64}));
+  EXPECT_EQ(GetCommBenchSizes(8, 100, 4), (std::vector<std::size_t>{8, 32, 100}));
+  EXPECT_EQ(GetCommBenchSizes(8, 8, 2), (std::vector<std::size_t>{8}));
+  EXPECT_EQ(GetCommBenchSizes(8, std::size_t{256} << 20, 2).size(), 26U);
+}
+
+TEST(CommBenchTest, SelectsRankCountsThatFit) {
+  ppc::runners::CommBenchOptions options;
+  EXPECT_EQ(ppc::runners::GetCommBenchRankCounts(options, 1), (std::vector<int>{1}));
+  EXPECT_EQ(ppc::runners::GetCommBenchRankCounts(options, 6), (std::vector<int>{2, 4, 6}));
+  EXPECT_EQ(ppc::runners::GetCommBenchRankCounts(options, 8), (std::vector<int>{2, 4, 8}));
+  options.ranks = {8, 3, 3, 16};
+  EXPECT_EQ(ppc::runners::GetCommBenchRankCounts(options, 8), (std::vector<int>{3, 8}));
+}
+
+TEST(CommBenchTest, ScalesIterationsWithMessageSize) {
+  EXPECT_EQ(ppc::performance::GetCommBenchIterations(8), 1000U);
+  EXPECT_EQ(ppc::performance::GetCommBenchIterations(std::size_t{1} << 20), 64U);
+  EXPECT_EQ(ppc::performance::GetCommBenchIterations(std::size_t{256} << 20), 5U);
+  EXPECT_EQ(ppc::performance::ParseCommPattern("reduce"), CommPattern::kReduce);
+  EXPECT_EQ(ppc::performance::GetCommPatternName(CommPattern::kGather), "gather");
+}
+
+}  // namespace ppc::test
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+// Per-ISA kernels are compiled in one translation unit with target attributes, so the baseline build flags stay
+// portable and the best variant the CPU supports is chosen at run time. Other compilers get the scalar kernels only.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PPC_SIMD_X86 1
+#define PPC_SIMD_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define PPC_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define PPC_SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl")))
+#else
+#define PPC_SIMD_X86 0
+#define PPC_SIMD_TARGET_SSE42
+#define PPC_SIMD_TARGET_AVX2
+#define PPC_SIMD_TARGET_AVX512
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PPC_SIMD_VECTOR_EXTENSIONS 1
+/// @brief Forces a kernel body into its per-ISA wrapper, which compiles it for that wrapper's target.
+#define PPC_SIMD_INLINE [[gnu::always_inline]] inline
+#else
+#define PPC_SIMD_VECTOR_EXTENSIONS 0
+#define PPC_SIMD_INLINE inline
+#endif
+
+namespace ppc::simd {
+
+/// @brief Instruction set of a kernel variant, ordered from the least to the most capable.
+enum class Isa : uint8_t {
+  kScalar,
+  kSse42,
+  kAvx2,
+  /// @brief AVX-512 F, BW and VL.
+  kAvx512,
+};
+
+inline constexpr std::array<Isa, 4> kIsas = {Isa::kScalar, Isa::kSse42, Isa::kAvx2, Isa::kAvx512};
+
+/// @brief Name used in PPC_SIMD_ISA and in reports: "scalar", "sse4.2", "avx2" or "avx512".
+std::string_view GetIsaName(Isa isa);
+
+/// @throws std::runtime_error If @p name is not one of the names returned by GetIsaName().
+Isa ParseIsa(std::string_view name);
+
+/// @brief Most capable ISA that both the CPU (cpuid) and this build support; detected once per process.
+Isa DetectIsa();
+
+/// @brief ISA the kernels dispatch to: DetectIsa(), lowered to PPC_SIMD_ISA if that names a less capable one.
+/// @details PPC_SIMD_ISA is read on the first call only, since every kernel call asks for the ISA.
+/// @throws std::runtime_error If PPC_SIMD_ISA is set to an unknown name.
+Isa ActiveIsa();
+
+/// @brief Makes the next ActiveIsa() call read PPC_SIMD_ISA again (for tests that change it).
+void ResetActiveIsa();
+
+/// @brief Variants of one kernel; null entries are not provided and fall back to the next less capable variant.
+template <typename Fn>
+struct Kernels {
+  Fn *scalar = nullptr;
+  Fn *sse42 = nullptr;
+  Fn *avx2 = nullptr;
+  Fn *avx512 = nullptr;
+};
+
+/// @brief Most capable variant of @p kernels not above @p isa.
+template <typename Fn>
+Fn *Select(const Kernels<Fn> &kernels, Isa isa = ActiveIsa()) {
+  if (isa >= Isa::kAvx512 && kernels.avx512 != nullptr) {
+    return kernels.avx512;
+  }
+  if (isa >= Isa::kAvx2 && kernels.avx2 != nullptr) {
+    return kernels.avx2;
+  }
+  if (isa >= Isa::kSse42 && kernels.sse42 != nullptr) {
+    return kernels.sse42;
+  }
+  return kernels.scalar;
+}
+
+#if PPC_SIMD_VECTOR_EXTENSIONS
+/// @cond
+template <typename T, std::size_t Bytes>
+struct VecStorage {
+  using Type __attribute__((vector_size(Bytes))) = T;
+};
+/// @endcond
+
+/// @brief Portable vector of @p Bytes / sizeof(T) lanes (GCC/Clang vector extensions).
+/// @details Arithmetic, comparisons (-1 in true lanes) and ?: work lane-wise, an operand may be a scalar, and all of
+/// them compile to the instructions of the enclosing function's target. One kernel body written with Vec therefore
+/// serves every ISA when instantiated with the register width of each variant.
+template <typename T, std::size_t Bytes>
+using Vec = typename VecStorage<T, Bytes>::Type;
+
+/// @brief Register widths in bytes of the vector variants.
+inline constexpr std::size_t kSse42Bytes = 16;
+inline constexpr std::size_t kAvx2Bytes = 32;
+inline constexpr std::size_t kAvx512Bytes = 64;
+
+template <typename V>
+inline constexpr std::size_t kLanes = sizeof(V) / sizeof(V{}[0]);
+
+/// @brief Unaligned load of kLanes<V> values starting at @p data.
+/// @details The helpers take vectors by reference: passing wide vectors by value to functions compiled for the
+/// baseline target changes their ABI, which GCC reports as an error under -Werror (-Wpsabi).
+template <typename V, typename T>
+PPC_SIMD_INLINE void Load(V &v, const T *data) {
+  std::memcpy(&v, data, sizeof(V));
+}
+
+template <typename V, typename T>
+PPC_SIMD_INLINE void Store(T *data, const V &v) {
+  std::memcpy(data, &v, sizeof(V));
+}
+
+template <typename V>
+PPC_SIMD_INLINE auto ReduceMin(const V &v) {
+  auto result = v[0];
+  for (std::size_t lane = 1; lane < kLanes<V>; lane++) {
+    result = v[lane] < result ? v[lane] : result;
+  }
+  return result;
+}
+
+template <typename V>
+PPC_SIMD_INLINE auto ReduceMax(const V &v) {
+  auto result = v[0];
+  for (std::size_t lane = 1; lane < kLanes<V>; lane++) {
+    result = result < v[lane] ? v[lane] : result;
+  }
+  return result;
+}
+
+/// @brief Sum of the lanes of @p v in @p Result, which must be wide enough not to overflow.
+template <typename Result, typename V>
+PPC_SIMD_INLINE Result ReduceAdd(const V &v) {
+  Result result{};
+  for (std::size_t lane = 0; lane < kLanes<V>; lane++) {
+    result += static_cast<Result>(v[lane]);
+  }
+  return result;
+}
+#endif
+
+/// @brief Smallest and largest element of a range.
+template <typename T>
+struct MinMaxResult {
+  T min{};
+  T max{};
+};
+
+/// @brief Smallest and largest of @p values, dispatched to the active ISA.
+/// @details Values must not be NaN.
+/// @throws std::runtime_error If @p values is empty.
+MinMaxResult<uint8_t> MinMax(std::span<const uint8_t> values);
+MinMaxResult<int32_t> MinMax(std::span<const int32_t> values);
+MinMaxResult<double> MinMax(std::span<const double> values);
+
+/// @brief Number of positions i < min(a.size(), b.size()) with a[i] != b[i], dispatched to the active ISA.
+std::size_t CountMismatches(std::span<const char> a, std::span<const char> b);
+
+/// @brief Maps doubles to unsigned keys with the same order (negative values bit-inverted, others with the sign bit
+/// set), as used by radix sorts; dispatched to the active ISA.
+/// @throws std::runtime_error If the sizes differ.
+void ToSortableKeys(std::span<const double> values, std::span<uint64_t> keys);
+
+/// @brief Inverse of ToSortableKeys().
+/// @throws std::runtime_error If the sizes differ.
+void FromSortableKeys(std::span<const uint64_t> keys, std::span<double> values);
+
+}  // namespace ppc::simd
@@ -0,0 +1,328 @@
+#include "simd/include/simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "util/include/util.hpp"
+
+namespace ppc::simd {
+
+namespace {
+
+constexpr uint64_t kSignBit = uint64_t{1} << 63U;
+
+Isa DetectCpuIsa() {
+#if PPC_SIMD_X86
+  // libgcc/compiler-rt also check that the OS saves the AVX and AVX-512 registers
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl")) {
+    return Isa::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return Isa::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return Isa::kSse42;
+  }
+#endif
+  return Isa::kScalar;
+}
+
+template <typename T>
+MinMaxResult<T> MinMaxScalar(std::span<const T> values) {
+  MinMaxResult<T> result{.min = values.front(), .max = values.front()};
+  for (const T value : values) {
+    result.min = std::min(result.min, value);
+    result.max = std::max(result.max, value);
+  }
+  return result;
+}
+
+std::size_t CountMismatchesScalar(std::span<const char> a, std::span<const char> b) {
+  const std::size_t n = std::min(a.size(), b.size());
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    count += a[i] != b[i] ? 1 : 0;
+  }
+  return count;
+}
+
+uint64_t ToSortableKey(double value) {
+  const auto bits = std::bit_cast<uint64_t>(value);
+  return (bits & kSignBit) != 0 ? ~bits : bits | kSignBit;
+}
+
+double FromSortableKey(uint64_t key) {
+  return std::bit_cast<double>((key & kSignBit) != 0 ? key & ~kSignBit : ~key);
+}
+
+void ToSortableKeysScalar(std::span<const double> values, std::span<uint64_t> keys) {
+  std::ranges::transform(values, keys.begin(), ToSortableKey);
+}
+
+void FromSortableKeysScalar(std::span<const uint64_t> keys, std::span<double> values) {
+  std::ranges::transform(keys, values.begin(), FromSortableKey);
+}
+
+#if PPC_SIMD_X86
+template <std::size_t Bytes, typename T>
+PPC_SIMD_INLINE MinMaxResult<T> MinMaxVector(std::span<const T> values) {
+  using V = Vec<T, Bytes>;
+  constexpr std::size_t kStep = kLanes<V>;
+  if (values.size() < kStep) {
+    return MinMaxScalar(values);
+  }
+  V low;
+  Load(low, values.data());
+  V high = low;
+  std::size_t i = kStep;
+  for (; i + kStep <= values.size(); i += kStep) {
+    V v;
+    Load(v, values.data() + i);
+    low = v < low ? v : low;
+    high = high < v ? v : high;
+  }
+  MinMaxResult<T> result{.min = ReduceMin(low), .max = ReduceMax(high)};
+  for (; i < values.size(); i++) {
+    result.min = std::min(result.min, values[i]);
+    result.max = std::max(result.max, values[i]);
+  }
+  return result;
+}
+
+template <std::size_t Bytes>
+PPC_SIMD_INLINE std::size_t CountMismatchesVector(std::span<const char> a, std::span<const char> b) {
+  using V = Vec<int8_t, Bytes>;
+  constexpr std::size_t kStep = kLanes<V>;
+  // Lane counters grow by one per block at most and are summed up before they could overflow
+  constexpr std::size_t kFlushBlocks = 127;
+  const std::size_t n = std::min(a.size(), b.size());
+  std::size_t count = 0;
+  std::size_t i = 0;
+  while (i + kStep <= n) {
+    V counters{};
+    const std::size_t end = i + (std::min((n - i) / kStep, kFlushBlocks) * kStep);
+    for (; i < end; i += kStep) {
+      V x;
+      V y;
+      Load(x, a.data() + i);
+      Load(y, b.data() + i);
+      counters -= (x != y);
+    }
+    count += ReduceAdd<std::size_t>(counters);
+  }
+  return count + CountMismatchesScalar(a.subspan(i, n - i), b.subspan(i, n - i));
+}
+
+template <std::size_t Bytes>
+PPC_SIMD_INLINE void ToSortableKeysVector(std::span<const double> values, std::span<uint64_t> keys) {
+  using V = Vec<uint64_t, Bytes>;
+  constexpr std::size_t kStep = kLanes<V>;
+  std::size_t i = 0;
+  for (; i + kStep <= values.size(); i += kStep) {
+    V bits;
+    Load(bits, values.data() + i);
+    // All ones for negative values, the sign bit only for the others
+    const V flip = (V{} - (bits >> 63U)) | kSignBit;
+    const V key = bits ^ flip;
+    Store(keys.data() + i, key);
+  }
+  ToSortableKeysScalar(values.subspan(i), keys.subspan(i));
+}
+
+template <std::size_t Bytes>
+PPC_SIMD_INLINE void FromSortableKeysVector(std::span<const uint64_t> keys, std::span<double> values) {
+  using V = Vec<uint64_t, Bytes>;
+  constexpr std::size_t kStep = kLanes<V>;
+  std::size_t i = 0;
+  for (; i + kStep <= keys.size(); i += kStep) {
+    V key;
+    Load(key, keys.data() + i);
+    // The sign bit only for keys of non-negative values, all ones for the others
+    const V flip = ((key >> 63U) - 1U) | kSignBit;
+    const V bits = key ^ flip;
+    Store(values.data() + i, bits);
+  }
+  FromSortableKeysScalar(keys.subspan(i), values.subspan(i));
+}
+
+template <typename T>
+PPC_SIMD_TARGET_SSE42 MinMaxResult<T> MinMaxSse42(std::span<const T> values) {
+  return MinMaxVector<kSse42Bytes>(values);
+}
+
+template <typename T>
+PPC_SIMD_TARGET_AVX2 MinMaxResult<T> MinMaxAvx2(std::span<const T> values) {
+  return MinMaxVector<kAvx2Bytes>(values);
+}
+
+template <typename T>
+PPC_SIMD_TARGET_AVX512 MinMaxResult<T> MinMaxAvx512(std::span<const T> values) {
+  return MinMaxVector<kAvx512Bytes>(values);
+}
+
+PPC_SIMD_TARGET_SSE42 std::size_t CountMismatchesSse42(std::span<const char> a, std::span<const char> b) {
+  return CountMismatchesVector<kSse42Bytes>(a, b);
+}
+
+PPC_SIMD_TARGET_AVX2 std::size_t CountMismatchesAvx2(std::span<const char> a, std::span<const char> b) {
+  return CountMismatchesVector<kAvx2Bytes>(a, b);
+}
+
+PPC_SIMD_TARGET_AVX512 std::size_t CountMismatchesAvx512(std::span<const char> a, std::span<const char> b) {
+  return CountMismatchesVector<kAvx512Bytes>(a, b);
+}
+
+PPC_SIMD_TARGET_AVX2 void ToSortableKeysAvx2(std::span<const double> values, std::span<uint64_t> keys) {
+  ToSortableKeysVector<kAvx2Bytes>(values, keys);
+}
+
+PPC_SIMD_TARGET_AVX512 void ToSortableKeysAvx512(std::span<const double> values, std::span<uint64_t> keys) {
+  ToSortableKeysVector<kAvx512Bytes>(values, keys);
+}
+
+PPC_SIMD_TARGET_AVX2 void FromSortableKeysAvx2(std::span<const uint64_t> keys, std::span<double> values) {
+  FromSortableKeysVector<kAvx2Bytes>(keys, values);
+}
+
+PPC_SIMD_TARGET_AVX512 void FromSortableKeysAvx512(std::span<const uint64_t> keys, std::span<double> values) {
+  FromSortableKeysVector<kAvx512Bytes>(keys, values);
+}
+#endif
+
+template <typename T>
+constexpr Kernels<MinMaxResult<T>(std::span<const T>)> kMinMaxKernels{
+    .scalar = &MinMaxScalar<T>,
+#if PPC_SIMD_X86
+    .sse42 = &MinMaxSse42<T>,
+    .avx2 = &MinMaxAvx2<T>,
+    .avx512 = &MinMaxAvx512<T>,
+#endif
+};
+
+constexpr Kernels<std::size_t(std::span<const char>, std::span<const char>)> kCountMismatchesKernels{
+    .scalar = &CountMismatchesScalar,
+#if PPC_SIMD_X86
+    .sse42 = &CountMismatchesSse42,
+    .avx2 = &CountMismatchesAvx2,
+    .avx512 = &CountMismatchesAvx512,
+#endif
+};
+
+// Two 64-bit lanes per register gain little over the scalar loop, so SSE4.2 CPUs use that
+constexpr Kernels<void(std::span<const double>, std::span<uint64_t>)> kToSortableKeysKernels{
+    .scalar = &ToSortableKeysScalar,
+#if PPC_SIMD_X86
+    .avx2 = &ToSortableKeysAvx2,
+    .avx512 = &ToSortableKeysAvx512,
+#endif
+};
+
+constexpr Kernels<void(std::span<const uint64_t>, std::span<double>)> kFromSortableKeysKernels{
+    .scalar = &FromSortableKeysScalar,
+#if PPC_SIMD_X86
+    .avx2 = &FromSortableKeysAvx2,
+    .avx512 = &FromSortableKeysAvx512,
+#endif
+};
+
+template <typename T>
+MinMaxResult<T> DispatchMinMax(std::span<const T> values) {
+  if (values.empty()) {
+    throw std::runtime_error("MinMax of an empty range");
+  }
+  return Select(kMinMaxKernels<T>)(values);
+}
+
+}  // namespace
+
+std::string_view GetIsaName(Isa isa) {
+  switch (isa) {
+    case Isa::kScalar:
+      return "scalar";
+    case Isa::kSse42:
+      return "sse4.2";
+    case Isa::kAvx2:
+      return "avx2";
+    case Isa::kAvx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+Isa ParseIsa(std::string_view name) {
+  const auto *it = std::ranges::find(kIsas, name, GetIsaName);
+  if (it == kIsas.end()) {
+    throw std::runtime_error("Unknown SIMD ISA '" + std::string(name) + "' (expected scalar, sse4.2, avx2 or avx512)");
+  }
+  return *it;
+}
+
+Isa DetectIsa() {
+  static const Isa kDetected = DetectCpuIsa();
+  return kDetected;
+}
+
+namespace {
+
+/// ActiveIsa() as resolved from PPC_SIMD_ISA, or -1 until the first call and after ResetActiveIsa().
+std::atomic<int> &ResolvedActiveIsa() {
+  static std::atomic<int> resolved{-1};
+  return resolved;
+}
+
+}  // namespace
+
+Isa ActiveIsa() {
+  auto &resolved = ResolvedActiveIsa();
+  if (const int cached = resolved.load(std::memory_order_relaxed); cached >= 0) {
+    return static_cast<Isa>(cached);
+  }
+  const auto requested = ppc::util::GetSimdIsa();
+  const Isa isa = requested.empty() ? DetectIsa() : std::min(DetectIsa(), ParseIsa(requested));
+  resolved.store(static_cast<int>(isa), std::memory_order_relaxed);
+  return isa;
+}
+
+void ResetActiveIsa() {
+  ResolvedActiveIsa().store(-1, std::memory_order_relaxed);
+}
+
+MinMaxResult<uint8_t> MinMax(std::span<const uint8_t> values) {
+  return DispatchMinMax(values);
+}
+
+MinMaxResult<int32_t> MinMax(std::span<const int32_t> values) {
+  return DispatchMinMax(values);
+}
+
+MinMaxResult<double> MinMax(std::span<const double> values) {
+  return DispatchMinMax(values);
+}
+
+std::size_t CountMismatches(std::span<const char> a, std::span<const char> b) {
+  return Select(kCountMismatchesKernels)(a, b);
+}
+
+void ToSortableKeys(std::span<const double> values, std::span<uint64_t> keys) {
+  if (values.size() != keys.size()) {
+    throw std::runtime_error("ToSortableKeys needs as many keys as values");
+  }
+  Select(kToSortableKeysKernels)(values, keys);
+}
+
+void FromSortableKeys(std::span<const uint64_t> keys, std::span<double> values) {
+  if (values.size() != keys.size()) {
+    throw std::runtime_error("FromSortableKeys needs as many values as keys");
+  }
+  Select(kFromSortableKeysKernels)(keys, values);
+}
+
+}  // namespace ppc::simd
@@ -0,0 +1,180 @@
+#include "simd/include/simd.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <libenvpp/detail/environment.hpp>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Sets PPC_SIMD_ISA for the scope; ActiveIsa() follows it inside the scope and the previous value after it.
+class ScopedSimdIsa {
+ public:
+  explicit ScopedSimdIsa(const std::string &name) : scoped_("PPC_SIMD_ISA", name) {
+    ppc::simd::ResetActiveIsa();
+  }
+  ScopedSimdIsa(const ScopedSimdIsa &) = delete;
+  ScopedSimdIsa &operator=(const ScopedSimdIsa &) = delete;
+  ScopedSimdIsa(ScopedSimdIsa &&) = delete;
+  ScopedSimdIsa &operator=(ScopedSimdIsa &&) = delete;
+  ~ScopedSimdIsa() {
+    ppc::simd::ResetActiveIsa();
+  }
+
+ private:
+  env::detail::set_scoped_environment_variable scoped_;
+};
+
+/// Every ISA the CPU supports; each test runs the kernels once per entry through PPC_SIMD_ISA.
+std::vector<ppc::simd::Isa> SupportedIsas() {
+  std::vector<ppc::simd::Isa> isas;
+  for (const auto isa : ppc::simd::kIsas) {
+    if (isa <= ppc::simd::DetectIsa()) {
+      isas.push_back(isa);
+    }
+  }
+  return isas;
+}
+
+// Lengths around the vector widths, so full blocks and tails are both covered
+constexpr std::array<std::size_t, 14> kSizes = {1, 2, 7, 15, 16, 17, 31, 33, 63, 64, 65, 100, 1000, 4099};
+
+int Identity(int value) {
+  return value;
+}
+
+int Twice(int value) {
+  return 2 * value;
+}
+
+}  // namespace
+
+TEST(Simd, IsaNamesRoundTrip) {
+  for (const auto isa : ppc::simd::kIsas) {
+    EXPECT_EQ(ppc::simd::ParseIsa(ppc::simd::GetIsaName(isa)), isa);
+  }
+  EXPECT_THROW((void)ppc::simd::ParseIsa("avx1024"), std::runtime_error);
+}
+
+TEST(Simd, EnvironmentLowersButNeverRaisesActiveIsa) {
+  {
+    const ScopedSimdIsa scoped("scalar");
+    EXPECT_EQ(ppc::simd::ActiveIsa(), ppc::simd::Isa::kScalar);
+  }
+  {
+    const ScopedSimdIsa scoped("avx512");
+    EXPECT_EQ(ppc::simd::ActiveIsa(), ppc::simd::DetectIsa());
+  }
+  const ScopedSimdIsa scoped("mmx");
+  EXPECT_THROW((void)ppc::simd::ActiveIsa(), std::runtime_error);
+}
+
+TEST(Simd, SelectFallsBackToLessCapableVariants) {
+  const ppc::simd::Kernels<int(int)> kernels{.scalar = &Identity, .sse42 = nullptr, .avx2 = &Twice, .avx512 = nullptr};
+  EXPECT_EQ(ppc::simd::Select(kernels, ppc::simd::Isa::kScalar), &Identity);
+  EXPECT_EQ(ppc::simd::Select(kernels, ppc::simd::Isa::kSse42), &Identity);
+  EXPECT_EQ(ppc::simd::Select(kernels, ppc::simd::Isa::kAvx2), &Twice);
+  EXPECT_EQ(ppc::simd::Select(kernels, ppc::simd::Isa::kAvx512), &Twice);
+}
+
+TEST(Simd, MinMaxMatchesScalarReferenceOnEveryIsa) {
+  std::mt19937 gen(42);
+  for (const auto isa : SupportedIsas()) {
+    const ScopedSimdIsa scoped(std::string(ppc::simd::GetIsaName(isa)));
+    for (const std::size_t size : kSizes) {
+      SCOPED_TRACE(std::string(ppc::simd::GetIsaName(isa)) + " size " + std::to_string(size));
+      std::vector<uint8_t> bytes(size);
+      std::vector<int32_t> ints(size);
+      std::vector<double> doubles(size);
+      std::uniform_int_distribution<int> byte_dist(0, 255);
+      std::uniform_int_distribution<int32_t> int_dist(std::numeric_limits<int32_t>::min(),
+                                                      std::numeric_limits<int32_t>::max());
+      std::uniform_real_distribution<double> double_dist(-1e6, 1e6);
+      std::ranges::generate(bytes, [&] { return static_cast<uint8_t>(byte_dist(gen)); });
+      std::ranges::generate(ints, [&] { return int_dist(gen); });
+      std::ranges::generate(doubles, [&] { return double_dist(gen); });
+
+      const auto byte_result = ppc::simd::MinMax(std::span<const uint8_t>(bytes));
+      EXPECT_EQ(byte_result.min, std::ranges::min(bytes));
+      EXPECT_EQ(byte_result.max, std::ranges::max(bytes));
+      const auto int_result = ppc::simd::MinMax(std::span<const int32_t>(ints));
+      EXPECT_EQ(int_result.min, std::ranges::min(ints));
+      EXPECT_EQ(int_result.max, std::ranges::max(ints));
+      const auto double_result = ppc::simd::MinMax(std::span<const double>(doubles));
+      EXPECT_EQ(double_result.min, std::ranges::min(doubles));
+      EXPECT_EQ(double_result.max, std::ranges::max(doubles));
+    }
+  }
+  EXPECT_THROW((void)ppc::simd::MinMax(std::span<const int32_t>()), std::runtime_error);
+}
+
+TEST(Simd, CountMismatchesMatchesScalarReferenceOnEveryIsa) {
+  std::mt19937 gen(7);
+  std::vector<std::size_t> sizes(kSizes.begin(), kSizes.end());
+  // More blocks than the 8-bit lane counters hold before they are flushed
+  sizes.push_back(300 * 64 + 5);
+  for (const auto isa : SupportedIsas()) {
+    const ScopedSimdIsa scoped(std::string(ppc::simd::GetIsaName(isa)));
+    for (const std::size_t size : sizes) {
+      SCOPED_TRACE(std::string(ppc::simd::GetIsaName(isa)) + " size " + std::to_string(size));
+      std::uniform_int_distribution<int> dist('a', 'c');
+      std::string a(size, ' ');
+      std::ranges::generate(a, [&] { return static_cast<char>(dist(gen)); });
+      std::string b = a;
+      std::ranges::generate(b, [&] { return static_cast<char>(dist(gen)); });
+      std::size_t expected = 0;
+      for (std::size_t i = 0; i < size; i++) {
+        expected += a[i] != b[i] ? 1 : 0;
+      }
+      EXPECT_EQ(ppc::simd::CountMismatches(a, b), expected);
+      // Only the common prefix is compared
+      EXPECT_EQ(ppc::simd::CountMismatches(a, b + "xyz"), expected);
+      EXPECT_EQ(ppc::simd::CountMismatches(a, std::string(size, '\xff')), size);
+      EXPECT_EQ(ppc::simd::CountMismatches(a, a), 0U);
+    }
+  }
+}
+
+TEST(Simd, SortableKeysRoundTripAndKeepOrderOnEveryIsa) {
+  std::mt19937 gen(3);
+  for (const auto isa : SupportedIsas()) {
+    const ScopedSimdIsa scoped(std::string(ppc::simd::GetIsaName(isa)));
+    for (const std::size_t size : kSizes) {
+      SCOPED_TRACE(std::string(ppc::simd::GetIsaName(isa)) + " size " + std::to_string(size));
+      std::uniform_real_distribution<double> dist(-1e9, 1e9);
+      std::vector<double> values(size);
+      std::ranges::generate(values, [&] { return dist(gen); });
+      if (size > 0) {
+        values[0] = -0.0;
+      }
+      if (size > 2) {
+        values[1] = 0.0;
+        values[2] = -std::numeric_limits<double>::infinity();
+      }
+
+      std::vector<uint64_t> keys(size);
+      ppc::simd::ToSortableKeys(values, keys);
+      std::vector<double> restored(size);
+      ppc::simd::FromSortableKeys(keys, restored);
+      for (std::size_t i = 0; i < size; i++) {
+        EXPECT_EQ(std::bit_cast<uint64_t>(restored[i]), std::bit_cast<uint64_t>(values[i]));
+      }
+
+      std::ranges::sort(keys);
+      ppc::simd::FromSortableKeys(keys, restored);
+      EXPECT_TRUE(std::ranges::is_sorted(restored));
+    }
+  }
+  std::vector<uint64_t> keys(2);
+  EXPECT_THROW(ppc::simd::ToSortableKeys(std::vector<double>(3), keys), std::runtime_error);
+}
@@ -33,19 +33,22 @@ enum class TypeOfTask : uint8_t {
   kSTL,
   /// Intel Threading Building Blocks (TBB)
   kTBB,
+  /// C++17 parallel algorithms (std::execution policies)
+  kPSTL,
   /// Unknown task type
   kUnknown,
 };
 
 using TaskMapping = std::pair<TypeOfTask, std::string>;
-using TaskMappingArray = std::array<TaskMapping, 6>;
+using TaskMappingArray = std::array<TaskMapping, 7>;
 
 const TaskMappingArray kTaskTypeMappings = {{{TypeOfTask::kALL, "all"},
                                              {TypeOfTask::kMPI, "mpi"},
                                              {TypeOfTask::kOMP, "omp"},
                                              {TypeOfTask::kSEQ, "seq"},
                                              {TypeOfTask::kSTL, "stl"},
-                                             {TypeOfTask::kTBB, "tbb"}}};
+                                             {TypeOfTask::kTBB, "tbb"},
+                                             {TypeOfTask::kPSTL, "pstl"}}};
 
 inline std::string TypeOfTaskToString(TypeOfTask type) {
   for (const auto &[key, value] : kTaskTypeMappings) {
@@ -116,6 +119,7 @@ class Task {
       stage_ = PipelineStage::kException;
       throw std::runtime_error("Validation should be called before preprocessing");
     }
+    const ppc::util::ProfileStageScope profile_stage("validation");
     return ValidationImpl();
   }
 
@@ -131,6 +135,7 @@ class Task {
     if (state_of_testing_ == StateOfTesting::kFunc) {
       InternalTimeTest();
     }
+    const ppc::util::ProfileStageScope profile_stage("pre_processing");
     return PreProcessingImpl();
   }
 
@@ -143,6 +148,7 @@ class Task {
       stage_ = PipelineStage::kException;
       throw std::runtime_error("Run should be called after preprocessing");
     }
+    const ppc::util::ProfileStageScope profile_stage("run");
     return RunImpl();
   }
 
@@ -158,6 +164,7 @@ class Task {
     if (state_of_testing_ == StateOfTesting::kFunc) {
       InternalTimeTest();
     }
+    const ppc::util::ProfileStageScope profile_stage("post_processing");
     return PostProcessingImpl();
   }
 
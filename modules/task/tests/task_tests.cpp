@@ -197,7 +197,7 @@ TEST(TaskTest, GetStringTaskTypeEachTypeWithValidFile) {
   ScopedFile cleaner(path);
   std::ofstream file(path);
   file
-      << R"({"tasks": {"all": "enabled", "stl": "enabled", "omp": "enabled", "mpi": "enabled", "tbb": "enabled", "seq": "enabled"}})";
+      << R"({"tasks": {"all": "enabled", "stl": "enabled", "omp": "enabled", "mpi": "enabled", "tbb": "enabled", "seq": "enabled", "pstl": "enabled"}})";
   file.close();
 
   EXPECT_NO_THROW(GetStringTaskType(TypeOfTask::kALL, path));
@@ -206,6 +206,7 @@ TEST(TaskTest, GetStringTaskTypeEachTypeWithValidFile) {
   EXPECT_NO_THROW(GetStringTaskType(TypeOfTask::kMPI, path));
   EXPECT_NO_THROW(GetStringTaskType(TypeOfTask::kTBB, path));
   EXPECT_NO_THROW(GetStringTaskType(TypeOfTask::kSEQ, path));
+  EXPECT_NO_THROW(GetStringTaskType(TypeOfTask::kPSTL, path));
 }
 
 TEST(TaskTest, GetStringTaskTypeReturnsUnknownOnDefault) {
@@ -352,6 +353,40 @@ TEST(TaskTest, PostProcessingThrowsIfCalledBeforeRun) {
   EXPECT_THROW(task->PostProcessing(), std::runtime_error);
 }
 
+class StageRecordingTask : public ppc::task::Task<int, std::vector<std::string>> {
+ public:
+  bool ValidationImpl() override {
+    return Note();
+  }
+  bool PreProcessingImpl() override {
+    return Note();
+  }
+  bool RunImpl() override {
+    return Note();
+  }
+  bool PostProcessingImpl() override {
+    return Note();
+  }
+
+ private:
+  bool Note() {
+    GetOutput().emplace_back(ppc::util::CurrentProfileContext().stage);
+    return true;
+  }
+};
+
+TEST(TaskTest, PipelineStagesAreVisibleToProfilers) {
+  const ppc::util::ProfileTaskScope profile_task("stage_test");
+  auto task = std::make_shared<StageRecordingTask>();
+  task->Validation();
+  task->PreProcessing();
+  task->Run();
+  task->PostProcessing();
+  EXPECT_EQ(task->GetOutput(), (std::vector<std::string>{"validation", "pre_processing", "run", "post_processing"}));
+  EXPECT_EQ(ppc::util::CurrentProfileContext().task, "stage_test");
+  EXPECT_EQ(ppc::util::CurrentProfileContext().stage, "harness");
+}
+
 int main(int argc, char **argv) {
   return ppc::runners::SimpleInit(argc, argv);
 }
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "performance/include/performance.hpp"
+#include "task/include/task.hpp"
+#include "util/include/perf_test_util.hpp"
+
+namespace ppc::util {
+
+/// @brief One measurement requested from ppc_bench.
+struct BenchRequest {
+  /// @brief Problem size handed to the generator; 0 selects the task's default size.
+  std::size_t size = 0;
+  /// @brief Name of the input generator; empty selects the first registered one.
+  std::string generator;
+  /// @brief Seed of the generator; every process must use the same one so that they build the same input.
+  uint64_t seed = 1;
+  ppc::performance::PerfResults::TypeOfRunning mode = ppc::performance::PerfResults::TypeOfRunning::kTaskRun;
+  ppc::performance::PerfAttr perf_attr;
+  /// @brief Verify the output with the task's checker, if it registered one.
+  bool check = true;
+};
+
+/// @brief Outcome of one ppc_bench measurement.
+struct BenchResult {
+  ppc::performance::PerfResults results;
+  std::size_t size = 0;
+  std::string generator;
+  std::optional<std::size_t> input_size;
+  std::optional<std::size_t> input_bytes;
+  /// @brief Floating-point operations of the task on the input, if the task registered a counter.
+  std::optional<double> flops;
+  /// @brief Verdict of the output checker; empty if the output was not checked.
+  std::optional<bool> check_passed;
+};
+
+/// @brief One implementation of a task that ppc_bench can run, with its inputs type-erased.
+struct BenchCase {
+  /// @brief Task directory name, e.g. "example_threads".
+  std::string task;
+  /// @brief Technology of the implementation, e.g. "omp".
+  std::string implementation;
+  ppc::task::TypeOfTask type = ppc::task::TypeOfTask::kUnknown;
+  std::string settings_path;
+  std::size_t default_size = 1;
+  std::vector<std::string> generators;
+  /// @cond
+  std::function<BenchResult(const BenchRequest &)> run;
+  /// @endcond
+};
+
+/// @brief Every implementation registered through RegisterBenchTasks, in registration order.
+inline std::vector<BenchCase> &BenchRegistry() {
+  static std::vector<BenchCase> registry;
+  return registry;
+}
+
+/// @brief Builds an input of the requested size from a seed.
+template <typename InType>
+using BenchGenerator = std::function<InType(std::size_t size, uint64_t seed)>;
+
+/// @brief Inputs of a task for ppc_bench.
+/// @tparam InType Input data type.
+/// @tparam OutType Output data type.
+template <typename InType, typename OutType>
+struct BenchInputs {
+  /// @brief Size used when the request does not give one, usually the size of the perf test.
+  std::size_t default_size = 1;
+  /// @brief Named generators; the first one is the default.
+  std::vector<std::pair<std::string, BenchGenerator<InType>>> generators;
+  /// @brief Optional output checker.
+  /// @cond
+  std::function<bool(const InType &, const OutType &)> check = {};
+  /// @endcond
+  /// @brief Optional floating-point operation count of an input, which places the run on the roofline.
+  /// @cond
+  std::function<double(const InType &)> flops = {};
+  /// @endcond
+};
+
+/// @brief Runs one measurement of @p TaskType on a freshly generated input.
+/// @throws std::runtime_error If the requested generator is not registered.
+template <typename TaskType, typename InType, typename OutType>
+BenchResult RunBenchCase(const BenchInputs<InType, OutType> &inputs, const BenchRequest &request) {
+  BenchResult result;
+  result.size = request.size == 0 ? inputs.default_size : request.size;
+  const BenchGenerator<InType> *generator = nullptr;
+  std::string known;
+  for (const auto &[name, candidate] : inputs.generators) {
+    if (generator == nullptr && (request.generator.empty() || request.generator == name)) {
+      generator = &candidate;
+      result.generator = name;
+    }
+    known += (known.empty() ? "" : ", ") + name;
+  }
+  if (generator == nullptr) {
+    throw std::runtime_error("Unknown generator '" + request.generator + "' (expected one of: " + known + ")");
+  }
+
+  const InType input = (*generator)(result.size, request.seed);
+  result.input_size = InputSizeOf(input);
+  result.input_bytes = InputBytesOf(input);
+  if (inputs.flops) {
+    result.flops = inputs.flops(input);
+  }
+  auto task = ppc::task::TaskGetter<TaskType, InType>(input);
+  ppc::performance::Perf<InType, OutType> perf(task);
+  if (request.mode == ppc::performance::PerfResults::TypeOfRunning::kPipeline) {
+    perf.PipelineRun(request.perf_attr);
+  } else {
+    perf.TaskRun(request.perf_attr);
+  }
+  result.results = perf.GetPerfResults();
+  if (request.check && inputs.check) {
+    result.check_passed = inputs.check(input, task->GetOutput());
+  }
+  return result;
+}
+
+/// @brief Registers every implementation in @p TaskTypes with ppc_bench.
+/// @param task_id Task directory name (PPC_ID_<task>).
+/// @param settings_path Task settings file (PPC_SETTINGS_<task>); only read when the task is run.
+/// @return Always true, so that the registration can initialize a namespace-scope constant.
+template <typename... TaskTypes, typename InType, typename OutType>
+bool RegisterBenchTasks(const std::string &task_id, const std::string &settings_path,
+                        const BenchInputs<InType, OutType> &inputs) {
+  std::vector<std::string> generators;
+  for (const auto &generator : inputs.generators) {
+    generators.push_back(generator.first);
+  }
+  (BenchRegistry().push_back(BenchCase{
+       .task = task_id,
+       .implementation = ppc::task::TypeOfTaskToString(TaskTypes::GetStaticTypeOfTask()),
+       .type = TaskTypes::GetStaticTypeOfTask(),
+       .settings_path = settings_path,
+       .default_size = inputs.default_size,
+       .generators = generators,
+       .run = [inputs](const BenchRequest &request) { return RunBenchCase<TaskTypes>(inputs, request); }}),
+   ...);
+  return true;
+}
+
+}  // namespace ppc::util
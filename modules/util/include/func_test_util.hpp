@@ -14,6 +14,7 @@
 #include <utility>
 
 #include "task/include/task.hpp"
+#include "util/include/test_data_cache.hpp"
 #include "util/include/util.hpp"
 
 namespace ppc::util {
@@ -56,6 +57,13 @@ class BaseRunFuncTests : public ::testing::TestWithParam<FuncTestParam<InType, O
   }
 
  protected:
+  /// @brief Scopes the shared test data cache to the running suite before the fixture's SetUp builds inputs.
+  BaseRunFuncTests() {
+    if (const auto *suite = ::testing::UnitTest::GetInstance()->current_test_suite()) {
+      TestDataCache::Instance().EnterSuite(suite->name());
+    }
+  }
+
   void ExecuteTest(FuncTestParam<InType, OutType, TestType> test_param) {
     const std::string &test_name = std::get<static_cast<std::size_t>(GTestParamIndex::kNameTest)>(test_param);
 
@@ -72,6 +80,7 @@ class BaseRunFuncTests : public ::testing::TestWithParam<FuncTestParam<InType, O
       GTEST_SKIP();
     }
 
+    const ppc::util::ProfileTaskScope profile_task(test_name);
     InitializeAndRunTask(test_param);
   }
 
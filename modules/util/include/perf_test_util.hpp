@@ -3,29 +3,211 @@
 #include <gtest/gtest.h>
 #include <omp.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
 #include <csignal>
 #include <cstddef>
+#include <filesystem>
+#include <fstream>
 #include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "performance/include/baseline.hpp"
+#include "performance/include/calibration.hpp"
 #include "performance/include/performance.hpp"
+#include "performance/include/run_metadata.hpp"
 #include "task/include/task.hpp"
+#include "util/include/test_data_cache.hpp"
 #include "util/include/util.hpp"
+#include "util/include/workload.hpp"
 
 namespace ppc::util {
 
 double GetTimeMPI();
 int GetMPIRank();
+int GetMPISize();
+/// @brief Logical OR of @p value over all processes in MPI_COMM_WORLD.
+bool AnyRankTrue(bool value);
+/// @brief Blocks until every process in MPI_COMM_WORLD reaches it.
+void BarrierAllRanks();
+/// @brief Element-wise maximum of equally sized vectors over all processes in MPI_COMM_WORLD.
+std::vector<double> MaxOverRanks(const std::vector<double> &local);
+/// @brief Gathers equally sized vectors from all processes; rank 0 receives them concatenated by rank.
+std::vector<double> GatherToRoot(const std::vector<double> &local);
+/// @brief Sums one value per shared-memory node (that of the node's first process) over MPI_COMM_WORLD.
+/// @details NaN on any node's first process makes the result NaN.
+double SumOverNodes(double local);
+/// @brief Number of processes sharing this process's node; collective over MPI_COMM_WORLD.
+int GetNodeProcessCount();
+
+/// @brief Concurrent workers a task of @p type runs on one node: 1 for SEQ, the thread count of thread-parallel
+/// tasks, the node's processes for MPI and processes times threads for ALL. Collective over MPI_COMM_WORLD.
+inline int GetCalibrationWorkers(ppc::task::TypeOfTask type) {
+  const int node_processes = GetNodeProcessCount();
+  switch (type) {
+    case ppc::task::TypeOfTask::kSEQ:
+      return 1;
+    case ppc::task::TypeOfTask::kMPI:
+      return node_processes;
+    case ppc::task::TypeOfTask::kALL:
+      return node_processes * GetNumThreads();
+    case ppc::task::TypeOfTask::kOMP:
+    case ppc::task::TypeOfTask::kPSTL:
+    case ppc::task::TypeOfTask::kSTL:
+    case ppc::task::TypeOfTask::kTBB:
+    case ppc::task::TypeOfTask::kUnknown:
+      return GetNumThreads();
+  }
+  return GetNumThreads();
+}
+
+/// @brief Settings file of every perf task instantiated through MakePerfTaskTuples, keyed by test name.
+inline std::map<std::string, std::string> &PerfTaskSettingsRegistry() {
+  static std::map<std::string, std::string> registry;
+  return registry;
+}
+
+/// @brief Number of elements of a sized input (vectors, strings, ...); empty for other input types.
+template <typename T>
+std::optional<std::size_t> InputSizeOf(const T &input) {
+  if constexpr (requires { input.size(); }) {
+    return static_cast<std::size_t>(input.size());
+  } else {
+    return std::nullopt;
+  }
+}
+
+/// @brief Bytes held by arithmetic values, strings, ranges, pairs and tuples of those; empty for other types.
+template <typename T>
+std::optional<std::size_t> DataBytesOf(const T &value) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    return sizeof(T);
+  } else if constexpr (requires { typename T::value_type; value.size(); value.begin(); }) {
+    using Value = typename T::value_type;
+    if constexpr (std::is_arithmetic_v<Value>) {
+      return value.size() * sizeof(Value);
+    } else {
+      std::size_t total = 0;
+      for (const auto &item : value) {
+        const auto bytes = DataBytesOf(item);
+        if (!bytes.has_value()) {
+          return std::nullopt;
+        }
+        total += bytes.value();
+      }
+      return total;
+    }
+  } else if constexpr (requires { std::tuple_size<T>::value; }) {
+    return std::apply(
+        [](const auto &...items) {
+          const std::array<std::optional<std::size_t>, sizeof...(items)> parts{DataBytesOf(items)...};
+          std::optional<std::size_t> total = 0;
+          for (const auto &part : parts) {
+            if (!part.has_value()) {
+              return std::optional<std::size_t>{};
+            }
+            total.value() += part.value();
+          }
+          return total;
+        },
+        value);
+  } else {
+    return std::nullopt;
+  }
+}
+
+/// @brief Size of the data a perf input carries; a plain number is a problem size rather than data, so it has none.
+template <typename T>
+std::optional<std::size_t> InputBytesOf(const T &input) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    return std::nullopt;
+  } else {
+    return DataBytesOf(input);
+  }
+}
+
+/// @brief Input scale of the perf case being set up; starts at PPC_PERF_SCALE.
+inline double &ActivePerfScale() {
+  static double scale = GetPerfScale();
+  return scale;
+}
+
+/// @brief Scales a perf input dimension by the active perf scale (PPC_PERF_SCALE times the PPC_PERF_SCALES entry).
+/// @param dimensions Number of dimensions built from @p base_size, so that the element count grows by the scale.
+/// @return The scaled size, never less than 1.
+template <typename T>
+  requires std::is_integral_v<T>
+T ScalePerfInputSize(T base_size, int dimensions = 1) {
+  const double factor = std::pow(ActivePerfScale(), 1.0 / static_cast<double>(dimensions));
+  const double scaled = std::round(static_cast<double>(base_size) * factor);
+  return std::max(static_cast<T>(scaled), static_cast<T>(1));
+}
+
+/// @brief Input distribution of the perf case being set up; empty until its fixture asks for one.
+inline std::optional<workload::Distribution> &ActivePerfDistribution() {
+  static std::optional<workload::Distribution> distribution;
+  return distribution;
+}
+
+/// @brief Distribution perf inputs built with ppc::util::workload are drawn from (PPC_PERF_DISTRIBUTION).
+/// @details Marks the case as distribution-dependent: its test name, perf record and baseline then carry the
+/// distribution, so runs over different distributions are kept apart.
+/// @throws std::runtime_error On an unknown distribution name.
+inline workload::Distribution PerfInputDistribution() {
+  ActivePerfDistribution() = workload::ParseDistribution(GetPerfDistribution());
+  return ActivePerfDistribution().value();
+}
+
+/// @brief Applies the harness defaults for a task of type @p type: adaptive sampling, the profilers enabled through the
+/// environment, and the timer and cross-process synchronization that fit the task's technology.
+/// @throws std::runtime_error If the task type cannot be timed.
+inline void ConfigurePerfAttributes(ppc::performance::PerfAttr &perf_attrs, ppc::task::TypeOfTask type) {
+  perf_attrs.adaptive_running = true;
+  perf_attrs.hw_counters = IsPerfHwCountersEnabled();
+  perf_attrs.energy = IsPerfEnergyEnabled();
+  perf_attrs.threading = IsPerfThreadingEnabled();
+  if (!GetPerfBaselineDir().empty()) {
+    perf_attrs.min_running = std::max(perf_attrs.min_running, ppc::performance::kMinBaselineSamples);
+  }
+  if (type == ppc::task::TypeOfTask::kMPI || type == ppc::task::TypeOfTask::kALL) {
+    const double t0 = GetTimeMPI();
+    perf_attrs.current_timer = [t0] { return GetTimeMPI() - t0; };
+    perf_attrs.sync_continue = AnyRankTrue;
+    perf_attrs.sync_start = BarrierAllRanks;
+    perf_attrs.combine_samples = MaxOverRanks;
+    perf_attrs.combine_energy = SumOverNodes;
+  } else if (type == ppc::task::TypeOfTask::kOMP) {
+    const double t0 = omp_get_wtime();
+    perf_attrs.current_timer = [t0] { return omp_get_wtime() - t0; };
+  } else if (type == ppc::task::TypeOfTask::kSEQ || type == ppc::task::TypeOfTask::kSTL ||
+             type == ppc::task::TypeOfTask::kPSTL || type == ppc::task::TypeOfTask::kTBB) {
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    perf_attrs.current_timer = [t0] {
+      auto now = std::chrono::high_resolution_clock::now();
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0).count();
+      return static_cast<double>(ns) * 1e-9;
+    };
+  } else {
+    throw std::runtime_error("The task type is not supported for performance testing.");
+  }
+}
 
 template <typename InType, typename OutType>
 using PerfTestParam = std::tuple<std::function<ppc::task::TaskPtr<InType, OutType>(InType)>, std::string,
-                                 ppc::performance::PerfResults::TypeOfRunning>;
+                                 ppc::performance::PerfResults::TypeOfRunning, double>;
 
 template <typename InType, typename OutType>
 /// @brief Base class for performance testing of parallel tasks.
@@ -37,40 +219,39 @@ class BaseRunPerfTests : public ::testing::TestWithParam<PerfTestParam<InType, O
   static std::string CustomPerfTestName(const ::testing::TestParamInfo<PerfTestParam<InType, OutType>> &info) {
     return ppc::performance::GetStringParamName(
                std::get<static_cast<std::size_t>(GTestParamIndex::kTestParams)>(info.param)) +
-           "_" + std::get<static_cast<std::size_t>(GTestParamIndex::kNameTest)>(info.param);
+           "_" + ScaledTestName(info.param);
   }
 
  protected:
+  /// @brief Makes the case's input scale visible to ScalePerfInputSize before the fixture's SetUp builds inputs,
+  /// forgets the distribution of the previous case, and scopes the shared test data cache to the running suite.
+  BaseRunPerfTests() {
+    ActivePerfScale() = std::get<static_cast<std::size_t>(GTestParamIndex::kPerfScale)>(this->GetParam());
+    ActivePerfDistribution().reset();
+    if (const auto *suite = ::testing::UnitTest::GetInstance()->current_test_suite()) {
+      TestDataCache::Instance().EnterSuite(suite->name());
+    }
+  }
+
   virtual bool CheckTestOutputData(OutType &output_data) = 0;
   /// @brief Supplies input data for performance testing.
   virtual InType GetTestInputData() = 0;
+  /// @brief Floating-point operations the task performs on @p input; places the run on the roofline when known.
+  virtual std::optional<double> GetFlopCount(const InType & /*input*/) {
+    return std::nullopt;
+  }
 
   virtual void SetPerfAttributes(ppc::performance::PerfAttr &perf_attrs) {
-    if (task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kMPI ||
-        task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kALL) {
-      const double t0 = GetTimeMPI();
-      perf_attrs.current_timer = [t0] { return GetTimeMPI() - t0; };
-    } else if (task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kOMP) {
-      const double t0 = omp_get_wtime();
-      perf_attrs.current_timer = [t0] { return omp_get_wtime() - t0; };
-    } else if (task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kSEQ ||
-               task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kSTL ||
-               task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kTBB) {
-      const auto t0 = std::chrono::high_resolution_clock::now();
-      perf_attrs.current_timer = [&] {
-        auto now = std::chrono::high_resolution_clock::now();
-        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0).count();
-        return static_cast<double>(ns) * 1e-9;
-      };
-    } else {
-      throw std::runtime_error("The task type is not supported for performance testing.");
-    }
+    ConfigurePerfAttributes(perf_attrs, task_->GetDynamicTypeOfTask());
   }
 
   void ExecuteTest(const PerfTestParam<InType, OutType> &perf_test_param) {
     auto task_getter = std::get<static_cast<std::size_t>(GTestParamIndex::kTaskGetter)>(perf_test_param);
-    auto test_name = std::get<static_cast<std::size_t>(GTestParamIndex::kNameTest)>(perf_test_param);
+    auto base_name = std::get<static_cast<std::size_t>(GTestParamIndex::kNameTest)>(perf_test_param);
     auto mode = std::get<static_cast<std::size_t>(GTestParamIndex::kTestParams)>(perf_test_param);
+    scale_ = std::get<static_cast<std::size_t>(GTestParamIndex::kPerfScale)>(perf_test_param);
+    distribution_ = ActivePerfDistribution();
+    const auto test_name = ScaledTestName(perf_test_param) + DistributionTag(distribution_);
 
     ASSERT_FALSE(test_name.find("unknown") != std::string::npos);
     if (test_name.find("disabled") != std::string::npos) {
@@ -78,12 +259,107 @@ class BaseRunPerfTests : public ::testing::TestWithParam<PerfTestParam<InType, O
     }
 
     const auto test_env_scope = ppc::util::test::MakePerTestEnvForCurrentGTest(test_name);
+    const ProfileTaskScope profile_task(test_name + ":" + ppc::performance::GetStringParamName(mode));
 
-    task_ = task_getter(GetTestInputData());
+    const InType input_data = GetTestInputData();
+    input_size_ = InputSizeOf(input_data);
+    input_bytes_ = InputBytesOf(input_data);
+    flop_count_ = GetFlopCount(input_data);
+    task_ = task_getter(input_data);
     ppc::performance::Perf perf(task_);
     ppc::performance::PerfAttr perf_attr;
     SetPerfAttributes(perf_attr);
+    const auto cache_mode = GetPerfCacheMode();
+    if (cache_mode != "warm" && cache_mode != "cold" && cache_mode != "both") {
+      throw std::runtime_error("Unknown PPC_PERF_CACHE mode '" + cache_mode + "' (expected warm, cold or both)");
+    }
+    perf_attr.cache_state =
+        cache_mode == "cold" ? ppc::performance::CacheState::kCold : ppc::performance::CacheState::kWarm;
+    RunPerfMode(perf, mode, perf_attr);
 
+    // The warm run stays the primary result; the cold one is reported next to it
+    std::optional<ppc::performance::PerfResults> cold_results;
+    if (cache_mode == "both") {
+      ppc::performance::Perf cold_perf(task_);
+      auto cold_attr = perf_attr;
+      cold_attr.cache_state = ppc::performance::CacheState::kCold;
+      RunPerfMode(cold_perf, mode, cold_attr);
+      cold_results = cold_perf.GetPerfResults();
+    }
+
+    if (perf_attr.hw_counters && IsMultiProcessTask()) {
+      PrintPerRankHwCounters(test_name, perf.GetPerfResults());
+    }
+    std::vector<double> rank_times;
+    if (IsMultiProcessTask()) {
+      rank_times = GatherToRoot({ppc::performance::ComputeStatistics(perf.GetPerfResults().local_samples).median});
+    }
+    // Measured (or loaded) after the timed runs, so calibrating a new host never disturbs them
+    const ppc::performance::MachineCalibration *calibration = nullptr;
+    if (const auto calibration_dir = GetCalibrationDir(); !calibration_dir.empty()) {
+      calibration = &ppc::performance::GetMachineCalibration(
+          calibration_dir, GetCalibrationWorkers(task_->GetDynamicTypeOfTask()));
+    }
+
+    // Only a correct run within the time limit may refresh a baseline or produce a record
+    OutType output_data = task_->GetOutput();
+    ASSERT_TRUE(CheckTestOutputData(output_data));
+
+    if (GetMPIRank() == 0) {
+      perf.PrintPerfStatistic(test_name);
+      auto record = MakePerfRecord(test_name, base_name, perf.GetPerfResults());
+      if (!rank_times.empty()) {
+        AddRankBreakdown(test_name, rank_times, record);
+      }
+      if (cold_results.has_value()) {
+        AddColdComparison(test_name, cold_results.value(), record);
+      }
+      if (calibration != nullptr) {
+        AddRoofline(test_name, *calibration, record);
+      }
+      const auto regression = ApplyPerfBaseline(test_name, record);
+      EmitPerfRecord(record);
+      PrintThroughput(test_name, record);
+      ReportComplexity(base_name, record);
+      if (regression.has_value() && GetPerfBaselineMode() == "compare") {
+        EXPECT_FALSE(regression->regressed) << "Performance regression against the baseline of " << test_name;
+      }
+    }
+  }
+
+ private:
+  ppc::task::TaskPtr<InType, OutType> task_;
+  double scale_ = 1.0;
+  std::optional<workload::Distribution> distribution_;
+  std::optional<std::size_t> input_size_;
+  std::optional<std::size_t> input_bytes_;
+  std::optional<double> flop_count_;
+
+  /// @brief Test name with the scale tag of the case appended (unchanged at scale 1).
+  static std::string ScaledTestName(const PerfTestParam<InType, OutType> &param) {
+    const auto &name = std::get<static_cast<std::size_t>(GTestParamIndex::kNameTest)>(param);
+    const auto tag =
+        ppc::performance::GetScaleTag(std::get<static_cast<std::size_t>(GTestParamIndex::kPerfScale)>(param));
+    return tag.empty() ? name : name + "_" + tag;
+  }
+
+  /// @brief Suffix of the test name for inputs drawn from a non-uniform distribution, e.g. "_zipf".
+  static std::string DistributionTag(const std::optional<workload::Distribution> &distribution) {
+    if (!distribution.has_value() || distribution.value() == workload::Distribution::kUniform) {
+      return {};
+    }
+    return "_" + std::string(workload::GetDistributionName(distribution.value()));
+  }
+
+  /// @brief (size, median time) of the cases of one test, keyed by test name and mode, then by scale.
+  static std::map<std::string, std::map<double, std::pair<double, double>>> &ComplexityPoints() {
+    static std::map<std::string, std::map<double, std::pair<double, double>>> points;
+    return points;
+  }
+
+  static void RunPerfMode(ppc::performance::Perf<InType, OutType> &perf,
+                          ppc::performance::PerfResults::TypeOfRunning mode,
+                          const ppc::performance::PerfAttr &perf_attr) {
     if (mode == ppc::performance::PerfResults::TypeOfRunning::kPipeline) {
       perf.PipelineRun(perf_attr);
     } else if (mode == ppc::performance::PerfResults::TypeOfRunning::kTaskRun) {
@@ -93,39 +369,297 @@ class BaseRunPerfTests : public ::testing::TestWithParam<PerfTestParam<InType, O
       err_msg << '\n' << "The type of performance check for the task was not selected.\n";
       throw std::runtime_error(err_msg.str().c_str());
     }
+  }
 
-    if (GetMPIRank() == 0) {
-      perf.PrintPerfStatistic(test_name);
+  /// @brief Records the cold-cache samples under "cold" and prints them with the cold/warm median ratio.
+  static void AddColdComparison(const std::string &test_name, const ppc::performance::PerfResults &cold,
+                                nlohmann::json &record) {
+    const auto cold_json = ppc::performance::PerfResultsToJson(cold);
+    const double warm_median = record["stats"]["median"].get<double>();
+    const double cold_to_warm = warm_median > 0.0 ? cold.stats.median / warm_median : 0.0;
+    record["cold"] = {{"samples", cold_json["samples"]},
+                      {"stats", cold_json["stats"]},
+                      {"median_rel_ci", cold_json["median_rel_ci"]},
+                      {"cold_to_warm", cold_to_warm}};
+    if (!record["input_bytes"].is_null() && cold.stats.median > 0.0) {
+      record["cold"]["bytes_per_sec"] = record["input_bytes"].get<double>() / cold.stats.median;
     }
+    std::cout << test_name << ":" << record["mode"].get<std::string>() << ":cold:n=" << cold.samples.size()
+              << " min=" << cold.stats.min << " median=" << cold.stats.median << " p90=" << cold.stats.p90
+              << " cold_to_warm=" << cold_to_warm << '\n';
+  }
 
-    OutType output_data = task_->GetOutput();
-    ASSERT_TRUE(CheckTestOutputData(output_data));
+  /// @brief Reports the spread of per-rank median times (barrier-aligned) and records it under "ranks".
+  static void AddRankBreakdown(const std::string &test_name, const std::vector<double> &rank_times,
+                               nlohmann::json &record) {
+    const auto breakdown = ppc::performance::ComputeRankBreakdown(rank_times);
+    record["ranks"] = {{"times", rank_times},
+                       {"max", breakdown.max},
+                       {"min", breakdown.min},
+                       {"mean", breakdown.mean},
+                       {"imbalance", breakdown.imbalance},
+                       {"slowest_rank", breakdown.slowest_rank}};
+    std::cout << test_name << ":" << record["mode"].get<std::string>() << ":ranks:max=" << breakdown.max
+              << " min=" << breakdown.min << " mean=" << breakdown.mean << " imbalance=" << breakdown.imbalance
+              << " slowest_rank=" << breakdown.slowest_rank << " times=";
+    for (std::size_t rank = 0; rank < rank_times.size(); rank++) {
+      std::cout << (rank == 0 ? "" : ",") << rank_times[rank];
+    }
+    std::cout << '\n';
   }
 
- private:
-  ppc::task::TaskPtr<InType, OutType> task_;
+  /// @brief Records the run's position against the calibrated STREAM bandwidth and FLOP peak under "roofline".
+  void AddRoofline(const std::string &test_name, const ppc::performance::MachineCalibration &calibration,
+                   nlohmann::json &record) const {
+    if (record["input_bytes"].is_null()) {
+      return;
+    }
+    const auto point = ppc::performance::ComputeRoofline(record["input_bytes"].get<double>(), flop_count_,
+                                                         record["stats"]["median"].get<double>(), calibration);
+    record["roofline"] = ppc::performance::RooflineToJson(point, calibration);
+    std::cout << test_name << ":" << record["mode"].get<std::string>()
+              << ":roofline:" << ppc::performance::FormatRoofline(point) << '\n';
+  }
+
+  /// @brief Prints the bytes per second achieved on the input, when its size in bytes is known.
+  static void PrintThroughput(const std::string &test_name, const nlohmann::json &record) {
+    if (record["bytes_per_sec"].is_null()) {
+      return;
+    }
+    std::cout << test_name << ":" << record["mode"].get<std::string>()
+              << ":throughput:bytes=" << record["input_bytes"].get<std::size_t>()
+              << " bytes_per_sec=" << record["bytes_per_sec"].get<double>() << '\n';
+  }
+
+  /// @brief Collects one point per scale and, once every configured scale has one, prints the fitted complexity
+  /// exponent.
+  /// @details Size is measured in input bytes, else in elements, else by the scale factor itself. Cases may run in
+  /// any order (--gtest_shuffle); a scale left out by a filter leaves the fit unreported.
+  static void ReportComplexity(const std::string &base_name, const nlohmann::json &record) {
+    const auto configured = GetPerfScales();
+    const std::set<double> scales(configured.begin(), configured.end());
+    if (scales.size() < 2) {
+      return;
+    }
+    const auto mode = record["mode"].get<std::string>();
+    const auto scale = record["scale"].get<double>();
+    std::string basis = "scale";
+    double size = scale;
+    if (!record["input_bytes"].is_null()) {
+      basis = "bytes";
+      size = record["input_bytes"].get<double>();
+    } else if (!record["input_size"].is_null()) {
+      basis = "elements";
+      size = record["input_size"].get<double>();
+    }
+    auto &by_scale = ComplexityPoints()[base_name + ":" + mode];
+    by_scale[scale] = {size, record["stats"]["median"].get<double>()};
+    if (by_scale.size() < scales.size()) {
+      return;
+    }
+    std::vector<std::pair<double, double>> points;
+    points.reserve(by_scale.size());
+    for (const auto &[case_scale, point] : by_scale) {
+      points.push_back(point);
+    }
+    by_scale.clear();
+    const auto fit = ppc::performance::FitPowerLaw(points);
+    std::cout << base_name << ":" << mode << ":complexity:exponent=" << fit.exponent << " r2=" << fit.r2
+              << " points=" << points.size() << " size=" << basis << '\n';
+  }
+
+  /// @brief Builds a self-describing perf record: task identity, parallel configuration, samples and run metadata.
+  [[nodiscard]] nlohmann::json MakePerfRecord(const std::string &test_name, const std::string &base_name,
+                                              const ppc::performance::PerfResults &results) const {
+    auto record = ppc::performance::PerfResultsToJson(results);
+    const auto implementation = ppc::task::TypeOfTaskToString(task_->GetDynamicTypeOfTask());
+    const auto impl_pos = test_name.rfind("_" + implementation + "_");
+    record["schema"] = "ppc.perf.v1";
+    record["test_id"] = test_name;
+    record["task"] = test_name.substr(0, impl_pos);
+    record["implementation"] = implementation;
+    record["status"] = test_name.ends_with("disabled") ? "disabled" : "enabled";
+    record["threads"] = GetNumThreads();
+    record["processes"] = IsMultiProcessTask() ? GetMPISize() : 1;
+    record["scale"] = scale_;
+    record["distribution"] = distribution_.has_value()
+                                 ? nlohmann::json(std::string(workload::GetDistributionName(distribution_.value())))
+                                 : nlohmann::json(nullptr);
+    record["input_size"] = input_size_.has_value() ? nlohmann::json(input_size_.value()) : nlohmann::json(nullptr);
+    record["input_bytes"] = input_bytes_.has_value() ? nlohmann::json(input_bytes_.value()) : nlohmann::json(nullptr);
+    record["bytes_per_sec"] = input_bytes_.has_value() && results.stats.median > 0.0
+                                  ? nlohmann::json(static_cast<double>(input_bytes_.value()) / results.stats.median)
+                                  : nlohmann::json(nullptr);
+    record["max_time_sec"] = GetPerfMaxTime();
+
+    if (auto it = PerfTaskSettingsRegistry().find(base_name); it != PerfTaskSettingsRegistry().end()) {
+      const std::filesystem::path settings_path(it->second);
+      record["task_dir"] = settings_path.parent_path().filename().string();
+      std::ifstream settings_file(settings_path);
+      const auto settings = nlohmann::json::parse(settings_file, nullptr, false);
+      if (!settings.is_discarded() && settings.contains("tasks_type")) {
+        record["tasks_type"] = settings["tasks_type"];
+      }
+    }
+
+    const auto &metadata = ppc::performance::GetRunMetadata();
+    record["host"] = {{"hostname", metadata.hostname}, {"cpu_model", metadata.cpu_model}};
+    record["build"] = {{"compiler", metadata.compiler},
+                       {"flags", metadata.compile_flags},
+                       {"build_type", metadata.build_type},
+                       {"git_sha", metadata.git_sha}};
+    record["timestamp"] =
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return record;
+  }
+
+  /// @brief Compares the run with its stored baseline or refreshes it, as selected by PPC_PERF_BASELINE.
+  /// @details The comparison verdict is added to @p record; nothing happens unless PPC_PERF_BASELINE_DIR is set.
+  static std::optional<ppc::performance::RegressionCheck> ApplyPerfBaseline(const std::string &test_name,
+                                                                           nlohmann::json &record) {
+    const auto dir = GetPerfBaselineDir();
+    const auto mode = GetPerfBaselineMode();
+    if (dir.empty() || mode == "off") {
+      return std::nullopt;
+    }
+    const ppc::performance::BaselineKey key{.task = record["task"].get<std::string>(),
+                                            .implementation = record["implementation"].get<std::string>(),
+                                            .mode = record["mode"].get<std::string>(),
+                                            .threads = record["threads"].get<int>(),
+                                            .processes = record["processes"].get<int>(),
+                                            .scale = record["scale"].get<double>(),
+                                            .cache = record["cache"].get<std::string>(),
+                                            .distribution = record["distribution"].is_string()
+                                                                ? record["distribution"].get<std::string>()
+                                                                : std::string()};
+    const auto path = ppc::performance::GetBaselinePath(dir, key);
+    const auto prefix = test_name + ":" + key.mode + ":baseline:";
+
+    if (mode == "update") {
+      ppc::performance::SaveBaseline(path, record);
+      std::cout << prefix << "updated " << path.string() << '\n';
+      return std::nullopt;
+    }
+    if (mode != "compare" && mode != "report") {
+      throw std::runtime_error("Unknown PPC_PERF_BASELINE mode '" + mode +
+                               "' (expected compare, report, update or off)");
+    }
+
+    const auto baseline = ppc::performance::LoadBaselineSamples(path);
+    if (!baseline.has_value()) {
+      std::cout << prefix << "missing " << path.string() << '\n';
+      return std::nullopt;
+    }
+    const auto check = ppc::performance::CheckRegression(record["samples"].get<std::vector<double>>(),
+                                                         baseline.value(), GetPerfRegressionThreshold());
+    record["regression"] = {{"baseline_median", check.baseline_median},
+                            {"median", check.current_median},
+                            {"slowdown", check.slowdown},
+                            {"p_value", check.p_value},
+                            {"regressed", check.regressed}};
+    std::cout << prefix << "baseline_median=" << check.baseline_median << " median=" << check.current_median
+              << " slowdown=" << std::showpos << std::fixed << std::setprecision(2) << (check.slowdown * 100.0)
+              << "%" << std::noshowpos << std::defaultfloat << std::setprecision(6) << " p=" << check.p_value << " "
+              << (check.regressed ? "REGRESSION" : "ok") << '\n';
+    return check;
+  }
+
+  /// @brief Prints the record as one JSON line and appends it to PPC_PERF_JSON if set.
+  static void EmitPerfRecord(const nlohmann::json &record) {
+    const auto line = record.dump();
+    std::cout << line << '\n';
+    if (const auto path = GetPerfJsonPath(); !path.empty()) {
+      std::ofstream(path, std::ios::app) << line << '\n';
+    }
+  }
+
+  [[nodiscard]] bool IsMultiProcessTask() const {
+    return task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kMPI ||
+           task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kALL;
+  }
+
+  /// @brief Collects every rank's hardware counter means on rank 0 and prints one line per rank.
+  static void PrintPerRankHwCounters(const std::string &test_name, const ppc::performance::PerfResults &results) {
+    using ppc::performance::HwCounterStats;
+    using ppc::performance::kHwCounterCount;
+    const auto &hw = results.hw_stats;
+    // Availability, the counter means, then the thread count
+    std::vector<double> local(kHwCounterCount + 2);
+    local[0] = hw.available ? 1.0 : 0.0;
+    for (std::size_t i = 0; i < kHwCounterCount; i++) {
+      local[i + 1] = hw.mean.valid[i] ? hw.mean.values[i] : -1.0;
+    }
+    local[kHwCounterCount + 1] = static_cast<double>(hw.threads);
+    const auto gathered = GatherToRoot(local);
+    const auto type_name = ppc::performance::GetStringParamName(results.type_of_running);
+    for (std::size_t rank = 0; rank * local.size() < gathered.size(); rank++) {
+      const auto *row = &gathered[rank * local.size()];
+      if (row[0] == 0.0) {
+        std::cout << test_name << ":" << type_name << ":hw:rank=" << rank << " unavailable\n";
+        continue;
+      }
+      std::vector<ppc::performance::HwCounterValues> rank_sample(1);
+      for (std::size_t i = 0; i < kHwCounterCount; i++) {
+        rank_sample[0].valid[i] = row[i + 1] >= 0.0;
+        rank_sample[0].values[i] = rank_sample[0].valid[i] ? row[i + 1] : 0.0;
+      }
+      rank_sample[0].threads = static_cast<std::size_t>(row[kHwCounterCount + 1]);
+      const HwCounterStats rank_stats = ppc::performance::ComputeHwCounterStats(rank_sample);
+      std::cout << test_name << ":" << type_name << ":hw:rank=" << rank << " "
+                << ppc::performance::FormatHwCounterStats(rank_stats) << '\n';
+    }
+  }
 };
 
+/// @brief Maps a task type to the perf test parameter of its Task<InType, OutType> base (used in decltype only).
+template <typename InType, typename OutType>
+PerfTestParam<InType, OutType> PerfTestParamOf(const ppc::task::Task<InType, OutType> *task);
+
 template <typename TaskType, typename InputType>
 auto MakePerfTaskTuples(const std::string &settings_path) {
   const auto name = std::string(GetNamespace<TaskType>()) + "_" +
                     ppc::task::GetStringTaskType(TaskType::GetStaticTypeOfTask(), settings_path);
+  PerfTaskSettingsRegistry()[name] = settings_path;
 
-  return std::make_tuple(std::make_tuple(ppc::task::TaskGetter<TaskType, InputType>, name,
-                                         ppc::performance::PerfResults::TypeOfRunning::kPipeline),
-                         std::make_tuple(ppc::task::TaskGetter<TaskType, InputType>, name,
-                                         ppc::performance::PerfResults::TypeOfRunning::kTaskRun));
+  using Param = decltype(PerfTestParamOf(static_cast<const TaskType *>(nullptr)));
+  return std::make_tuple(
+      Param{ppc::task::TaskGetter<TaskType, InputType>, name, ppc::performance::PerfResults::TypeOfRunning::kPipeline,
+            1.0},
+      Param{ppc::task::TaskGetter<TaskType, InputType>, name, ppc::performance::PerfResults::TypeOfRunning::kTaskRun,
+            1.0});
 }
 
+/// @brief Expands every perf case into one case per entry of @p scales, each scaled by PPC_PERF_SCALE.
 template <typename Tuple, std::size_t... I>
-auto TupleToGTestValuesImpl(const Tuple &tup, std::index_sequence<I...> /*unused*/) {
-  return ::testing::Values(std::get<I>(tup)...);
+auto TupleToGTestValuesImpl(const Tuple &tup, const std::vector<double> &scales,
+                            std::index_sequence<I...> /*unused*/) {
+  using Param = std::tuple_element_t<0, Tuple>;
+  const std::array<Param, sizeof...(I)> cases{std::get<I>(tup)...};
+  std::vector<Param> params;
+  params.reserve(cases.size() * scales.size());
+  for (const auto &perf_case : cases) {
+    for (double scale : scales) {
+      auto param = perf_case;
+      std::get<static_cast<std::size_t>(GTestParamIndex::kPerfScale)>(param) = GetPerfScale() * scale;
+      params.push_back(std::move(param));
+    }
+  }
+  return ::testing::ValuesIn(params);
 }
 
+/// @brief One case per perf case, at PPC_PERF_SCALE, for suites whose inputs do not depend on the scale.
 template <typename Tuple>
 auto TupleToGTestValues(Tuple &&tup) {
   constexpr size_t kSize = std::tuple_size_v<std::decay_t<Tuple>>;
-  return TupleToGTestValuesImpl(std::forward<Tuple>(tup), std::make_index_sequence<kSize>{});
+  return TupleToGTestValuesImpl(std::forward<Tuple>(tup), {1.0}, std::make_index_sequence<kSize>{});
+}
+
+/// @brief One case per perf case and PPC_PERF_SCALES entry, for suites that build their inputs with
+/// ScalePerfInputSize; suites that do not would run the same input once per scale.
+template <typename Tuple>
+auto TupleToScaledGTestValues(Tuple &&tup) {
+  constexpr size_t kSize = std::tuple_size_v<std::decay_t<Tuple>>;
+  return TupleToGTestValuesImpl(std::forward<Tuple>(tup), GetPerfScales(), std::make_index_sequence<kSize>{});
 }
 
 template <typename InputType, typename... TaskTypes>
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace ppc::util {
+
+/// @brief Joins a generator name and its parameters into a cache key, e.g. MakeTestDataKey("lcg", 200000, 17) gives
+/// "lcg:200000:17". Bump a version in the generator name when its output changes, so persisted entries are not reused.
+template <typename... Params>
+std::string MakeTestDataKey(std::string_view generator, const Params &...params) {
+  std::ostringstream key;
+  key.precision(17);
+  key << generator;
+  ((key << ':' << params), ...);
+  return key.str();
+}
+
+namespace detail {
+
+template <typename T>
+struct IsVector : std::false_type {};
+template <typename T>
+struct IsVector<std::vector<T>> : std::true_type {};
+
+template <typename T>
+struct IsTupleLike : std::false_type {};
+template <typename... Ts>
+struct IsTupleLike<std::tuple<Ts...>> : std::true_type {};
+template <typename A, typename B>
+struct IsTupleLike<std::pair<A, B>> : std::true_type {};
+
+/// Arithmetic values, enums, std::string, and vectors, pairs and tuples of those.
+template <typename T>
+constexpr bool IsPersistableTestData() {
+  if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, std::string>) {
+    return true;
+  } else if constexpr (IsVector<T>::value) {
+    return IsPersistableTestData<typename T::value_type>();
+  } else if constexpr (IsTupleLike<T>::value) {
+    return []<std::size_t... I>(std::index_sequence<I...>) {
+      return (IsPersistableTestData<std::tuple_element_t<I, T>>() && ...);
+    }(std::make_index_sequence<std::tuple_size_v<T>>{});
+  } else {
+    return false;
+  }
+}
+
+template <typename T>
+void WriteTestData(std::ostream &out, const T &value) {
+  if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  } else if constexpr (std::is_same_v<T, std::string> || IsVector<T>::value) {
+    const auto size = static_cast<uint64_t>(value.size());
+    out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    using Value = typename T::value_type;
+    if constexpr (std::is_arithmetic_v<Value> && !std::is_same_v<Value, bool>) {
+      out.write(reinterpret_cast<const char *>(value.data()), static_cast<std::streamsize>(size * sizeof(Value)));
+    } else {
+      for (const auto &item : value) {
+        WriteTestData<Value>(out, item);
+      }
+    }
+  } else {
+    std::apply([&out](const auto &...items) { (WriteTestData(out, items), ...); }, value);
+  }
+}
+
+template <typename T>
+bool ReadTestData(std::istream &in, T &value) {
+  if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  } else if constexpr (std::is_same_v<T, std::string> || IsVector<T>::value) {
+    uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+      return false;
+    }
+    using Value = typename T::value_type;
+    if constexpr (std::is_arithmetic_v<Value> && !std::is_same_v<Value, bool>) {
+      value.resize(static_cast<std::size_t>(size));
+      return static_cast<bool>(
+          in.read(reinterpret_cast<char *>(value.data()), static_cast<std::streamsize>(size * sizeof(Value))));
+    } else {
+      value.clear();
+      for (uint64_t i = 0; i < size; i++) {
+        Value item{};
+        if (!ReadTestData(in, item)) {
+          return false;
+        }
+        value.push_back(std::move(item));
+      }
+      return true;
+    }
+  } else {
+    return std::apply([&in](auto &...items) { return (ReadTestData(in, items) && ...); }, value);
+  }
+}
+
+}  // namespace detail
+
+/// @brief Inputs and expected outputs shared by the cases of one test suite.
+/// @details Perf and functional suites instantiate the same data once per implementation and mode; the cache builds it
+/// once per suite instead. The harness calls EnterSuite() for every test, which drops the entries of the previous
+/// suite, so at most one suite's data stays in memory. With PPC_TEST_DATA_CACHE_DIR set, persistable values are also
+/// stored on disk and reused by later runs.
+class TestDataCache {
+ public:
+  static TestDataCache &Instance();
+
+  /// @brief Starts caching for @p suite; entries of any other suite are dropped.
+  void EnterSuite(const std::string &suite);
+  void Clear();
+  [[nodiscard]] std::size_t Size() const;
+
+  /// @brief Returns the value cached under @p key, calling @p generate on the first request of the suite.
+  /// @details The reference stays valid until the suite changes, so fixtures copy what they keep. @p generate may
+  /// itself read other entries, e.g. an expected output computed from a cached input.
+  template <typename Generator>
+  const std::invoke_result_t<Generator> &GetOrCreate(const std::string &key, Generator &&generate) {
+    using T = std::invoke_result_t<Generator>;
+    const std::string typed_key = key + "|" + typeid(T).name();
+    if (auto found = Find(typed_key)) {
+      return *std::static_pointer_cast<const T>(found);
+    }
+    std::shared_ptr<const T> value;
+    if constexpr (detail::IsPersistableTestData<T>()) {
+      value = Load<T>(key, typed_key);
+    }
+    if (!value) {
+      value = std::make_shared<const T>(std::forward<Generator>(generate)());
+      if constexpr (detail::IsPersistableTestData<T>()) {
+        Store(key, typed_key, *value);
+      }
+    }
+    return *std::static_pointer_cast<const T>(Insert(typed_key, value));
+  }
+
+ private:
+  TestDataCache() = default;
+
+  std::shared_ptr<const void> Find(const std::string &typed_key) const;
+  /// Keeps an entry inserted meanwhile, so every caller sees the same object.
+  std::shared_ptr<const void> Insert(const std::string &typed_key, std::shared_ptr<const void> value);
+  /// File of @p key in PPC_TEST_DATA_CACHE_DIR; empty when persistence is off.
+  static std::filesystem::path DiskPath(const std::string &key, const std::string &typed_key);
+  /// Writes through a temporary file and a rename, so concurrent ranks never read a partial entry.
+  static void Commit(const std::filesystem::path &path, const std::string &data);
+  static constexpr std::string_view kFileMagic = "ppc.test_data.v1";
+
+  template <typename T>
+  static std::shared_ptr<const T> Load(const std::string &key, const std::string &typed_key) {
+    const auto path = DiskPath(key, typed_key);
+    if (path.empty()) {
+      return nullptr;
+    }
+    std::ifstream in(path, std::ios::binary);
+    std::string magic;
+    std::string stored_key;
+    if (!std::getline(in, magic) || magic != kFileMagic || !std::getline(in, stored_key) || stored_key != typed_key) {
+      return nullptr;
+    }
+    T value{};
+    if (!detail::ReadTestData(in, value) || in.peek() != std::char_traits<char>::eof()) {
+      return nullptr;
+    }
+    return std::make_shared<const T>(std::move(value));
+  }
+
+  template <typename T>
+  static void Store(const std::string &key, const std::string &typed_key, const T &value) {
+    const auto path = DiskPath(key, typed_key);
+    if (path.empty()) {
+      return;
+    }
+    std::ostringstream out(std::ios::binary);
+    out << kFileMagic << '\n' << typed_key << '\n';
+    detail::WriteTestData(out, value);
+    Commit(path, out.str());
+  }
+
+  mutable std::mutex mutex_;
+  std::string suite_;
+  std::map<std::string, std::shared_ptr<const void>> entries_;
+};
+
+/// @brief Shorthand for TestDataCache::Instance().GetOrCreate().
+template <typename Generator>
+const std::invoke_result_t<Generator> &GetCachedTestData(const std::string &key, Generator &&generate) {
+  return TestDataCache::Instance().GetOrCreate(key, std::forward<Generator>(generate));
+}
+
+}  // namespace ppc::util
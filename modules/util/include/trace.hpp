@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nlohmann/json_fwd.hpp"
+
+namespace ppc::util {
+
+/// @brief One finished zone of the timeline.
+struct TraceEvent {
+  /// @brief Zone name; a string literal or a name returned by InternTraceName().
+  std::string_view name;
+  /// @brief "zone" for PPC_TRACE_SCOPE, "stage" for pipeline stages, "task" for whole tests.
+  std::string_view category;
+  /// @brief Nanoseconds since the process started tracing.
+  int64_t begin_ns = 0;
+  int64_t end_ns = 0;
+  /// @brief Sequential id of the recording thread, in order of the thread's first event.
+  int thread = 0;
+};
+
+namespace detail {
+std::atomic<bool> &TraceEnabledFlag();
+}  // namespace detail
+
+/// @brief True when zones are recorded: PPC_TRACE_JSON is set or SetTraceEnabled(true) was called.
+inline bool IsTraceEnabled() {
+  return detail::TraceEnabledFlag().load(std::memory_order_relaxed);
+}
+
+void SetTraceEnabled(bool enabled);
+
+/// @brief Monotonic timestamp in nanoseconds used for trace events.
+int64_t TraceNow();
+
+/// @brief Appends a finished zone to the calling thread's buffer; no locking after the thread's first event.
+void RecordTraceEvent(std::string_view name, std::string_view category, int64_t begin_ns, int64_t end_ns);
+
+/// @brief Returns a copy of @p name that lives until the end of the process, for zones with runtime names.
+std::string_view InternTraceName(const std::string &name);
+
+/// @brief Events of all threads of this process ordered by start time.
+/// @note Must not run concurrently with recording threads.
+std::vector<TraceEvent> CollectTraceEvents();
+
+/// @brief Drops the recorded events of all threads. Must not run concurrently with recording threads.
+void ClearTraceEvents();
+
+/// @brief Converts events to Chrome trace format: complete ("X") events with the rank as pid and the thread as tid,
+/// preceded by process and thread name metadata. @p offset_ns is added to every timestamp.
+nlohmann::json TraceEventsToJson(const std::vector<TraceEvent> &events, int rank, int64_t offset_ns = 0);
+
+/// @brief Gathers the events of all ranks and writes one Chrome trace JSON to PPC_TRACE_JSON on rank 0.
+/// @details Collective over MPI_COMM_WORLD. Rank clocks are aligned on a barrier, so the timeline is exact on a
+/// single node and within the barrier latency across nodes. Does nothing if tracing is disabled.
+void WriteTrace();
+
+/// @brief Records the lifetime of the scope as one trace zone when tracing is enabled.
+class TraceScope {
+ public:
+  explicit TraceScope(std::string_view name, std::string_view category = "zone")
+      : name_(name), category_(category), begin_ns_(IsTraceEnabled() ? TraceNow() : -1) {}
+  ~TraceScope() {
+    if (begin_ns_ >= 0) {
+      RecordTraceEvent(name_, category_, begin_ns_, TraceNow());
+    }
+  }
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+  TraceScope(TraceScope &&) = delete;
+  TraceScope &operator=(TraceScope &&) = delete;
+
+ private:
+  std::string_view name_;
+  std::string_view category_;
+  int64_t begin_ns_;
+};
+
+}  // namespace ppc::util
+
+#define PPC_TRACE_CONCAT_IMPL(a, b) a##b
+#define PPC_TRACE_CONCAT(a, b) PPC_TRACE_CONCAT_IMPL(a, b)
+
+/// @brief Records the enclosing scope as a trace zone named @p name (a string literal).
+#define PPC_TRACE_SCOPE(name) const ppc::util::TraceScope PPC_TRACE_CONCAT(ppc_trace_scope_, __LINE__)(name)
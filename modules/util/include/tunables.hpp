@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json_fwd.hpp"
+
+namespace ppc::util {
+
+/// @brief Integer parameter of a kernel that the autotuner may change, and the values it tries.
+struct TunableSpec {
+  /// @brief Task directory name, e.g. "morozova_s_broadcast".
+  std::string task;
+  /// @brief Technology of the implementation that reads the parameter, e.g. "mpi".
+  std::string implementation;
+  std::string name;
+  /// @brief Value used when nothing was tuned for the current host and configuration.
+  int64_t default_value = 0;
+  /// @brief Values the tuner measures besides @ref default_value.
+  std::vector<int64_t> candidates;
+};
+
+/// @brief Powers of two in [@p min, @p max], e.g. candidates of a block or segment size.
+std::vector<int64_t> PowerOfTwoRange(int64_t min, int64_t max);
+
+/// @brief @p min, @p min + @p step, ... up to @p max.
+/// @throws std::runtime_error If @p step is not positive.
+std::vector<int64_t> LinearRange(int64_t min, int64_t max, int64_t step);
+
+/// @brief Size class of an input with @p elements elements: floor(log2(elements)), 0 for empty inputs.
+int GetSizeBucket(std::size_t elements);
+
+/// @brief Configuration a tuned value was measured for.
+struct TuningContext {
+  std::string hostname;
+  /// @brief PPC_NUM_THREADS for threaded implementations, 1 for seq and mpi.
+  int threads = 1;
+  /// @brief MPI processes for mpi and all, 1 for the others.
+  int processes = 1;
+  int size_bucket = 0;
+};
+
+/// @brief Context of @p spec on the current host for an input of @p elements elements.
+TuningContext GetTuningContext(const TunableSpec &spec, std::size_t elements);
+
+/// @brief Best value the tuner found for one parameter in one context.
+struct TunedValue {
+  std::string task;
+  std::string implementation;
+  std::string name;
+  TuningContext context;
+  int64_t value = 0;
+  /// @brief Median time with @ref value and with the default value, in seconds.
+  double median_sec = 0.0;
+  double default_median_sec = 0.0;
+};
+
+/// @brief Tuning file of one host: `<dir>/<hostname>.json` (schema "ppc.tuning.v1").
+std::filesystem::path GetTuningPath(const std::filesystem::path &dir, const std::string &hostname);
+
+nlohmann::json TunedValueToJson(const TunedValue &tuned);
+/// @throws nlohmann::json::exception On missing fields.
+TunedValue TunedValueFromJson(const nlohmann::json &json);
+
+/// @brief Adds @p tuned to the tuning file of its host, replacing the value of the same parameter and context.
+/// @details Written through a temporary file and a rename, so tasks never read a partial file. Later lookups in this
+/// process see the new value.
+void SaveTunedValue(const std::filesystem::path &dir, const TunedValue &tuned);
+
+/// @brief Every tunable parameter declared by the linked tasks, in declaration order.
+std::vector<const TunableSpec *> &TunableRegistry();
+
+/// @brief Forces @p name of @p task / @p implementation to @p value in this process (used by the tuner).
+void SetTunableOverride(const TunableSpec &spec, std::optional<int64_t> value);
+
+/// @brief Tunable parameter of a task, declared as a namespace-scope constant next to the kernel that reads it.
+/// @details Get() returns, in order: the tuner's override, the value tuned for the current host, thread and process
+/// count and the nearest size bucket (from PPC_TUNING_DIR), or the default. The tuning file is read once per process,
+/// so a lookup is a map search and safe to call from every Run().
+class Tunable {
+ public:
+  explicit Tunable(TunableSpec spec);
+
+  Tunable(const Tunable &) = delete;
+  Tunable &operator=(const Tunable &) = delete;
+  Tunable(Tunable &&) = delete;
+  Tunable &operator=(Tunable &&) = delete;
+  ~Tunable() = default;
+
+  /// @brief Value for an input of @p elements elements.
+  [[nodiscard]] int64_t Get(std::size_t elements) const;
+  [[nodiscard]] const TunableSpec &Spec() const {
+    return spec_;
+  }
+
+ private:
+  TunableSpec spec_;
+};
+
+}  // namespace ppc::util
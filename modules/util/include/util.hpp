@@ -13,11 +13,14 @@
 #include <string_view>
 #include <system_error>
 #include <typeinfo>
+#include <utility>
+#include <vector>
 #ifdef __GNUG__
 #  include <cxxabi.h>
 #endif
 
 #include "nlohmann/json_fwd.hpp"
+#include "util/include/trace.hpp"
 
 #ifdef _MSC_VER
 #  pragma warning(push)
@@ -68,6 +71,59 @@ enum class GTestParamIndex : uint8_t {
   kTaskGetter,
   kNameTest,
   kTestParams,
+  kPerfScale,
+};
+
+/// @brief Task and pipeline stage running on the current thread, used by profilers to attribute their samples.
+struct ProfileContext {
+  /// @brief Test harness label of the task; empty outside of a test.
+  std::string task;
+  /// @brief Pipeline stage of the task, or "harness" for work done around the pipeline.
+  std::string_view stage = "harness";
+};
+
+/// @brief Returns the profiling context of the calling thread.
+inline ProfileContext &CurrentProfileContext() {
+  thread_local ProfileContext context;
+  return context;
+}
+
+/// @brief Sets the pipeline stage of the current thread's profiling context for the lifetime of the scope.
+/// @details Also records the stage as a trace zone when tracing is enabled.
+class ProfileStageScope {
+ public:
+  explicit ProfileStageScope(std::string_view stage)
+      : trace_(stage, "stage"), previous_(std::exchange(CurrentProfileContext().stage, stage)) {}
+  ~ProfileStageScope() {
+    CurrentProfileContext().stage = previous_;
+  }
+  ProfileStageScope(const ProfileStageScope &) = delete;
+  ProfileStageScope &operator=(const ProfileStageScope &) = delete;
+  ProfileStageScope(ProfileStageScope &&) = delete;
+  ProfileStageScope &operator=(ProfileStageScope &&) = delete;
+
+ private:
+  TraceScope trace_;
+  std::string_view previous_;
+};
+
+/// @brief Sets the task label of the current thread's profiling context for the lifetime of the scope.
+class ProfileTaskScope {
+ public:
+  explicit ProfileTaskScope(std::string task)
+      : trace_(IsTraceEnabled() ? InternTraceName(task) : std::string_view{}, "task"),
+        previous_(std::exchange(CurrentProfileContext().task, std::move(task))) {}
+  ~ProfileTaskScope() {
+    CurrentProfileContext().task = std::move(previous_);
+  }
+  ProfileTaskScope(const ProfileTaskScope &) = delete;
+  ProfileTaskScope &operator=(const ProfileTaskScope &) = delete;
+  ProfileTaskScope(ProfileTaskScope &&) = delete;
+  ProfileTaskScope &operator=(ProfileTaskScope &&) = delete;
+
+ private:
+  TraceScope trace_;
+  std::string previous_;
 };
 
 std::string GetAbsoluteTaskPath(const std::string &id_path, const std::string &relative_path);
@@ -75,6 +131,24 @@ int GetNumThreads();
 int GetNumProc();
 double GetTaskMaxTime();
 double GetPerfMaxTime();
+bool IsPerfHwCountersEnabled();
+bool IsPerfEnergyEnabled();
+bool IsPerfThreadingEnabled();
+std::string GetPerfJsonPath();
+std::string GetPerfBaselineDir();
+std::string GetPerfBaselineMode();
+double GetPerfRegressionThreshold();
+double GetPerfScale();
+std::vector<double> GetPerfScales();
+std::string GetPerfCacheMode();
+std::string GetPerfDistribution();
+std::string GetMpiProfileJsonPath();
+std::string GetTraceJsonPath();
+std::string GetTestDataCacheDir();
+std::string GetCalibrationDir();
+std::string GetTuningDir();
+std::string GetSimdIsa();
+int GetMpiMaxCount();
 
 template <typename T>
 std::string GetNamespace() {
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ppc::util::workload {
+
+/// @brief Shape of generated perf input values.
+enum class Distribution : uint8_t {
+  kUniform,
+  kNormal,
+  /// @brief Few values repeated very often, the rest rarely (power law over the value ranks).
+  kZipf,
+  kSorted,
+  kReverseSorted,
+  kFewDistinct,
+};
+
+inline constexpr std::array<Distribution, 6> kDistributions = {
+    Distribution::kUniform, Distribution::kNormal,        Distribution::kZipf,
+    Distribution::kSorted,  Distribution::kReverseSorted, Distribution::kFewDistinct};
+
+/// @brief Seed of the generators unless a suite picks its own.
+inline constexpr uint64_t kDefaultSeed = 42;
+
+/// @brief Site percolation threshold of the square lattice (4-neighbourhood).
+/// @details Binary images with this density have one component spanning the image, surrounded by many small ones.
+inline constexpr double kPercolationThreshold = 0.592746;
+
+/// @brief Name used in PPC_PERF_DISTRIBUTION and in test names, e.g. "reverse_sorted".
+std::string_view GetDistributionName(Distribution distribution);
+
+/// @throws std::runtime_error If @p name is not one of the names returned by GetDistributionName().
+Distribution ParseDistribution(std::string_view name);
+
+/// @brief Parameters of the skewed distributions.
+struct ValueOptions {
+  uint64_t seed = kDefaultSeed;
+  /// @brief Exponent s of kZipf: the k-th most frequent value occurs with probability proportional to 1 / k^s.
+  double zipf_exponent = 1.1;
+  /// @brief Number of different values kZipf draws from.
+  std::size_t zipf_values = std::size_t{1} << 16;
+  /// @brief Number of different values of kFewDistinct.
+  std::size_t distinct_values = 16;
+};
+
+/// @brief Random 64-bit value depending only on @p seed and @p index (SplitMix64 finalizer).
+/// @details Every element is derived from its index alone, so the generators fill vectors in parallel and produce
+/// the same data for any thread count.
+constexpr uint64_t Hash(uint64_t seed, uint64_t index) {
+  uint64_t z = seed + ((index + 1) * 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31U);
+}
+
+/// @brief Uniform value in [0, 1) depending only on @p seed and @p index.
+constexpr double UniformUnit(uint64_t seed, uint64_t index) {
+  return static_cast<double>(Hash(seed, index) >> 11U) * 0x1.0p-53;
+}
+
+/// @brief @p count values in [0, 1] drawn from @p distribution.
+/// @throws std::runtime_error On zero zipf_values or distinct_values, or a negative zipf_exponent.
+std::vector<double> GenerateUnitValues(Distribution distribution, std::size_t count, const ValueOptions &options = {});
+
+/// @brief @p count values in [@p low, @p high] drawn from @p distribution.
+/// @details Unit values are mapped monotonically, so sorted data stays sorted; integers cover every value of the
+/// range with equal width.
+template <typename T>
+  requires std::is_arithmetic_v<T>
+std::vector<T> GenerateValues(Distribution distribution, std::size_t count, T low, T high,
+                              const ValueOptions &options = {}) {
+  const auto unit = GenerateUnitValues(distribution, count, options);
+  const double base = static_cast<double>(low);
+  const double span = static_cast<double>(high) - base;
+  std::vector<T> values(count);
+  for (std::size_t i = 0; i < count; i++) {
+    if constexpr (std::is_integral_v<T>) {
+      const double offset = std::min(std::floor(unit[i] * (span + 1.0)), span);
+      values[i] = static_cast<T>(base + offset);
+    } else {
+      values[i] = static_cast<T>(base + (unit[i] * span));
+    }
+  }
+  return values;
+}
+
+/// @brief Random binary image: every pixel is 1 with probability @p density, independently of the others.
+/// @details Around kPercolationThreshold the components are largest and most irregular; far below it the image
+/// breaks into many tiny components, far above it into one component with holes.
+/// @throws std::runtime_error On negative sizes or a density outside [0, 1].
+std::vector<std::vector<int>> GenerateBinaryImage(int rows, int cols, double density, uint64_t seed = kDefaultSeed);
+
+/// @brief Dense system matrix * solution = rhs with a known solution.
+struct LinearSystem {
+  std::size_t size = 0;
+  /// @brief Row-major size x size coefficients.
+  std::vector<double> matrix;
+  std::vector<double> rhs;
+  std::vector<double> solution;
+};
+
+/// @brief Strictly diagonally dominant system: Gaussian elimination needs no pivoting and stays accurate.
+LinearSystem GenerateDiagonallyDominantSystem(std::size_t size, uint64_t seed = kDefaultSeed);
+
+/// @brief System whose 2-norm condition number is close to @p condition.
+/// @details The matrix is L * D * U^T with unit triangular L and U close to the identity and D decaying
+/// geometrically from 1 to 1 / @p condition, so elimination without pivoting still works, but the computed solution
+/// loses about log10(@p condition) digits. Check such results by their residual rather than against the solution.
+/// @throws std::runtime_error If @p condition is less than 1.
+LinearSystem GenerateIllConditionedSystem(std::size_t size, double condition, uint64_t seed = kDefaultSeed);
+
+}  // namespace ppc::util::workload
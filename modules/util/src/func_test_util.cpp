@@ -1,5 +1,10 @@
 #include <mpi.h>
 
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
 #include "util/include/perf_test_util.hpp"
 
 double ppc::util::GetTimeMPI() {
@@ -11,3 +16,60 @@ int ppc::util::GetMPIRank() {
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   return rank;
 }
+
+int ppc::util::GetMPISize() {
+  int size = -1;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  return size;
+}
+
+bool ppc::util::AnyRankTrue(bool value) {
+  int local = value ? 1 : 0;
+  int global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+  return global != 0;
+}
+
+void ppc::util::BarrierAllRanks() {
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+std::vector<double> ppc::util::MaxOverRanks(const std::vector<double> &local) {
+  std::vector<double> global(local.size());
+  MPI_Allreduce(local.data(), global.data(), static_cast<int>(local.size()), MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  return global;
+}
+
+std::vector<double> ppc::util::GatherToRoot(const std::vector<double> &local) {
+  const int size = GetMPISize();
+  const int count = static_cast<int>(local.size());
+  std::vector<double> gathered(GetMPIRank() == 0 ? local.size() * static_cast<std::size_t>(size) : 0);
+  MPI_Gather(local.data(), count, MPI_DOUBLE, gathered.data(), count, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  return gathered;
+}
+
+double ppc::util::SumOverNodes(double local) {
+  MPI_Comm node_comm = MPI_COMM_NULL;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+  int node_rank = 0;
+  MPI_Comm_rank(node_comm, &node_rank);
+  MPI_Comm_free(&node_comm);
+
+  // Sum the values and count the missing ones separately, so NaN does not depend on the MPI library's reduction
+  const bool leader = node_rank == 0;
+  const bool missing = std::isnan(local);
+  std::vector<double> contribution = {leader && !missing ? local : 0.0, leader && missing ? 1.0 : 0.0};
+  std::vector<double> total(contribution.size());
+  MPI_Allreduce(contribution.data(), total.data(), static_cast<int>(contribution.size()), MPI_DOUBLE, MPI_SUM,
+                MPI_COMM_WORLD);
+  return total[1] > 0.0 ? std::numeric_limits<double>::quiet_NaN() : total[0];
+}
+
+int ppc::util::GetNodeProcessCount() {
+  MPI_Comm node_comm = MPI_COMM_NULL;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+  int node_size = 1;
+  MPI_Comm_size(node_comm, &node_size);
+  MPI_Comm_free(&node_comm);
+  return node_size;
+}
@@ -0,0 +1,105 @@
+#include "util/include/test_data_cache.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "util/include/util.hpp"
+
+namespace ppc::util {
+
+namespace {
+
+/// FNV-1a, so file names stay the same across compilers and runs.
+uint64_t StableHash(const std::string &text) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : text) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // namespace
+
+TestDataCache &TestDataCache::Instance() {
+  static TestDataCache cache;
+  return cache;
+}
+
+void TestDataCache::EnterSuite(const std::string &suite) {
+  const std::scoped_lock lock(mutex_);
+  if (suite != suite_) {
+    entries_.clear();
+    suite_ = suite;
+  }
+}
+
+void TestDataCache::Clear() {
+  const std::scoped_lock lock(mutex_);
+  entries_.clear();
+}
+
+std::size_t TestDataCache::Size() const {
+  const std::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+std::shared_ptr<const void> TestDataCache::Find(const std::string &typed_key) const {
+  const std::scoped_lock lock(mutex_);
+  const auto it = entries_.find(typed_key);
+  return it == entries_.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<const void> TestDataCache::Insert(const std::string &typed_key, std::shared_ptr<const void> value) {
+  const std::scoped_lock lock(mutex_);
+  return entries_.try_emplace(typed_key, std::move(value)).first->second;
+}
+
+std::filesystem::path TestDataCache::DiskPath(const std::string &key, const std::string &typed_key) {
+  const auto dir = GetTestDataCacheDir();
+  if (dir.empty()) {
+    return {};
+  }
+  // Generator name for humans browsing the directory, hash of the full key for uniqueness
+  std::string name = key.substr(0, key.find(':'));
+  for (char &c : name) {
+    if (std::isalnum(static_cast<unsigned char>(c)) == 0 && c != '_' && c != '-') {
+      c = '_';
+    }
+  }
+  std::ostringstream file;
+  file << name << '_' << std::hex << StableHash(typed_key) << ".bin";
+  return std::filesystem::path(dir) / file.str();
+}
+
+void TestDataCache::Commit(const std::filesystem::path &path, const std::string &data) {
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  auto temporary = path;
+  temporary += ".tmp" + std::to_string(std::random_device{}());
+  {
+    std::ofstream out(temporary, std::ios::binary);
+    if (!out.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+      out.close();
+      std::filesystem::remove(temporary, error);
+      return;
+    }
+  }
+  // A failed write only costs the next run a regeneration
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+  }
+}
+
+}  // namespace ppc::util
@@ -0,0 +1,171 @@
+#include "util/include/trace.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "util/include/util.hpp"
+
+namespace ppc::util {
+
+namespace {
+
+struct ThreadTraceBuffer {
+  int thread = 0;
+  std::vector<TraceEvent> events;
+};
+
+/// Buffers are owned here rather than by the threads, so events of threads that already exited are kept.
+struct TraceRegistry {
+  std::mutex mutex;
+  std::deque<std::unique_ptr<ThreadTraceBuffer>> buffers;
+  std::set<std::string, std::less<>> names;
+};
+
+TraceRegistry &GetTraceRegistry() {
+  static TraceRegistry registry;
+  return registry;
+}
+
+ThreadTraceBuffer &LocalTraceBuffer() {
+  thread_local ThreadTraceBuffer *buffer = [] {
+    auto &registry = GetTraceRegistry();
+    const std::scoped_lock lock(registry.mutex);
+    auto &created = registry.buffers.emplace_back(std::make_unique<ThreadTraceBuffer>());
+    created->thread = static_cast<int>(registry.buffers.size()) - 1;
+    return created.get();
+  }();
+  return *buffer;
+}
+
+const auto kTraceEpoch = std::chrono::steady_clock::now();
+
+}  // namespace
+
+std::atomic<bool> &detail::TraceEnabledFlag() {
+  static std::atomic<bool> enabled{!GetTraceJsonPath().empty()};
+  return enabled;
+}
+
+void SetTraceEnabled(bool enabled) {
+  detail::TraceEnabledFlag().store(enabled, std::memory_order_relaxed);
+}
+
+int64_t TraceNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kTraceEpoch).count();
+}
+
+void RecordTraceEvent(std::string_view name, std::string_view category, int64_t begin_ns, int64_t end_ns) {
+  auto &buffer = LocalTraceBuffer();
+  buffer.events.push_back({.name = name, .category = category, .begin_ns = begin_ns, .end_ns = end_ns,
+                           .thread = buffer.thread});
+}
+
+std::string_view InternTraceName(const std::string &name) {
+  auto &registry = GetTraceRegistry();
+  const std::scoped_lock lock(registry.mutex);
+  return *registry.names.insert(name).first;
+}
+
+std::vector<TraceEvent> CollectTraceEvents() {
+  auto &registry = GetTraceRegistry();
+  const std::scoped_lock lock(registry.mutex);
+  std::vector<TraceEvent> events;
+  for (const auto &buffer : registry.buffers) {
+    events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+  }
+  std::ranges::stable_sort(events, {}, &TraceEvent::begin_ns);
+  return events;
+}
+
+void ClearTraceEvents() {
+  auto &registry = GetTraceRegistry();
+  const std::scoped_lock lock(registry.mutex);
+  for (auto &buffer : registry.buffers) {
+    buffer->events.clear();
+  }
+}
+
+nlohmann::json TraceEventsToJson(const std::vector<TraceEvent> &events, int rank, int64_t offset_ns) {
+  auto json = nlohmann::json::array();
+  json.push_back(
+      {{"name", "process_name"}, {"ph", "M"}, {"pid", rank}, {"args", {{"name", "rank " + std::to_string(rank)}}}});
+  json.push_back({{"name", "process_sort_index"}, {"ph", "M"}, {"pid", rank}, {"args", {{"sort_index", rank}}}});
+  std::set<int> threads;
+  for (const auto &event : events) {
+    if (threads.insert(event.thread).second) {
+      json.push_back({{"name", "thread_name"},
+                      {"ph", "M"},
+                      {"pid", rank},
+                      {"tid", event.thread},
+                      {"args", {{"name", "thread " + std::to_string(event.thread)}}}});
+    }
+  }
+  for (const auto &event : events) {
+    json.push_back({{"name", event.name},
+                    {"cat", event.category},
+                    {"ph", "X"},
+                    {"ts", static_cast<double>(event.begin_ns + offset_ns) / 1e3},
+                    {"dur", static_cast<double>(event.end_ns - event.begin_ns) / 1e3},
+                    {"pid", rank},
+                    {"tid", event.thread}});
+  }
+  return json;
+}
+
+void WriteTrace() {
+  if (!IsTraceEnabled()) {
+    return;
+  }
+  int rank = 0;
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // Express every rank's timestamps on rank 0's clock, taking the moment all ranks leave a barrier as common
+  MPI_Barrier(MPI_COMM_WORLD);
+  int64_t now = TraceNow();
+  const int64_t local_now = now;
+  MPI_Bcast(&now, 1, MPI_INT64_T, 0, MPI_COMM_WORLD);
+
+  const auto local = TraceEventsToJson(CollectTraceEvents(), rank, now - local_now).dump();
+  const int length = static_cast<int>(local.size());
+  std::vector<int> lengths(rank == 0 ? static_cast<std::size_t>(size) : 0);
+  MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  std::vector<int> displs(lengths.size(), 0);
+  for (std::size_t i = 1; i < lengths.size(); i++) {
+    displs[i] = displs[i - 1] + lengths[i - 1];
+  }
+  std::string gathered(rank == 0 ? static_cast<std::size_t>(displs.back() + lengths.back()) : 0, '\0');
+  MPI_Gatherv(local.data(), length, MPI_CHAR, gathered.data(), lengths.data(), displs.data(), MPI_CHAR, 0,
+              MPI_COMM_WORLD);
+  if (rank != 0) {
+    return;
+  }
+
+  auto trace_events = nlohmann::json::array();
+  for (std::size_t i = 0; i < lengths.size(); i++) {
+    for (auto &event : nlohmann::json::parse(gathered.substr(displs[i], lengths[i]))) {
+      trace_events.push_back(std::move(event));
+    }
+  }
+  std::ofstream(GetTraceJsonPath()) << nlohmann::json{{"traceEvents", trace_events}, {"displayTimeUnit", "ms"}}.dump()
+                                    << '\n';
+}
+
+}  // namespace ppc::util
@@ -0,0 +1,239 @@
+#include "util/include/tunables.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "performance/include/run_metadata.hpp"
+#include "util/include/util.hpp"
+
+namespace ppc::util {
+
+namespace {
+
+constexpr const char *kTuningSchema = "ppc.tuning.v1";
+
+std::string TunableKey(const std::string &task, const std::string &implementation, const std::string &name) {
+  return task + "/" + implementation + "/" + name;
+}
+
+/// Tuned values of the current host, loaded from the tuning directory the last lookup used.
+struct TuningTable {
+  std::optional<std::string> dir;
+  std::map<std::string, std::vector<TunedValue>> values;
+  std::map<std::string, int64_t> overrides;
+};
+
+std::mutex &TuningMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+TuningTable &GetTuningTable() {
+  static TuningTable table;
+  return table;
+}
+
+/// Entries of the tuning file at @p path; a missing or malformed file has none.
+std::vector<TunedValue> ReadTuningFile(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return {};
+  }
+  const auto json = nlohmann::json::parse(file, nullptr, false);
+  if (json.is_discarded() || json.value("schema", "") != kTuningSchema || !json.contains("values")) {
+    return {};
+  }
+  std::vector<TunedValue> values;
+  for (const auto &entry : json["values"]) {
+    try {
+      values.push_back(TunedValueFromJson(entry));
+    } catch (const nlohmann::json::exception &) {
+      continue;
+    }
+  }
+  return values;
+}
+
+/// Reloads @p table when PPC_TUNING_DIR changed since the last lookup.
+void RefreshTuningTable(TuningTable &table) {
+  const auto dir = GetTuningDir();
+  if (table.dir == dir) {
+    return;
+  }
+  table.dir = dir;
+  table.values.clear();
+  if (dir.empty()) {
+    return;
+  }
+  for (auto &tuned : ReadTuningFile(GetTuningPath(dir, ppc::performance::GetRunMetadata().hostname))) {
+    const auto key = TunableKey(tuned.task, tuned.implementation, tuned.name);
+    table.values[key].push_back(std::move(tuned));
+  }
+}
+
+bool SameEntry(const TunedValue &a, const TunedValue &b) {
+  return a.task == b.task && a.implementation == b.implementation && a.name == b.name &&
+         a.context.threads == b.context.threads && a.context.processes == b.context.processes &&
+         a.context.size_bucket == b.context.size_bucket;
+}
+
+}  // namespace
+
+std::vector<int64_t> PowerOfTwoRange(int64_t min, int64_t max) {
+  std::vector<int64_t> values;
+  for (int64_t value = std::bit_ceil(static_cast<uint64_t>(std::max<int64_t>(min, 1))); value <= max; value *= 2) {
+    values.push_back(value);
+  }
+  return values;
+}
+
+std::vector<int64_t> LinearRange(int64_t min, int64_t max, int64_t step) {
+  if (step <= 0) {
+    throw std::runtime_error("The step of a tunable range must be positive");
+  }
+  std::vector<int64_t> values;
+  for (int64_t value = min; value <= max; value += step) {
+    values.push_back(value);
+  }
+  return values;
+}
+
+int GetSizeBucket(std::size_t elements) {
+  return elements == 0 ? 0 : static_cast<int>(std::bit_width(elements)) - 1;
+}
+
+TuningContext GetTuningContext(const TunableSpec &spec, std::size_t elements) {
+  TuningContext context{.hostname = ppc::performance::GetRunMetadata().hostname,
+                        .threads = 1,
+                        .processes = 1,
+                        .size_bucket = GetSizeBucket(elements)};
+  if (spec.implementation != "seq" && spec.implementation != "mpi") {
+    context.threads = GetNumThreads();
+  }
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if ((spec.implementation == "mpi" || spec.implementation == "all") && initialized != 0) {
+    MPI_Comm_size(MPI_COMM_WORLD, &context.processes);
+  }
+  return context;
+}
+
+std::filesystem::path GetTuningPath(const std::filesystem::path &dir, const std::string &hostname) {
+  return dir / (hostname + ".json");
+}
+
+nlohmann::json TunedValueToJson(const TunedValue &tuned) {
+  return {{"task", tuned.task},
+          {"implementation", tuned.implementation},
+          {"name", tuned.name},
+          {"threads", tuned.context.threads},
+          {"processes", tuned.context.processes},
+          {"size_bucket", tuned.context.size_bucket},
+          {"value", tuned.value},
+          {"median_sec", tuned.median_sec},
+          {"default_median_sec", tuned.default_median_sec}};
+}
+
+TunedValue TunedValueFromJson(const nlohmann::json &json) {
+  return TunedValue{.task = json.at("task").get<std::string>(),
+                    .implementation = json.at("implementation").get<std::string>(),
+                    .name = json.at("name").get<std::string>(),
+                    .context = {.hostname = {},
+                                .threads = json.at("threads").get<int>(),
+                                .processes = json.at("processes").get<int>(),
+                                .size_bucket = json.at("size_bucket").get<int>()},
+                    .value = json.at("value").get<int64_t>(),
+                    .median_sec = json.value("median_sec", 0.0),
+                    .default_median_sec = json.value("default_median_sec", 0.0)};
+}
+
+void SaveTunedValue(const std::filesystem::path &dir, const TunedValue &tuned) {
+  const auto path = GetTuningPath(dir, tuned.context.hostname);
+  auto values = ReadTuningFile(path);
+  std::erase_if(values, [&](const TunedValue &stored) { return SameEntry(stored, tuned); });
+  values.push_back(tuned);
+
+  const auto &metadata = ppc::performance::GetRunMetadata();
+  nlohmann::json json = {{"schema", kTuningSchema},
+                         {"hostname", tuned.context.hostname},
+                         {"cpu_model", metadata.cpu_model},
+                         {"values", nlohmann::json::array()}};
+  for (const auto &value : values) {
+    json["values"].push_back(TunedValueToJson(value));
+  }
+  std::error_code error;
+  std::filesystem::create_directories(dir, error);
+  auto temp_path = path;
+  temp_path += ".tmp";
+  std::ofstream(temp_path) << json.dump(2) << '\n';
+  std::filesystem::rename(temp_path, path, error);
+  if (error) {
+    throw std::runtime_error("Failed to write the tuning file " + path.string() + ": " + error.message());
+  }
+  // The next lookup reads the new entry
+  const std::scoped_lock lock(TuningMutex());
+  GetTuningTable().dir.reset();
+}
+
+std::vector<const TunableSpec *> &TunableRegistry() {
+  static std::vector<const TunableSpec *> registry;
+  return registry;
+}
+
+void SetTunableOverride(const TunableSpec &spec, std::optional<int64_t> value) {
+  const std::scoped_lock lock(TuningMutex());
+  const auto key = TunableKey(spec.task, spec.implementation, spec.name);
+  if (value.has_value()) {
+    GetTuningTable().overrides[key] = value.value();
+  } else {
+    GetTuningTable().overrides.erase(key);
+  }
+}
+
+Tunable::Tunable(TunableSpec spec) : spec_(std::move(spec)) {
+  TunableRegistry().push_back(&spec_);
+}
+
+int64_t Tunable::Get(std::size_t elements) const {
+  const auto key = TunableKey(spec_.task, spec_.implementation, spec_.name);
+  const std::scoped_lock lock(TuningMutex());
+  auto &table = GetTuningTable();
+  if (const auto it = table.overrides.find(key); it != table.overrides.end()) {
+    return it->second;
+  }
+  RefreshTuningTable(table);
+  const auto it = table.values.find(key);
+  if (it == table.values.end()) {
+    return spec_.default_value;
+  }
+  const auto context = GetTuningContext(spec_, elements);
+  const TunedValue *best = nullptr;
+  for (const auto &tuned : it->second) {
+    if (tuned.context.threads != context.threads || tuned.context.processes != context.processes) {
+      continue;
+    }
+    if (best == nullptr || std::abs(tuned.context.size_bucket - context.size_bucket) <
+                               std::abs(best->context.size_bucket - context.size_bucket)) {
+      best = &tuned;
+    }
+  }
+  return best == nullptr ? spec_.default_value : best->value;
+}
+
+}  // namespace ppc::util
@@ -2,9 +2,14 @@
 
 #include <algorithm>
 #include <array>
+#include <exception>
 #include <filesystem>
 #include <libenvpp/detail/get.hpp>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -52,6 +57,162 @@ double ppc::util::GetPerfMaxTime() {
   return 10.0;
 }
 
+bool ppc::util::IsPerfHwCountersEnabled() {
+  const auto val = env::get<int>("PPC_PERF_HW_COUNTERS");
+  return val.has_value() && val.value() != 0;
+}
+
+bool ppc::util::IsPerfEnergyEnabled() {
+  const auto val = env::get<int>("PPC_PERF_ENERGY");
+  return val.has_value() && val.value() != 0;
+}
+
+bool ppc::util::IsPerfThreadingEnabled() {
+  const auto val = env::get<int>("PPC_PERF_THREADING");
+  return val.has_value() && val.value() != 0;
+}
+
+std::string ppc::util::GetPerfJsonPath() {
+  const auto val = env::get<std::string>("PPC_PERF_JSON");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::string ppc::util::GetPerfBaselineDir() {
+  const auto val = env::get<std::string>("PPC_PERF_BASELINE_DIR");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::string ppc::util::GetPerfBaselineMode() {
+  const auto val = env::get<std::string>("PPC_PERF_BASELINE");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return "compare";
+}
+
+double ppc::util::GetPerfRegressionThreshold() {
+  const auto val = env::get<double>("PPC_PERF_REGRESSION_THRESHOLD");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return 0.05;
+}
+
+double ppc::util::GetPerfScale() {
+  const auto val = env::get<double>("PPC_PERF_SCALE");
+  if (val.has_value() && val.value() > 0.0) {
+    return val.value();
+  }
+  return 1.0;
+}
+
+std::vector<double> ppc::util::GetPerfScales() {
+  const auto val = env::get<std::string>("PPC_PERF_SCALES");
+  if (!val.has_value()) {
+    return {1.0};
+  }
+  std::vector<double> scales;
+  std::stringstream list(val.value());
+  std::string item;
+  while (std::getline(list, item, ',')) {
+    if (item.find_first_not_of(' ') == std::string::npos) {
+      continue;
+    }
+    double scale = 0.0;
+    try {
+      scale = std::stod(item);
+    } catch (const std::exception &) {
+      throw std::runtime_error("PPC_PERF_SCALES: invalid scale '" + item + "'");
+    }
+    if (scale <= 0.0) {
+      throw std::runtime_error("PPC_PERF_SCALES: scales must be positive, got '" + item + "'");
+    }
+    scales.push_back(scale);
+  }
+  if (scales.empty()) {
+    scales.push_back(1.0);
+  }
+  return scales;
+}
+
+std::string ppc::util::GetPerfCacheMode() {
+  const auto val = env::get<std::string>("PPC_PERF_CACHE");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return "warm";
+}
+
+std::string ppc::util::GetPerfDistribution() {
+  const auto val = env::get<std::string>("PPC_PERF_DISTRIBUTION");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return "uniform";
+}
+
+std::string ppc::util::GetMpiProfileJsonPath() {
+  const auto val = env::get<std::string>("PPC_MPI_PROFILE_JSON");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::string ppc::util::GetTraceJsonPath() {
+  const auto val = env::get<std::string>("PPC_TRACE_JSON");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::string ppc::util::GetTestDataCacheDir() {
+  const auto val = env::get<std::string>("PPC_TEST_DATA_CACHE_DIR");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::string ppc::util::GetCalibrationDir() {
+  const auto val = env::get<std::string>("PPC_CALIBRATION_DIR");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::string ppc::util::GetTuningDir() {
+  const auto val = env::get<std::string>("PPC_TUNING_DIR");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::string ppc::util::GetSimdIsa() {
+  const auto val = env::get<std::string>("PPC_SIMD_ISA");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+int ppc::util::GetMpiMaxCount() {
+  const auto val = env::get<int>("PPC_MPI_MAX_COUNT");
+  if (val.has_value() && val.value() > 0) {
+    return val.value();
+  }
+  return std::numeric_limits<int>::max();
+}
+
 // List of environment variables that signal the application is running under
 // an MPI launcher. The array size must match the number of entries to avoid
 // looking up empty environment variable names.
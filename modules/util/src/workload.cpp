@@ -0,0 +1,230 @@
+#include "util/include/workload.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ppc::util::workload {
+
+namespace {
+
+// Independent streams for the different parts of one generated input
+constexpr uint64_t kValueSalt = 0x5851F42D4C957F2DULL;
+constexpr uint64_t kSolutionSalt = 0x14057B7EF767814FULL;
+constexpr uint64_t kLowerSalt = 0x2545F4914F6CDD1DULL;
+constexpr uint64_t kUpperSalt = 0x9FB21C651E98DF25ULL;
+
+/// Normal values outside mean +- 4 sigma (about 6e-5 of them) are clamped to the ends of [0, 1].
+constexpr double kNormalSigmas = 4.0;
+
+/// Cumulative probabilities of the ranks 1..values under P(k) ~ 1 / k^exponent.
+std::vector<double> ZipfCdf(std::size_t values, double exponent) {
+  std::vector<double> cdf(values);
+  double total = 0.0;
+  for (std::size_t k = 0; k < values; k++) {
+    total += std::pow(static_cast<double>(k + 1), -exponent);
+    cdf[k] = total;
+  }
+  for (auto &p : cdf) {
+    p /= total;
+  }
+  return cdf;
+}
+
+/// Fills @p values in parallel with value(i); each element depends on its index only.
+template <typename Fn>
+void FillByIndex(std::vector<double> &values, const Fn &value) {
+  const auto n = static_cast<int64_t>(values.size());
+#pragma omp parallel for schedule(static) default(none) shared(values, value, n)
+  for (int64_t i = 0; i < n; i++) {
+    values[i] = value(static_cast<uint64_t>(i));
+  }
+}
+
+/// Sets rhs = matrix * solution with the solution drawn from [-1, 1].
+void CompleteSystem(LinearSystem &system, uint64_t seed) {
+  const auto n = static_cast<int64_t>(system.size);
+  system.solution.resize(system.size);
+  system.rhs.assign(system.size, 0.0);
+  for (std::size_t j = 0; j < system.size; j++) {
+    system.solution[j] = (2.0 * UniformUnit(seed ^ kSolutionSalt, j)) - 1.0;
+  }
+#pragma omp parallel for schedule(static) default(none) shared(system, n)
+  for (int64_t i = 0; i < n; i++) {
+    double sum = 0.0;
+    for (int64_t j = 0; j < n; j++) {
+      sum += system.matrix[(i * n) + j] * system.solution[j];
+    }
+    system.rhs[i] = sum;
+  }
+}
+
+}  // namespace
+
+std::string_view GetDistributionName(Distribution distribution) {
+  switch (distribution) {
+    case Distribution::kUniform:
+      return "uniform";
+    case Distribution::kNormal:
+      return "normal";
+    case Distribution::kZipf:
+      return "zipf";
+    case Distribution::kSorted:
+      return "sorted";
+    case Distribution::kReverseSorted:
+      return "reverse_sorted";
+    case Distribution::kFewDistinct:
+      return "few_distinct";
+  }
+  return "unknown";
+}
+
+Distribution ParseDistribution(std::string_view name) {
+  const auto *it = std::ranges::find(kDistributions, name, GetDistributionName);
+  if (it == kDistributions.end()) {
+    throw std::runtime_error("Unknown distribution '" + std::string(name) +
+                             "' (expected uniform, normal, zipf, sorted, reverse_sorted or few_distinct)");
+  }
+  return *it;
+}
+
+std::vector<double> GenerateUnitValues(Distribution distribution, std::size_t count, const ValueOptions &options) {
+  if (options.zipf_values == 0 || options.distinct_values == 0) {
+    throw std::runtime_error("zipf_values and distinct_values must be positive");
+  }
+  if (!(options.zipf_exponent >= 0.0)) {
+    throw std::runtime_error("zipf_exponent must not be negative");
+  }
+  const uint64_t seed = options.seed;
+  std::vector<double> values(count);
+  switch (distribution) {
+    case Distribution::kUniform:
+    case Distribution::kSorted:
+    case Distribution::kReverseSorted:
+      FillByIndex(values, [seed](uint64_t i) { return UniformUnit(seed, i); });
+      break;
+    case Distribution::kNormal:
+      FillByIndex(values, [seed](uint64_t i) {
+        // Box-Muller; 1 - u keeps the logarithm finite
+        const double radius = std::sqrt(-2.0 * std::log(1.0 - UniformUnit(seed, 2 * i)));
+        const double z = radius * std::cos(2.0 * std::numbers::pi * UniformUnit(seed, (2 * i) + 1));
+        return std::clamp(0.5 + (z / (2.0 * kNormalSigmas)), 0.0, 1.0);
+      });
+      break;
+    case Distribution::kZipf: {
+      // Every rank sits at a random position of the range, so frequent values are not just the small ones
+      const auto cdf = ZipfCdf(options.zipf_values, options.zipf_exponent);
+      FillByIndex(values, [seed, &cdf](uint64_t i) {
+        const auto rank = std::min(static_cast<std::size_t>(std::ranges::lower_bound(cdf, UniformUnit(seed, i)) -
+                                                            cdf.begin()),
+                                   cdf.size() - 1);
+        return UniformUnit(seed ^ kValueSalt, rank);
+      });
+      break;
+    }
+    case Distribution::kFewDistinct: {
+      const auto distinct = static_cast<double>(options.distinct_values);
+      FillByIndex(values, [seed, distinct](uint64_t i) {
+        const auto rank = static_cast<uint64_t>(std::min(std::floor(UniformUnit(seed, i) * distinct), distinct - 1.0));
+        return UniformUnit(seed ^ kValueSalt, rank);
+      });
+      break;
+    }
+  }
+  if (distribution == Distribution::kSorted) {
+    std::ranges::sort(values);
+  } else if (distribution == Distribution::kReverseSorted) {
+    std::ranges::sort(values, std::greater<>());
+  }
+  return values;
+}
+
+std::vector<std::vector<int>> GenerateBinaryImage(int rows, int cols, double density, uint64_t seed) {
+  if (rows < 0 || cols < 0) {
+    throw std::runtime_error("Image sizes must not be negative");
+  }
+  if (!(density >= 0.0 && density <= 1.0)) {
+    throw std::runtime_error("Image density must lie in [0, 1]");
+  }
+  std::vector<std::vector<int>> image(rows, std::vector<int>(cols, 0));
+#pragma omp parallel for schedule(static) default(none) shared(image, rows, cols, density, seed)
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      const auto index = (static_cast<uint64_t>(i) * static_cast<uint64_t>(cols)) + static_cast<uint64_t>(j);
+      image[i][j] = UniformUnit(seed, index) < density ? 1 : 0;
+    }
+  }
+  return image;
+}
+
+LinearSystem GenerateDiagonallyDominantSystem(std::size_t size, uint64_t seed) {
+  LinearSystem system;
+  system.size = size;
+  system.matrix.resize(size * size);
+  const auto n = static_cast<int64_t>(size);
+#pragma omp parallel for schedule(static) default(none) shared(system, n, seed)
+  for (int64_t i = 0; i < n; i++) {
+    double off_diagonal = 0.0;
+    for (int64_t j = 0; j < n; j++) {
+      if (i != j) {
+        const double value = (2.0 * UniformUnit(seed, static_cast<uint64_t>((i * n) + j))) - 1.0;
+        system.matrix[(i * n) + j] = value;
+        off_diagonal += std::abs(value);
+      }
+    }
+    system.matrix[(i * n) + i] = off_diagonal + 1.0;
+  }
+  CompleteSystem(system, seed);
+  return system;
+}
+
+LinearSystem GenerateIllConditionedSystem(std::size_t size, double condition, uint64_t seed) {
+  if (!(condition >= 1.0) || std::isinf(condition)) {
+    throw std::runtime_error("The condition number must be finite and at least 1");
+  }
+  const auto n = static_cast<int64_t>(size);
+  // Off-diagonal factor entries of order 1 / n keep L and U well conditioned; D sets the condition number
+  const double factor_scale = 1.0 / static_cast<double>(std::max<int64_t>(n, 1));
+  std::vector<double> lower(size * size);
+  std::vector<double> upper(size * size);
+  std::vector<double> diagonal(size, 1.0);
+  for (int64_t i = 0; i < n; i++) {
+    for (int64_t k = 0; k < i; k++) {
+      const auto index = static_cast<uint64_t>((i * n) + k);
+      lower[(i * n) + k] = ((2.0 * UniformUnit(seed ^ kLowerSalt, index)) - 1.0) * factor_scale;
+      upper[(i * n) + k] = ((2.0 * UniformUnit(seed ^ kUpperSalt, index)) - 1.0) * factor_scale;
+    }
+    lower[(i * n) + i] = 1.0;
+    upper[(i * n) + i] = 1.0;
+    if (n > 1) {
+      diagonal[i] = std::pow(condition, -static_cast<double>(i) / static_cast<double>(n - 1));
+    }
+  }
+
+  LinearSystem system;
+  system.size = size;
+  system.matrix.resize(size * size);
+#pragma omp parallel for schedule(dynamic) default(none) shared(system, lower, upper, diagonal, n)
+  for (int64_t i = 0; i < n; i++) {
+    for (int64_t j = 0; j < n; j++) {
+      double sum = 0.0;
+      for (int64_t k = 0; k <= std::min(i, j); k++) {
+        sum += lower[(i * n) + k] * diagonal[k] * upper[(j * n) + k];
+      }
+      system.matrix[(i * n) + j] = sum;
+    }
+  }
+  CompleteSystem(system, seed);
+  return system;
+}
+
+}  // namespace ppc::util::workload
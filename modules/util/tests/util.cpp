@@ -2,11 +2,32 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <libenvpp/detail/environment.hpp>
 #include <libenvpp/detail/get.hpp>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #include "omp.h"
+#include "util/include/perf_test_util.hpp"
+#include "util/include/test_data_cache.hpp"
+#include "util/include/trace.hpp"
+#include "util/include/tunables.hpp"
+#include "util/include/workload.hpp"
 
 namespace my::nested {
 struct Type {};
@@ -109,6 +130,15 @@ TEST(GetPerfMaxTime, ReadsFromEnvironment) {
   EXPECT_DOUBLE_EQ(ppc::util::GetPerfMaxTime(), 12.5);
 }
 
+TEST(GetMpiMaxCount, DefaultsToIntMaxAndIgnoresNonPositiveValues) {
+  {
+    env::detail::set_scoped_environment_variable scoped("PPC_MPI_MAX_COUNT", "0");
+    EXPECT_EQ(ppc::util::GetMpiMaxCount(), std::numeric_limits<int>::max());
+  }
+  env::detail::set_scoped_environment_variable scoped("PPC_MPI_MAX_COUNT", "7");
+  EXPECT_EQ(ppc::util::GetMpiMaxCount(), 7);
+}
+
 TEST(GetNumProc, ReturnsDefaultWhenUnset) {
   const auto old = env::get<int>("PPC_NUM_PROC");
   if (old.has_value()) {
@@ -124,3 +154,348 @@ TEST(GetNumProc, ReadsFromEnvironment) {
   env::detail::set_scoped_environment_variable scoped("PPC_NUM_PROC", "4");
   EXPECT_EQ(ppc::util::GetNumProc(), 4);
 }
+
+TEST(GetPerfScales, ReturnsSingleScaleWhenUnset) {
+  const auto old = env::get<std::string>("PPC_PERF_SCALES");
+  if (old.has_value()) {
+    env::detail::delete_environment_variable("PPC_PERF_SCALES");
+  }
+  EXPECT_EQ(ppc::util::GetPerfScales(), std::vector<double>{1.0});
+  if (old.has_value()) {
+    env::detail::set_environment_variable("PPC_PERF_SCALES", *old);
+  }
+}
+
+TEST(GetPerfScales, ParsesCommaSeparatedList) {
+  env::detail::set_scoped_environment_variable scoped("PPC_PERF_SCALES", "1, 10,0.5,");
+  EXPECT_EQ(ppc::util::GetPerfScales(), (std::vector<double>{1.0, 10.0, 0.5}));
+}
+
+TEST(GetPerfScales, RejectsInvalidScales) {
+  {
+    env::detail::set_scoped_environment_variable scoped("PPC_PERF_SCALES", "1,abc");
+    EXPECT_THROW(ppc::util::GetPerfScales(), std::runtime_error);
+  }
+  env::detail::set_scoped_environment_variable scoped("PPC_PERF_SCALES", "0");
+  EXPECT_THROW(ppc::util::GetPerfScales(), std::runtime_error);
+}
+
+TEST(ScalePerfInputSize, ScalesElementCountAcrossDimensions) {
+  const double old_scale = ppc::util::ActivePerfScale();
+  ppc::util::ActivePerfScale() = 4.0;
+  EXPECT_EQ(ppc::util::ScalePerfInputSize(100), 400);
+  EXPECT_EQ(ppc::util::ScalePerfInputSize(100, 2), 200);
+  ppc::util::ActivePerfScale() = 1e-6;
+  EXPECT_EQ(ppc::util::ScalePerfInputSize(std::size_t{100}), std::size_t{1});
+  ppc::util::ActivePerfScale() = old_scale;
+}
+
+TEST(TupleToGTestValues, ExpandsOnlyOptedInSuitesOverScales) {
+  env::detail::set_scoped_environment_variable scoped("PPC_PERF_SCALES", "1,10");
+  using Param = ppc::util::PerfTestParam<int, int>;
+  const auto cases =
+      std::make_tuple(Param{nullptr, "task", ppc::performance::PerfResults::TypeOfRunning::kPipeline, 1.0});
+  auto scales_of = [](const ::testing::internal::ParamGenerator<Param> &generator) {
+    std::vector<double> scales;
+    for (const auto &param : generator) {
+      scales.push_back(std::get<static_cast<std::size_t>(ppc::util::GTestParamIndex::kPerfScale)>(param));
+    }
+    return scales;
+  };
+  const auto base = ppc::util::GetPerfScale();
+  EXPECT_EQ(scales_of(ppc::util::TupleToGTestValues(cases)), std::vector<double>{base});
+  EXPECT_EQ(scales_of(ppc::util::TupleToScaledGTestValues(cases)), (std::vector<double>{base, base * 10.0}));
+}
+
+TEST(InputBytesOf, CountsNestedContainersAndTuples) {
+  EXPECT_EQ(ppc::util::InputBytesOf(std::vector<int>(10)), 10 * sizeof(int));
+  EXPECT_EQ(ppc::util::InputBytesOf(std::vector<std::vector<double>>(3, std::vector<double>(4))),
+            12 * sizeof(double));
+  EXPECT_EQ(ppc::util::InputBytesOf(std::string("abcd")), std::size_t{4});
+  EXPECT_EQ(ppc::util::InputBytesOf(std::make_tuple(2, 3, std::vector<double>(6))),
+            (2 * sizeof(int)) + (6 * sizeof(double)));
+  EXPECT_FALSE(ppc::util::InputBytesOf(100).has_value());
+}
+
+TEST(Trace, RecordsZonesOnlyWhenEnabled) {
+  ppc::util::ClearTraceEvents();
+  ppc::util::SetTraceEnabled(false);
+  {
+    PPC_TRACE_SCOPE("disabled");
+  }
+  EXPECT_TRUE(ppc::util::CollectTraceEvents().empty());
+
+  ppc::util::SetTraceEnabled(true);
+  {
+    const ppc::util::ProfileTaskScope profile_task("trace_test");
+    PPC_TRACE_SCOPE("outer");
+    std::thread([] { PPC_TRACE_SCOPE("worker"); }).join();
+  }
+  ppc::util::SetTraceEnabled(false);
+
+  const auto events = ppc::util::CollectTraceEvents();
+  ppc::util::ClearTraceEvents();
+  ASSERT_EQ(events.size(), 3U);
+  EXPECT_EQ(events[0].name, "trace_test");
+  EXPECT_EQ(events[0].category, "task");
+  EXPECT_EQ(events[1].name, "outer");
+  EXPECT_EQ(events[2].name, "worker");
+  EXPECT_NE(events[2].thread, events[1].thread);
+  EXPECT_LE(events[1].begin_ns, events[2].begin_ns);
+  EXPECT_GE(events[1].end_ns, events[2].end_ns);
+}
+
+TEST(Trace, ConvertsEventsToChromeTraceFormat) {
+  const std::vector<ppc::util::TraceEvent> events{
+      {.name = "run", .category = "stage", .begin_ns = 2000, .end_ns = 5000, .thread = 1}};
+  const auto json = ppc::util::TraceEventsToJson(events, 3, 1000);
+  ASSERT_EQ(json.size(), 4U);
+  EXPECT_EQ(json[0]["name"], "process_name");
+  EXPECT_EQ(json[0]["args"]["name"], "rank 3");
+  EXPECT_EQ(json[2]["name"], "thread_name");
+  EXPECT_EQ(json[2]["tid"], 1);
+  EXPECT_EQ(json[3]["ph"], "X");
+  EXPECT_EQ(json[3]["pid"], 3);
+  EXPECT_EQ(json[3]["cat"], "stage");
+  EXPECT_DOUBLE_EQ(json[3]["ts"].get<double>(), 3.0);
+  EXPECT_DOUBLE_EQ(json[3]["dur"].get<double>(), 3.0);
+}
+
+TEST(TestDataCache, GeneratesOncePerSuite) {
+  auto &cache = ppc::util::TestDataCache::Instance();
+  cache.EnterSuite("TestDataCacheSuiteA");
+  cache.Clear();
+  int calls = 0;
+  const auto generate = [&calls] {
+    calls++;
+    return std::vector<int>{1, 2, 3};
+  };
+  const auto key = ppc::util::MakeTestDataKey("iota", 3, 0.5);
+  EXPECT_EQ(key, "iota:3:0.5");
+  EXPECT_EQ(ppc::util::GetCachedTestData(key, generate), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(ppc::util::GetCachedTestData(key, generate), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(calls, 1);
+
+  // Entries are typed: the same key with another value type is a separate entry
+  EXPECT_EQ(ppc::util::GetCachedTestData(key, [] { return std::string("abc"); }), "abc");
+  // Generators may build on other entries
+  const auto &sum = ppc::util::GetCachedTestData(key + ":sum", [&] {
+    const auto &values = ppc::util::GetCachedTestData(key, generate);
+    return values[0] + values[1] + values[2];
+  });
+  EXPECT_EQ(sum, 6);
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(cache.Size(), 3U);
+
+  cache.EnterSuite("TestDataCacheSuiteA");
+  EXPECT_EQ(cache.Size(), 3U);
+  cache.EnterSuite("TestDataCacheSuiteB");
+  EXPECT_EQ(cache.Size(), 0U);
+  std::ignore = ppc::util::GetCachedTestData(key, generate);
+  EXPECT_EQ(calls, 2);
+  cache.Clear();
+}
+
+TEST(TestDataCache, PersistsEntriesAcrossRuns) {
+  const auto dir =
+      std::filesystem::temp_directory_path() / ("ppc_test_data_cache_" + std::to_string(std::random_device{}()));
+  env::detail::set_scoped_environment_variable scoped("PPC_TEST_DATA_CACHE_DIR", dir.string());
+  auto &cache = ppc::util::TestDataCache::Instance();
+  cache.Clear();
+  using Data = std::tuple<std::vector<std::vector<double>>, std::string, int>;
+  const Data data{{{1.5, -2.0}, {}, {3.25}}, "abc", 7};
+  const auto key = ppc::util::MakeTestDataKey("persisted", 42);
+  EXPECT_EQ(ppc::util::GetCachedTestData(key, [&] { return data; }), data);
+
+  // A later run finds the entry on disk and never calls the generator
+  cache.Clear();
+  int calls = 0;
+  EXPECT_EQ(ppc::util::GetCachedTestData(key,
+                                         [&] {
+                                           calls++;
+                                           return Data{};
+                                         }),
+            data);
+  EXPECT_EQ(calls, 0);
+
+  // Truncated files are regenerated
+  cache.Clear();
+  for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+    std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) - 1);
+  }
+  EXPECT_EQ(ppc::util::GetCachedTestData(key,
+                                         [&] {
+                                           calls++;
+                                           return data;
+                                         }),
+            data);
+  EXPECT_EQ(calls, 1);
+  cache.Clear();
+  std::filesystem::remove_all(dir);
+}
+
+TEST(Workload, GeneratesTheSameValuesForAnyThreadCount) {
+  using ppc::util::workload::Distribution;
+  const int old_threads = omp_get_max_threads();
+  for (const auto distribution : ppc::util::workload::kDistributions) {
+    omp_set_num_threads(1);
+    const auto serial = ppc::util::workload::GenerateValues<int>(distribution, 10000, -50, 50);
+    omp_set_num_threads(4);
+    const auto parallel = ppc::util::workload::GenerateValues<int>(distribution, 10000, -50, 50);
+    EXPECT_EQ(serial, parallel) << ppc::util::workload::GetDistributionName(distribution);
+    EXPECT_TRUE(std::ranges::all_of(serial, [](int value) { return value >= -50 && value <= 50; }));
+    EXPECT_EQ(ppc::util::workload::ParseDistribution(ppc::util::workload::GetDistributionName(distribution)),
+              distribution);
+  }
+  omp_set_num_threads(old_threads);
+  EXPECT_NE(ppc::util::workload::GenerateValues(Distribution::kUniform, 100, 0.0, 1.0, {.seed = 1}),
+            ppc::util::workload::GenerateValues(Distribution::kUniform, 100, 0.0, 1.0, {.seed = 2}));
+  EXPECT_THROW(ppc::util::workload::ParseDistribution("exponential"), std::runtime_error);
+}
+
+TEST(Workload, DistributionsHaveTheirShape) {
+  using ppc::util::workload::Distribution;
+  using ppc::util::workload::GenerateValues;
+  const auto most_frequent_share = [](std::vector<int> values) {
+    std::ranges::sort(values);
+    std::size_t best = 0;
+    for (auto it = values.begin(); it != values.end();) {
+      const auto next = std::ranges::upper_bound(it, values.end(), *it);
+      best = std::max(best, static_cast<std::size_t>(next - it));
+      it = next;
+    }
+    return static_cast<double>(best) / static_cast<double>(values.size());
+  };
+  constexpr std::size_t kCount = 100000;
+  const int max_value = 1 << 30;
+
+  EXPECT_LT(most_frequent_share(GenerateValues(Distribution::kUniform, kCount, 0, max_value)), 0.001);
+  EXPECT_GT(most_frequent_share(GenerateValues(Distribution::kZipf, kCount, 0, max_value)), 0.05);
+  auto few = GenerateValues(Distribution::kFewDistinct, kCount, 0, max_value, {.distinct_values = 8});
+  std::ranges::sort(few);
+  EXPECT_EQ(std::ranges::distance(few.begin(), std::ranges::unique(few).begin()), 8);
+
+  EXPECT_TRUE(std::ranges::is_sorted(GenerateValues(Distribution::kSorted, kCount, 0.0, 1.0)));
+  EXPECT_TRUE(std::ranges::is_sorted(GenerateValues(Distribution::kReverseSorted, kCount, 0.0, 1.0), std::greater<>()));
+
+  // Mean 0.5 and sigma 1/8: about 95% of the values lie within two sigmas
+  const auto normal = GenerateValues(Distribution::kNormal, kCount, 0.0, 1.0);
+  const auto central = std::ranges::count_if(normal, [](double value) { return std::abs(value - 0.5) < 0.25; });
+  EXPECT_NEAR(static_cast<double>(central) / kCount, 0.954, 0.01);
+}
+
+TEST(Workload, BinaryImagesHaveTheRequestedDensity) {
+  const auto image = ppc::util::workload::GenerateBinaryImage(300, 200, 0.3);
+  ASSERT_EQ(image.size(), 300U);
+  ASSERT_EQ(image[0].size(), 200U);
+  double ones = 0.0;
+  for (const auto &row : image) {
+    ones += std::accumulate(row.begin(), row.end(), 0.0);
+  }
+  EXPECT_NEAR(ones / (300.0 * 200.0), 0.3, 0.01);
+  EXPECT_EQ(ppc::util::workload::GenerateBinaryImage(4, 4, 1.0), std::vector<std::vector<int>>(4, {1, 1, 1, 1}));
+  EXPECT_EQ(ppc::util::workload::GenerateBinaryImage(2, 3, 0.0), std::vector<std::vector<int>>(2, {0, 0, 0}));
+  EXPECT_THROW(ppc::util::workload::GenerateBinaryImage(2, 2, 1.5), std::runtime_error);
+}
+
+TEST(Workload, LinearSystemsAreConsistentWithTheirSolution) {
+  const auto residual = [](const ppc::util::workload::LinearSystem &system) {
+    double worst = 0.0;
+    for (std::size_t i = 0; i < system.size; i++) {
+      double sum = -system.rhs[i];
+      for (std::size_t j = 0; j < system.size; j++) {
+        sum += system.matrix[(i * system.size) + j] * system.solution[j];
+      }
+      worst = std::max(worst, std::abs(sum));
+    }
+    return worst;
+  };
+
+  const auto dominant = ppc::util::workload::GenerateDiagonallyDominantSystem(50);
+  EXPECT_LT(residual(dominant), 1e-12);
+  for (std::size_t i = 0; i < dominant.size; i++) {
+    double off_diagonal = 0.0;
+    for (std::size_t j = 0; j < dominant.size; j++) {
+      off_diagonal += i == j ? 0.0 : std::abs(dominant.matrix[(i * dominant.size) + j]);
+    }
+    EXPECT_GT(dominant.matrix[(i * dominant.size) + i], off_diagonal);
+  }
+
+  // det(L * D * U^T) is the product of D: 1, 1e-3 and 1e-6
+  const auto ill = ppc::util::workload::GenerateIllConditionedSystem(3, 1e6);
+  const auto &a = ill.matrix;
+  const double det = (a[0] * ((a[4] * a[8]) - (a[5] * a[7]))) - (a[1] * ((a[3] * a[8]) - (a[5] * a[6]))) +
+                     (a[2] * ((a[3] * a[7]) - (a[4] * a[6])));
+  EXPECT_NEAR(det, 1e-9, 1e-15);
+  EXPECT_LT(residual(ill), 1e-12);
+  EXPECT_THROW(ppc::util::workload::GenerateIllConditionedSystem(3, 0.5), std::runtime_error);
+}
+
+TEST(Workload, PerfInputDistributionFollowsTheEnvironment) {
+  const auto old_distribution = ppc::util::ActivePerfDistribution();
+  {
+    env::detail::set_scoped_environment_variable scoped("PPC_PERF_DISTRIBUTION", "zipf");
+    EXPECT_EQ(ppc::util::PerfInputDistribution(), ppc::util::workload::Distribution::kZipf);
+    EXPECT_EQ(ppc::util::ActivePerfDistribution(), ppc::util::workload::Distribution::kZipf);
+  }
+  env::detail::set_scoped_environment_variable scoped("PPC_PERF_DISTRIBUTION", "skewed");
+  EXPECT_THROW(ppc::util::PerfInputDistribution(), std::runtime_error);
+  ppc::util::ActivePerfDistribution() = old_distribution;
+}
+
+namespace {
+
+const ppc::util::Tunable kTestBlockSize({.task = "util_tests",
+                                         .implementation = "seq",
+                                         .name = "block_size",
+                                         .default_value = 64,
+                                         .candidates = ppc::util::PowerOfTwoRange(16, 256)});
+
+}  // namespace
+
+TEST(Tunables, BuildsCandidateRangesAndSizeBuckets) {
+  EXPECT_EQ(ppc::util::PowerOfTwoRange(3, 40), (std::vector<int64_t>{4, 8, 16, 32}));
+  EXPECT_EQ(ppc::util::LinearRange(4, 16, 4), (std::vector<int64_t>{4, 8, 12, 16}));
+  EXPECT_THROW(ppc::util::LinearRange(1, 2, 0), std::runtime_error);
+  EXPECT_EQ(ppc::util::GetSizeBucket(0), 0);
+  EXPECT_EQ(ppc::util::GetSizeBucket(1), 0);
+  EXPECT_EQ(ppc::util::GetSizeBucket(1023), 9);
+  EXPECT_EQ(ppc::util::GetSizeBucket(1024), 10);
+  EXPECT_NE(std::ranges::find(ppc::util::TunableRegistry(), &kTestBlockSize.Spec()),
+            ppc::util::TunableRegistry().end());
+}
+
+TEST(Tunables, PrefersOverrideThenNearestTunedBucketThenDefault) {
+  const auto dir = std::filesystem::temp_directory_path() / ("ppc_tuning_" + std::to_string(std::random_device{}()));
+  env::detail::set_scoped_environment_variable scoped("PPC_TUNING_DIR", dir.string());
+  const auto &spec = kTestBlockSize.Spec();
+  EXPECT_EQ(kTestBlockSize.Get(1 << 10), 64);
+
+  auto tuned = ppc::util::TunedValue{.task = spec.task,
+                                     .implementation = spec.implementation,
+                                     .name = spec.name,
+                                     .context = ppc::util::GetTuningContext(spec, 1 << 10),
+                                     .value = 128,
+                                     .median_sec = 0.5,
+                                     .default_median_sec = 1.0};
+  ppc::util::SaveTunedValue(dir, tuned);
+  tuned.context.size_bucket = 20;
+  tuned.value = 32;
+  ppc::util::SaveTunedValue(dir, tuned);
+  // Saving the same context again replaces its entry
+  tuned.value = 16;
+  ppc::util::SaveTunedValue(dir, tuned);
+
+  EXPECT_EQ(kTestBlockSize.Get(1 << 11), 128);
+  EXPECT_EQ(kTestBlockSize.Get(1 << 19), 16);
+  ppc::util::SetTunableOverride(spec, 256);
+  EXPECT_EQ(kTestBlockSize.Get(1 << 11), 256);
+  ppc::util::SetTunableOverride(spec, std::nullopt);
+  EXPECT_EQ(kTestBlockSize.Get(1 << 11), 128);
+
+  std::ifstream file(ppc::util::GetTuningPath(dir, tuned.context.hostname));
+  const auto json = nlohmann::json::parse(file);
+  EXPECT_EQ(json["schema"], "ppc.tuning.v1");
+  EXPECT_EQ(json["values"].size(), 2U);
+  std::filesystem::remove_all(dir);
+}
@@ -2,6 +2,8 @@ import argparse
 import csv
 import json
 import logging
+import math
+import os
 import shutil
 import subprocess
 import sys
@@ -16,9 +18,9 @@ from jinja2 import Environment, FileSystemLoader
 logging.basicConfig(level=logging.INFO, format="%(levelname)s: %(message)s")
 logger = logging.getLogger(__name__)
 
-task_types = ["all", "mpi", "omp", "seq", "stl", "tbb"]
-# Threads table order: seq first, then omp, tbb, stl, all
-task_types_threads = ["seq", "omp", "tbb", "stl", "all"]
+task_types = ["all", "mpi", "omp", "pstl", "seq", "stl", "tbb"]
+# Threads table order: seq first, then omp, tbb, stl, pstl, all
+task_types_threads = ["seq", "omp", "tbb", "stl", "pstl", "all"]
 task_types_processes = ["mpi", "seq"]
 
 script_dir = Path(__file__).parent
@@ -124,7 +126,7 @@ directories, tasks_type_map = discover_tasks(tasks_dir, task_types)
 
 def load_performance_data_threads(perf_stat_file_path: Path) -> dict:
     """Load threads performance ratios (T_x/T_seq) from CSV.
-    Expected header: Task, SEQ, OMP, TBB, STL, ALL
+    Expected header: Task, SEQ, OMP, TBB, STL, PSTL, ALL
     """
     perf_stats: dict[str, dict] = {}
     if perf_stat_file_path.exists():
@@ -139,6 +141,7 @@ def load_performance_data_threads(perf_stat_file_path: Path) -> dict:
                     "omp": row.get("OMP", "?"),
                     "tbb": row.get("TBB", "?"),
                     "stl": row.get("STL", "?"),
+                    "pstl": row.get("PSTL", "?"),
                     "all": row.get("ALL", "?"),
                 }
     else:
@@ -149,7 +152,7 @@ def load_performance_data_threads(perf_stat_file_path: Path) -> dict:
 def load_performance_data(perf_stat_file_path: Path) -> dict:
     """Compatibility helper for legacy tests: load perf data with optional MPI column.
 
-    Always returns a mapping: task -> {seq, omp, stl, tbb, all, mpi}
+    Always returns a mapping: task -> {seq, omp, stl, pstl, tbb, all, mpi}
     Missing columns are filled with ``"N/A"``; empty cells stay empty strings.
     """
     perf_stats: dict[str, dict] = {}
@@ -173,6 +176,7 @@ def load_performance_data(perf_stat_file_path: Path) -> dict:
                 "seq": _get("SEQ"),
                 "omp": _get("OMP"),
                 "stl": _get("STL"),
+                "pstl": _get("PSTL"),
                 "tbb": _get("TBB"),
                 "all": _get("ALL"),
                 "mpi": _get("MPI"),
@@ -235,6 +239,266 @@ def load_performance_data_processes(perf_stat_file_path: Path) -> dict:
     return perf_stats
 
 
+def _is_default_configuration(record: dict) -> bool:
+    """Whether a perf record was measured at scale 1, warm cache and the default input.
+
+    Scale sweeps (PPC_PERF_SCALES), cold-cache runs (PPC_PERF_CACHE) and
+    non-uniform input distributions write records of their own, which must not
+    stand in for the default time of a task.
+    """
+    try:
+        scale = float(record.get("scale", 1.0))
+    except (TypeError, ValueError):
+        return False
+    return (
+        math.isclose(scale, 1.0)
+        and record.get("cache", "warm") == "warm"
+        and record.get("distribution") in (None, "uniform")
+    )
+
+
+def load_performance_records(perf_records_path: Path) -> dict:
+    """Load structured perf records (JSON Lines) keyed by task directory.
+
+    Each record carries its task directory and implementation explicitly, so
+    no name matching is needed. Only ``task_run`` times of the default
+    configuration are used, as strings to match the CSV loaders.
+    """
+    perf_stats: dict[str, dict] = {}
+    if not perf_records_path.exists():
+        return perf_stats
+
+    with open(perf_records_path, "r") as records_file:
+        for line in records_file:
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                record = json.loads(line)
+            except json.JSONDecodeError:
+                logger.warning(
+                    "Skipping malformed perf record in %s", perf_records_path
+                )
+                continue
+            if record.get("mode") != "task_run":
+                continue
+            if not _is_default_configuration(record):
+                continue
+            task_dir = record.get("task_dir")
+            impl = record.get("implementation")
+            time_sec = record.get("time_sec")
+            if not task_dir or not impl or time_sec is None:
+                continue
+            perf_stats.setdefault(task_dir, {})[impl] = str(time_sec)
+    return perf_stats
+
+
+def load_perf_history(history_path: Path) -> list[dict]:
+    """Load the perf history (JSON Lines of ppc.perf.v1 records) in time order.
+
+    The history is appended to by ``scripts/perf_history.py`` after every perf
+    run; records without a task directory, mode, time or timestamp are skipped.
+    """
+    records: list[dict] = []
+    if not history_path.exists():
+        return records
+
+    with open(history_path, "r") as history_file:
+        for line in history_file:
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                record = json.loads(line)
+            except json.JSONDecodeError:
+                logger.warning("Skipping malformed perf record in %s", history_path)
+                continue
+            if not isinstance(record, dict):
+                continue
+            required = ("task_dir", "implementation", "mode", "time_sec", "timestamp")
+            if any(record.get(key) is None for key in required):
+                continue
+            records.append(record)
+    records.sort(key=lambda r: r["timestamp"])
+    return records
+
+
+def _history_workers(record: dict) -> int:
+    """Workers a record's speedup is divided by to get its efficiency."""
+    impl = record.get("implementation")
+    threads = int(record.get("threads") or 1)
+    processes = int(record.get("processes") or 1)
+    if impl == "seq":
+        return 1
+    if impl == "mpi":
+        return processes
+    if impl == "all":
+        return processes * threads
+    return threads
+
+
+def _history_context(record: dict) -> tuple:
+    """Configuration shared by a parallel record and the seq record it is compared with."""
+    return (
+        record["task_dir"],
+        record["mode"],
+        (record.get("host") or {}).get("hostname"),
+        record.get("scale", 1.0),
+        record.get("cache", "warm"),
+        record.get("distribution"),
+    )
+
+
+def _find_seq_time(seq_runs: list[tuple], record: dict):
+    """Seq time of the same commit, else of the latest seq run not after the record."""
+    git_sha = (record.get("build") or {}).get("git_sha")
+    same_commit = [t for ts, sha, t in seq_runs if sha == git_sha and sha]
+    if same_commit:
+        return same_commit[-1]
+    earlier = [t for ts, sha, t in seq_runs if ts <= record["timestamp"]]
+    return earlier[-1] if earlier else None
+
+
+def _median(values: list[float]) -> float:
+    ordered = sorted(values)
+    mid = len(ordered) // 2
+    if len(ordered) % 2:
+        return ordered[mid]
+    return (ordered[mid - 1] + ordered[mid]) / 2.0
+
+
+def _trend_svg(points: list[dict], width: int = 600, height: int = 120) -> dict:
+    """Polyline and markers of a series' times, scaled into a width x height box."""
+    pad = 6
+    times = [p["time"] for p in points]
+    lo, hi = min(times), max(times)
+    span = (hi - lo) or hi or 1.0
+    step = (width - 2 * pad) / max(len(points) - 1, 1)
+    markers = []
+    for i, point in enumerate(points):
+        x = pad + i * step
+        y = height - pad - (point["time"] - lo) / span * (height - 2 * pad)
+        markers.append(
+            {"x": round(x, 1), "y": round(y, 1), "regression": point["regression"]}
+        )
+    return {
+        "width": width,
+        "height": height,
+        "polyline": " ".join(f"{m['x']},{m['y']}" for m in markers),
+        "markers": markers,
+        "min": lo,
+        "max": hi,
+    }
+
+
+def build_perf_trends(
+    records: list[dict], regression_threshold: float = 0.1, window: int = 5
+) -> dict[str, list[dict]]:
+    """Group history records into per-task series with speedup, efficiency and regressions.
+
+    A series is one implementation, mode, thread and process count, host, scale,
+    cache state and input distribution. A point is marked as a regression when its time exceeds the
+    median of the previous ``window`` points by more than ``regression_threshold``,
+    or when the perf run itself flagged it against its baseline.
+    """
+    seq_runs: dict[tuple, list[tuple]] = defaultdict(list)
+    for record in records:
+        if record["implementation"] == "seq":
+            seq_runs[_history_context(record)].append(
+                (
+                    record["timestamp"],
+                    (record.get("build") or {}).get("git_sha"),
+                    float(record["time_sec"]),
+                )
+            )
+
+    series_map: dict[tuple, dict] = {}
+    for record in records:
+        hostname = (record.get("host") or {}).get("hostname") or "?"
+        threads = int(record.get("threads") or 1)
+        processes = int(record.get("processes") or 1)
+        key = (
+            record["task_dir"],
+            record["implementation"],
+            record["mode"],
+            threads,
+            processes,
+            hostname,
+            record.get("scale", 1.0),
+            record.get("cache", "warm"),
+            record.get("distribution"),
+        )
+        series = series_map.setdefault(
+            key,
+            {
+                "task_dir": record["task_dir"],
+                "implementation": record["implementation"],
+                "mode": record["mode"],
+                "threads": threads,
+                "processes": processes,
+                "hostname": hostname,
+                "scale": record.get("scale", 1.0),
+                "cache": record.get("cache", "warm"),
+                "distribution": record.get("distribution"),
+                "points": [],
+            },
+        )
+
+        time_sec = float(record["time_sec"])
+        seq_time = _find_seq_time(seq_runs.get(_history_context(record), []), record)
+        speedup = None
+        efficiency = None
+        if seq_time is not None and time_sec > 0:
+            speedup = seq_time / time_sec
+            efficiency = speedup / _history_workers(record) * 100.0
+
+        previous = [p["time"] for p in series["points"][-window:]]
+        baseline = _median(previous) if previous else None
+        slowdown = time_sec / baseline - 1.0 if baseline else None
+        flagged = bool((record.get("regression") or {}).get("regressed"))
+        git_sha = (record.get("build") or {}).get("git_sha") or ""
+        series["points"].append(
+            {
+                "timestamp": record["timestamp"],
+                "date": datetime.fromtimestamp(
+                    record["timestamp"], tz=ZoneInfo("UTC")
+                ).strftime("%Y-%m-%d %H:%M"),
+                "git_sha": git_sha[:10],
+                "time": time_sec,
+                "speedup": speedup,
+                "efficiency": efficiency,
+                "baseline": baseline,
+                "slowdown": slowdown,
+                "regression": flagged
+                or (slowdown is not None and slowdown > regression_threshold),
+            }
+        )
+
+    trends: dict[str, list[dict]] = {}
+    for series in series_map.values():
+        points = series["points"]
+        series["latest"] = points[-1]
+        series["drift"] = (
+            points[-1]["time"] / points[0]["time"] - 1.0
+            if len(points) > 1 and points[0]["time"] > 0
+            else None
+        )
+        series["regressions"] = sum(1 for p in points if p["regression"])
+        series["svg"] = _trend_svg(points)
+        trends.setdefault(series["task_dir"], []).append(series)
+    for task_series in trends.values():
+        task_series.sort(
+            key=lambda s: (
+                s["mode"],
+                s["implementation"],
+                s["threads"],
+                s["processes"],
+                s["hostname"],
+            )
+        )
+    return dict(sorted(trends.items()))
+
+
 def calculate_performance_metrics(perf_val, eff_num_proc, task_type, seq_val=None):
     """Calculate acceleration and efficiency.
 
@@ -677,6 +941,7 @@ def main():
       - index.html: simple menu linking to threads.html and processes.html
       - threads.html: scoreboard for thread-based tasks
       - processes.html: scoreboard for process-based tasks
+    and, when a perf history exists, trends.html with one trend_<task>.html per task.
     """
     cfg, eff_num_proc, deadlines_cfg, plagiarism_cfg_local = load_configurations()
 
@@ -931,7 +1196,7 @@ def main():
 
     def _match_dir(csv_key: str) -> str | None:
         # Strip common suffixes like "_mpi_enabled" etc. to improve matching
-        base = _re.sub(r"_(mpi|omp|tbb|stl|all|seq)_enabled.*", "", csv_key)
+        base = _re.sub(r"_(mpi|omp|tbb|pstl|stl|all|seq)_enabled.*", "", csv_key)
         for d in dir_names_sorted:
             if base.startswith(d) or d in base or csv_key.startswith(d):
                 return d
@@ -959,6 +1224,18 @@ def main():
         for t in targets:
             perf_stats[t] = _merge_perf_maps(perf_stats.get(t, {}), vals)
 
+    # Structured records name their task directory exactly; they win over CSV matches
+    candidates_records = [
+        script_dir.parent / "build" / "perf_stat_dir" / "perf_records.jsonl",
+        script_dir.parent / "perf_stat_dir" / "perf_records.jsonl",
+    ]
+    records_path = next(
+        (p for p in candidates_records if p.exists()), candidates_records[0]
+    )
+    for t, vals in load_performance_records(records_path).items():
+        if t in directories:
+            perf_stats[t] = _merge_perf_maps(perf_stats.get(t, {}), vals)
+
     # Build rows for each page
     threads_rows = _build_rows_for_task_types(
         task_types_threads,
@@ -1477,6 +1754,51 @@ def main():
             f.write(html_g)
         processes_groups_menu.append({"href": out_file.name, "title": g})
 
+    # Trend pages from the perf history kept by scripts/perf_history.py
+    history_path = Path(
+        os.environ.get(
+            "PPC_PERF_HISTORY", str(REPO_ROOT / "perf_history" / "perf_history.jsonl")
+        )
+    )
+    trends = build_perf_trends(load_perf_history(history_path))
+    menu_pages = [
+        {"href": "threads.html", "title": "Threads Scoreboard"},
+        {"href": "processes.html", "title": "Processes Scoreboard"},
+    ]
+    if trends:
+        trend_template = env.get_template("trend.html.j2")
+        trends_index = []
+        for task_dir, task_series in trends.items():
+            href = f"trend_{task_dir}.html"
+            with open(output_path / href, "w") as f:
+                f.write(
+                    trend_template.render(
+                        task_dir=task_dir,
+                        series=task_series,
+                        generated_msk=generated_msk,
+                    )
+                )
+            trends_index.append(
+                {
+                    "href": href,
+                    "task_dir": task_dir,
+                    "series": len(task_series),
+                    "runs": max(len(s["points"]) for s in task_series),
+                    "regressed": [
+                        s for s in task_series if s["latest"]["regression"]
+                    ],
+                }
+            )
+        with open(output_path / "trends.html", "w") as f:
+            f.write(
+                env.get_template("trends_index.html.j2").render(
+                    tasks=trends_index,
+                    history_path=history_path.name,
+                    generated_msk=generated_msk,
+                )
+            )
+        menu_pages.append({"href": "trends.html", "title": "Performance Trends"})
+
     # Render index menu page
     try:
         menu_template = env.get_template("menu_index.html.j2")
@@ -1493,10 +1815,7 @@ def main():
         )
     else:
         menu_html_content = menu_template.render(
-            pages=[
-                {"href": "threads.html", "title": "Threads Scoreboard"},
-                {"href": "processes.html", "title": "Processes Scoreboard"},
-            ],
+            pages=menu_pages,
             groups_threads=threads_groups_menu,
             groups_processes=processes_groups_menu,
             generated_msk=generated_msk,
@@ -0,0 +1,93 @@
+"""
+Tests for the perf history loader and the trend series built from it.
+"""
+
+import json
+
+from main import build_perf_trends, load_perf_history
+
+
+def _record(impl, time_sec, timestamp, git_sha="abc", **extra):
+    record = {
+        "schema": "ppc.perf.v1",
+        "task_dir": "example_threads",
+        "implementation": impl,
+        "mode": "task_run",
+        "threads": 4,
+        "processes": 1,
+        "time_sec": time_sec,
+        "timestamp": timestamp,
+        "host": {"hostname": "node1"},
+        "build": {"git_sha": git_sha},
+    }
+    record.update(extra)
+    return record
+
+
+class TestLoadPerfHistory:
+    """Test cases for load_perf_history function."""
+
+    def test_load_perf_history_sorts_and_skips_incomplete(self, temp_dir):
+        """Records are returned in time order; malformed and incomplete ones are dropped."""
+        history_path = temp_dir / "perf_history.jsonl"
+        with open(history_path, "w") as f:
+            f.write(json.dumps(_record("omp", 0.5, 20)) + "\n")
+            f.write("not json\n")
+            f.write(json.dumps({"task_dir": "x", "mode": "task_run"}) + "\n")
+            f.write(json.dumps(_record("seq", 2.0, 10)) + "\n")
+
+        records = load_perf_history(history_path)
+
+        assert [r["timestamp"] for r in records] == [10, 20]
+
+    def test_load_perf_history_nonexistent_file(self, temp_dir):
+        """Missing history yields no records."""
+        assert load_perf_history(temp_dir / "missing.jsonl") == []
+
+
+class TestBuildPerfTrends:
+    """Test cases for build_perf_trends function."""
+
+    def test_speedup_and_efficiency_use_seq_of_same_commit(self):
+        """Speedup divides the seq time of the same commit; efficiency divides it by the threads."""
+        records = [
+            _record("seq", 2.0, 10, git_sha="a"),
+            _record("omp", 1.0, 11, git_sha="a"),
+            _record("seq", 4.0, 20, git_sha="b"),
+            _record("omp", 1.0, 21, git_sha="b"),
+        ]
+
+        trends = build_perf_trends(records)
+
+        omp = next(s for s in trends["example_threads"] if s["implementation"] == "omp")
+        assert [p["speedup"] for p in omp["points"]] == [2.0, 4.0]
+        assert [p["efficiency"] for p in omp["points"]] == [50.0, 100.0]
+        assert omp["drift"] == 0.0
+
+    def test_marks_slowdowns_against_previous_runs(self):
+        """A run slower than the median of the previous ones by more than the threshold is a regression."""
+        times = [1.0, 1.02, 0.98, 1.05, 1.3]
+        records = [_record("seq", t, i) for i, t in enumerate(times)]
+
+        series = build_perf_trends(records, regression_threshold=0.1)["example_threads"][0]
+
+        assert [p["regression"] for p in series["points"]] == [False, False, False, False, True]
+        assert series["regressions"] == 1
+        assert series["latest"]["regression"]
+        assert abs(series["points"][-1]["slowdown"] - (1.3 / 1.01 - 1.0)) < 1e-9
+
+    def test_keeps_baseline_verdict_and_separates_configurations(self):
+        """Runs flagged by the perf baseline stay flagged; hosts and thread counts form separate series."""
+        records = [
+            _record("omp", 1.0, 1, regression={"regressed": True}),
+            _record("omp", 1.0, 2, threads=8),
+            _record("omp", 1.0, 3, host={"hostname": "node2"}),
+        ]
+
+        task_series = build_perf_trends(records)["example_threads"]
+
+        assert len(task_series) == 3
+        flagged = [s for s in task_series if s["regressions"]]
+        assert len(flagged) == 1
+        assert flagged[0]["threads"] == 4 and flagged[0]["hostname"] == "node1"
+        assert all(s["points"][0]["speedup"] is None for s in task_series)
@@ -2,7 +2,7 @@
 Tests for the discover_tasks function.
 """
 
-from main import discover_tasks
+from main import discover_tasks, task_types, task_types_threads
 
 
 class TestDiscoverTasks:
@@ -108,3 +108,18 @@ class TestDiscoverTasks:
         assert result["example_task"]["omp"] == "done"
         # stl should not be included even though directory exists
         assert "stl" not in result["example_task"]
+
+    def test_discover_tasks_pstl_implementation(self, temp_dir):
+        """Test discovering a pstl implementation with the scoreboard task types."""
+        tasks_dir = temp_dir / "tasks"
+        (tasks_dir / "pstl_task" / "seq").mkdir(parents=True)
+        (tasks_dir / "pstl_task" / "pstl").mkdir(parents=True)
+
+        assert "pstl" in task_types
+        assert "pstl" in task_types_threads
+
+        directories, _ = discover_tasks(tasks_dir, task_types)
+
+        assert directories["pstl_task"]["seq"] == "done"
+        assert directories["pstl_task"]["pstl"] == "done"
+        assert "stl" not in directories["pstl_task"]
@@ -4,7 +4,7 @@ Tests for the load_performance_data function.
 
 import csv
 
-from main import load_performance_data
+from main import load_performance_data, load_performance_data_threads
 
 
 class TestLoadPerformanceData:
@@ -143,3 +143,36 @@ class TestLoadPerformanceData:
         assert task_data["tbb"] == ""
         assert task_data["all"] == "N/A"
         assert task_data["mpi"] == "N/A"
+
+    def test_load_performance_data_pstl_column(self, temp_dir):
+        """Test that the PSTL column of the threads table is read by both loaders."""
+        pstl_csv = temp_dir / "pstl.csv"
+
+        with open(pstl_csv, "w", newline="") as f:
+            writer = csv.DictWriter(
+                f, fieldnames=["Task", "SEQ", "OMP", "TBB", "STL", "PSTL", "ALL"]
+            )
+            writer.writeheader()
+            writer.writerow(
+                {
+                    "Task": "pstl_task",
+                    "SEQ": "1.0",
+                    "OMP": "0.5",
+                    "TBB": "0.4",
+                    "STL": "0.3",
+                    "PSTL": "0.35",
+                    "ALL": "0.2",
+                }
+            )
+
+        assert load_performance_data(pstl_csv)["pstl_task"]["pstl"] == "0.35"
+        assert load_performance_data_threads(pstl_csv)["pstl_task"]["pstl"] == "0.35"
+
+    def test_load_performance_data_threads_without_pstl_column(
+        self, sample_performance_csv
+    ):
+        """Test that tables written before the pstl type show it as unknown."""
+        result = load_performance_data_threads(sample_performance_csv)
+
+        assert result["example_task"]["stl"] == "0.3"
+        assert result["example_task"]["pstl"] == "?"
@@ -0,0 +1,114 @@
+"""
+Tests for the load_performance_records function.
+"""
+
+import json
+
+from main import load_performance_records
+
+
+def _write_records(path, records):
+    with open(path, "w") as f:
+        for record in records:
+            f.write((record if isinstance(record, str) else json.dumps(record)) + "\n")
+
+
+class TestLoadPerformanceRecords:
+    """Test cases for load_performance_records function."""
+
+    def test_load_performance_records_task_run_only(self, temp_dir):
+        """Only task_run records are used, keyed by task directory."""
+        records_path = temp_dir / "perf_records.jsonl"
+        _write_records(
+            records_path,
+            [
+                {
+                    "schema": "ppc.perf.v1",
+                    "task_dir": "example_threads",
+                    "implementation": "omp",
+                    "mode": "task_run",
+                    "time_sec": 0.25,
+                },
+                {
+                    "schema": "ppc.perf.v1",
+                    "task_dir": "example_threads",
+                    "implementation": "omp",
+                    "mode": "pipeline",
+                    "time_sec": 9.0,
+                },
+                {
+                    "schema": "ppc.perf.v1",
+                    "task_dir": "example_threads",
+                    "implementation": "seq",
+                    "mode": "task_run",
+                    "time_sec": 1.0,
+                },
+            ],
+        )
+
+        result = load_performance_records(records_path)
+
+        assert result == {"example_threads": {"omp": "0.25", "seq": "1.0"}}
+
+    def test_load_performance_records_skips_malformed_lines(self, temp_dir):
+        """Malformed and incomplete records are ignored."""
+        records_path = temp_dir / "perf_records.jsonl"
+        _write_records(
+            records_path,
+            [
+                "not json",
+                {"mode": "task_run", "implementation": "mpi", "time_sec": 1.0},
+                {
+                    "task_dir": "example_processes",
+                    "implementation": "mpi",
+                    "mode": "task_run",
+                    "time_sec": 0.5,
+                },
+            ],
+        )
+
+        result = load_performance_records(records_path)
+
+        assert result == {"example_processes": {"mpi": "0.5"}}
+
+    def test_load_performance_records_default_configuration_only(self, temp_dir):
+        """Scale sweeps, cold-cache runs and skewed inputs keep the default time."""
+        records_path = temp_dir / "perf_records.jsonl"
+        default = {
+            "task_dir": "example_threads",
+            "implementation": "omp",
+            "mode": "task_run",
+            "scale": 1.0,
+            "cache": "warm",
+            "distribution": None,
+            "time_sec": 0.25,
+        }
+        _write_records(
+            records_path,
+            [
+                default,
+                {**default, "scale": 4.0, "time_sec": 1.0},
+                {**default, "cache": "cold", "time_sec": 0.4},
+                {**default, "distribution": "zipf", "time_sec": 0.3},
+                {**default, "implementation": "seq", "time_sec": 1.0},
+                {**default, "implementation": "seq", "scale": 0.5, "time_sec": 0.5},
+                {
+                    **default,
+                    "implementation": "tbb",
+                    "distribution": "uniform",
+                    "time_sec": 0.5,
+                },
+            ],
+        )
+
+        result = load_performance_records(records_path)
+
+        assert result == {
+            "example_threads": {"omp": "0.25", "seq": "1.0", "tbb": "0.5"}
+        }
+
+    def test_load_performance_records_nonexistent_file(self, temp_dir):
+        """Missing records file yields no data."""
+        result = load_performance_records(temp_dir / "missing.jsonl")
+
+        assert result == {}
@@ -1,5 +1,7 @@
 import argparse
 import csv
+import json
+import math
 import os
 import re
 
@@ -10,7 +12,7 @@ import xlsxwriter
 # -------------------------------
 
 # Known task types (used to pre-initialize tables)
-list_of_type_of_tasks = ["all", "mpi", "omp", "seq", "stl", "tbb"]
+list_of_type_of_tasks = ["all", "mpi", "omp", "pstl", "seq", "stl", "tbb"]
 
 # Compile patterns once
 OLD_PATTERN = re.compile(r"tasks[\/|\\](\w*)[\/|\\](\w*):(\w*):(-*\d*\.\d*)")
@@ -22,10 +24,46 @@ NEW_PATTERN = re.compile(
 #   example_processes_2_mpi_enabled:pipeline:0.0507
 # Accept optional suffix after `_enabled` (e.g., `_enabled_size1000000`) before the colon
 SIMPLE_PATTERN = re.compile(
-    r"(.+?)_(omp|seq|tbb|stl|all|mpi)_enabled[^:]*:(task_run|pipeline):(-*\d*\.\d*)"
+    r"(.+?)_(omp|seq|tbb|pstl|stl|all|mpi)_enabled[^:]*:(task_run|pipeline):(-*\d*\.\d*)"
 )
 
 
+# Structured records emitted by the perf harness (one JSON object per line)
+PERF_RECORD_SCHEMA = "ppc.perf.v1"
+
+
+def _parse_perf_record(line: str) -> dict | None:
+    """Return the structured perf record on this log line, if any."""
+    line = line.strip()
+    if not line.startswith("{"):
+        return None
+    try:
+        record = json.loads(line)
+    except json.JSONDecodeError:
+        return None
+    if not isinstance(record, dict) or record.get("schema") != PERF_RECORD_SCHEMA:
+        return None
+    return record
+
+
+def _is_default_configuration(record: dict) -> bool:
+    """Whether a perf record was measured at scale 1, warm cache and the default input.
+
+    Scale sweeps, cold-cache runs and non-uniform input distributions write
+    records of their own; they stay in perf_records.jsonl but must not replace
+    the default time of a task in the tables. Same rule as the scoreboard.
+    """
+    try:
+        scale = float(record.get("scale", 1.0))
+    except (TypeError, ValueError):
+        return False
+    return (
+        math.isclose(scale, 1.0)
+        and record.get("cache", "warm") == "warm"
+        and record.get("distribution") in (None, "uniform")
+    )
+
+
 def _ensure_task_tables(result_tables: dict, perf_type: str, task_name: str) -> None:
     if perf_type not in result_tables:
         result_tables[perf_type] = {}
@@ -39,7 +77,9 @@ def _infer_category(task_name: str) -> str:
 
 def _columns_for_category(category: str) -> list[str]:
     return (
-        ["seq", "omp", "tbb", "stl", "all"] if category == "threads" else ["seq", "mpi"]
+        ["seq", "omp", "tbb", "stl", "pstl", "all"]
+        if category == "threads"
+        else ["seq", "mpi"]
     )
 
 
@@ -129,6 +169,46 @@ def _write_csv(path: str, header: list[str], tasks_list: list[str], table: dict)
             writer.writerow(row)
 
 
+def _write_roofline_csv(path: str, records: list[dict]):
+    """Write each record's position against the calibrated STREAM bandwidth and FLOP peak."""
+
+    def percent(value):
+        return round(value * 100.0, 2) if isinstance(value, (int, float)) else "?"
+
+    with open(path, "w", newline="") as csvfile:
+        writer = csv.writer(csvfile)
+        writer.writerow(
+            [
+                "Task",
+                "Impl",
+                "Mode",
+                "Workers",
+                "Bytes/s",
+                "% STREAM",
+                "Flop/byte",
+                "% Roofline",
+                "Bound",
+                "Host",
+            ]
+        )
+        for record in records:
+            roofline = record["roofline"]
+            writer.writerow(
+                [
+                    record["task"],
+                    record["implementation"],
+                    record["mode"],
+                    roofline.get("workers", "?"),
+                    roofline.get("bytes_per_sec", "?"),
+                    percent(roofline.get("stream_fraction")),
+                    roofline.get("intensity", "?"),
+                    percent(roofline.get("roofline_fraction")),
+                    roofline.get("bound", "?"),
+                    record.get("host", {}).get("hostname", "?"),
+                ]
+            )
+
+
 parser = argparse.ArgumentParser()
 parser.add_argument(
     "-i", "--input", help="Input file path (logs of perf tests, .txt)", required=True
@@ -149,6 +229,34 @@ tasks_by_category = {"threads": set(), "processes": set()}
 
 with open(logs_path, "r") as logs_file:
     logs_lines = logs_file.readlines()
+
+# Structured records carry task, implementation, mode and category explicitly;
+# the text patterns below only read logs from before the records existed.
+perf_records = []
+text_lines = []
+for line in logs_lines:
+    record = _parse_perf_record(line)
+    if record is None:
+        text_lines.append(line)
+        continue
+    perf_records.append(record)
+    if not _is_default_configuration(record):
+        continue
+    task_name = record["task"]
+    task_type = record["implementation"]
+    perf_type = record["mode"]
+    task_category = record.get("tasks_type")
+    if task_category not in tasks_by_category:
+        task_category = _infer_category(task_name)
+    _ensure_task_tables(result_tables, perf_type, task_name)
+    result_tables[perf_type][task_name][task_type] = float(record["time_sec"])
+    task_categories[task_name] = task_category
+    tasks_by_category[task_category].add(task_name)
+# The harness still prints a test_id:mode:time line next to every record, also
+# for scale sweeps, cold-cache and distribution runs, whose lines would replace
+# the default times above. Once records are present, they are the only source.
+logs_lines = [] if perf_records else text_lines
+
 for line in logs_lines:
     # Handle both old format: tasks/task_type/task_name:perf_type:time
     # and new format: namespace_task_type_enabled:perf_type:time
@@ -246,6 +354,14 @@ for line in logs_lines:
         tasks_by_category[task_category].add(task_name)
 
 
+if perf_records:
+    with open(os.path.join(xlsx_path, "perf_records.jsonl"), "w") as records_file:
+        for record in perf_records:
+            records_file.write(json.dumps(record) + "\n")
+    roofline_records = [r for r in perf_records if isinstance(r.get("roofline"), dict)]
+    if roofline_records:
+        _write_roofline_csv(os.path.join(xlsx_path, "roofline.csv"), roofline_records)
+
 for table_name, table_data in result_tables.items():
     # Prepare two workbooks/CSVs: threads and processes
     for category in ["threads", "processes"]:
@@ -2,3 +2,4 @@
 mkdir build\perf_stat_dir
 scripts/run_tests.py --running-type="performance" > build\perf_stat_dir\perf_log.txt
 python scripts\create_perf_table.py --input build\perf_stat_dir\perf_log.txt --output build\perf_stat_dir
+if exist build\perf_stat_dir\perf_records.jsonl python scripts\perf_history.py --records build\perf_stat_dir\perf_records.jsonl
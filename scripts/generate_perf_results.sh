@@ -4,3 +4,7 @@ set -euo pipefail
 mkdir -p build/perf_stat_dir
 scripts/run_tests.py --running-type="performance" | tee build/perf_stat_dir/perf_log.txt
 python3 scripts/create_perf_table.py --input build/perf_stat_dir/perf_log.txt --output build/perf_stat_dir
+# Keep every run in the history that the scoreboard's trend pages are built from
+if [[ -f build/perf_stat_dir/perf_records.jsonl ]]; then
+  python3 scripts/perf_history.py --records build/perf_stat_dir/perf_records.jsonl
+fi
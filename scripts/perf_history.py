@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Append structured perf records to a local history (JSON Lines) for trend views.
+
+Every ppc.perf.v1 record produced by a perf run is appended once, together with
+the commit, host and configuration it carries. Records already present (same
+test, configuration, host, commit and timestamp) are skipped, so appending the
+same run twice is harmless.
+
+Usage:
+  scripts/perf_history.py --records build/perf_stat_dir/perf_records.jsonl \
+    --history perf_history/perf_history.jsonl
+"""
+
+import argparse
+import json
+import os
+import sys
+from pathlib import Path
+
+PERF_RECORD_SCHEMA = "ppc.perf.v1"
+DEFAULT_HISTORY = Path("perf_history") / "perf_history.jsonl"
+
+
+def history_key(record: dict) -> tuple:
+    """Identity of one measurement: what ran, where, on which commit and when."""
+    return (
+        record.get("test_id"),
+        record.get("mode"),
+        record.get("threads"),
+        record.get("processes"),
+        record.get("scale"),
+        record.get("cache", "warm"),
+        record.get("distribution"),
+        (record.get("host") or {}).get("hostname"),
+        (record.get("build") or {}).get("git_sha"),
+        record.get("timestamp"),
+    )
+
+
+def read_records(path: Path) -> list[dict]:
+    """Read ppc.perf.v1 records from a JSON Lines file, skipping anything else."""
+    records = []
+    if not path.exists():
+        return records
+    with open(path, "r") as records_file:
+        for line in records_file:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue
+            try:
+                record = json.loads(line)
+            except json.JSONDecodeError:
+                continue
+            if isinstance(record, dict) and record.get("schema") == PERF_RECORD_SCHEMA:
+                records.append(record)
+    return records
+
+
+def append_records(records: list[dict], history_path: Path) -> int:
+    """Append the records not yet in the history; return how many were added."""
+    known = {history_key(record) for record in read_records(history_path)}
+    added = 0
+    history_path.parent.mkdir(parents=True, exist_ok=True)
+    with open(history_path, "a") as history_file:
+        for record in records:
+            key = history_key(record)
+            if key in known:
+                continue
+            known.add(key)
+            history_file.write(json.dumps(record, sort_keys=True) + "\n")
+            added += 1
+    return added
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--records",
+        required=True,
+        help="perf records of one run (perf_records.jsonl or a raw perf log)",
+    )
+    parser.add_argument(
+        "--history",
+        default=os.environ.get("PPC_PERF_HISTORY", str(DEFAULT_HISTORY)),
+        help="history file to append to (default: $PPC_PERF_HISTORY or %(default)s)",
+    )
+    args = parser.parse_args()
+
+    records = read_records(Path(args.records))
+    if not records:
+        print(f"No {PERF_RECORD_SCHEMA} records in {args.records}", file=sys.stderr)
+        return 1
+    added = append_records(records, Path(args.history))
+    print(
+        f"Appended {added} of {len(records)} perf records to {args.history}",
+        file=sys.stderr,
+    )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
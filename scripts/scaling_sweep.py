@@ -0,0 +1,391 @@
+#!/usr/bin/env python3
+"""Strong and weak scaling sweeps over thread or process counts.
+
+Runs the performance tests once per worker count with PPC_PERF_JSON set, then
+derives speedup, efficiency and the Karp-Flatt serial fraction for every task
+and implementation from the collected perf records. Each implementation is
+compared with its own 1-process, 1-thread run at scale 1.
+
+Strong scaling keeps the input fixed. Weak scaling sets PPC_PERF_SCALE to the
+worker count, so tasks that size their perf input with ScalePerfInputSize grow
+it with the number of workers. Tasks whose recorded input did not grow by the
+scale are left out of weak scaling tables.
+"""
+
+import argparse
+import csv
+import json
+import math
+import os
+import subprocess
+import sys
+from collections import defaultdict
+from pathlib import Path
+
+import xlsxwriter
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+PROJECT_DIR = SCRIPT_DIR.parent
+PERF_RECORD_SCHEMA = "ppc.perf.v1"
+COUNT_ENV = {"threads": "PPC_NUM_THREADS", "processes": "PPC_NUM_PROC"}
+# (processes, threads, scale) a perf record was measured with
+Config = tuple[int, int, float]
+BASELINE_CONFIG: Config = (1, 1, 1.0)
+# Relative slack when checking that a weak-scaling input grew by its scale
+# (multi-dimensional inputs are rounded per dimension)
+INPUT_GROWTH_TOLERANCE = 0.1
+
+
+def init_cmd_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--mode",
+        required=True,
+        choices=["strong", "weak"],
+        help="Strong scaling keeps the input fixed; weak scaling grows it with workers.",
+    )
+    parser.add_argument(
+        "--running-type",
+        required=True,
+        choices=["threads", "processes"],
+        help="Worker count to sweep: PPC_NUM_THREADS or PPC_NUM_PROC.",
+    )
+    parser.add_argument(
+        "--counts",
+        nargs="+",
+        type=int,
+        required=True,
+        help="Worker counts to run; include 1, the run speedups are measured against.",
+    )
+    parser.add_argument(
+        "--perf-type",
+        default="task_run",
+        choices=["task_run", "pipeline"],
+        help="Which perf mode the tables are built from. Default: 'task_run'.",
+    )
+    parser.add_argument(
+        "--build-dir",
+        default="build",
+        help="CMake build directory passed to run_tests.py. Default: 'build'.",
+    )
+    parser.add_argument(
+        "--output",
+        default="build/perf_stat_dir/scaling",
+        help="Directory for records, tables and charts.",
+    )
+    parser.add_argument(
+        "--records-only",
+        action="store_true",
+        help="Do not run tests; rebuild tables from records already in --output.",
+    )
+    return vars(parser.parse_args())
+
+
+def records_path(output_dir: Path, mode: str, running_type: str, count: int) -> Path:
+    return output_dir / f"records_{mode}_{running_type}_{count}.jsonl"
+
+
+def run_sweep(args: dict, output_dir: Path) -> None:
+    for count in args["counts"]:
+        path = records_path(output_dir, args["mode"], args["running_type"], count)
+        if path.exists():
+            path.unlink()
+
+        env = os.environ.copy()
+        env[COUNT_ENV[args["running_type"]]] = str(count)
+        for var in COUNT_ENV.values():
+            env.setdefault(var, "1")
+        env["PPC_PERF_SCALE"] = str(count) if args["mode"] == "weak" else "1"
+        env["PPC_PERF_JSON"] = str(path)
+
+        print(
+            f"Executing {args['mode']} scaling with {args['running_type']} count: {count}",
+            flush=True,
+        )
+        subprocess.run(
+            [
+                sys.executable,
+                str(SCRIPT_DIR / "run_tests.py"),
+                "--running-type=performance",
+                "--build-dir",
+                args["build_dir"],
+            ],
+            env=env,
+            check=True,
+            cwd=PROJECT_DIR,
+        )
+
+
+def _input_amount(record: dict) -> float | None:
+    """Input size of a record in bytes, else in elements; None when unknown."""
+    for field in ("input_bytes", "input_size"):
+        if record.get(field) is not None:
+            return float(record[field])
+    return None
+
+
+def load_times(
+    args: dict, output_dir: Path
+) -> tuple[
+    dict[tuple[str, str], dict[Config, float]],
+    dict[tuple[str, str], dict[Config, float | None]],
+]:
+    """Median time and input size per (task, implementation) and (processes, threads, scale).
+
+    The configuration is read from the record rather than taken from the sweep
+    count: a sequential implementation reports one process whatever PPC_NUM_PROC
+    was, and must not be mistaken for a run on that many processes.
+    """
+    times: dict[tuple[str, str], dict[Config, float]] = defaultdict(dict)
+    inputs: dict[tuple[str, str], dict[Config, float | None]] = defaultdict(dict)
+    for count in args["counts"]:
+        path = records_path(output_dir, args["mode"], args["running_type"], count)
+        if not path.exists():
+            print(f"No perf records for count {count} at {path}", file=sys.stderr)
+            continue
+        with open(path, "r") as records_file:
+            for line in records_file:
+                try:
+                    record = json.loads(line)
+                except json.JSONDecodeError:
+                    continue
+                if record.get("schema") != PERF_RECORD_SCHEMA:
+                    continue
+                if record.get("mode") != args["perf_type"]:
+                    continue
+                stats = record.get("stats") or {}
+                time_sec = stats.get("median", record.get("time_sec"))
+                if not time_sec or time_sec <= 0:
+                    continue
+                key = (record.get("task_dir") or record["task"], record["implementation"])
+                config = (
+                    int(record.get("processes", 1)),
+                    int(record.get("threads", 1)),
+                    float(record.get("scale", 1.0)),
+                )
+                # Identical configurations from several sweep counts: keep the fastest
+                time_sec = float(time_sec)
+                if time_sec < times[key].get(config, math.inf):
+                    times[key][config] = time_sec
+                    inputs[key][config] = _input_amount(record)
+    return times, inputs
+
+
+def _workers(config: Config, running_type: str) -> int:
+    processes, threads, _ = config
+    return processes if running_type == "processes" else threads
+
+
+def _in_sweep(config: Config, args: dict) -> bool:
+    """Whether a configuration belongs to this sweep.
+
+    The worker count not being swept must be 1, and the scale must be the one
+    the mode sets: 1 for strong scaling, the worker count for weak scaling.
+    """
+    processes, threads, scale = config
+    workers = _workers(config, args["running_type"])
+    other = threads if args["running_type"] == "processes" else processes
+    expected_scale = workers if args["mode"] == "weak" else 1
+    return other == 1 and math.isclose(scale, expected_scale)
+
+
+def weak_input_problem(
+    times: dict[Config, float], inputs: dict[Config, float | None], args: dict
+) -> str | None:
+    """Why a task's records cannot be used for weak scaling, or None if they can.
+
+    The scaled speedup assumes the work grew by the scale. A task that ignores
+    PPC_PERF_SCALE repeats the baseline input, and multiplying its speedup by
+    the worker count would credit it with work it never did.
+    """
+    base_input = inputs.get(BASELINE_CONFIG)
+    if base_input is None or base_input <= 0:
+        return "the baseline record has no input size"
+    for config in times:
+        if config == BASELINE_CONFIG or not _in_sweep(config, args):
+            continue
+        scale = config[2]
+        amount = inputs.get(config)
+        if amount is None or not math.isclose(
+            amount / base_input, scale, rel_tol=INPUT_GROWTH_TOLERANCE
+        ):
+            return f"its input did not grow by the scale {scale:g}"
+    return None
+
+
+def scaling_metrics(times: dict[Config, float], args: dict) -> list[dict]:
+    """Speedup, efficiency and Karp-Flatt serial fraction against the baseline run.
+
+    The baseline is the 1-process, 1-thread run at scale 1; without one there
+    are no rows. Weak scaling uses the scaled (Gustafson) speedup
+    p * T(1) / T(p), since the work grows with the number of workers.
+    """
+    base_time = times.get(BASELINE_CONFIG)
+    if base_time is None:
+        return []
+    points = sorted(
+        (config for config in times if _in_sweep(config, args)),
+        key=lambda config: _workers(config, args["running_type"]),
+    )
+    rows = []
+    for config in points:
+        workers = _workers(config, args["running_type"])
+        speedup = base_time / times[config]
+        if args["mode"] == "weak":
+            speedup *= workers
+        efficiency = speedup / workers
+        karp_flatt = None
+        if workers > 1:
+            karp_flatt = (1 / speedup - 1 / workers) / (1 - 1 / workers)
+        rows.append(
+            {
+                "workers": workers,
+                "time_sec": times[config],
+                "ideal": workers,
+                "speedup": speedup,
+                "efficiency": efficiency,
+                "karp_flatt": karp_flatt,
+                "processes": config[0],
+                "threads": config[1],
+                "scale": config[2],
+            }
+        )
+    return rows
+
+
+def _sheet_name(task: str, used: set[str]) -> str:
+    # Excel limits sheet names to 31 characters and needs them unique
+    base = task[:31]
+    name = base
+    suffix = 1
+    while name in used:
+        suffix += 1
+        name = f"{base[: 31 - len(str(suffix)) - 1]}~{suffix}"
+    used.add(name)
+    return name
+
+
+def write_tables(
+    metrics: dict[tuple[str, str], list[dict]], args: dict, output_dir: Path
+) -> None:
+    stem = f"{args['mode']}_{args['running_type']}_scaling"
+    columns = [
+        "workers",
+        "time_sec",
+        "ideal",
+        "speedup",
+        "efficiency",
+        "karp_flatt",
+        "processes",
+        "threads",
+        "scale",
+    ]
+
+    with open(output_dir / f"{stem}.csv", "w", newline="") as csvfile:
+        writer = csv.writer(csvfile)
+        writer.writerow(["task", "implementation"] + columns)
+        for (task, impl), rows in sorted(metrics.items()):
+            for row in rows:
+                values = [row[c] if row[c] is not None else "—" for c in columns]
+                writer.writerow([task, impl] + values)
+
+    workbook = xlsxwriter.Workbook(str(output_dir / f"{stem}.xlsx"))
+    bold = workbook.add_format({"bold": True, "bottom": 2})
+    number = workbook.add_format({"num_format": "0.0000"})
+    by_task: dict[str, list[tuple[str, list[dict]]]] = defaultdict(list)
+    for (task, impl), rows in sorted(metrics.items()):
+        by_task[task].append((impl, rows))
+
+    used_names: set[str] = set()
+    for task, impl_rows in by_task.items():
+        worksheet = workbook.add_worksheet(_sheet_name(task, used_names))
+        worksheet.set_column("A:J", 14)
+        worksheet.write_row(0, 0, ["implementation"] + columns, bold)
+        speedup_chart = workbook.add_chart(
+            {"type": "scatter", "subtype": "straight_with_markers"}
+        )
+        efficiency_chart = workbook.add_chart(
+            {"type": "scatter", "subtype": "straight_with_markers"}
+        )
+        row_idx = 1
+        for impl, rows in impl_rows:
+            first = row_idx
+            for row in rows:
+                worksheet.write(row_idx, 0, impl)
+                for col, name in enumerate(columns, start=1):
+                    value = row[name]
+                    worksheet.write(row_idx, col, "—" if value is None else value, number)
+                row_idx += 1
+            last = row_idx - 1
+            sheet = worksheet.get_name()
+            speedup_chart.add_series(
+                {
+                    "name": impl,
+                    "categories": [sheet, first, 1, last, 1],
+                    "values": [sheet, first, 4, last, 4],
+                }
+            )
+            efficiency_chart.add_series(
+                {
+                    "name": impl,
+                    "categories": [sheet, first, 1, last, 1],
+                    "values": [sheet, first, 5, last, 5],
+                }
+            )
+        if impl_rows:
+            _, ideal_rows = impl_rows[0]
+            sheet = worksheet.get_name()
+            speedup_chart.add_series(
+                {
+                    "name": "ideal",
+                    "categories": [sheet, 1, 1, len(ideal_rows), 1],
+                    "values": [sheet, 1, 3, len(ideal_rows), 3],
+                    "line": {"dash_type": "dash"},
+                }
+            )
+        for chart, title in (
+            (speedup_chart, "Speedup"),
+            (efficiency_chart, "Efficiency"),
+        ):
+            chart.set_title({"name": f"{task}: {title.lower()} ({args['mode']})"})
+            chart.set_x_axis({"name": args["running_type"]})
+            chart.set_y_axis({"name": title})
+        worksheet.insert_chart(row_idx + 1, 0, speedup_chart)
+        worksheet.insert_chart(row_idx + 1, 8, efficiency_chart)
+    workbook.close()
+
+
+def main():
+    args = init_cmd_args()
+    output_dir = Path(args["output"])
+    if not output_dir.is_absolute():
+        output_dir = PROJECT_DIR / output_dir
+    output_dir.mkdir(parents=True, exist_ok=True)
+
+    if not args["records_only"]:
+        run_sweep(args, output_dir)
+
+    times, inputs = load_times(args, output_dir)
+    metrics = {}
+    for (task, impl), per_config in sorted(times.items()):
+        if args["mode"] == "weak" and BASELINE_CONFIG in per_config:
+            problem = weak_input_problem(per_config, inputs[(task, impl)], args)
+            if problem is not None:
+                print(f"{task} ({impl}) skipped: {problem}", file=sys.stderr)
+                continue
+        rows = scaling_metrics(per_config, args)
+        if rows:
+            metrics[(task, impl)] = rows
+        else:
+            print(
+                f"No 1-process, 1-thread record for {task} ({impl}); skipped",
+                file=sys.stderr,
+            )
+    if not metrics:
+        raise SystemExit("No perf records collected; nothing to tabulate.")
+    write_tables(metrics, args, output_dir)
+    print(f"Scaling tables written to {output_dir}")
+
+
+if __name__ == "__main__":
+    main()
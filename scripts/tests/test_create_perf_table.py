@@ -0,0 +1,71 @@
+"""
+Tests for scripts/create_perf_table.py.
+"""
+
+import csv
+import json
+import os
+import subprocess
+import sys
+from pathlib import Path
+
+SCRIPT = Path(__file__).resolve().parents[1] / "create_perf_table.py"
+
+
+def _record(time_sec, **overrides):
+    record = {
+        "schema": "ppc.perf.v1",
+        "task": "example_threads",
+        "implementation": "omp",
+        "mode": "pipeline",
+        "tasks_type": "threads",
+        "time_sec": time_sec,
+        "scale": 1.0,
+        "cache": "warm",
+        "distribution": "uniform",
+    }
+    record.update(overrides)
+    return json.dumps(record)
+
+
+def _run(tmp_path, lines):
+    log_path = tmp_path / "perf_log.txt"
+    log_path.write_text("\n".join(lines) + "\n")
+    env = dict(os.environ, PPC_NUM_THREADS="4", PPC_NUM_PROC="4")
+    subprocess.run(
+        [sys.executable, str(SCRIPT), "-i", str(log_path), "-o", str(tmp_path)],
+        check=True,
+        env=env,
+    )
+    with open(tmp_path / "threads_pipeline_perf_table.csv", newline="") as f:
+        return {row["Task"]: row for row in csv.DictReader(f)}
+
+
+class TestCreatePerfTable:
+    """Test cases for the tables built from perf logs."""
+
+    def test_text_lines_do_not_replace_default_record(self, tmp_path):
+        """Suffixed and cold text lines of the same run leave the default time alone."""
+        prefix = "ppc_perf_tests_example_threads_omp_enabled"
+        table = _run(
+            tmp_path,
+            [
+                _record(0.5),
+                f"{prefix}:pipeline:0.5",
+                _record(1.0, scale=2.0),
+                f"{prefix}_x2:pipeline:1.0",
+                _record(0.7, distribution="zipf"),
+                f"{prefix}_zipf:pipeline:0.7",
+                _record(0.9, cache="cold"),
+                f"{prefix}:pipeline:0.9",
+            ],
+        )
+        assert list(table) == ["example_threads"]
+        assert float(table["example_threads"]["OMP"]) == 0.5
+
+    def test_text_only_log_still_fills_table(self, tmp_path):
+        """Logs without records are read from the text lines."""
+        table = _run(
+            tmp_path, ["ppc_perf_tests_example_threads_omp_enabled:pipeline:0.25"]
+        )
+        assert float(table["ppc_perf_tests_example_threads"]["OMP"]) == 0.25
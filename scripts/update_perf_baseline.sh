@@ -0,0 +1,10 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Re-run performance tests and store their samples as the new baseline.
+# Compare later runs with: PPC_PERF_BASELINE_DIR=<dir> scripts/run_tests.py --running-type="performance"
+export PPC_PERF_BASELINE_DIR="${PPC_PERF_BASELINE_DIR:-build/perf_baseline}"
+export PPC_PERF_BASELINE=update
+
+mkdir -p "${PPC_PERF_BASELINE_DIR}"
+scripts/run_tests.py --running-type="performance" "$@"
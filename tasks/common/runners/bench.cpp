@@ -0,0 +1,5 @@
+#include "runners/include/bench.hpp"
+
+int main(int argc, char **argv) {
+  return ppc::runners::BenchMain(argc, argv);
+}
@@ -0,0 +1,5 @@
+#include "runners/include/comm_bench.hpp"
+
+int main(int argc, char **argv) {
+  return ppc::runners::CommBenchMain(argc, argv);
+}
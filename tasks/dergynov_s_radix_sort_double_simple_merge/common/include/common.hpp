@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <string>
@@ -7,6 +9,7 @@
 #include <vector>
 
 #include "task/include/task.hpp"
+#include "util/include/tunables.hpp"
 
 namespace dergynov_s_radix_sort_double_simple_merge {
 
@@ -15,6 +18,22 @@ using OutType = std::tuple<std::vector<double>, int>;
 using TestType = std::tuple<std::tuple<std::vector<double>, std::vector<double>>, std::string>;
 using BaseTask = ppc::task::Task<InType, OutType>;
 
+/// @brief Bits per radix digit of the sort in the implementation of type @p kType, tuned separately for each.
+/// @details Wider digits mean fewer passes over the keys but larger count tables; the best width depends on the cache
+/// sizes.
+template <ppc::task::TypeOfTask kType>
+inline const ppc::util::Tunable kRadixBits({.task = "dergynov_s_radix_sort_double_simple_merge",
+                                            .implementation = ppc::task::TypeOfTaskToString(kType),
+                                            .name = "radix_bits",
+                                            .default_value = 8,
+                                            .candidates = ppc::util::LinearRange(4, 16, 4)});
+
+/// @brief Digit width, in [1, 16], the implementation of type @p kType uses for @p elements elements.
+template <ppc::task::TypeOfTask kType>
+int GetRadixBits(std::size_t elements) {
+  return static_cast<int>(std::clamp<int64_t>(kRadixBits<kType>.Get(elements), 1, 16));
+}
+
 inline uint64_t DoubleToSortableUint64(double d) {
   uint64_t u = 0;
   std::memcpy(&u, &d, sizeof(double));
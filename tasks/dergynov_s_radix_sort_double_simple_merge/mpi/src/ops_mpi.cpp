@@ -9,37 +9,39 @@
 #include <vector>
 
 #include "dergynov_s_radix_sort_double_simple_merge/common/include/common.hpp"
+#include "mpi/include/collectives.hpp"
+#include "mpi/include/distribution.hpp"
+#include "simd/include/simd.hpp"
 
 namespace dergynov_s_radix_sort_double_simple_merge {
 namespace {
 
-void RadixSortDoubles(std::vector<double> &data) {
+void RadixSortDoubles(std::vector<double> &data, int radix_bits) {
   if (data.size() <= 1) {
     return;
   }
 
   std::vector<uint64_t> keys(data.size());
-  for (size_t i = 0; i < data.size(); ++i) {
-    keys[i] = DoubleToSortableUint64(data[i]);
-  }
+  ppc::simd::ToSortableKeys(data, keys);
 
-  const int k_radix = 256;
+  const size_t k_radix = size_t{1} << radix_bits;
+  const uint64_t mask = k_radix - 1;
   std::vector<uint64_t> temp(data.size());
 
-  for (int shift = 0; shift < 64; shift += 8) {
+  for (int shift = 0; shift < 64; shift += radix_bits) {
     std::vector<size_t> count(k_radix + 1, 0);
 
     for (uint64_t key : keys) {
-      uint8_t digit = (key >> shift) & 0xFF;
+      uint64_t digit = (key >> shift) & mask;
       ++count[digit + 1];
     }
 
-    for (int i = 0; i < k_radix; ++i) {
+    for (size_t i = 0; i < k_radix; ++i) {
       count[i + 1] += count[i];
     }
 
     for (uint64_t key : keys) {
-      uint8_t digit = (key >> shift) & 0xFF;
+      uint64_t digit = (key >> shift) & mask;
       size_t pos = count[digit];
       temp[pos] = key;
       ++count[digit];
@@ -48,9 +50,7 @@ void RadixSortDoubles(std::vector<double> &data) {
     keys.swap(temp);
   }
 
-  for (size_t i = 0; i < data.size(); ++i) {
-    data[i] = SortableUint64ToDouble(keys[i]);
-  }
+  ppc::simd::FromSortableKeys(keys, data);
 }
 
 std::vector<double> MergeSorted(const std::vector<double> &a, const std::vector<double> &b) {
@@ -101,44 +101,25 @@ bool DergynovSRadixSortDoubleSimpleMergeMPI::RunImpl() {
   MPI_Comm_size(MPI_COMM_WORLD, &size);
 
   const auto &input = GetInput();
-  int n = static_cast<int>(input.size());
-
-  MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-  std::vector<int> counts(size);
-  std::vector<int> displs(size);
-
-  int base = n / size;
-  int rem = n % size;
-  int offset = 0;
-
-  for (int i = 0; i < size; ++i) {
-    counts[i] = base + (i < rem ? 1 : 0);
-    displs[i] = offset;
-    offset += counts[i];
-  }
-
-  std::vector<double> local_data(counts[rank]);
+  const auto n = static_cast<std::size_t>(ppc::mpi::Bcast<uint64_t>(input.size(), 0, MPI_COMM_WORLD));
 
-  MPI_Scatterv(rank == 0 ? input.data() : nullptr, counts.data(), displs.data(), MPI_DOUBLE, local_data.data(),
-               counts[rank], MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  const auto &plan = ppc::mpi::GetBlockPlan(n, MPI_COMM_WORLD);
+  std::vector<double> local_data(plan.LocalSize(rank));
+  ppc::mpi::Scatter<double>(plan, input, local_data, 0, MPI_COMM_WORLD);
 
-  RadixSortDoubles(local_data);
+  RadixSortDoubles(local_data, GetRadixBits<ppc::task::TypeOfTask::kMPI>(n));
 
   if (rank == 0) {
     result_ = std::move(local_data);
 
+    // The plan already tells every part's size, so only the data travels
     for (int proc = 1; proc < size; ++proc) {
-      int recv_count = 0;
-      MPI_Recv(&recv_count, 1, MPI_INT, proc, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-      std::vector<double> part(recv_count);
-      MPI_Recv(part.data(), recv_count, MPI_DOUBLE, proc, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      std::vector<double> part(plan.LocalSize(proc));
+      ppc::mpi::Recv<double>(part, proc, 1, MPI_COMM_WORLD);
       result_ = MergeSorted(result_, part);
     }
   } else {
-    int send_count = static_cast<int>(local_data.size());
-    MPI_Send(&send_count, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-    MPI_Send(local_data.data(), send_count, MPI_DOUBLE, 0, 1, MPI_COMM_WORLD);
+    ppc::mpi::Send<double>(local_data, 0, 1, MPI_COMM_WORLD);
   }
 
   std::get<1>(GetOutput()) = rank;
@@ -6,37 +6,37 @@
 #include <vector>
 
 #include "dergynov_s_radix_sort_double_simple_merge/common/include/common.hpp"
+#include "simd/include/simd.hpp"
 
 namespace dergynov_s_radix_sort_double_simple_merge {
 namespace {
 
-void RadixSortDoubles(std::vector<double> &data) {
+void RadixSortDoubles(std::vector<double> &data, int radix_bits) {
   if (data.size() <= 1) {
     return;
   }
 
   std::vector<uint64_t> keys(data.size());
-  for (size_t i = 0; i < data.size(); ++i) {
-    keys[i] = DoubleToSortableUint64(data[i]);
-  }
+  ppc::simd::ToSortableKeys(data, keys);
 
-  const int k_radix = 256;
+  const size_t k_radix = size_t{1} << radix_bits;
+  const uint64_t mask = k_radix - 1;
   std::vector<uint64_t> temp(data.size());
 
-  for (int shift = 0; shift < 64; shift += 8) {
+  for (int shift = 0; shift < 64; shift += radix_bits) {
     std::vector<size_t> count(k_radix + 1, 0);
 
     for (uint64_t key : keys) {
-      uint8_t digit = (key >> shift) & 0xFF;
+      uint64_t digit = (key >> shift) & mask;
       ++count[digit + 1];
     }
 
-    for (int i = 0; i < k_radix; ++i) {
+    for (size_t i = 0; i < k_radix; ++i) {
       count[i + 1] += count[i];
     }
 
     for (uint64_t key : keys) {
-      uint8_t digit = (key >> shift) & 0xFF;
+      uint64_t digit = (key >> shift) & mask;
       size_t pos = count[digit];
       temp[pos] = key;
       ++count[digit];
@@ -45,9 +45,7 @@ void RadixSortDoubles(std::vector<double> &data) {
     keys.swap(temp);
   }
 
-  for (size_t i = 0; i < data.size(); ++i) {
-    data[i] = SortableUint64ToDouble(keys[i]);
-  }
+  ppc::simd::FromSortableKeys(keys, data);
 }
 
 }  // namespace
@@ -71,7 +69,7 @@ bool DergynovSRadixSortDoubleSimpleMergeSEQ::PreProcessingImpl() {
 
 bool DergynovSRadixSortDoubleSimpleMergeSEQ::RunImpl() {
   sorted_ = GetInput();
-  RadixSortDoubles(sorted_);
+  RadixSortDoubles(sorted_, GetRadixBits<ppc::task::TypeOfTask::kSEQ>(sorted_.size()));
   return true;
 }
 
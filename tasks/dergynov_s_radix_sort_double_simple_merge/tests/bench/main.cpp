@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "dergynov_s_radix_sort_double_simple_merge/common/include/common.hpp"
+#include "dergynov_s_radix_sort_double_simple_merge/mpi/include/ops_mpi.hpp"
+#include "dergynov_s_radix_sort_double_simple_merge/seq/include/ops_seq.hpp"
+#include "util/include/bench_registry.hpp"
+#include "util/include/workload.hpp"
+
+namespace dergynov_s_radix_sort_double_simple_merge {
+
+namespace {
+
+std::vector<std::pair<std::string, ppc::util::BenchGenerator<InType>>> MakeGenerators() {
+  std::vector<std::pair<std::string, ppc::util::BenchGenerator<InType>>> generators;
+  for (const auto distribution : ppc::util::workload::kDistributions) {
+    generators.emplace_back(std::string(ppc::util::workload::GetDistributionName(distribution)),
+                            [distribution](std::size_t size, uint64_t seed) {
+                              return ppc::util::workload::GenerateValues(distribution, size, -1000.0, 1000.0,
+                                                                         {.seed = seed});
+                            });
+  }
+  return generators;
+}
+
+const ppc::util::BenchInputs<InType, OutType> kBenchInputs{
+    .default_size = 1000000,
+    .generators = MakeGenerators(),
+    .check = [](const InType &input, const OutType &output) {
+      // Only rank 0 of the MPI version gathers the result; the others report their rank
+      if (std::get<1>(output) > 0) {
+        return true;
+      }
+      auto expected = input;
+      std::ranges::sort(expected);
+      return std::get<0>(output) == expected;
+    },
+    // Radix sort moves keys without floating-point arithmetic, so it has no FLOP count for the roofline
+    .flops = {}};
+
+const bool kBenchRegistered =
+    ppc::util::RegisterBenchTasks<DergynovSRadixSortDoubleSimpleMergeMPI, DergynovSRadixSortDoubleSimpleMergeSEQ>(
+        PPC_ID_dergynov_s_radix_sort_double_simple_merge, PPC_SETTINGS_dergynov_s_radix_sort_double_simple_merge,
+        kBenchInputs);
+
+}  // namespace
+
+}  // namespace dergynov_s_radix_sort_double_simple_merge
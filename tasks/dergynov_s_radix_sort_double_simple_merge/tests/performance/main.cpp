@@ -3,11 +3,12 @@
 
 #include <algorithm>
 #include <cstddef>
-#include <random>
 #include <vector>
 
 #include "dergynov_s_radix_sort_double_simple_merge/mpi/include/ops_mpi.hpp"
 #include "dergynov_s_radix_sort_double_simple_merge/seq/include/ops_seq.hpp"
+#include "util/include/perf_test_util.hpp"
+#include "util/include/workload.hpp"
 
 namespace dergynov_s_radix_sort_double_simple_merge {
 namespace {
@@ -41,13 +42,7 @@ class DergynovRadixSortPerfTests : public ::testing::Test {
  protected:
   void SetUp() override {
     const size_t k_data_size = 1000000;
-    data.resize(k_data_size);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
-    for (size_t i = 0; i < k_data_size; ++i) {
-      data[i] = dist(gen);
-    }
+    data = ppc::util::workload::GenerateValues(ppc::util::PerfInputDistribution(), k_data_size, -1000.0, 1000.0);
   }
 
   std::vector<double> data;
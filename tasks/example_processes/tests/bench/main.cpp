@@ -0,0 +1,23 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "example_processes/common/include/common.hpp"
+#include "example_processes/mpi/include/ops_mpi.hpp"
+#include "example_processes/seq/include/ops_seq.hpp"
+#include "util/include/bench_registry.hpp"
+
+namespace nesterov_a_test_task_processes {
+
+namespace {
+
+const ppc::util::BenchInputs<InType, OutType> kBenchInputs{
+    .default_size = 100,
+    .generators = {{"count", [](std::size_t size, uint64_t /*seed*/) { return static_cast<InType>(size); }}},
+    .check = [](const InType &input, const OutType &output) { return input == output; }};
+
+const bool kBenchRegistered = ppc::util::RegisterBenchTasks<NesterovATestTaskMPI, NesterovATestTaskSEQ>(
+    PPC_ID_example_processes, PPC_SETTINGS_example_processes, kBenchInputs);
+
+}  // namespace
+
+}  // namespace nesterov_a_test_task_processes
@@ -12,7 +12,7 @@ class ExampleRunPerfTestProcesses2 : public ppc::util::BaseRunPerfTests<InType,
   InType input_data_{};
 
   void SetUp() override {
-    input_data_ = kCount_;
+    input_data_ = ppc::util::ScalePerfInputSize(kCount_);
   }
 
   bool CheckTestOutputData(OutType &output_data) final {
@@ -33,7 +33,7 @@ namespace {
 const auto kAllPerfTasks =
     ppc::util::MakeAllPerfTasks<InType, NesterovATestTaskMPI, NesterovATestTaskSEQ>(PPC_SETTINGS_example_processes_2);
 
-const auto kGtestValues = ppc::util::TupleToGTestValues(kAllPerfTasks);
+const auto kGtestValues = ppc::util::TupleToScaledGTestValues(kAllPerfTasks);
 
 const auto kPerfTestName = ExampleRunPerfTestProcesses2::CustomPerfTestName;
 
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "example_threads/common/include/common.hpp"
+#include "task/include/task.hpp"
+
+namespace nesterov_a_test_task_threads {
+
+class NesterovATestTaskPSTL : public BaseTask {
+ public:
+  static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
+    return ppc::task::TypeOfTask::kPSTL;
+  }
+  explicit NesterovATestTaskPSTL(const InType &in);
+
+ private:
+  bool ValidationImpl() override;
+  bool PreProcessingImpl() override;
+  bool RunImpl() override;
+  bool PostProcessingImpl() override;
+};
+
+}  // namespace nesterov_a_test_task_threads
@@ -0,0 +1,56 @@
+#include "example_threads/pstl/include/ops_pstl.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#include "example_threads/common/include/common.hpp"
+#include "util/include/util.hpp"
+
+namespace nesterov_a_test_task_threads {
+
+NesterovATestTaskPSTL::NesterovATestTaskPSTL(const InType &in) {
+  SetTypeOfTask(GetStaticTypeOfTask());
+  GetInput() = in;
+  GetOutput() = 0;
+}
+
+bool NesterovATestTaskPSTL::ValidationImpl() {
+  return (GetInput() > 0) && (GetOutput() == 0);
+}
+
+bool NesterovATestTaskPSTL::PreProcessingImpl() {
+  GetOutput() = 2 * GetInput();
+  return GetOutput() > 0;
+}
+
+bool NesterovATestTaskPSTL::RunImpl() {
+  for (InType i = 0; i < GetInput(); i++) {
+    for (InType j = 0; j < GetInput(); j++) {
+      for (InType k = 0; k < GetInput(); k++) {
+        std::vector<InType> tmp(i + j + k, 1);
+        GetOutput() += std::reduce(std::execution::par, tmp.begin(), tmp.end(), 0);
+        GetOutput() -= i + j + k;
+      }
+    }
+  }
+
+  const int num_threads = ppc::util::GetNumThreads();
+  GetOutput() *= num_threads;
+
+  std::atomic<int> counter(0);
+  std::vector<int> workers(num_threads);
+  std::for_each(std::execution::par, workers.begin(), workers.end(), [&](int /*worker*/) { counter++; });
+
+  GetOutput() /= counter;
+  return GetOutput() > 0;
+}
+
+bool NesterovATestTaskPSTL::PostProcessingImpl() {
+  GetOutput() -= GetInput();
+  return GetOutput() > 0;
+}
+
+}  // namespace nesterov_a_test_task_threads
@@ -0,0 +1,29 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "example_threads/all/include/ops_all.hpp"
+#include "example_threads/common/include/common.hpp"
+#include "example_threads/omp/include/ops_omp.hpp"
+#include "example_threads/pstl/include/ops_pstl.hpp"
+#include "example_threads/seq/include/ops_seq.hpp"
+#include "example_threads/stl/include/ops_stl.hpp"
+#include "example_threads/tbb/include/ops_tbb.hpp"
+#include "util/include/bench_registry.hpp"
+
+namespace nesterov_a_test_task_threads {
+
+namespace {
+
+const ppc::util::BenchInputs<InType, OutType> kBenchInputs{
+    .default_size = 200,
+    .generators = {{"count", [](std::size_t size, uint64_t /*seed*/) { return static_cast<InType>(size); }}},
+    .check = [](const InType &input, const OutType &output) { return input == output; }};
+
+const bool kBenchRegistered =
+    ppc::util::RegisterBenchTasks<NesterovATestTaskALL, NesterovATestTaskOMP, NesterovATestTaskPSTL,
+                                  NesterovATestTaskSEQ, NesterovATestTaskSTL, NesterovATestTaskTBB>(
+        PPC_ID_example_threads, PPC_SETTINGS_example_threads, kBenchInputs);
+
+}  // namespace
+
+}  // namespace nesterov_a_test_task_threads
@@ -3,6 +3,7 @@
 #include "example_threads/all/include/ops_all.hpp"
 #include "example_threads/common/include/common.hpp"
 #include "example_threads/omp/include/ops_omp.hpp"
+#include "example_threads/pstl/include/ops_pstl.hpp"
 #include "example_threads/seq/include/ops_seq.hpp"
 #include "example_threads/stl/include/ops_stl.hpp"
 #include "example_threads/tbb/include/ops_tbb.hpp"
@@ -15,7 +16,7 @@ class ExampleRunPerfTestThreads : public ppc::util::BaseRunPerfTests<InType, Out
   InType input_data_{};
 
   void SetUp() override {
-    input_data_ = kCount_;
+    input_data_ = ppc::util::ScalePerfInputSize(kCount_);
   }
 
   bool CheckTestOutputData(OutType &output_data) final {
@@ -34,10 +35,11 @@ TEST_P(ExampleRunPerfTestThreads, RunPerfModes) {
 namespace {
 
 const auto kAllPerfTasks =
-    ppc::util::MakeAllPerfTasks<InType, NesterovATestTaskALL, NesterovATestTaskOMP, NesterovATestTaskSEQ,
-                                NesterovATestTaskSTL, NesterovATestTaskTBB>(PPC_SETTINGS_example_threads);
+    ppc::util::MakeAllPerfTasks<InType, NesterovATestTaskALL, NesterovATestTaskOMP, NesterovATestTaskPSTL,
+                                NesterovATestTaskSEQ, NesterovATestTaskSTL, NesterovATestTaskTBB>(
+        PPC_SETTINGS_example_threads);
 
-const auto kGtestValues = ppc::util::TupleToGTestValues(kAllPerfTasks);
+const auto kGtestValues = ppc::util::TupleToScaledGTestValues(kAllPerfTasks);
 
 const auto kPerfTestName = ExampleRunPerfTestThreads::CustomPerfTestName;
 
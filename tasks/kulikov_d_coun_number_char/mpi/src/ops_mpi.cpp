@@ -4,11 +4,15 @@
 
 #include <algorithm>
 #include <cstddef>
-#include <string>
-#include <utility>
+#include <cstdint>
+#include <limits>
+#include <span>
 #include <vector>
 
 #include "kulikov_d_coun_number_char/common/include/common.hpp"
+#include "mpi/include/collectives.hpp"
+#include "mpi/include/distribution.hpp"
+#include "simd/include/simd.hpp"
 
 namespace kulikov_d_coun_number_char {
 
@@ -22,7 +26,12 @@ KulikovDiffCountNumberCharMPI::KulikovDiffCountNumberCharMPI(const InType &in) {
 }
 
 bool KulikovDiffCountNumberCharMPI::ValidationImpl() {
-  return true;
+  // Every character of the longer string may differ and OutType is int, so a longer string would wrap the count;
+  // only the root holds the input, so its verdict is shared with the other ranks
+  const auto &[s1, s2] = GetInput();
+  const auto max_count = static_cast<size_t>(std::numeric_limits<OutType>::max());
+  const int fits = (proc_rank_ == 0 && std::max(s1.size(), s2.size()) > max_count) ? 0 : 1;
+  return ppc::mpi::Bcast(fits, 0, MPI_COMM_WORLD) == 1;
 }
 
 bool KulikovDiffCountNumberCharMPI::PreProcessingImpl() {
@@ -30,63 +39,25 @@ bool KulikovDiffCountNumberCharMPI::PreProcessingImpl() {
 }
 
 bool KulikovDiffCountNumberCharMPI::RunImpl() {
-  std::string s1;
-  std::string s2;
-  size_t len1 = 0;
-  size_t len2 = 0;
-
-  if (proc_rank_ == 0) {
-    const auto &input = GetInput();
-    s1 = input.first;
-    s2 = input.second;
-    len1 = s1.size();
-    len2 = s2.size();
-  }
-
-  MPI_Bcast(&len1, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-  MPI_Bcast(&len2, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-
-  const size_t min_len = std::min(len1, len2);
-  const size_t max_len = std::max(len1, len2);
-  const size_t base = min_len / proc_size_;
-  const size_t rem = min_len % proc_size_;
-
-  std::vector<int> send_counts(proc_size_);
-  std::vector<int> displs(proc_size_);
-
-  if (proc_rank_ == 0) {
-    size_t offset = 0;
-    for (int i = 0; i < proc_size_; ++i) {
-      send_counts[i] = static_cast<int>(base + (std::cmp_less(i, rem) ? 1 : 0));
-      displs[i] = static_cast<int>(offset);
-      offset += send_counts[i];
-    }
-  }
-
-  MPI_Bcast(send_counts.data(), proc_size_, MPI_INT, 0, MPI_COMM_WORLD);
-  MPI_Bcast(displs.data(), proc_size_, MPI_INT, 0, MPI_COMM_WORLD);
-
-  const size_t local_size = base + (std::cmp_less(proc_rank_, rem) ? 1 : 0);
-
-  std::vector<char> local_s1(local_size);
-  std::vector<char> local_s2(local_size);
-
-  MPI_Scatterv(proc_rank_ == 0 ? const_cast<char *>(s1.data()) : nullptr, send_counts.data(), displs.data(), MPI_CHAR,
-               local_s1.data(), static_cast<int>(local_size), MPI_CHAR, 0, MPI_COMM_WORLD);
-
-  MPI_Scatterv(proc_rank_ == 0 ? const_cast<char *>(s2.data()) : nullptr, send_counts.data(), displs.data(), MPI_CHAR,
-               local_s2.data(), static_cast<int>(local_size), MPI_CHAR, 0, MPI_COMM_WORLD);
-
-  int local_diff = 0;
-  for (size_t i = 0; i < local_size; ++i) {
-    if (local_s1[i] != local_s2[i]) {
-      local_diff++;
-    }
-  }
-
-  int global_diff = 0;
-  MPI_Allreduce(&local_diff, &global_diff, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  GetOutput() = global_diff + static_cast<int>(max_len - min_len);
+  const auto &input = GetInput();
+  const uint64_t len1 = ppc::mpi::Bcast<uint64_t>(proc_rank_ == 0 ? input.first.size() : 0, 0, MPI_COMM_WORLD);
+  const uint64_t len2 = ppc::mpi::Bcast<uint64_t>(proc_rank_ == 0 ? input.second.size() : 0, 0, MPI_COMM_WORLD);
+
+  const auto min_len = static_cast<size_t>(std::min(len1, len2));
+  const auto max_len = static_cast<size_t>(std::max(len1, len2));
+  const auto &plan = ppc::mpi::GetBlockPlan(min_len, MPI_COMM_WORLD);
+  std::vector<char> local_s1(plan.LocalSize(proc_rank_));
+  std::vector<char> local_s2(plan.LocalSize(proc_rank_));
+
+  // Only the common prefix is compared, so the root sends that much of each string
+  ppc::mpi::Scatter<char>(plan, std::span<const char>(input.first).first(proc_rank_ == 0 ? min_len : 0), local_s1, 0,
+                          MPI_COMM_WORLD);
+  ppc::mpi::Scatter<char>(plan, std::span<const char>(input.second).first(proc_rank_ == 0 ? min_len : 0), local_s2,
+                          0, MPI_COMM_WORLD);
+
+  const uint64_t local_diff = ppc::simd::CountMismatches(local_s1, local_s2);
+  const uint64_t global_diff = ppc::mpi::Allreduce(local_diff, MPI_SUM, MPI_COMM_WORLD);
+  GetOutput() = static_cast<int>(global_diff + (max_len - min_len));
   return true;
 }
 
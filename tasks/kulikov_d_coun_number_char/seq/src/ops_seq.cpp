@@ -2,8 +2,10 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <limits>
 
 #include "kulikov_d_coun_number_char/common/include/common.hpp"
+#include "simd/include/simd.hpp"
 
 namespace kulikov_d_coun_number_char {
 
@@ -14,7 +16,9 @@ KulikovDiffCountNumberCharSEQ::KulikovDiffCountNumberCharSEQ(const InType &in) {
 }
 
 bool KulikovDiffCountNumberCharSEQ::ValidationImpl() {
-  return true;
+  // Every character of the longer string may differ and OutType is int, so a longer string would wrap the count
+  const auto &[s1, s2] = GetInput();
+  return std::max(s1.size(), s2.size()) <= static_cast<size_t>(std::numeric_limits<OutType>::max());
 }
 
 bool KulikovDiffCountNumberCharSEQ::PreProcessingImpl() {
@@ -27,14 +31,8 @@ bool KulikovDiffCountNumberCharSEQ::RunImpl() {
   size_t min_len = std::min(s1.size(), s2.size());
   size_t max_len = std::max(s1.size(), s2.size());
 
-  int diff_count = 0;
-
   // cчитаем несовпадения по диапазону
-  for (size_t i = 0; i < min_len; ++i) {
-    if (s1[i] != s2[i]) {
-      diff_count++;
-    }
-  }
+  int diff_count = static_cast<int>(ppc::simd::CountMismatches(s1, s2));
 
   diff_count += static_cast<int>(max_len - min_len);
 
@@ -1,7 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <mpi.h>
+
 #include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
+#include <libenvpp/detail/environment.hpp>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -10,6 +16,7 @@
 #include "kulikov_d_coun_number_char/common/include/common.hpp"
 #include "kulikov_d_coun_number_char/mpi/include/ops_mpi.hpp"
 #include "kulikov_d_coun_number_char/seq/include/ops_seq.hpp"
+#include "mpi/include/collectives.hpp"
 #include "util/include/func_test_util.hpp"
 #include "util/include/util.hpp"
 
@@ -101,5 +108,74 @@ const auto kAllTestTasks = std::tuple_cat(
 INSTANTIATE_TEST_SUITE_P(CharacterDiffFuncTests, KulikovDiffCountNumberCharFuncTests,
                          ppc::util::ExpandToValues(kAllTestTasks), KulikovDiffCountNumberCharFuncTests::PrintTestParam);
 
+/// MemAvailable of /proc/meminfo in bytes; 0 where it cannot be read.
+uint64_t AvailableMemory() {
+  std::ifstream meminfo("/proc/meminfo");
+  std::string key;
+  uint64_t kib = 0;
+  std::string unit;
+  while (meminfo >> key >> kib >> unit) {
+    if (key == "MemAvailable:") {
+      return kib * 1024;
+    }
+  }
+  return 0;
+}
+
+/// Whether the root has more than @p bytes of free memory, agreed on by every rank.
+bool RootHasMemory(uint64_t bytes) {
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  int enough_memory = rank == 0 && AvailableMemory() > bytes + (std::size_t{1} << 30U) ? 1 : 0;
+  MPI_Bcast(&enough_memory, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  return enough_memory != 0;
+}
+
+OutType RunMpiTask(const InType &input) {
+  KulikovDiffCountNumberCharMPI task(input);
+  EXPECT_TRUE(task.Validation() && task.PreProcessing() && task.Run() && task.PostProcessing());
+  return task.GetOutput();
+}
+
+TEST(KulikovDiffCountNumberCharLargeCount, ChunkedTransfersCountEveryDifference) {
+  if (!ppc::util::IsUnderMpirun()) {
+    GTEST_SKIP();
+  }
+  // A tiny count limit sends every transfer down the path of counts above INT_MAX
+  env::detail::set_scoped_environment_variable max_count("PPC_MPI_MAX_COUNT", "5");
+  ppc::mpi::ResetMaxCount();
+  std::string first(997, 'x');
+  std::string second = first + "tail";
+  for (std::size_t i = 0; i < first.size(); i += 7) {
+    second[i] = 'y';
+  }
+  EXPECT_EQ(RunMpiTask({first, second}), 143 + 4);
+  // The collectives read the limit once; the next test reads the previous value again
+  ppc::mpi::ResetMaxCount();
+}
+
+TEST(KulikovDiffCountNumberCharLargeCount, StringsLongerThanIntMaxAreRejected) {
+  if (!ppc::util::IsUnderMpirun()) {
+    GTEST_SKIP();
+  }
+  const std::size_t length = std::size_t{INT_MAX} + 1;
+  // The root holds the string and the task's copy of it
+  if (!RootHasMemory(2 * length)) {
+    GTEST_SKIP() << "Needs about " << ((2 * length) >> 30U) << " GiB of free memory";
+  }
+
+  InType input;
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) {
+    input.first.assign(length, 'a');
+  }
+  {
+    KulikovDiffCountNumberCharMPI task(input);
+    EXPECT_FALSE(task.Validation());
+  }
+  ppc::util::DestructorFailureFlag::Unset();
+}
+
 }  // namespace
 }  // namespace kulikov_d_coun_number_char
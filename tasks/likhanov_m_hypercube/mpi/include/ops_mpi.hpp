@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mpi.h>
+
 #include <cstdint>
 
 #include "likhanov_m_hypercube/common/include/common.hpp"
@@ -7,6 +9,10 @@
 
 namespace likhanov_m_hypercube {
 
+/// @brief Element-wise sum of @p count values over @p comm into rank 0's @p data, exchanging along the dimensions
+/// of a hypercube; the contents of @p data on other ranks are unspecified afterwards.
+void DimensionExchangeSum(std::uint64_t *data, int count, MPI_Comm comm);
+
 class LikhanovMHypercubeMPI : public BaseTask {
  public:
   static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
@@ -2,13 +2,35 @@
 
 #include <mpi.h>
 
-#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "likhanov_m_hypercube/common/include/common.hpp"
 
 namespace likhanov_m_hypercube {
 
+void DimensionExchangeSum(std::uint64_t *data, int count, MPI_Comm comm) {
+  int rank = 0;
+  int size = 0;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+  std::vector<std::uint64_t> received(static_cast<std::size_t>(count));
+  for (int mask = 1; mask < size; mask <<= 1) {
+    const int partner = rank ^ mask;
+    if ((rank & mask) != 0) {
+      MPI_Send(data, count, MPI_UINT64_T, partner, 0, comm);
+      break;
+    }
+    if (partner < size) {
+      MPI_Recv(received.data(), count, MPI_UINT64_T, partner, 0, comm, MPI_STATUS_IGNORE);
+      for (std::size_t i = 0; i < received.size(); i++) {
+        data[i] += received[i];
+      }
+    }
+  }
+}
+
 LikhanovMHypercubeMPI::LikhanovMHypercubeMPI(const InType &in) {
   SetTypeOfTask(GetStaticTypeOfTask());
   GetInput() = in;
@@ -38,7 +60,6 @@ bool LikhanovMHypercubeMPI::RunImpl() {
     return false;
   }
 
-  const int dimension = static_cast<int>(std::log2(size));
   const InType n = GetInput();
 
   const std::uint64_t vertices = static_cast<std::uint64_t>(1) << n;
@@ -58,20 +79,7 @@ bool LikhanovMHypercubeMPI::RunImpl() {
   std::uint64_t local_edges = ComputeLocalEdges(start, end, n);
 
   std::uint64_t sum = local_edges;
-
-  for (int k = 0; k < dimension; ++k) {
-    int partner = rank ^ (1 << k);
-
-    if ((rank & (1 << k)) != 0) {
-      MPI_Send(&sum, 1, MPI_UINT64_T, partner, 0, MPI_COMM_WORLD);
-      break;
-    }
-    if (partner < size) {
-      std::uint64_t received = 0;
-      MPI_Recv(&received, 1, MPI_UINT64_T, partner, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-      sum += received;
-    }
-  }
+  DimensionExchangeSum(&sum, 1, MPI_COMM_WORLD);
 
   MPI_Bcast(&sum, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
 
@@ -0,0 +1,21 @@
+#include <mpi.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "likhanov_m_hypercube/mpi/include/ops_mpi.hpp"
+#include "performance/include/comm_bench.hpp"
+
+namespace likhanov_m_hypercube {
+
+namespace {
+
+const bool kCommBenchRegistered = ppc::performance::RegisterCustomCollective(
+    ppc::performance::CommPattern::kReduce,
+    {.task = "likhanov_m_hypercube", .reduce = [](std::vector<uint64_t> &values, MPI_Comm comm) {
+       DimensionExchangeSum(values.data(), static_cast<int>(values.size()), comm);
+     }});
+
+}  // namespace
+
+}  // namespace likhanov_m_hypercube
@@ -2,11 +2,20 @@
 
 #include <mpi.h>
 
+#include <cstddef>
+
 #include "morozova_s_broadcast/common/include/common.hpp"
 #include "task/include/task.hpp"
 
 namespace morozova_s_broadcast {
 
+/// @brief Broadcasts @p count elements of @p type from @p root over a binomial tree of point-to-point messages.
+/// @details The message travels in segments of @p segment elements, or whole for 0.
+void BinomialTreeBroadcast(void *buffer, int count, MPI_Datatype type, int root, MPI_Comm comm, int segment);
+
+/// @brief Segment length, in elements, the task uses for a broadcast of @p elements elements on this host.
+int GetSegmentElements(std::size_t elements);
+
 class MorozovaSBroadcastMPI : public BaseTask {
  public:
   static ppc::task::TypeOfTask GetStaticTypeOfTask();
@@ -24,8 +33,6 @@ class MorozovaSBroadcastMPI : public BaseTask {
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
-  static void CustomBroadcast(void *buffer, int count, MPI_Datatype type, int root, MPI_Comm comm);
-
   int root_;
 };
 
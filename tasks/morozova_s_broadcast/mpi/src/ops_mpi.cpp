@@ -3,13 +3,34 @@
 #include <mpi.h>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 
 #include "morozova_s_broadcast/common/include/common.hpp"
 #include "task/include/task.hpp"
+#include "util/include/tunables.hpp"
 
 namespace morozova_s_broadcast {
 
+namespace {
+
+// Large messages pipelined in segments keep every level of the tree busy; 0 sends the message whole
+const ppc::util::Tunable kSegmentElements({.task = "morozova_s_broadcast",
+                                           .implementation = "mpi",
+                                           .name = "segment_elements",
+                                           .default_value = 0,
+                                           .candidates = ppc::util::PowerOfTwoRange(int64_t{1} << 12,
+                                                                                    int64_t{1} << 20)});
+
+}  // namespace
+
+int GetSegmentElements(std::size_t elements) {
+  const auto limit = static_cast<int64_t>(std::min<std::size_t>(elements, std::numeric_limits<int>::max()));
+  return static_cast<int>(std::clamp<int64_t>(kSegmentElements.Get(elements), 0, limit));
+}
+
 ppc::task::TypeOfTask MorozovaSBroadcastMPI::GetStaticTypeOfTask() {
   return ppc::task::TypeOfTask::kMPI;
 }
@@ -45,17 +66,20 @@ bool MorozovaSBroadcastMPI::PreProcessingImpl() {
 bool MorozovaSBroadcastMPI::RunImpl() {
   int rank = 0;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  int data_size = 0;
+  // The root picks the segment size, so ranks on hosts with different tuning still split the data alike
+  std::array<int, 2> header = {0, 0};
   if (rank == root_) {
-    data_size = static_cast<int>(GetInput().size());
+    header[0] = static_cast<int>(GetInput().size());
+    header[1] = GetSegmentElements(GetInput().size());
   }
-  CustomBroadcast(&data_size, 1, MPI_INT, root_, MPI_COMM_WORLD);
+  BinomialTreeBroadcast(header.data(), 2, MPI_INT, root_, MPI_COMM_WORLD, 0);
+  const int data_size = header[0];
   GetOutput().resize(static_cast<size_t>(data_size));
   if (data_size > 0) {
     if (rank == root_) {
       std::copy(GetInput().begin(), GetInput().end(), GetOutput().begin());
     }
-    CustomBroadcast(GetOutput().data(), data_size, MPI_INT, root_, MPI_COMM_WORLD);
+    BinomialTreeBroadcast(GetOutput().data(), data_size, MPI_INT, root_, MPI_COMM_WORLD, header[1]);
   }
   return true;
 }
@@ -64,7 +88,7 @@ bool MorozovaSBroadcastMPI::PostProcessingImpl() {
   return true;
 }
 
-void MorozovaSBroadcastMPI::CustomBroadcast(void *buffer, int count, MPI_Datatype type, int root, MPI_Comm comm) {
+void BinomialTreeBroadcast(void *buffer, int count, MPI_Datatype type, int root, MPI_Comm comm, int segment) {
   int rank = 0;
   int size = 0;
   MPI_Comm_rank(comm, &rank);
@@ -72,18 +96,27 @@ void MorozovaSBroadcastMPI::CustomBroadcast(void *buffer, int count, MPI_Datatyp
   if (size <= 1) {
     return;
   }
+  MPI_Aint lower_bound = 0;
+  MPI_Aint extent = 0;
+  MPI_Type_get_extent(type, &lower_bound, &extent);
+  // Segments travel down the tree one after another, so inner ranks forward one while receiving the next
+  const int segment_count = segment > 0 ? segment : count;
   int vrank = (rank - root + size) % size;
-  for (int step = 1; step < size; step <<= 1) {
-    if (vrank < step) {
-      int dst_vrank = vrank + step;
-      if (dst_vrank < size) {
-        int dst_rank = (dst_vrank + root) % size;
-        MPI_Send(buffer, count, type, dst_rank, 0, comm);
+  for (int offset = 0; offset < count; offset += segment_count) {
+    void *chunk = static_cast<char *>(buffer) + (static_cast<MPI_Aint>(offset) * extent);
+    const int chunk_count = std::min(segment_count, count - offset);
+    for (int step = 1; step < size; step <<= 1) {
+      if (vrank < step) {
+        int dst_vrank = vrank + step;
+        if (dst_vrank < size) {
+          int dst_rank = (dst_vrank + root) % size;
+          MPI_Send(chunk, chunk_count, type, dst_rank, 0, comm);
+        }
+      } else if (vrank < 2 * step) {
+        int src_vrank = vrank - step;
+        int src_rank = (src_vrank + root) % size;
+        MPI_Recv(chunk, chunk_count, type, src_rank, 0, comm, MPI_STATUS_IGNORE);
       }
-    } else if (vrank < 2 * step) {
-      int src_vrank = vrank - step;
-      int src_rank = (src_vrank + root) % size;
-      MPI_Recv(buffer, count, type, src_rank, 0, comm, MPI_STATUS_IGNORE);
     }
   }
 }
@@ -0,0 +1,28 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "morozova_s_broadcast/common/include/common.hpp"
+#include "morozova_s_broadcast/mpi/include/ops_mpi.hpp"
+#include "morozova_s_broadcast/seq/include/ops_seq.hpp"
+#include "util/include/bench_registry.hpp"
+#include "util/include/workload.hpp"
+
+namespace morozova_s_broadcast {
+
+namespace {
+
+const ppc::util::BenchInputs<InType, OutType> kBenchInputs{
+    .default_size = 10000000,
+    .generators = {{"uniform",
+                    [](std::size_t size, uint64_t seed) {
+                      return ppc::util::workload::GenerateValues(ppc::util::workload::Distribution::kUniform, size,
+                                                                 -1000, 1000, {.seed = seed});
+                    }}},
+    .check = [](const InType &input, const OutType &output) { return input == output; }};
+
+const bool kBenchRegistered = ppc::util::RegisterBenchTasks<MorozovaSBroadcastMPI, MorozovaSBroadcastSEQ>(
+    PPC_ID_morozova_s_broadcast, PPC_SETTINGS_morozova_s_broadcast, kBenchInputs);
+
+}  // namespace
+
+}  // namespace morozova_s_broadcast
@@ -0,0 +1,22 @@
+#include <mpi.h>
+
+#include <vector>
+
+#include "morozova_s_broadcast/mpi/include/ops_mpi.hpp"
+#include "performance/include/comm_bench.hpp"
+
+namespace morozova_s_broadcast {
+
+namespace {
+
+// The bytes are split into segments of the tuned length the task would use for the same number of ints
+const bool kCommBenchRegistered = ppc::performance::RegisterCustomCollective(
+    ppc::performance::CommPattern::kBcast,
+    {.task = "morozova_s_broadcast", .bcast = [](std::vector<char> &block, MPI_Comm comm) {
+       const int segment = GetSegmentElements(block.size() / sizeof(int)) * static_cast<int>(sizeof(int));
+       BinomialTreeBroadcast(block.data(), static_cast<int>(block.size()), MPI_CHAR, 0, comm, segment);
+     }});
+
+}  // namespace
+
+}  // namespace morozova_s_broadcast
@@ -14,7 +14,7 @@ class MorozovaSRunPerfTestProcesses : public ppc::util::BaseRunPerfTests<InType,
   InType input_data_;
 
   void SetUp() override {
-    input_data_.resize(kCount_, 1);
+    input_data_.resize(ppc::util::ScalePerfInputSize(kCount_), 1);
   }
 
   bool CheckTestOutputData(OutType &output_data) final {
@@ -33,7 +33,7 @@ TEST_P(MorozovaSRunPerfTestProcesses, RunPerfModes) {
 const auto kAllPerfTasks = ppc::util::MakeAllPerfTasks<InType, MorozovaSBroadcastMPI, MorozovaSBroadcastSEQ>(
     PPC_SETTINGS_morozova_s_broadcast);
 
-const auto kGtestValues = ppc::util::TupleToGTestValues(kAllPerfTasks);
+const auto kGtestValues = ppc::util::TupleToScaledGTestValues(kAllPerfTasks);
 const auto kPerfTestName = MorozovaSRunPerfTestProcesses::CustomPerfTestName;
 
 INSTANTIATE_TEST_SUITE_P(RunModeTests, MorozovaSRunPerfTestProcesses, kGtestValues, kPerfTestName);
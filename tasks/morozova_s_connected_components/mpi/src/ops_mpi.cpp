@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "morozova_s_connected_components/common/include/common.hpp"
+#include "util/include/trace.hpp"
 
 namespace morozova_s_connected_components {
 
@@ -292,14 +293,28 @@ bool MorozovaSConnectedComponentsMPI::RunImpl() {
     return true;
   }
   const auto [start, end] = ComputeRowRange();
-  ComputeLocalComponents(start, end, rank_ * kLabelOffset);
+  {
+    PPC_TRACE_SCOPE("local_components");
+    ComputeLocalComponents(start, end, rank_ * kLabelOffset);
+  }
   if (rank_ == 0) {
-    GatherLocalResults();
-    MergeBoundaries();
-    NormalizeLabels();
+    {
+      PPC_TRACE_SCOPE("gather_local_results");
+      GatherLocalResults();
+    }
+    {
+      PPC_TRACE_SCOPE("boundary_merge");
+      MergeBoundaries();
+      NormalizeLabels();
+    }
+    PPC_TRACE_SCOPE("broadcast_result");
     BroadcastResult();
   } else {
-    SendLocalResult(start, end);
+    {
+      PPC_TRACE_SCOPE("send_local_result");
+      SendLocalResult(start, end);
+    }
+    PPC_TRACE_SCOPE("receive_final_result");
     ReceiveFinalResult();
   }
   return true;
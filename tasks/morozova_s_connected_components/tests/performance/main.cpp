@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <vector>
 
@@ -7,6 +8,8 @@
 #include "morozova_s_connected_components/mpi/include/ops_mpi.hpp"
 #include "morozova_s_connected_components/seq/include/ops_seq.hpp"
 #include "util/include/perf_test_util.hpp"
+#include "util/include/test_data_cache.hpp"
+#include "util/include/workload.hpp"
 
 namespace morozova_s_connected_components {
 
@@ -15,27 +18,11 @@ class MorozovaSRunPerfTestConnectedComponents : public ppc::util::BaseRunPerfTes
   InType input_data_;
 
   void SetUp() override {
-    input_data_ = std::vector<std::vector<int>>(kImageSize_, std::vector<int>(kImageSize_, 0));
-    for (int i = 10; i < 40; ++i) {
-      input_data_[i][20] = 1;
-      input_data_[i][21] = 1;
-    }
-    for (int j = 60; j < 90; ++j) {
-      input_data_[50][j] = 1;
-      input_data_[51][j] = 1;
-    }
-    for (int i = 70; i < 85; ++i) {
-      for (int j = 70; j < 85; ++j) {
-        input_data_[i][j] = 1;
-      }
-    }
-    for (int i = 0; i < 20; ++i) {
-      input_data_[80 + i][10 + i] = 1;
-    }
-    input_data_[5][5] = 1;
-    input_data_[95][95] = 1;
-    input_data_[10][90] = 1;
-    input_data_[90][10] = 1;
+    // Random pixels at the percolation threshold: one image-spanning component among many small ones
+    const int size = std::max(ppc::util::ScalePerfInputSize(kImageSize_, 2), kImageSize_);
+    input_data_ = ppc::util::GetCachedTestData(ppc::util::MakeTestDataKey("morozova_cc_percolation_v1", size), [size] {
+      return ppc::util::workload::GenerateBinaryImage(size, size, ppc::util::workload::kPercolationThreshold);
+    });
   }
 
   bool CheckTestOutputData(OutType &output_data) final {
@@ -84,7 +71,7 @@ TEST_P(MorozovaSRunPerfTestConnectedComponents, RunPerfModes) {
 const auto kAllPerfTasks =
     ppc::util::MakeAllPerfTasks<InType, MorozovaSConnectedComponentsMPI, MorozovaSConnectedComponentsSEQ>(
         PPC_SETTINGS_morozova_s_connected_components);
-const auto kGtestValues = ppc::util::TupleToGTestValues(kAllPerfTasks);
+const auto kGtestValues = ppc::util::TupleToScaledGTestValues(kAllPerfTasks);
 const auto kPerfTestName = MorozovaSRunPerfTestConnectedComponents::CustomPerfTestName;
 INSTANTIATE_TEST_SUITE_P(RunModeTests, MorozovaSRunPerfTestConnectedComponents, kGtestValues, kPerfTestName);
 
@@ -4,9 +4,12 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <vector>
 
 #include "morozova_s_matrix_max_value/common/include/common.hpp"
+#include "mpi/include/collectives.hpp"
+#include "mpi/include/distribution.hpp"
 
 namespace morozova_s_matrix_max_value {
 
@@ -34,17 +37,15 @@ bool MorozovaSMatrixMaxValueMPI::PreProcessingImpl() {
 
 bool MorozovaSMatrixMaxValueMPI::RunImpl() {
   int rank = 0;
-  int size = 1;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
   const auto &matrix = GetInput();
   if (matrix.empty() || matrix[0].empty()) {
     GetOutput() = 0;
     return true;
   }
-  const int rows = static_cast<int>(matrix.size());
-  const int cols = static_cast<int>(matrix[0].size());
-  const int total = rows * cols;
+  const std::size_t rows = matrix.size();
+  const std::size_t cols = matrix[0].size();
+  const std::size_t total = rows * cols;
   std::vector<int> flat;
   if (rank == 0) {
     flat.reserve(total);
@@ -52,26 +53,16 @@ bool MorozovaSMatrixMaxValueMPI::RunImpl() {
       flat.insert(flat.end(), row.begin(), row.end());
     }
   }
-  std::vector<int> counts(size);
-  std::vector<int> displs(size);
-  const int base = total / size;
-  const int rest = total % size;
-  for (int i = 0, off = 0; i < size; ++i) {
-    counts[i] = base + static_cast<int>(i < rest);
-    displs[i] = off;
-    off += counts[i];
-  }
-  std::vector<int> local(counts[rank]);
-  MPI_Scatterv(rank == 0 ? flat.data() : nullptr, counts.data(), displs.data(), MPI_INT, local.data(), counts[rank],
-               MPI_INT, 0, MPI_COMM_WORLD);
+  const auto &plan = ppc::mpi::GetBlockPlan(total, MPI_COMM_WORLD);
+  std::vector<int> local(plan.LocalSize(rank));
+  ppc::mpi::Scatter<int>(plan, flat, local, 0, MPI_COMM_WORLD);
 
-  int local_max = local[0];
+  // Ranks beyond the element count get nothing and must not decide the maximum
+  int local_max = std::numeric_limits<int>::min();
   for (int v : local) {
     local_max = std::max(local_max, v);
   }
-  int global_max = 0;
-  MPI_Allreduce(&local_max, &global_max, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-  GetOutput() = global_max;
+  GetOutput() = ppc::mpi::Allreduce(local_max, MPI_MAX, MPI_COMM_WORLD);
   return true;
 }
 
@@ -4,9 +4,14 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+#include "mpi/include/collectives.hpp"
+#include "mpi/include/distribution.hpp"
 #include "sabutay_a_increasing_contrast/common/include/common.hpp"
+#include "simd/include/simd.hpp"
 
 namespace sabutay_a_increasing_contrast {
 
@@ -26,20 +31,15 @@ bool SabutayAIncreaseContrastMPI::PreProcessingImpl() {
 
 bool SabutayAIncreaseContrastMPI::RunImpl() {
   int rank = 0;
-  int size = 0;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
-
-  int data_len = 0;
-  if (rank == 0) {
-    data_len = static_cast<int>(GetInput().size());
-  }
 
   // Рассылаем процессам размер данных
-  MPI_Bcast(&data_len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  const uint64_t data_len = ppc::mpi::Bcast<uint64_t>(rank == 0 ? GetInput().size() : 0, 0, MPI_COMM_WORLD);
 
   // Раздаем локальные данные всем процессам
-  std::vector<unsigned char> proc_part = ScatterInputData(rank, size, data_len);
+  const auto &plan = ppc::mpi::GetBlockPlan(static_cast<std::size_t>(data_len), MPI_COMM_WORLD);
+  std::vector<unsigned char> proc_part(plan.LocalSize(rank));
+  ppc::mpi::Scatter<unsigned char>(plan, GetInput(), proc_part, 0, MPI_COMM_WORLD);
 
   // Узнаем максимальное и минимальное значение пикселей и сообщаем об этом всем процессам
   unsigned char data_min = 0;
@@ -49,74 +49,37 @@ bool SabutayAIncreaseContrastMPI::RunImpl() {
   // Преобразование пикселей процессами
   std::vector<unsigned char> local_output = ApplyContrast(proc_part, data_min, data_max);
 
-  // Получаем данные о частях
-  int local_size = data_len / size;
-  int remainder = data_len % size;
-  std::vector<int> counts(size);
-  std::vector<int> step(size);
-  int start = 0;
-  for (int i = 0; i < size; ++i) {
-    counts[i] = local_size + (i < remainder ? 1 : 0);
-    step[i] = start;
-    start += counts[i];
-  }
-
   // Рассылаем результат всем процессам
   GetOutput().resize(data_len);
-  MPI_Allgatherv(local_output.data(), static_cast<int>(local_output.size()), MPI_UNSIGNED_CHAR, GetOutput().data(),
-                 counts.data(), step.data(), MPI_UNSIGNED_CHAR, MPI_COMM_WORLD);
+  ppc::mpi::Allgather<unsigned char>(plan, local_output, GetOutput(), MPI_COMM_WORLD);
 
   return true;
 }
 
-std::vector<unsigned char> SabutayAIncreaseContrastMPI::ScatterInputData(int rank, int size, int data_len) {
-  int local_size = data_len / size;
-  int remainder = data_len % size;
-  int my_size = local_size + (rank < remainder ? 1 : 0);
-
-  std::vector<int> counts(size);
-  std::vector<int> step(size);
-  int start = 0;
-  for (int i = 0; i < size; ++i) {
-    counts[i] = local_size + (i < remainder ? 1 : 0);
-    step[i] = start;
-    start += counts[i];
-  }
-
-  std::vector<unsigned char> proc_part(my_size);
-  if (rank == 0) {
-    MPI_Scatterv(GetInput().data(), counts.data(), step.data(), MPI_UNSIGNED_CHAR, proc_part.data(), my_size,
-                 MPI_UNSIGNED_CHAR, 0, MPI_COMM_WORLD);
-  } else {
-    MPI_Scatterv(nullptr, nullptr, nullptr, MPI_UNSIGNED_CHAR, proc_part.data(), my_size, MPI_UNSIGNED_CHAR, 0,
-                 MPI_COMM_WORLD);
-  }
-  return proc_part;
-}
-
 void SabutayAIncreaseContrastMPI::FindGlobalMinMax(const std::vector<unsigned char> &proc_part, unsigned char *data_min,
                                                    unsigned char *data_max) {
   unsigned char local_min = 255;
   unsigned char local_max = 0;
-  for (unsigned char pixel : proc_part) {
-    local_min = std::min(local_min, pixel);
-    local_max = std::max(local_max, pixel);
+  if (!proc_part.empty()) {
+    const auto local = ppc::simd::MinMax(proc_part);
+    local_min = local.min;
+    local_max = local.max;
   }
 
-  MPI_Allreduce(&local_min, data_min, 1, MPI_UNSIGNED_CHAR, MPI_MIN, MPI_COMM_WORLD);
-  MPI_Allreduce(&local_max, data_max, 1, MPI_UNSIGNED_CHAR, MPI_MAX, MPI_COMM_WORLD);
+  *data_min = ppc::mpi::Allreduce(local_min, MPI_MIN, MPI_COMM_WORLD);
+  *data_max = ppc::mpi::Allreduce(local_max, MPI_MAX, MPI_COMM_WORLD);
 }
 
 std::vector<unsigned char> SabutayAIncreaseContrastMPI::ApplyContrast(const std::vector<unsigned char> &proc_part,
                                                                       unsigned char data_min, unsigned char data_max) {
-  int my_size = static_cast<int>(proc_part.size());
+  const std::size_t my_size = proc_part.size();
   std::vector<unsigned char> local_output(my_size);
 
   if (data_min == data_max) {
     std::ranges::fill(local_output, 128);
   } else {
     const double scale = 255.0 / (data_max - data_min);
-    for (int i = 0; i < my_size; ++i) {
+    for (std::size_t i = 0; i < my_size; ++i) {
       double scaled_value = (proc_part[i] - data_min) * scale;
       int new_pixel = static_cast<int>(std::lround(scaled_value));
       if (new_pixel < 0) {
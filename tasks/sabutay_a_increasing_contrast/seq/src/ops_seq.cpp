@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "sabutay_a_increasing_contrast/common/include/common.hpp"
+#include "simd/include/simd.hpp"
 
 namespace sabutay_a_increasing_contrast {
 
@@ -27,8 +28,7 @@ bool SabutayAIncreaseContrastSEQ::RunImpl() {
   const std::vector<unsigned char> &input = GetInput();
   std::vector<unsigned char> &output = GetOutput();
 
-  unsigned char min_val = *std::ranges::min_element(input);
-  unsigned char max_val = *std::ranges::max_element(input);
+  const auto [min_val, max_val] = ppc::simd::MinMax(input);
 
   if (min_val == max_val) {
     std::ranges::fill(output, 128);
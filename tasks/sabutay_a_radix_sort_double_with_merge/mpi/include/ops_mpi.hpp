@@ -1,5 +1,8 @@
 #pragma once
 
+#include <mpi.h>
+
+#include <functional>
 #include <vector>
 
 #include "sabutay_a_radix_sort_double_with_merge/common/include/common.hpp"
@@ -7,6 +10,15 @@
 
 namespace sabutay_a_radix_sort_double_with_merge {
 
+/// @brief Joins the block held so far with one received from another rank.
+using CombineBlocks = std::function<std::vector<double>(const std::vector<double> &, const std::vector<double> &)>;
+
+/// @brief Collects every rank's @p local block on rank 0 over a binary tree.
+/// @details At step s, ranks that are multiples of 2s receive the size and then the block accumulated by rank + s
+/// and replace theirs with @p combine(theirs, received); the other ranks send theirs and stop. Only rank 0's
+/// @p local holds the result afterwards.
+void BinaryTreeCombine(std::vector<double> &local, const CombineBlocks &combine, MPI_Comm comm);
+
 class SabutayAradixSortDoubleWithMergeMPI : public BaseTask {
  public:
   static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
@@ -26,8 +38,6 @@ class SabutayAradixSortDoubleWithMergeMPI : public BaseTask {
   bool PostProcessingImpl() override;
 
   std::vector<double> local_;
-  std::vector<int> counts_;
-  std::vector<int> displs_;
   int world_rank_{0};
   int world_size_{1};
 };
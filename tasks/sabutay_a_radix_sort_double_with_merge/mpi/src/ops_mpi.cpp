@@ -7,8 +7,13 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
+#include "mpi/include/collectives.hpp"
+#include "mpi/include/distribution.hpp"
+#include "util/include/trace.hpp"
+
 namespace sabutay_a_radix_sort_double_with_merge {
 
 namespace {
@@ -95,27 +100,45 @@ std::vector<double> MergeSorted(const std::vector<double> &a, const std::vector<
 }
 
 std::vector<double> RecvVectorD(int src, int tag_base, MPI_Comm comm) {
-  int sz = 0;
-  MPI_Status status{};
-  MPI_Recv(&sz, 1, MPI_INT, src, tag_base, comm, &status);
+  uint64_t sz = 0;
+  ppc::mpi::Recv<uint64_t>(std::span(&sz, 1), src, tag_base, comm);
 
   std::vector<double> v(static_cast<std::size_t>(sz));
   if (sz > 0) {
-    MPI_Recv(v.data(), sz, MPI_DOUBLE, src, tag_base + 1, comm, &status);
+    ppc::mpi::Recv<double>(v, src, tag_base + 1, comm);
   }
   return v;
 }
 
 void SendVectorD(int dst, int tag_base, const std::vector<double> &v, MPI_Comm comm) {
-  const int sz = static_cast<int>(v.size());
-  MPI_Send(&sz, 1, MPI_INT, dst, tag_base, comm);
+  const uint64_t sz = v.size();
+  ppc::mpi::Send<uint64_t>(std::span(&sz, 1), dst, tag_base, comm);
   if (sz > 0) {
-    MPI_Send(v.data(), sz, MPI_DOUBLE, dst, tag_base + 1, comm);
+    ppc::mpi::Send<double>(v, dst, tag_base + 1, comm);
   }
 }
 
 }  // namespace
 
+void BinaryTreeCombine(std::vector<double> &local, const CombineBlocks &combine, MPI_Comm comm) {
+  int rank = 0;
+  int size = 1;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+  for (int step = 1; step < size; step <<= 1) {
+    if ((rank % (2 * step)) == 0) {
+      const int partner = rank + step;
+      if (partner < size) {
+        std::vector<double> other = RecvVectorD(partner, 2000 + step, comm);
+        local = combine(local, other);
+      }
+    } else {
+      SendVectorD(rank - step, 2000 + step, local, comm);
+      break;
+    }
+  }
+}
+
 bool SabutayAradixSortDoubleWithMergeMPI::ValidationImpl() {
   MPI_Comm_rank(MPI_COMM_WORLD, &world_rank_);
   MPI_Comm_size(MPI_COMM_WORLD, &world_size_);
@@ -126,73 +149,39 @@ bool SabutayAradixSortDoubleWithMergeMPI::PreProcessingImpl() {
   MPI_Comm_rank(MPI_COMM_WORLD, &world_rank_);
   MPI_Comm_size(MPI_COMM_WORLD, &world_size_);
 
-  int global_size = 0;
-  if (world_rank_ == 0) {
-    global_size = static_cast<int>(GetInput().size());
-  }
-  MPI_Bcast(&global_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-  counts_.assign(world_size_, 0);
-  displs_.assign(world_size_, 0);
-
-  const int base = (world_size_ > 0) ? (global_size / world_size_) : 0;
-  const int rem = (world_size_ > 0) ? (global_size % world_size_) : 0;
+  const uint64_t global_size = ppc::mpi::Bcast<uint64_t>(world_rank_ == 0 ? GetInput().size() : 0, 0, MPI_COMM_WORLD);
 
-  for (int rank_idx = 0; rank_idx < world_size_; ++rank_idx) {
-    counts_[rank_idx] = base + ((rank_idx < rem) ? 1 : 0);
-  }
-  for (int rank_idx = 1; rank_idx < world_size_; ++rank_idx) {
-    displs_[rank_idx] = displs_[rank_idx - 1] + counts_[rank_idx - 1];
-  }
-
-  local_.assign(static_cast<std::size_t>(counts_[world_rank_]), 0.0);
-
-  double *send_buf = nullptr;
-  if (world_rank_ == 0 && global_size > 0) {
-    send_buf = GetInput().data();
-  }
-
-  MPI_Scatterv(send_buf, counts_.data(), displs_.data(), MPI_DOUBLE, local_.data(), counts_[world_rank_], MPI_DOUBLE, 0,
-               MPI_COMM_WORLD);
+  const auto &plan = ppc::mpi::GetBlockPlan(static_cast<std::size_t>(global_size), MPI_COMM_WORLD);
+  local_.assign(plan.LocalSize(world_rank_), 0.0);
+  ppc::mpi::Scatter<double>(plan, GetInput(), local_, 0, MPI_COMM_WORLD);
 
   GetOutput().clear();
   return true;
 }
 
 bool SabutayAradixSortDoubleWithMergeMPI::RunImpl() {
-  RadixSortDouble(&local_);
-
-  for (int step = 1; step < world_size_; step <<= 1) {
-    if ((world_rank_ % (2 * step)) == 0) {
-      const int partner = world_rank_ + step;
-      if (partner < world_size_) {
-        std::vector<double> other = RecvVectorD(partner, 2000 + step, MPI_COMM_WORLD);
-        local_ = MergeSorted(local_, other);
-      }
-    } else {
-      const int partner = world_rank_ - step;
-      SendVectorD(partner, 2000 + step, local_, MPI_COMM_WORLD);
-      break;
-    }
+  {
+    PPC_TRACE_SCOPE("local_radix_sort");
+    RadixSortDouble(&local_);
   }
+
+  PPC_TRACE_SCOPE("tree_merge");
+  BinaryTreeCombine(local_, MergeSorted, MPI_COMM_WORLD);
   return true;
 }
 
 bool SabutayAradixSortDoubleWithMergeMPI::PostProcessingImpl() {
-  int out_size = 0;
   if (world_rank_ == 0) {
     GetOutput() = local_;
-    out_size = static_cast<int>(GetOutput().size());
   }
-
-  MPI_Bcast(&out_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  const uint64_t out_size = ppc::mpi::Bcast<uint64_t>(GetOutput().size(), 0, MPI_COMM_WORLD);
 
   if (world_rank_ != 0) {
     GetOutput().assign(static_cast<std::size_t>(out_size), 0.0);
   }
 
   if (out_size > 0) {
-    MPI_Bcast(GetOutput().data(), out_size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    ppc::mpi::Bcast<double>(GetOutput(), 0, MPI_COMM_WORLD);
   }
   return true;
 }
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "sabutay_a_radix_sort_double_with_merge/common/include/common.hpp"
+#include "sabutay_a_radix_sort_double_with_merge/mpi/include/ops_mpi.hpp"
+#include "sabutay_a_radix_sort_double_with_merge/seq/include/ops_seq.hpp"
+#include "util/include/bench_registry.hpp"
+
+namespace sabutay_a_radix_sort_double_with_merge {
+
+namespace {
+
+InType MakeUniform(std::size_t size, uint64_t seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_real_distribution<double> dist(-1.0e6, 1.0e6);
+  InType data(size);
+  for (auto &value : data) {
+    value = dist(gen);
+  }
+  return data;
+}
+
+InType MakeSorted(std::size_t size, uint64_t seed) {
+  auto data = MakeUniform(size, seed);
+  std::ranges::sort(data);
+  return data;
+}
+
+InType MakeReversed(std::size_t size, uint64_t seed) {
+  auto data = MakeSorted(size, seed);
+  std::ranges::reverse(data);
+  return data;
+}
+
+const ppc::util::BenchInputs<InType, OutType> kBenchInputs{
+    .default_size = 200000,
+    .generators = {{"uniform", MakeUniform}, {"sorted", MakeSorted}, {"reversed", MakeReversed}},
+    .check = [](const InType &input, const OutType &output) {
+      auto expected = input;
+      std::ranges::sort(expected);
+      return output == expected;
+    }};
+
+const bool kBenchRegistered =
+    ppc::util::RegisterBenchTasks<SabutayAradixSortDoubleWithMergeMPI, SabutayAradixSortDoubleWithMergeSEQ>(
+        PPC_ID_sabutay_a_radix_sort_double_with_merge, PPC_SETTINGS_sabutay_a_radix_sort_double_with_merge,
+        kBenchInputs);
+
+}  // namespace
+
+}  // namespace sabutay_a_radix_sort_double_with_merge
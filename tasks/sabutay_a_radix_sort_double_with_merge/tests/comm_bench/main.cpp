@@ -0,0 +1,32 @@
+#include <mpi.h>
+
+#include <vector>
+
+#include "performance/include/comm_bench.hpp"
+#include "sabutay_a_radix_sort_double_with_merge/mpi/include/ops_mpi.hpp"
+
+namespace sabutay_a_radix_sort_double_with_merge {
+
+namespace {
+
+// Stands in for the task's merge so that only the communication of its tree is timed
+std::vector<double> Concatenate(const std::vector<double> &left, const std::vector<double> &right) {
+  std::vector<double> combined(left);
+  combined.insert(combined.end(), right.begin(), right.end());
+  return combined;
+}
+
+std::vector<double> TreeGather(std::vector<double> part, MPI_Comm comm) {
+  BinaryTreeCombine(part, Concatenate, comm);
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  return rank == 0 ? part : std::vector<double>{};
+}
+
+const bool kCommBenchRegistered = ppc::performance::RegisterCustomCollective(
+    ppc::performance::CommPattern::kGather,
+    {.task = "sabutay_a_radix_sort_double_with_merge", .gather = TreeGather});
+
+}  // namespace
+
+}  // namespace sabutay_a_radix_sort_double_with_merge
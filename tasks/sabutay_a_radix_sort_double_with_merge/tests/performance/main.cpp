@@ -10,18 +10,13 @@
 #include "sabutay_a_radix_sort_double_with_merge/common/include/common.hpp"
 #include "sabutay_a_radix_sort_double_with_merge/mpi/include/ops_mpi.hpp"
 #include "util/include/perf_test_util.hpp"
+#include "util/include/test_data_cache.hpp"
+#include "util/include/workload.hpp"
 
 namespace sabutay_a_radix_sort_double_with_merge {
 
 namespace {
 
-double NextRandDouble(uint32_t *state) {
-  *state = (*state * 1103515245U) + 12345U;
-  const uint32_t x = *state;
-  const double u = static_cast<double>(x) / static_cast<double>(UINT32_MAX);
-  return (u * 2.0 - 1.0) * 1.0e6;
-}
-
 inline uint64_t DoubleToOrderedKey(double x) {
   if (std::isnan(x)) {
     return UINT64_MAX;
@@ -81,16 +76,19 @@ void RadixSortDouble(std::vector<double> *vec) {
 class RastvorovKRadixSortDoubleMergeRunPerfTestProcesses : public ppc::util::BaseRunPerfTests<InType, OutType> {
  public:
   void SetUp() override {
+    // Every implementation and mode sorts the same data, so it is generated and sorted once per suite
     constexpr std::size_t kSize = 200000;
-    input_data_.resize(kSize);
-
-    uint32_t state = 17U;
-    for (std::size_t i = 0; i < kSize; ++i) {
-      input_data_[i] = NextRandDouble(&state);
-    }
-
-    expected_ = input_data_;
-    RadixSortDouble(&expected_);
+    const auto distribution = ppc::util::PerfInputDistribution();
+    const auto input_key = ppc::util::MakeTestDataKey("sabutay_radix_workload_v1", kSize,
+                                                      ppc::util::workload::GetDistributionName(distribution));
+    const auto &input = ppc::util::GetCachedTestData(
+        input_key, [distribution] { return ppc::util::workload::GenerateValues(distribution, kSize, -1.0e6, 1.0e6); });
+    input_data_ = input;
+    expected_ = ppc::util::GetCachedTestData(input_key + ":sorted", [&input] {
+      OutType sorted = input;
+      RadixSortDouble(&sorted);
+      return sorted;
+    });
   }
 
   bool CheckTestOutputData(OutType &output_data) final {
@@ -1,11 +1,9 @@
 #include "shkryleva_s_vec_min_val/seq/include/ops_seq.hpp"
 
-#include <algorithm>
-#include <cstddef>
 #include <limits>
-#include <vector>
 
 #include "shkryleva_s_vec_min_val/common/include/common.hpp"
+#include "simd/include/simd.hpp"
 
 namespace shkryleva_s_vec_min_val {
 
@@ -32,12 +30,7 @@ bool ShkrylevaSVecMinValSEQ::RunImpl() {
     return true;
   }
 
-  int min_val = input.front();
-  for (std::size_t i = 1; i < input.size(); ++i) {
-    min_val = std::min(input[i], min_val);
-  }
-
-  GetOutput() = min_val;
+  GetOutput() = ppc::simd::MinMax(input).min;
   return true;
 }
 
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "shkryleva_s_vec_min_val/common/include/common.hpp"
+#include "shkryleva_s_vec_min_val/mpi/include/ops_mpi.hpp"
+#include "shkryleva_s_vec_min_val/seq/include/ops_seq.hpp"
+#include "util/include/bench_registry.hpp"
+
+namespace shkryleva_s_vec_min_val {
+
+namespace {
+
+InType MakeUniform(std::size_t size, uint64_t seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int> dist(-1000, 1000);
+  InType data(size);
+  for (auto &value : data) {
+    value = dist(gen);
+  }
+  return data;
+}
+
+/// Decreasing values put the minimum into the last process's block.
+InType MakeDescending(std::size_t size, uint64_t /*seed*/) {
+  InType data(size);
+  for (std::size_t i = 0; i < size; i++) {
+    data[i] = static_cast<int>(size - i);
+  }
+  return data;
+}
+
+const ppc::util::BenchInputs<InType, OutType> kBenchInputs{
+    .default_size = 100000000,
+    .generators = {{"uniform", MakeUniform}, {"descending", MakeDescending}},
+    .check = [](const InType &input, const OutType &output) {
+      return !input.empty() && std::ranges::min(input) == output;
+    }};
+
+const bool kBenchRegistered = ppc::util::RegisterBenchTasks<ShkrylevaSVecMinValMPI, ShkrylevaSVecMinValSEQ>(
+    PPC_ID_shkryleva_s_vec_min_val, PPC_SETTINGS_shkryleva_s_vec_min_val, kBenchInputs);
+
+}  // namespace
+
+}  // namespace shkryleva_s_vec_min_val
@@ -1,11 +1,18 @@
 #include <gtest/gtest.h>
 
+#include <mpi.h>
+
+#include <algorithm>
 #include <array>
 #include <climits>
 #include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <libenvpp/detail/environment.hpp>
 #include <string>
 #include <tuple>
 
+#include "mpi/include/distribution.hpp"
 #include "shkryleva_s_vec_min_val/common/include/common.hpp"
 #include "shkryleva_s_vec_min_val/mpi/include/ops_mpi.hpp"
 #include "shkryleva_s_vec_min_val/seq/include/ops_seq.hpp"
@@ -90,6 +97,54 @@ const auto kPerfTestName = ShkrylevaRunFuncTestsProcesses::PrintFuncTestName<Shk
 
 INSTANTIATE_TEST_SUITE_P(VectorMinTests, ShkrylevaRunFuncTestsProcesses, kGtestValues, kPerfTestName);
 
+/// MemAvailable of /proc/meminfo in bytes; 0 where it cannot be read.
+auto AvailableMemory() -> uint64_t {
+  std::ifstream meminfo("/proc/meminfo");
+  std::string key;
+  uint64_t kib = 0;
+  std::string unit;
+  while (meminfo >> key >> kib >> unit) {
+    if (key == "MemAvailable:") {
+      return kib * 1024;
+    }
+  }
+  return 0;
+}
+
+TEST(ShkrylevaVecMinValLargeCount, VectorLongerThanIntMax) {
+  if (!ppc::util::IsUnderMpirun()) {
+    GTEST_SKIP();
+  }
+  int rank = 0;
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  // The scatter leaves the int-count call once the last rank's displacement (or the only count) passes INT_MAX
+  const auto ranks = static_cast<std::size_t>(size);
+  const std::size_t length = ((std::size_t{INT_MAX} + 64) * ranks / std::max<std::size_t>(ranks - 1, 1)) + 1;
+  const std::size_t bytes = length * sizeof(int);
+  // The root holds the vector and the task's copy of it, the ranks' parts add up to the vector once more
+  int enough_memory = rank == 0 && AvailableMemory() > (3 * bytes) + (std::size_t{1} << 30U) ? 1 : 0;
+  MPI_Bcast(&enough_memory, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (enough_memory == 0) {
+    GTEST_SKIP() << "Needs about " << ((3 * bytes) >> 30U) << " GiB of free memory";
+  }
+
+  ASSERT_GT(ppc::mpi::GetBlockPlan(length, MPI_COMM_WORLD).MaxExtent(), std::size_t{INT_MAX});
+
+  InType input;
+  if (rank == 0) {
+    input.assign(length, 7);
+    // Lies in the last part, which only a transfer with 64-bit counts or displacements delivers
+    input[length - 1] = -5;
+  }
+  // The time limit of the small cases does not apply to an input of this size
+  env::detail::set_scoped_environment_variable max_time("PPC_TASK_MAX_TIME", "600");
+  ShkrylevaSVecMinValMPI task(input);
+  ASSERT_TRUE(task.Validation() && task.PreProcessing() && task.Run() && task.PostProcessing());
+  EXPECT_EQ(task.GetOutput(), -5);
+}
+
 }  // namespace
 
 }  // namespace shkryleva_s_vec_min_val
@@ -20,13 +20,14 @@ class ShkrylevaSVecMinValPerfTests : public ppc::util::BaseRunPerfTests<InType,
     std::mt19937 gen(dev());
     std::uniform_int_distribution<int> dist(-1000, 1000);
 
-    input_data_.resize(kVectorSize);
-    for (size_t i = 0; i < kVectorSize; i++) {
+    const size_t size = ppc::util::ScalePerfInputSize(kVectorSize);
+    input_data_.resize(size);
+    for (size_t i = 0; i < size; i++) {
       input_data_[i] = dist(gen);
     }
 
     expected_min_ = -1500;
-    input_data_[kVectorSize / 2] = expected_min_;
+    input_data_[size / 2] = expected_min_;
   }
 
   auto CheckTestOutputData(OutType &output_data) -> bool final {
@@ -49,7 +50,7 @@ TEST_P(ShkrylevaSVecMinValPerfTests, RunPerfModes) {
 const auto kAllPerfTasks = ppc::util::MakeAllPerfTasks<InType, ShkrylevaSVecMinValMPI, ShkrylevaSVecMinValSEQ>(
     PPC_SETTINGS_shkryleva_s_vec_min_val);
 
-const auto kGtestValues = ppc::util::TupleToGTestValues(kAllPerfTasks);
+const auto kGtestValues = ppc::util::TupleToScaledGTestValues(kAllPerfTasks);
 
 const auto kPerfTestName = ShkrylevaSVecMinValPerfTests::CustomPerfTestName;
 
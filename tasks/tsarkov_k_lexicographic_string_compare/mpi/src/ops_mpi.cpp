@@ -10,6 +10,7 @@
 #include <utility>
 #include <vector>
 
+#include "mpi/include/collectives.hpp"
 #include "tsarkov_k_lexicographic_string_compare/common/include/common.hpp"
 
 namespace tsarkov_k_lexicographic_string_compare {
@@ -28,12 +29,7 @@ void BroadcastString(std::string *value, int root, MPI_Comm comm) {
   int rank = 0;
   MPI_Comm_rank(comm, &rank);
 
-  int size = 0;
-  if (rank == root) {
-    size = static_cast<int>(value->size());
-  }
-
-  MPI_Bcast(&size, 1, MPI_INT, root, comm);
+  const std::uint64_t size = ppc::mpi::Bcast<std::uint64_t>(rank == root ? value->size() : 0, root, comm);
 
   std::vector<char> buf;
   if (rank == root) {
@@ -43,7 +39,7 @@ void BroadcastString(std::string *value, int root, MPI_Comm comm) {
   }
 
   if (size > 0) {
-    MPI_Bcast(buf.data(), size, MPI_CHAR, root, comm);
+    ppc::mpi::Bcast<char>(buf, root, comm);
   }
 
   if (rank != root) {
@@ -8,6 +8,8 @@
 #include <limits>
 #include <vector>
 
+#include "mpi/include/collectives.hpp"
+#include "mpi/include/distribution.hpp"
 #include "yushkova_p_min_in_matrix/common/include/common.hpp"
 
 namespace yushkova_p_min_in_matrix {
@@ -44,20 +46,16 @@ bool YushkovaPMinInMatrixMPI::PreProcessingImpl() {
 
 bool YushkovaPMinInMatrixMPI::RunImpl() {
   int n = static_cast<int>(GetInput());
-  int world_size = 0;
   int rank = 0;
-  MPI_Comm_size(MPI_COMM_WORLD, &world_size);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-  int base_rows = n / world_size;
-  int extra = n % world_size;
-
-  int my_start = (rank * base_rows) + std::min(rank, extra);
-  int my_count = base_rows + (rank < extra ? 1 : 0);
+  const auto &plan = ppc::mpi::GetBlockPlan(static_cast<std::size_t>(n), MPI_COMM_WORLD);
+  const std::size_t my_start = plan.Displacements()[rank];
+  const std::size_t my_count = plan.Counts()[rank];
 
   std::vector<int> local_results(my_count);
-  for (int i = 0; i < my_count; ++i) {
-    int current_row = my_start + i;
+  for (std::size_t i = 0; i < my_count; ++i) {
+    const auto current_row = static_cast<int64_t>(my_start + i);
     int row_min = std::numeric_limits<int>::max();
 
     for (int j = 0; j < n; ++j) {
@@ -67,18 +65,7 @@ bool YushkovaPMinInMatrixMPI::RunImpl() {
     local_results[i] = row_min;
   }
 
-  std::vector<int> recv_counts(world_size);
-  std::vector<int> offsets(world_size);
-
-  int current_offset = 0;
-  for (int i = 0; i < world_size; ++i) {
-    recv_counts[i] = base_rows + (i < extra ? 1 : 0);
-    offsets[i] = current_offset;
-    current_offset += recv_counts[i];
-  }
-
-  MPI_Allgatherv(local_results.data(), my_count, MPI_INT, GetOutput().data(), recv_counts.data(), offsets.data(),
-                 MPI_INT, MPI_COMM_WORLD);
+  ppc::mpi::Allgather<int>(plan, local_results, GetOutput(), MPI_COMM_WORLD);
 
   return true;
 }